@@ -26,11 +26,16 @@
 
 #define OPENTXS_ARG_BACKUP_DIRECTORY "backupdirectory"
 #define OPENTXS_ARG_BINDIP "bindip"
+#define OPENTXS_ARG_BLOCK_CACHE_SIZE "blockcachesize"
 #define OPENTXS_ARG_BLOCK_STORAGE_LEVEL "blockstoragelevel"
+#define OPENTXS_ARG_BOOTSTRAP_EXPORT "bootstrapexport"
+#define OPENTXS_ARG_BOOTSTRAP_IMPORT "bootstrapimport"
 #define OPENTXS_ARG_COMMANDPORT "commandport"
 #define OPENTXS_ARG_EEP "eep"
 #define OPENTXS_ARG_ENCRYPTED_DIRECTORY "encrypteddirectory"
 #define OPENTXS_ARG_EXTERNALIP "externalip"
+#define OPENTXS_ARG_FILTER_CACHE_SIZE "filtercachesize"
+#define OPENTXS_ARG_FILTER_SOURCE "filtersource"
 #define OPENTXS_ARG_GC "gc"
 #define OPENTXS_ARG_HOME "home"
 #define OPENTXS_ARG_INIT "only-init"
@@ -39,6 +44,7 @@
 #define OPENTXS_ARG_LISTENNOTIFY "listennotify"
 #define OPENTXS_ARG_LOGENDPOINT "logendpoint"
 #define OPENTXS_ARG_LOGLEVEL "log_level"
+#define OPENTXS_ARG_MEMPOOL_SIZE "mempoolsize"
 #define OPENTXS_ARG_NAME "name"
 #define OPENTXS_ARG_NOTIFICATIONPORT "notificationport"
 #define OPENTXS_ARG_ONION "onion"
@@ -46,6 +52,7 @@
 #define OPENTXS_ARG_RESET_BLOCK_DB "resetblockdb"
 #define OPENTXS_ARG_RESET_FILTER_DB "resetfilterdb"
 #define OPENTXS_ARG_RESET_HEADER_DB "resetheaderdb"
+#define OPENTXS_ARG_SCAN_THREADS "scanthreads"
 #define OPENTXS_ARG_STORAGE_PLUGIN "storageplugin"
 #define OPENTXS_ARG_TERMS "terms"
 #define OPENTXS_ARG_VERSION "version"
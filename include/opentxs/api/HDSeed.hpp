@@ -39,6 +39,17 @@ public:
         const BIP44Chain internal,
         const Bip32Index index,
         const PasswordPrompt& reason) const = 0;
+    /// Derives count consecutive keys starting at index first in one call
+    ///
+    /// Fewer keys than requested are returned if a derivation fails
+    OPENTXS_EXPORT virtual std::vector<
+        std::unique_ptr<opentxs::crypto::key::HD>>
+    AccountChildKeys(
+        const proto::HDPath& path,
+        const BIP44Chain internal,
+        const Bip32Index first,
+        const Bip32Index count,
+        const PasswordPrompt& reason) const = 0;
 #endif  // OT_CRYPTO_WITH_BIP32
     OPENTXS_EXPORT virtual std::string Bip32Root(
         const PasswordPrompt& reason,
@@ -19,6 +19,8 @@ namespace crypto
 class Config
 {
 public:
+    /// Maximum number of extended nodes retained by the bip32 cache
+    OPENTXS_EXPORT virtual std::uint32_t Bip32CacheSize() const = 0;
     OPENTXS_EXPORT virtual std::uint32_t IterationCount() const = 0;
     OPENTXS_EXPORT virtual std::uint32_t SymmetricSaltSize() const = 0;
     OPENTXS_EXPORT virtual std::uint32_t SymmetricKeySize() const = 0;
@@ -33,6 +33,11 @@ OPENTXS_EXPORT auto FilterHash(
     const Type chain,
     const ReadView input,
     const AllocateOutput output) noexcept -> bool;
+OPENTXS_EXPORT auto MerkleHash(
+    const api::Core& api,
+    const Type chain,
+    const ReadView input,
+    const AllocateOutput output) noexcept -> bool;
 OPENTXS_EXPORT auto P2PMessageHash(
     const api::Core& api,
     const Type chain,
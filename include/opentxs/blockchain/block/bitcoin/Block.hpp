@@ -38,6 +38,10 @@ public:
     OPENTXS_EXPORT virtual auto cbegin() const noexcept -> const_iterator = 0;
     OPENTXS_EXPORT virtual auto cend() const noexcept -> const_iterator = 0;
     OPENTXS_EXPORT virtual auto end() const noexcept -> const_iterator = 0;
+    /// Approximate memory held by the transactions which at() instantiated.
+    /// They are kept for the lifetime of the block.
+    OPENTXS_EXPORT virtual auto InstantiatedSize() const noexcept
+        -> std::size_t = 0;
     OPENTXS_EXPORT virtual auto size() const noexcept -> std::size_t = 0;
 
     ~Block() override = default;
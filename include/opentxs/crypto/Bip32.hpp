@@ -39,6 +39,28 @@ public:
         const EcdsaCurve& curve,
         const OTPassword& seed,
         const Path& path) const = 0;
+    /// Derives count consecutive children of parent, starting at index first
+    ///
+    /// Fewer keys than requested are returned if a derivation fails
+    OPENTXS_EXPORT virtual std::vector<Key> DeriveKeys(
+        const EcdsaCurve& curve,
+        const OTPassword& seed,
+        const Path& parent,
+        const Bip32Index first,
+        const Bip32Index count) const = 0;
+    /// Derives count consecutive non-hardened children of parent, starting at
+    /// index first, from the compressed public key and chain code of parent
+    ///
+    /// parent is only used to set the path of the returned keys. The private
+    /// key of every returned key is empty. Fewer keys than requested are
+    /// returned if a derivation fails.
+    OPENTXS_EXPORT virtual std::vector<Key> DerivePublicKeys(
+        const EcdsaCurve& curve,
+        const ReadView publicKey,
+        const ReadView chainCode,
+        const Path& parent,
+        const Bip32Index first,
+        const Bip32Index count) const = 0;
 #endif  // OT_CRYPTO_WITH_BIP32
     OPENTXS_EXPORT virtual bool DeserializePrivate(
         const std::string& serialized,
@@ -203,6 +203,12 @@ namespace internal
 struct Header;
 }  // namespace internal
 }  // namespace bitcoin
+
+namespace internal
+{
+class HeaderView;
+struct SerializedHeader;
+}  // namespace internal
 }  // namespace block
 
 namespace client
@@ -215,6 +221,7 @@ struct FilterOracle;
 struct HeaderDatabase;
 struct HeaderOracle;
 struct IO;
+struct Mempool;
 struct Network;
 struct PeerDatabase;
 struct PeerManager;
@@ -120,6 +120,11 @@ public:
         const blockchain::block::Hash& parent,
         const blockchain::block::Height height) noexcept
         -> std::unique_ptr<blockchain::block::bitcoin::internal::Header>;
+    static auto BitcoinBlockHeader(
+        const api::internal::Core& api,
+        const blockchain::block::Hash& hash,
+        const blockchain::block::internal::SerializedHeader& record) noexcept
+        -> std::unique_ptr<blockchain::block::bitcoin::internal::Header>;
     static blockchain::p2p::bitcoin::message::internal::Addr* BitcoinP2PAddr(
         const api::internal::Core& api,
         std::unique_ptr<blockchain::p2p::bitcoin::Header> pHeader,
@@ -574,6 +579,12 @@ public:
             outputs,
         std::optional<std::size_t> size = {}) noexcept
         -> std::unique_ptr<blockchain::block::bitcoin::Outputs>;
+    /// Constructs a header from a stored record without rehashing it
+    OPENTXS_EXPORT static auto BlockHeader(
+        const api::internal::Core& api,
+        const blockchain::block::Hash& hash,
+        const blockchain::block::internal::SerializedHeader& record) noexcept
+        -> std::unique_ptr<blockchain::block::Header>;
 #endif  // OT_BLOCKCHAIN
     static auto BlockchainAPI(
         const api::client::internal::Manager& api,
@@ -799,10 +810,24 @@ public:
         const ReadView key,
         const std::vector<OTData>& elements) noexcept
         -> std::unique_ptr<blockchain::internal::GCS>;
+    OPENTXS_EXPORT static auto GCS(
+        const api::Core& api,
+        const std::uint8_t bits,
+        const std::uint32_t fpRate,
+        const ReadView key,
+        const std::vector<Space>& elements) noexcept
+        -> std::unique_ptr<blockchain::internal::GCS>;
     OPENTXS_EXPORT static auto GCS(
         const api::Core& api,
         const proto::GCS& serialized) noexcept
         -> std::unique_ptr<blockchain::internal::GCS>;
+    /// If borrow is true the filter bytes are not copied and serialized must
+    /// outlive the returned object
+    OPENTXS_EXPORT static auto GCS(
+        const api::Core& api,
+        const ReadView serialized,
+        const bool borrow) noexcept
+        -> std::unique_ptr<blockchain::internal::GCS>;
     OPENTXS_EXPORT static auto GCS(
         const api::Core& api,
         const std::uint8_t bits,
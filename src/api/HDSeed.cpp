@@ -100,6 +100,47 @@ std::unique_ptr<opentxs::crypto::key::HD> HDSeed::AccountChildKey(
 
     return GetHDKey(fingerprint, EcdsaCurve::secp256k1, path, reason);
 }
+
+std::vector<std::unique_ptr<opentxs::crypto::key::HD>> HDSeed::
+    AccountChildKeys(
+        const proto::HDPath& rootPath,
+        const BIP44Chain internal,
+        const Bip32Index first,
+        const Bip32Index count,
+        const PasswordPrompt& reason) const
+{
+    std::vector<std::unique_ptr<opentxs::crypto::key::HD>> output{};
+    std::string fingerprint{rootPath.root()};
+    Bip32Index notUsed{0};
+    auto seed = Seed(fingerprint, notUsed, reason);
+
+    if (false == bool(seed)) { return output; }
+
+    const Bip32Index change = internal ? 1 : 0;
+    Path path{};
+
+    for (const auto& child : rootPath.child()) { path.emplace_back(child); }
+
+    path.emplace_back(change);
+    const auto keys = bip32_.DeriveKeys(
+        EcdsaCurve::secp256k1, *seed, path, first, count);
+
+    for (const auto& key : keys) {
+        auto pKey = asymmetric_.InstantiateKey(
+            proto::AKEYTYPE_SECP256K1,
+            fingerprint,
+            key,
+            reason,
+            proto::KEYROLE_SIGN,
+            opentxs::crypto::key::EllipticCurve::DefaultVersion);
+
+        if (false == bool(pKey)) { break; }
+
+        output.emplace_back(std::move(pKey));
+    }
+
+    return output;
+}
 #endif  // OT_CRYPTO_WITH_BIP32
 
 std::string HDSeed::Bip32Root(
@@ -71,6 +71,12 @@ public:
         const BIP44Chain internal,
         const Bip32Index index,
         const PasswordPrompt& reason) const final;
+    std::vector<std::unique_ptr<opentxs::crypto::key::HD>> AccountChildKeys(
+        const proto::HDPath& path,
+        const BIP44Chain internal,
+        const Bip32Index first,
+        const Bip32Index count,
+        const PasswordPrompt& reason) const final;
 #endif  // OT_CRYPTO_WITH_BIP32
     std::string Bip32Root(
         const PasswordPrompt& reason,
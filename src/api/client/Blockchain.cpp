@@ -275,6 +275,16 @@ auto Blockchain::ThreadPoolManager::callback(zmq::Message& in) noexcept -> void
         case Work::Wallet: {
             opentxs::blockchain::client::internal::Wallet::ProcessTask(in);
         } break;
+        case Work::ParallelScan: {
+            opentxs::blockchain::client::internal::ParallelScan::ProcessTask(
+                in);
+        } break;
+        case Work::Lookahead: {
+            client::blockchain::internal::Deterministic::ProcessTask(in);
+        } break;
+        case Work::Bootstrap: {
+            opentxs::blockchain::client::internal::Network::ProcessTask(in);
+        } break;
         default: {
             OT_FAIL;
         }
@@ -333,6 +343,16 @@ auto Blockchain::ThreadPoolManager::run(const Chain chain) noexcept
     return output;
 }
 
+auto Blockchain::ThreadPoolManager::Send(zmq::Message& task) const noexcept
+    -> bool
+{
+    if (false == running_.load()) { return false; }
+
+    startup();
+
+    return int_->Send(task);
+}
+
 auto Blockchain::ThreadPoolManager::Shutdown() noexcept -> void
 {
     if (running_.exchange(false)) {
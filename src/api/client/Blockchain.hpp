@@ -293,6 +293,7 @@ private:
     struct ThreadPoolManager final : virtual public ThreadPoolType {
         auto Endpoint() const noexcept -> std::string final;
         auto Reset(const Chain chain) const noexcept -> void final;
+        auto Send(zmq::Message& task) const noexcept -> bool final;
         auto Stop(const Chain chain) const noexcept -> Future final;
 
         auto Shutdown() noexcept -> void;
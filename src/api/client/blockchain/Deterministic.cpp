@@ -8,11 +8,18 @@
 #include "api/client/blockchain/Deterministic.hpp"  // IWYU pragma: associated
 
 #include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <stdexcept>
 #include <utility>
 
 #include "api/client/blockchain/BalanceNode.hpp"
 #include "internal/api/Api.hpp"
+#include "internal/api/client/Client.hpp"
+#include "internal/blockchain/client/Client.hpp"
 #include "opentxs/Pimpl.hpp"
 #include "opentxs/api/Factory.hpp"
 #include "opentxs/api/HDSeed.hpp"
@@ -20,6 +27,10 @@
 #include "opentxs/core/LogSource.hpp"
 #include "opentxs/crypto/key/EllipticCurve.hpp"
 #include "opentxs/crypto/key/HD.hpp"
+#include "opentxs/network/zeromq/Context.hpp"
+#include "opentxs/network/zeromq/Frame.hpp"
+#include "opentxs/network/zeromq/FrameSection.hpp"
+#include "opentxs/network/zeromq/Message.hpp"
 #include "opentxs/protobuf/Enums.pb.h"
 
 #if OT_CRYPTO_WITH_BIP32
@@ -27,6 +38,71 @@
     "opentxs::api::client::blockchain::implementation::Deterministic::"
 #endif  // OT_CRYPTO_WITH_BIP32
 
+namespace opentxs::api::client::blockchain::internal
+{
+namespace
+{
+// Thread pool messages refer to an account by id since a queued task may run
+// after the account has been destroyed
+struct Accounts {
+    std::mutex lock_{};
+    std::condition_variable finished_{};
+    std::size_t next_{0};
+    // The account is null once cancelled. The count is the number of tasks
+    // which are currently running for it.
+    std::map<std::size_t, std::pair<const Deterministic*, std::size_t>> map_{};
+};
+
+auto accounts() noexcept -> Accounts&
+{
+    static auto output = Accounts{};
+
+    return output;
+}
+}  // namespace
+
+#if OT_BLOCKCHAIN
+void Deterministic::ProcessTask(const zmq::Message& in) noexcept
+{
+    const auto body = in.Body();
+
+    if (2 > body.size()) {
+        LogOutput(
+            "opentxs::api::client::blockchain::internal::Deterministic::")(
+            __FUNCTION__)(": Invalid message")
+            .Flush();
+
+        OT_FAIL;
+    }
+
+    const auto id = body.at(0).as<std::size_t>();
+    auto& accounts = internal::accounts();
+    const auto* pAccount = [&]() -> const Deterministic* {
+        Lock lock(accounts.lock_);
+        auto it = accounts.map_.find(id);
+
+        if (accounts.map_.end() == it) { return nullptr; }
+
+        auto& [account, tasks] = it->second;
+
+        if (nullptr == account) { return nullptr; }
+
+        ++tasks;
+
+        return account;
+    }();
+
+    if (nullptr == pAccount) { return; }
+
+    pAccount->GenerateLookahead(body.at(1).as<Subchain>());
+    Lock lock(accounts.lock_);
+    auto& tasks = accounts.map_.at(id).second;
+
+    if (0 == --tasks) { accounts.finished_.notify_all(); }
+}
+#endif  // OT_BLOCKCHAIN
+}  // namespace opentxs::api::client::blockchain::internal
+
 namespace opentxs::api::client::blockchain::implementation
 {
 Deterministic::Deterministic(
@@ -45,7 +121,18 @@ Deterministic::Deterministic(
 #endif  // OT_CRYPTO_WITH_BIP32
     , generated_(generated)
     , used_(used)
+    , lookahead_id_([] {
+        auto& accounts = internal::accounts();
+        Lock lock(accounts.lock_);
+
+        return ++accounts.next_;
+    }())
 {
+    auto& accounts = internal::accounts();
+    Lock lock(accounts.lock_);
+    accounts.map_.emplace(
+        lookahead_id_,
+        std::make_pair(static_cast<const internal::Deterministic*>(this), 0));
 }
 
 std::optional<Bip32Index> Deterministic::bump(
@@ -62,13 +149,61 @@ std::optional<Bip32Index> Deterministic::bump(
     }
 }
 
+void Deterministic::cancel_lookahead() const noexcept
+{
+    auto& accounts = internal::accounts();
+    Lock lock(accounts.lock_);
+    auto it = accounts.map_.find(lookahead_id_);
+
+    if (accounts.map_.end() == it) { return; }
+
+    auto& [account, tasks] = it->second;
+    account = nullptr;
+    accounts.finished_.wait(lock, [&tasks = tasks] { return 0 == tasks; });
+    accounts.map_.erase(it);
+}
+
 #if OT_CRYPTO_WITH_BIP32
 void Deterministic::check_lookahead(
     const Lock& lock,
     const Subchain type,
     const PasswordPrompt& reason) const noexcept(false)
 {
-    while (need_lookahead(lock, type)) { generate_next(lock, type, reason); }
+    generate(lock, type, used_.at(type) + Lookahead, reason);
+}
+
+Deterministic::Keys Deterministic::derive_keys(
+    const Subchain type,
+    const Bip32Index first,
+    const Bip32Index last,
+    const PasswordPrompt& reason) const noexcept(false)
+{
+    if (MaxIndex < last) { throw std::runtime_error("Account is full"); }
+
+    const auto chain =
+        (Subchain::Internal == type) ? INTERNAL_CHAIN : EXTERNAL_CHAIN;
+    const auto count = last - first;
+    auto output =
+        api_.Seeds().AccountChildKeys(path_, chain, first, count, reason);
+
+    if (count != output.size()) {
+        throw std::runtime_error("Failed to generate key");
+    }
+
+    return output;
+}
+
+void Deterministic::generate(
+    const Lock& lock,
+    const Subchain type,
+    const Bip32Index last,
+    const PasswordPrompt& reason) const noexcept(false)
+{
+    const auto first = generated_.at(type);
+
+    if (first >= last) { return; }
+
+    add_keys(lock, type, first, derive_keys(type, first, last, reason));
 }
 
 std::optional<Bip32Index> Deterministic::GenerateNext(
@@ -80,7 +215,8 @@ std::optional<Bip32Index> Deterministic::GenerateNext(
     if (0 == generated_.count(type)) { return {}; }
 
     try {
-        auto output = generate_next(lock, type, reason);
+        const auto output = generated_.at(type);
+        generate(lock, type, output + 1, reason);
 
         if (save(lock)) {
 
@@ -123,6 +259,32 @@ HDKey Deterministic::instantiate_key(
 }
 #endif  // OT_CRYPTO_WITH_BIP32
 
+void Deterministic::GenerateLookahead(const Subchain type) const noexcept
+{
+#if OT_CRYPTO_WITH_BIP32
+    try {
+        Lock lock(lock_);
+        const auto first = generated_.at(type);
+        const auto last = used_.at(type) + Lookahead;
+
+        if (first >= last) { return; }
+
+        // Derivation does not touch any account state, so the lock is released
+        // while it runs. Keys added by a concurrent caller in the meantime are
+        // discarded by add_keys.
+        lock.unlock();
+        const auto reason =
+            api_.Factory().PasswordPrompt("Generating lookahead keys");
+        auto keys = derive_keys(type, first, last, reason);
+        lock.lock();
+
+        if (0 < add_keys(lock, type, first, std::move(keys))) { save(lock); }
+    } catch (const std::exception& e) {
+        LogVerbose(OT_METHOD)(__FUNCTION__)(": ")(e.what()).Flush();
+    }
+#endif  // OT_CRYPTO_WITH_BIP32
+}
+
 std::optional<Bip32Index> Deterministic::LastGenerated(
     const Subchain type) const noexcept
 {
@@ -160,6 +322,29 @@ bool Deterministic::need_lookahead(const Lock& lock, const Subchain type) const
     return Lookahead > (generated_.at(type) - used_.at(type));
 }
 
+void Deterministic::queue_lookahead(
+    const Lock& lock,
+    const Subchain type,
+    const PasswordPrompt& reason) const noexcept
+{
+    if (false == need_lookahead(lock, type)) { return; }
+
+#if OT_BLOCKCHAIN
+    auto work = api_.ZeroMQ().Message(chain_);
+    work->AddFrame(
+        opentxs::blockchain::client::internal::ThreadPool::Work::Lookahead);
+    work->AddFrame();
+    work->AddFrame(lookahead_id_);
+    work->AddFrame(type);
+    parent_.Parent().Parent().ThreadPool().Send(work);
+#else
+    try {
+        check_lookahead(lock, type, reason);
+    } catch (...) {
+    }
+#endif  // OT_BLOCKCHAIN
+}
+
 HDKey Deterministic::RootNode(const PasswordPrompt& reason) const noexcept
 {
     auto fingerprint(path_.root());
@@ -176,6 +361,14 @@ HDKey Deterministic::RootNode(const PasswordPrompt& reason) const noexcept
         opentxs::crypto::key::EllipticCurve::MaxVersion);
 }
 
+void Deterministic::start_lookahead(const PasswordPrompt& reason) const
+    noexcept
+{
+    Lock lock(lock_);
+    queue_lookahead(lock, Subchain::Internal, reason);
+    queue_lookahead(lock, Subchain::External, reason);
+}
+
 std::optional<Bip32Index> Deterministic::UseNext(
     const Subchain type,
     const PasswordPrompt& reason,
@@ -204,8 +397,11 @@ std::optional<Bip32Index> Deterministic::use_next(
         }
 
         auto output = next++;
-        check_lookahead(lock, type, reason);
+        // The caller only waits for key derivation when the lookahead window
+        // has been exhausted. Otherwise it is replenished in the background.
+        generate(lock, type, output + 1, reason);
         set_metadata(lock, type, output, contact, label);
+        queue_lookahead(lock, type, reason);
 
         if (save(lock)) {
 
@@ -220,4 +416,6 @@ std::optional<Bip32Index> Deterministic::use_next(
     }
 }
 #endif  // OT_CRYPTO_WITH_BIP32
+
+Deterministic::~Deterministic() { cancel_lookahead(); }
 }  // namespace opentxs::api::client::blockchain::implementation
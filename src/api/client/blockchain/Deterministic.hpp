@@ -6,7 +6,9 @@
 #pragma once
 
 #include <atomic>
+#include <cstddef>
 #include <map>
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
@@ -42,6 +44,7 @@ public:
         const Subchain type,
         const PasswordPrompt& reason) const noexcept final;
 #endif  // OT_CRYPTO_WITH_BIP32
+    void GenerateLookahead(const Subchain type) const noexcept final;
     std::optional<Bip32Index> LastGenerated(const Subchain type) const
         noexcept final;
     std::optional<Bip32Index> LastUsed(const Subchain type) const
@@ -56,10 +59,11 @@ public:
         const std::string& label) const noexcept final;
 #endif  // OT_CRYPTO_WITH_BIP32
 
-    ~Deterministic() override = default;
+    ~Deterministic() override;
 
 protected:
     using IndexMap = std::map<Subchain, Bip32Index>;
+    using Keys = std::vector<std::unique_ptr<opentxs::crypto::key::HD>>;
 
     static const Bip32Index Lookahead{5};
     static const Bip32Index MaxIndex{2147483648};
@@ -88,12 +92,29 @@ protected:
     {
         return bump(lock, type, used_);
     }
+    /// Discards queued lookahead tasks and waits for running ones to finish.
+    /// Must be called by the destructor of the most derived class.
+    void cancel_lookahead() const noexcept;
 #if OT_CRYPTO_WITH_BIP32
     void check_lookahead(
         const Lock& lock,
         const Subchain type,
         const PasswordPrompt& reason) const noexcept(false);
+    /// Derives keys in one batch until the subchain contains last keys
+    void generate(
+        const Lock& lock,
+        const Subchain type,
+        const Bip32Index last,
+        const PasswordPrompt& reason) const noexcept(false);
     bool need_lookahead(const Lock& lock, const Subchain type) const noexcept;
+    /// Tops up the lookahead for the subchain on the blockchain thread pool
+    void queue_lookahead(
+        const Lock& lock,
+        const Subchain type,
+        const PasswordPrompt& reason) const noexcept;
+    /// Tops up the lookahead for both subchains of a loaded account. Must be
+    /// called after construction is complete.
+    void start_lookahead(const PasswordPrompt& reason) const noexcept;
     std::optional<Bip32Index> use_next(
         const Lock& lock,
         const Subchain type,
@@ -113,15 +134,26 @@ protected:
         IndexMap used) noexcept;
 
 private:
+    // Identifies the account in thread pool messages
+    const std::size_t lookahead_id_;
+
     std::optional<Bip32Index> bump(
         const Lock& lock,
         const Subchain type,
         IndexMap map) const noexcept;
 #if OT_CRYPTO_WITH_BIP32
-    virtual Bip32Index generate_next(
+    /// Returns the number of keys which were not already present
+    virtual Bip32Index add_keys(
         const Lock& lock,
         const Subchain type,
-        const PasswordPrompt& reason) const noexcept(false) = 0;
+        const Bip32Index first,
+        Keys&& keys) const noexcept(false) = 0;
+    /// Does not require the account lock
+    Keys derive_keys(
+        const Subchain type,
+        const Bip32Index first,
+        const Bip32Index last,
+        const PasswordPrompt& reason) const noexcept(false);
 #endif  // OT_CRYPTO_WITH_BIP32
     virtual void set_metadata(
         const Lock& lock,
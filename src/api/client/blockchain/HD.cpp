@@ -61,7 +61,13 @@ api::client::blockchain::internal::HD* Factory::BlockchainHDBalanceNode(
         parent.API().Factory().PasswordPrompt("Loading a blockchain account");
 
     try {
-        return new ReturnType{parent, serialized, reason, id};
+        auto output =
+            std::unique_ptr<ReturnType>{new ReturnType{parent, serialized, id}};
+#if OT_CRYPTO_WITH_BIP32
+        output->start_lookahead(reason);
+#endif  // OT_CRYPTO_WITH_BIP32
+
+        return output.release();
     } catch (const std::exception& e) {
         LogOutput("opentxs::Factory::")(__FUNCTION__)(": ")(e.what()).Flush();
 
@@ -90,6 +96,8 @@ HD::HD(
     , revision_(0)
     , internal_addresses_()
     , external_addresses_()
+    , internal_snapshot_(std::make_shared<Snapshot>())
+    , external_snapshot_(std::make_shared<Snapshot>())
 {
     id.Assign(id_);
     Lock lock(lock_);
@@ -115,7 +123,6 @@ HD::HD(
 HD::HD(
     const internal::BalanceTree& parent,
     const SerializedType& serialized,
-    const PasswordPrompt& reason,
     Identifier& id) noexcept(false)
     : Deterministic(
           parent,
@@ -134,29 +141,78 @@ HD::HD(
           extract_internal(*this, parent.Parent().Parent(), chain_, serialized))
     , external_addresses_(
           extract_external(*this, parent.Parent().Parent(), chain_, serialized))
+    , internal_snapshot_()
+    , external_snapshot_()
 {
     id.Assign(id_);
 
     if (Translate(serialized.type()) != chain_) {
         throw std::runtime_error("Wrong account type");
     }
+
+    Lock lock(lock_);
+    publish(lock, Subchain::Internal);
+    publish(lock, Subchain::External);
 }
 
-const HD::Element& HD::BalanceElement(
+#if OT_CRYPTO_WITH_BIP32
+Bip32Index HD::add_keys(
+    const Lock& lock,
     const Subchain type,
-    const Bip32Index index) const noexcept(false)
+    const Bip32Index first,
+    Keys&& keys) const noexcept(false)
 {
-    switch (type) {
-        case Subchain::Internal: {
-            return internal_addresses_.at(index);
-        }
-        case Subchain::External: {
-            return external_addresses_.at(index);
-        }
-        default: {
-            throw std::out_of_range("Invalid subchain");
+    auto& generated = generated_.at(type);
+    auto& addressMap = (Subchain::Internal == type) ? internal_addresses_
+                                                    : external_addresses_;
+    auto output = Bip32Index{0};
+    auto next{first};
+
+    for (auto& pKey : keys) {
+        const auto index = next++;
+
+        if (index < generated) { continue; }
+
+        OT_ASSERT(index == generated);
+
+        const auto [it, added] = addressMap.emplace(
+            std::piecewise_construct,
+            std::forward_as_tuple(generated),
+            std::forward_as_tuple(
+                *this,
+                parent_.Parent().Parent(),
+                chain_,
+                type,
+                generated,
+                std::move(pKey)));
+
+        if (false == added) { throw std::runtime_error("Failed to add key"); }
+
+        const auto elements = it->second.Elements();
+
+        for (const auto& element : elements) {
+            claim_element(lock, element, {id_->str(), type, generated});
         }
+
+        ++generated;
+        ++output;
     }
+
+    if (0 < output) { publish(lock, type); }
+
+    return output;
+}
+#endif  // OT_CRYPTO_WITH_BIP32
+
+const HD::Element& HD::BalanceElement(
+    const Subchain type,
+    const Bip32Index index) const noexcept(false)
+{
+    const auto* element = snapshot(type)->at(index);
+
+    if (nullptr == element) { throw std::out_of_range("Invalid index"); }
+
+    return *element;
 }
 
 bool HD::check_activity(
@@ -197,6 +253,10 @@ bool HD::check_activity(
         const auto empty = std::string{};
 
 #if OT_CRYPTO_WITH_BIP32
+        // Derive every missing key in one batch rather than one per address
+        generate(lock, Subchain::External, targetExternal + 1, reason);
+        generate(lock, Subchain::Internal, targetInternal + 1, reason);
+
         for (auto i{currentExternal}; i < targetExternal; ++i) {
             use_next(lock, Subchain::External, reason, blank, empty);
         }
@@ -276,67 +336,11 @@ std::vector<Activity> HD::extract_outgoing(const SerializedType& in)
     return output;
 }
 
-#if OT_CRYPTO_WITH_BIP32
-Bip32Index HD::generate_next(
-    const Lock& lock,
-    const Subchain type,
-    const PasswordPrompt& reason) const noexcept(false)
-{
-    auto& index = generated_.at(type);
-
-    if (MaxIndex <= index) { throw std::runtime_error("Account is full"); }
-
-    auto pKey = api_.Seeds().AccountChildKey(
-        path_,
-        (Subchain::Internal == type) ? INTERNAL_CHAIN : EXTERNAL_CHAIN,
-        index,
-        reason);
-
-    if (false == bool(pKey)) {
-        throw std::runtime_error("Failed to generate key");
-    }
-
-    auto& addressMap = (Subchain::Internal == type) ? internal_addresses_
-                                                    : external_addresses_;
-    const auto [it, added] = addressMap.emplace(
-        std::piecewise_construct,
-        std::forward_as_tuple(index),
-        std::forward_as_tuple(
-            *this,
-            parent_.Parent().Parent(),
-            chain_,
-            type,
-            index,
-            std::move(pKey)));
-
-    if (false == added) { throw std::runtime_error("Failed to add key"); }
-
-    const auto elements = it->second.Elements();
-
-    for (const auto& element : elements) {
-        claim_element(lock, element, {id_->str(), type, index});
-    }
-
-    return index++;
-}
-#endif  // OT_CRYPTO_WITH_BIP32
-
 ECKey HD::Key(const Subchain type, const Bip32Index index) const noexcept
 {
     try {
-        switch (type) {
-            case Subchain::Internal: {
 
-                return internal_addresses_.at(index).Key();
-            }
-            case Subchain::External: {
-
-                return external_addresses_.at(index).Key();
-            }
-            default: {
-                return nullptr;
-            }
-        }
+        return BalanceElement(type, index).Key();
     } catch (...) {
 
         return nullptr;
@@ -361,6 +365,25 @@ internal::BalanceElement& HD::mutable_element(
     }
 }
 
+void HD::publish(const Lock& lock, const Subchain type) const noexcept
+{
+    const auto& addressMap = (Subchain::Internal == type) ? internal_addresses_
+                                                          : external_addresses_;
+    auto& target = (Subchain::Internal == type) ? internal_snapshot_
+                                                : external_snapshot_;
+    auto output = std::make_shared<Snapshot>();
+
+    if (false == addressMap.empty()) {
+        output->assign(addressMap.crbegin()->first + 1, nullptr);
+    }
+
+    for (const auto& [index, element] : addressMap) {
+        output->at(index) = &element;
+    }
+
+    std::atomic_store(&target, pSnapshot{std::move(output)});
+}
+
 bool HD::save(const Lock& lock) const noexcept
 {
     const auto type = Translate(chain_);
@@ -428,4 +451,23 @@ void HD::set_metadata(
     } catch (...) {
     }
 }
+
+HD::pSnapshot HD::snapshot(const Subchain type) const noexcept(false)
+{
+    switch (type) {
+        case Subchain::Internal: {
+
+            return std::atomic_load(&internal_snapshot_);
+        }
+        case Subchain::External: {
+
+            return std::atomic_load(&external_snapshot_);
+        }
+        default: {
+            throw std::out_of_range("Invalid subchain");
+        }
+    }
+}
+
+HD::~HD() { cancel_lookahead(); }
 }  // namespace opentxs::api::client::blockchain::implementation
@@ -11,6 +11,7 @@
 #include <atomic>
 #include <cstdint>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
@@ -56,7 +57,7 @@ public:
         const noexcept(false) final;
     ECKey Key(const Subchain type, const Bip32Index index) const noexcept final;
 
-    ~HD() final = default;
+    ~HD() final;
 
 private:
     friend opentxs::Factory;
@@ -64,6 +65,10 @@ private:
     using AddressMap = std::map<Bip32Index, Element>;
     using Revision = std::uint64_t;
     using SerializedType = proto::HDAccount;
+    // Immutable view of an AddressMap which is replaced as a whole whenever
+    // keys are added, so readers never need the account lock
+    using Snapshot = std::vector<const Element*>;
+    using pSnapshot = std::shared_ptr<const Snapshot>;
 
     static const VersionNumber DefaultVersion{1};
 
@@ -71,6 +76,8 @@ private:
     mutable std::atomic<Revision> revision_;
     mutable AddressMap internal_addresses_;
     mutable AddressMap external_addresses_;
+    mutable pSnapshot internal_snapshot_;
+    mutable pSnapshot external_snapshot_;
 
     static AddressMap extract_external(
         const internal::BalanceNode& parent,
@@ -85,21 +92,23 @@ private:
         const SerializedType& in) noexcept(false);
     static std::vector<Activity> extract_outgoing(const SerializedType& in);
 
+#if OT_CRYPTO_WITH_BIP32
+    Bip32Index add_keys(
+        const Lock& lock,
+        const Subchain type,
+        const Bip32Index first,
+        Keys&& keys) const noexcept(false) final;
+#endif  // OT_CRYPTO_WITH_BIP32
     bool check_activity(
         const Lock& lock,
         const std::vector<Activity>& unspent,
         std::set<OTIdentifier>& contacts,
         const PasswordPrompt& reason) const noexcept final;
-#if OT_CRYPTO_WITH_BIP32
-    Bip32Index generate_next(
-        const Lock& lock,
-        const Subchain type,
-        const PasswordPrompt& reason) const noexcept(false) final;
-#endif  // OT_CRYPTO_WITH_BIP32
     internal::BalanceElement& mutable_element(
         const Lock& lock,
         const Subchain type,
         const Bip32Index index) noexcept(false) final;
+    void publish(const Lock& lock, const Subchain type) const noexcept;
     bool save(const Lock& lock) const noexcept final;
     void set_metadata(
         const Lock& lock,
@@ -107,6 +116,7 @@ private:
         const Bip32Index index,
         const Identifier& contact,
         const std::string& label) const noexcept final;
+    pSnapshot snapshot(const Subchain type) const noexcept(false);
 
     HD(const internal::BalanceTree& parent,
        const proto::HDPath& path,
@@ -115,7 +125,6 @@ private:
     noexcept(false);
     HD(const internal::BalanceTree& parent,
        const SerializedType& serialized,
-       const PasswordPrompt& reason,
        Identifier& id)
     noexcept(false);
     HD(const HD&) = delete;
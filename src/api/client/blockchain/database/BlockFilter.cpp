@@ -11,6 +11,7 @@
 #include <stdexcept>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "Factory.hpp"
 #include "internal/api/Api.hpp"  // IWYU pragma: keep
@@ -21,11 +22,15 @@
 #include "opentxs/core/Log.hpp"
 #include "util/LMDB.hpp"
 
-// #define OT_METHOD
-// "opentxs::api::client::blockchain::database::implementation::BlockFilter::"
+#define OT_METHOD                                                              \
+    "opentxs::api::client::blockchain::database::implementation::BlockFilter::"
 
 namespace opentxs::api::client::blockchain::database::implementation
 {
+using SerializedFilter = opentxs::blockchain::internal::SerializedFilter;
+
+const std::size_t BlockFilter::upgrade_batch_{1000};
+
 BlockFilter::BlockFilter(
     const api::internal::Core& api,
     opentxs::storage::lmdb::LMDB& lmdb) noexcept(false)
@@ -61,11 +66,7 @@ auto BlockFilter::LoadFilter(const FilterType type, const ReadView blockHash)
     const noexcept -> std::unique_ptr<const opentxs::blockchain::internal::GCS>
 {
     auto output = std::unique_ptr<const opentxs::blockchain::internal::GCS>{};
-    auto cb = [this, &output](const auto in) {
-        if ((nullptr == in.data()) || (0 == in.size())) { return; }
-
-        output = opentxs::Factory::GCS(api_, proto::Factory<proto::GCS>(in));
-    };
+    auto cb = [this, &output](const auto in) { output = parse(in, false); };
 
     try {
         lmdb_.Load(translate_filter(type), blockHash, cb);
@@ -131,6 +132,46 @@ auto BlockFilter::LoadFilterHeader(
     return output;
 }
 
+auto BlockFilter::parse(const ReadView record, const bool borrow) const
+    noexcept -> std::unique_ptr<const opentxs::blockchain::internal::GCS>
+{
+    if ((nullptr == record.data()) || (0 == record.size())) { return {}; }
+
+    if (SerializedFilter::Valid(record)) {
+
+        return opentxs::Factory::GCS(api_, record, borrow);
+    } else {
+
+        return opentxs::Factory::GCS(
+            api_, proto::Factory<proto::GCS>(record));
+    }
+}
+
+auto BlockFilter::ReadFilter(
+    const FilterType type,
+    const ReadView blockHash,
+    const FilterCallback& cb) const noexcept -> bool
+{
+    if (false == bool(cb)) { return false; }
+
+    auto output{false};
+    auto read = [this, &output, &cb](const auto in) {
+        const auto pFilter = parse(in, true);
+
+        if (false == bool(pFilter)) { return; }
+
+        output = true;
+        cb(*pFilter);
+    };
+
+    try {
+        lmdb_.Load(translate_filter(type), blockHash, read);
+    } catch (...) {
+    }
+
+    return output;
+}
+
 auto BlockFilter::StoreFilterHeaders(
     const FilterType type,
     const std::vector<FilterHeader>& headers) const noexcept -> bool
@@ -173,10 +214,9 @@ auto BlockFilter::StoreFilters(
         OT_ASSERT(pFilter);
 
         const auto& filter = *pFilter;
-        const auto proto = filter.Serialize();
-        auto bytes = space(proto.ByteSize());
-        proto.SerializeWithCachedSizesToArray(
-            reinterpret_cast<std::uint8_t*>(bytes.data()));
+        auto bytes = Space{};
+
+        if (false == filter.Serialize(writer(bytes))) { return false; }
 
         try {
             const auto stored = lmdb_.Store(
@@ -192,6 +232,78 @@ auto BlockFilter::StoreFilters(
     return parentTxn.Finalize(true);
 }
 
+auto BlockFilter::upgrade(const Table table) const noexcept -> bool
+{
+    auto legacy = std::vector<Space>{};
+    auto find = [&legacy](const auto key, const auto value) {
+        if (false == SerializedFilter::Valid(value)) {
+            legacy.emplace_back(space(key));
+        }
+
+        return true;
+    };
+    lmdb_.Read(table, find, opentxs::storage::lmdb::LMDB::Dir::Forward);
+
+    if (legacy.empty()) { return true; }
+
+    LogNormal(OT_METHOD)(__FUNCTION__)(": Converting ")(legacy.size())(
+        " filters to the current storage format")
+        .Flush();
+    auto it = legacy.cbegin();
+
+    while (legacy.cend() != it) {
+        // Records are converted before the write transaction is opened since
+        // a thread may only hold one transaction at a time
+        auto batch = std::vector<std::pair<ReadView, Space>>{};
+
+        for (; (legacy.cend() != it) && (batch.size() < upgrade_batch_); ++it) {
+            const auto key = reader(*it);
+            auto& record = batch.emplace_back(key, Space{}).second;
+            auto cb = [&](const auto in) {
+                const auto pFilter = parse(in, false);
+
+                if (pFilter) { pFilter->Serialize(writer(record)); }
+            };
+            lmdb_.Load(table, key, cb);
+
+            if (record.empty()) {
+                LogOutput(OT_METHOD)(__FUNCTION__)(
+                    ": Failed to convert filter")
+                    .Flush();
+
+                return false;
+            }
+        }
+
+        auto parentTxn = lmdb_.TransactionRW();
+
+        for (const auto& [key, record] : batch) {
+            const auto stored =
+                lmdb_.Store(table, key, reader(record), parentTxn);
+
+            if (false == stored.first) { return false; }
+        }
+
+        if (false == parentTxn.Finalize(true)) { return false; }
+    }
+
+    return true;
+}
+
+auto BlockFilter::Upgrade() const noexcept -> bool
+{
+    try {
+        for (const auto table : {FiltersBasic, FiltersBCH, FiltersOpentxs}) {
+            if (false == upgrade(table)) { return false; }
+        }
+    } catch (...) {
+
+        return false;
+    }
+
+    return true;
+}
+
 auto BlockFilter::translate_filter(const FilterType type) noexcept(false)
     -> Table
 {
@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <vector>
@@ -60,12 +61,19 @@ public:
         const FilterType type,
         const ReadView blockHash,
         const AllocateOutput header) const noexcept -> bool;
+    auto ReadFilter(
+        const FilterType type,
+        const ReadView blockHash,
+        const FilterCallback& cb) const noexcept -> bool;
     auto StoreFilterHeaders(
         const FilterType type,
         const std::vector<FilterHeader>& headers) const noexcept -> bool;
     auto StoreFilters(const FilterType type, std::vector<FilterData>& filters)
         const noexcept -> bool;
 
+    /// Converts records written in the legacy protobuf format
+    auto Upgrade() const noexcept -> bool;
+
     BlockFilter(
         const api::internal::Core& api,
         opentxs::storage::lmdb::LMDB& lmdb) noexcept(false);
@@ -75,6 +83,7 @@ private:
     static const std::uint32_t blockchain_filter_headers_version_{1};
     static const std::uint32_t blockchain_filter_version_{1};
     static const std::uint32_t blockchain_filters_version_{1};
+    static const std::size_t upgrade_batch_;
 
     const api::internal::Core& api_;
     opentxs::storage::lmdb::LMDB& lmdb_;
@@ -83,5 +92,9 @@ private:
         -> Table;
     static auto translate_header(const FilterType type) noexcept(false)
         -> Table;
+
+    auto parse(const ReadView record, const bool borrow) const noexcept
+        -> std::unique_ptr<const opentxs::blockchain::internal::GCS>;
+    auto upgrade(const Table table) const noexcept -> bool;
 };
 }  // namespace opentxs::api::client::blockchain::database::implementation
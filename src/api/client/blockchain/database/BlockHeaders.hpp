@@ -46,8 +46,9 @@ public:
         noexcept -> bool;
     auto LoadBlockHeader(const opentxs::blockchain::block::Hash& hash) const
         noexcept(false) -> proto::BlockchainBlockHeader;
-    auto StoreBlockHeader(const opentxs::blockchain::block::Header& header)
-        const noexcept -> bool;
+    OPENTXS_EXPORT auto StoreBlockHeader(
+        const opentxs::blockchain::block::Header& header) const noexcept
+        -> bool;
     auto StoreBlockHeaders(const UpdatedHeader& headers) const noexcept -> bool;
 
     BlockHeader(
@@ -10,6 +10,7 @@
 #include <algorithm>
 #include <cstring>
 #include <stdexcept>
+#include <string>
 
 #include "api/client/blockchain/database/Blocks.hpp"
 #include "internal/api/Api.hpp"
@@ -27,6 +28,17 @@ ReadView tsv(const Input& in) noexcept
     return {reinterpret_cast<const char*>(&in), sizeof(in)};
 }
 
+// Megabytes
+const std::size_t Database::block_cache_size_default_{256};
+// Megabytes
+const std::size_t Database::filter_cache_size_default_{64};
+// Version 1 stored filters as serialized proto::GCS
+const std::size_t Database::filter_storage_version_{2};
+// Megabytes
+const std::size_t Database::mempool_size_default_{32};
+// Zero uses every available core
+const std::size_t Database::scan_threads_default_{0};
+
 const opentxs::storage::lmdb::TableNames Database::table_names_{
     {BlockHeaders, "block_headers"},
     {PeerDetails, "peers"},
@@ -78,6 +90,21 @@ Database::Database(
               {BlockIndex, 0},
           })
     , block_policy_(block_storage_level(args, lmdb_))
+    , block_cache_size_(megabytes(size_arg(
+          args,
+          OPENTXS_ARG_BLOCK_CACHE_SIZE,
+          block_cache_size_default_)))
+    , bootstrap_export_(directory(args, OPENTXS_ARG_BOOTSTRAP_EXPORT))
+    , bootstrap_import_(directory(args, OPENTXS_ARG_BOOTSTRAP_IMPORT))
+    , filter_cache_size_(megabytes(size_arg(
+          args,
+          OPENTXS_ARG_FILTER_CACHE_SIZE,
+          filter_cache_size_default_)))
+    , filter_source_(filter_source(args))
+    , mempool_size_(megabytes(
+          size_arg(args, OPENTXS_ARG_MEMPOOL_SIZE, mempool_size_default_)))
+    , scan_threads_(
+          size_arg(args, OPENTXS_ARG_SCAN_THREADS, scan_threads_default_))
     , headers_(api, lmdb_)
     , peers_(api, lmdb_)
     , filters_(api, lmdb_)
@@ -85,6 +112,7 @@ Database::Database(
     , blocks_(lmdb_, blocks_path_->Get())
 #endif  // OPENTXS_BLOCK_STORAGE_ENABLED
 {
+    upgrade_filters();
 }
 
 auto Database::AllocateStorageFolder(const std::string& dir) const noexcept
@@ -206,6 +234,57 @@ auto Database::BlockStore(const BlockHash& block, const std::size_t bytes) const
 #endif
 }
 
+// Empty if the argument is absent
+auto Database::directory(const ArgList& args, const std::string& name) noexcept
+    -> std::string
+{
+    try {
+        const auto& arg = args.at(name);
+
+        if (0 < arg.size()) { return *arg.cbegin(); }
+    } catch (...) {
+    }
+
+    return {};
+}
+
+auto Database::filter_source(const ArgList& args) noexcept -> FilterSource
+{
+    try {
+        const auto& arg = args.at(OPENTXS_ARG_FILTER_SOURCE);
+
+        if (0 == arg.size()) { return FilterSource::Peers; }
+
+        switch (std::stoi(*arg.cbegin())) {
+            case 2: {
+                return FilterSource::Local;
+            }
+            case 1: {
+                return FilterSource::Verify;
+            }
+            default: {
+                return FilterSource::Peers;
+            }
+        }
+    } catch (...) {
+        return FilterSource::Peers;
+    }
+}
+
+auto Database::filter_storage_version_configured(
+    opentxs::storage::lmdb::LMDB& db) noexcept -> std::size_t
+{
+    auto output = std::size_t{1};
+    auto cb = [&output](const auto in) {
+        if (sizeof(output) != in.size()) { return; }
+
+        std::memcpy(&output, in.data(), in.size());
+    };
+    db.Load(Config, tsv(Key::FilterStorageVersion), cb);
+
+    return output;
+}
+
 auto Database::init_folder(
     const api::Legacy& legacy,
     const String& parent,
@@ -231,4 +310,39 @@ auto Database::init_storage_path(
     return init_folder(
         legacy, String::Factory(dataFolder), String::Factory("blockchain"));
 }
+
+auto Database::megabytes(const std::size_t value) noexcept -> std::size_t
+{
+    return value * 1024u * 1024u;
+}
+
+// The default is used if the argument is absent or not a number
+auto Database::size_arg(
+    const ArgList& args,
+    const std::string& name,
+    const std::size_t value) noexcept -> std::size_t
+{
+    try {
+        const auto& arg = args.at(name);
+
+        if (0 < arg.size()) { return std::stoul(*arg.cbegin()); }
+    } catch (...) {
+    }
+
+    return value;
+}
+
+auto Database::upgrade_filters() noexcept -> void
+{
+    if (filter_storage_version_ <= filter_storage_version_configured(lmdb_)) {
+        return;
+    }
+
+    if (filters_.Upgrade()) {
+        lmdb_.Store(
+            Config,
+            tsv(Key::FilterStorageVersion),
+            tsv(filter_storage_version_));
+    }
+}
 }  // namespace opentxs::api::client::blockchain::database::implementation
@@ -66,6 +66,7 @@ public:
     enum class Key : std::size_t {
         BlockStoragePolicy = 0,
         NextBlockAddress = 1,
+        FilterStorageVersion = 2,
     };
 
     using BlockHash = opentxs::blockchain::block::Hash;
@@ -74,17 +75,37 @@ public:
     {
         return peers_.Insert(std::move(address));
     }
-    auto AllocateStorageFolder(const std::string& dir) const noexcept
-        -> std::string;
+    OPENTXS_EXPORT auto AllocateStorageFolder(const std::string& dir) const
+        noexcept -> std::string;
     auto BlockHeaderExists(const BlockHash& hash) const noexcept -> bool
     {
         return headers_.BlockHeaderExists(hash);
     }
+    auto BlockCacheSize() const noexcept -> std::size_t
+    {
+        return block_cache_size_;
+    }
     auto BlockExists(const BlockHash& block) const noexcept -> bool;
     auto BlockLoad(const BlockHash& block) const noexcept -> BlockReader;
     auto BlockPolicy() const noexcept -> BlockStorage { return block_policy_; }
     auto BlockStore(const BlockHash& block, const std::size_t bytes) const
         noexcept -> BlockWriter;
+    auto BootstrapExport() const noexcept -> const std::string&
+    {
+        return bootstrap_export_;
+    }
+    auto BootstrapImport() const noexcept -> const std::string&
+    {
+        return bootstrap_import_;
+    }
+    auto FilterCacheSize() const noexcept -> std::size_t
+    {
+        return filter_cache_size_;
+    }
+    auto FilterPolicy() const noexcept -> FilterSource
+    {
+        return filter_source_;
+    }
     auto Find(
         const Chain chain,
         const Protocol protocol,
@@ -131,6 +152,18 @@ public:
     {
         return filters_.LoadFilterHeader(type, blockHash, header);
     }
+    auto MempoolSize() const noexcept -> std::size_t
+    {
+        return mempool_size_;
+    }
+    auto ReadFilter(
+        const FilterType type,
+        const ReadView blockHash,
+        const FilterCallback& cb) const noexcept -> bool
+    {
+        return filters_.ReadFilter(type, blockHash, cb);
+    }
+    auto ScanThreads() const noexcept -> std::size_t { return scan_threads_; }
     auto StoreBlockHeader(
         const opentxs::blockchain::block::Header& header) const noexcept -> bool
     {
@@ -159,6 +192,11 @@ public:
         const ArgList& args) noexcept(false);
 
 private:
+    static const std::size_t block_cache_size_default_;
+    static const std::size_t filter_cache_size_default_;
+    static const std::size_t filter_storage_version_;
+    static const std::size_t mempool_size_default_;
+    static const std::size_t scan_threads_default_;
     static const opentxs::storage::lmdb::TableNames table_names_;
 
     const api::internal::Core& api_;
@@ -169,6 +207,13 @@ private:
 #endif  // OPENTXS_BLOCK_STORAGE_ENABLED
     opentxs::storage::lmdb::LMDB lmdb_;
     const BlockStorage block_policy_;
+    const std::size_t block_cache_size_;
+    const std::string bootstrap_export_;
+    const std::string bootstrap_import_;
+    const std::size_t filter_cache_size_;
+    const FilterSource filter_source_;
+    const std::size_t mempool_size_;
+    const std::size_t scan_threads_;
     mutable BlockHeader headers_;
     mutable Peers peers_;
     mutable BlockFilter filters_;
@@ -186,6 +231,11 @@ private:
         opentxs::storage::lmdb::LMDB& db) noexcept
         -> std::optional<BlockStorage>;
     static auto block_storage_level_default() noexcept -> BlockStorage;
+    static auto directory(const ArgList& args, const std::string& name) noexcept
+        -> std::string;
+    static auto filter_source(const ArgList& args) noexcept -> FilterSource;
+    static auto filter_storage_version_configured(
+        opentxs::storage::lmdb::LMDB& db) noexcept -> std::size_t;
     static auto init_folder(
         const api::Legacy& legacy,
         const String& parent,
@@ -193,6 +243,13 @@ private:
     static auto init_storage_path(
         const api::Legacy& legacy,
         const std::string& dataFolder) noexcept(false) -> OTString;
+    static auto megabytes(const std::size_t value) noexcept -> std::size_t;
+    static auto size_arg(
+        const ArgList& args,
+        const std::string& name,
+        const std::size_t value) noexcept -> std::size_t;
+
+    auto upgrade_filters() noexcept -> void;
 
     Database() = delete;
     Database(const Database&) = delete;
@@ -20,6 +20,7 @@
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
 #endif
 
+#define OT_DEFAULT_BIP32_CACHE_SIZE 256        // in extended nodes
 #define OT_DEFAULT_ITERATION_COUNT 65535       // in bytes
 #define OT_DEFAULT_SYMMETRIC_SALT_SIZE 8       // in bytes
 #define OT_DEFAULT_SYMMETRIC_KEY_SIZE 32       // in bytes
@@ -29,6 +30,7 @@
 #define OT_DEFAULT_PUBLIC_KEYSIZE 128          // in bytes == 4096 bits
 #define OT_DEFAULT_PUBLIC_KEYSIZE_MAX 512      // in bytes == 1024 bits
 
+#define OT_KEY_BIP32_CACHE_SIZE "bip32_cache_size"
 #define OT_KEY_ITERATION_COUNT "iteration_count"
 #define OT_KEY_SYMMETRIC_SALT_SIZE "symmetric_salt_size"
 #define OT_KEY_SYMMETRIC_KEY_SIZE "symmetric_key_size"
@@ -56,6 +58,11 @@ Config::Config(const api::Settings& settings)
 
 bool Config::GetSetAll() const
 {
+    if (!GetSetValue(
+            OT_KEY_BIP32_CACHE_SIZE,
+            OT_DEFAULT_BIP32_CACHE_SIZE,
+            sp_nBip32CacheSize))
+        return false;
     if (!GetSetValue(
             OT_KEY_ITERATION_COUNT,
             OT_DEFAULT_ITERATION_COUNT,
@@ -122,6 +129,7 @@ bool Config::GetSetValue(
     return true;
 }
 
+std::uint32_t Config::Bip32CacheSize() const { return sp_nBip32CacheSize; }
 std::uint32_t Config::IterationCount() const { return sp_nIterationCount; }
 std::uint32_t Config::SymmetricSaltSize() const
 {
@@ -28,6 +28,7 @@ namespace opentxs::api::crypto::implementation
 class Config final : public api::crypto::Config
 {
 public:
+    std::uint32_t Bip32CacheSize() const override;
     std::uint32_t IterationCount() const override;
     std::uint32_t SymmetricSaltSize() const override;
     std::uint32_t SymmetricKeySize() const override;
@@ -41,6 +42,7 @@ private:
     friend opentxs::Factory;
 
     const api::Settings& config_;
+    mutable std::int32_t sp_nBip32CacheSize{0};
     mutable std::int32_t sp_nIterationCount{0};
     mutable std::int32_t sp_nSymmetricSaltSize{0};
     mutable std::int32_t sp_nSymmetricKeySize{0};
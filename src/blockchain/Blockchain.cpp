@@ -15,6 +15,7 @@
 #include <memory>
 #include <set>
 #include <stdexcept>
+#include <string>
 #include <thread>
 #include <utility>
 
@@ -60,6 +61,20 @@ auto FilterHash(
     }
 }
 
+auto MerkleHash(
+    const api::Core& api,
+    const Type chain,
+    const ReadView input,
+    const AllocateOutput output) noexcept -> bool
+{
+    switch (chain) {
+        default: {
+            return api.Crypto().Hash().Digest(
+                proto::HASHTYPE_SHA256D, input, output);
+        }
+    }
+}
+
 auto P2PMessageHash(
     const api::Core& api,
     const Type chain,
@@ -131,9 +146,31 @@ auto TransactionHash(
 
 namespace opentxs::blockchain::internal
 {
+constexpr auto word_bits_ = std::size_t{64};
+
+inline auto leading_ones(const std::uint64_t value) noexcept -> std::size_t
+{
+    const auto inverted = ~value;
+
+    if (0 == inverted) { return word_bits_; }
+
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<std::size_t>(__builtin_clzll(inverted));
+#else
+    auto output = std::size_t{0};
+
+    for (auto mask = std::uint64_t{1} << 63; 0 == (inverted & mask);
+         mask >>= 1) {
+        ++output;
+    }
+
+    return output;
+#endif
+}
+
 BitReader::BitReader(const Space& bytes)
     : raw_data_(Data::Factory(bytes))
-    , data_(reinterpret_cast<std::uint8_t*>(raw_data_->data()))
+    , data_(static_cast<const std::uint8_t*>(raw_data_->data()))
     , len_(raw_data_->size())
     , accum_(0)
     , n_(0)
@@ -142,94 +179,102 @@ BitReader::BitReader(const Space& bytes)
 
 BitReader::BitReader(std::uint8_t* data, int len)
     : raw_data_(Data::Factory(data, len))
-    , data_(reinterpret_cast<std::uint8_t*>(raw_data_->data()))
+    , data_(static_cast<const std::uint8_t*>(raw_data_->data()))
     , len_(raw_data_->size())
     , accum_(0)
     , n_(0)
 {
 }
 
+BitReader::BitReader(const ReadView data)
+    : raw_data_(Data::Factory())
+    , data_(reinterpret_cast<const std::uint8_t*>(data.data()))
+    , len_(data.size())
+    , accum_(0)
+    , n_(0)
+{
+}
+
 bool BitReader::eof() { return (len_ == 0 && n_ == 0); }
 
 std::uint64_t BitReader::read(std::size_t nbits)
 {
-    // nbits is the number of bits the programmer is trying to read from our
-    // internal data and, interpreted as big endian, return to the caller in
-    // native format. Let's say he's trying to read 19 bits.
-    OT_ASSERT(nbits < 32);
+    // A refill always leaves at least 57 bits in accum_ unless the input is
+    // exhausted
+    OT_ASSERT(nbits <= 57);
 
-    std::uint64_t ret{0};
+    if (0 == nbits) { return 0; }
 
-    // The first loop iteration, nbits is therefore 19.
-    while (nbits) {
+    if (nbits > n_) { refill(); }
 
-        // n_ starts out as zero. Therefore this if() will resolve to true.
-        // This is because accum_ contains no data, since all the input data
-        // is in the OTData member raw_data_.
-        if (!n_) {
-            // Let's say the raw data contains 500 bytes. so len_ is 500,
-            // and definitely larger than 4 bytes.
-            if (len_ > 4) {
-                // We grab the next 4 bytes from the raw data into a
-                // uint32_t. The first byte is left-shifted 24 bits. The
-                // second 16 bits, the third 8 bits, and the fourth 0 bits,
-                // which are all OR'd together.
-                accum_ = (static_cast<std::uint32_t>(data_[0]) << 24) |
-                         (static_cast<std::uint32_t>(data_[1]) << 16) |
-                         (static_cast<std::uint32_t>(data_[2]) << 8) |
-                         (static_cast<std::uint32_t>(data_[3]));
-                // The data iterator is incremented by 4 bytes.
-                data_ += 4;
-                // The length we're trying to read is decremented by 4
-                // bytes.
-                len_ -= 4;
-                // The number of bits in accum_ are incremented by 32.
-                n_ += 32;
-            }
-            // If the raw data didn't even contain 4 bytes, then does it at
-            // least contain more than 0?
-            else if (len_ > 0) {
-                // Dereference data, grab one byte to accum_, and increment
-                // the data pointer.
-                accum_ = *data_++;
-                // We read one byte, so decrement len_ which is the number
-                // of bytes needing to be read from raw_data_.
-                --len_;
-                // n_ records that we now have 8 more bits of data in
-                // accum_.
-                n_ += 8;
-            } else {
-                return 0;
-            }
-        }
+    if (nbits > n_) {
+        // Not enough input remains to satisfy the request
+        accum_ = 0;
+        n_ = 0;
+
+        return 0;
+    }
+
+    const auto output = accum_ >> (word_bits_ - nbits);
+    accum_ <<= nbits;
+    n_ -= nbits;
+
+    return output;
+}
+
+void BitReader::refill() noexcept
+{
+    if ((0 == n_) && (8 <= len_)) {
+        accum_ = (static_cast<std::uint64_t>(data_[0]) << 56) |
+                 (static_cast<std::uint64_t>(data_[1]) << 48) |
+                 (static_cast<std::uint64_t>(data_[2]) << 40) |
+                 (static_cast<std::uint64_t>(data_[3]) << 32) |
+                 (static_cast<std::uint64_t>(data_[4]) << 24) |
+                 (static_cast<std::uint64_t>(data_[5]) << 16) |
+                 (static_cast<std::uint64_t>(data_[6]) << 8) |
+                 (static_cast<std::uint64_t>(data_[7]));
+        data_ += 8;
+        len_ -= 8;
+        n_ = 64;
+
+        return;
+    }
 
-        // n_ is the number of bits in accum_, and nbits is the number of
-        // bits the programmer is trying to read. We choose the smaller. So
-        // if there are 10 bits in accum_, and he's trying to read 19,
-        // 'toread' gets set to 10.
-        std::size_t toread = std::min(n_, nbits);
-        // ret is 0 on the first loop iteration. So this does nothing. But
-        // subsequent iterations will, say, left-shift 10 bits to make room
-        // for the 10 being read from accum_.
-        ret <<= toread;
-        // Ret is OR'd with accum_. accum_ is right-shifted by, say, from
-        // (19 bits available) to (10 bits we're reading), subtracting that
-        // results in 9 bits remaining to slice off accum_ before OR'ing
-        // them into return value.
-        ret |= (accum_ >> (n_ - toread));
-        // We've read, say 10 bits, so n_ is reduced from, say 19 to 9. That
-        // is, 9 bits left in accum_ to be read.
-        n_ -= toread;
-        // nbits (number we're trying to read) is decremented by the number
-        // we've just read so far. Eventually it will read zero and this
-        // loop will end.
-        nbits -= toread;
-        // accum_ has, say, 9 bits left to read. So all the other bits are
-        // bitmasked away.
-        accum_ &= BITMASK(n_);
+    while ((n_ <= 56) && (0 < len_)) {
+        accum_ |= static_cast<std::uint64_t>(*data_++) << (56 - n_);
+        --len_;
+        n_ += 8;
     }
+}
+
+std::uint64_t BitReader::unary()
+{
+    auto output = std::uint64_t{0};
+
+    while (true) {
+        if (0 == n_) {
+            refill();
+
+            if (0 == n_) { return output; }
+        }
+
+        // Bits below n_ are always zero so the run of ones can not extend
+        // past the unread bits
+        const auto ones = leading_ones(accum_);
+
+        if (ones < n_) {
+            output += ones;
+            accum_ <<= ones;
+            accum_ <<= 1;
+            n_ -= (ones + 1);
 
-    return ret;
+            return output;
+        }
+
+        output += n_;
+        accum_ = 0;
+        n_ = 0;
+    }
 }
 
 // output will contain the result after flush.
@@ -360,6 +405,76 @@ SerializedBloomFilter::SerializedBloomFilter() noexcept
     static_assert(9 == sizeof(SerializedBloomFilter));
 }
 
+SerializedFilter::SerializedFilter(
+    const std::uint8_t bits,
+    const std::uint32_t fpRate,
+    const std::uint32_t count,
+    const ReadView key) noexcept(false)
+    : version_(current_version_)
+    , bits_(bits)
+    , fp_rate_(fpRate)
+    , count_(count)
+    , key_()
+{
+    static_assert(26 == sizeof(SerializedFilter));
+
+    if (key_.size() != key.size()) {
+        throw std::runtime_error(
+            "Invalid key size: " + std::to_string(key.size()));
+    }
+
+    std::memcpy(key_.data(), key.data(), key_.size());
+}
+
+SerializedFilter::SerializedFilter() noexcept
+    : version_()
+    , bits_()
+    , fp_rate_()
+    , count_()
+    , key_()
+{
+    static_assert(26 == sizeof(SerializedFilter));
+}
+
+auto SerializedFilter::Filter(const ReadView record) noexcept(false)
+    -> ReadView
+{
+    if (false == Valid(record)) {
+        throw std::runtime_error("Invalid filter record");
+    }
+
+    return {
+        record.data() + sizeof(SerializedFilter),
+        record.size() - sizeof(SerializedFilter)};
+}
+
+auto SerializedFilter::Header(const ReadView record) noexcept(false)
+    -> const SerializedFilter&
+{
+    if (false == Valid(record)) {
+        throw std::runtime_error("Invalid filter record");
+    }
+
+    return *reinterpret_cast<const SerializedFilter*>(record.data());
+}
+
+auto SerializedFilter::Key() const noexcept -> ReadView
+{
+    return {reinterpret_cast<const char*>(key_.data()), key_.size()};
+}
+
+// Serialized protobuf messages never begin with a byte smaller than 0x08, so
+// the version byte also distinguishes these records from the legacy format
+auto SerializedFilter::Valid(const ReadView record) noexcept -> bool
+{
+    if ((nullptr == record.data()) ||
+        (sizeof(SerializedFilter) > record.size())) {
+        return false;
+    }
+
+    return current_version_ == static_cast<std::uint8_t>(record.front());
+}
+
 auto DisplayString(const Type type) noexcept -> std::string
 {
     switch (type) {
@@ -624,4 +739,46 @@ auto DisplayService(const Service service) noexcept -> std::string
     }
 }
 }  // namespace opentxs::blockchain::p2p
+
+namespace opentxs::blockchain::script
+{
+auto P2PK(const ReadView pubkey) noexcept -> const Template&
+{
+    if (P2PK_uncompressed.payload_size_ == pubkey.size()) {
+
+        return P2PK_uncompressed;
+    }
+
+    return P2PK_compressed;
+}
+
+auto Template::Write(const ReadView payload, const AllocateOutput output) const
+    noexcept -> bool
+{
+    if (false == bool(output)) { return false; }
+    if (payload_size_ != payload.size()) { return false; }
+
+    auto out = output(Size());
+
+    if (false == out.valid(Size())) { return false; }
+
+    return Write(payload, static_cast<std::uint8_t*>(out.data()));
+}
+
+auto Template::Write(const ReadView payload, std::uint8_t* output) const
+    noexcept -> bool
+{
+    if (nullptr == output) { return false; }
+    if (payload_size_ != payload.size()) { return false; }
+
+    auto* it = output;
+    std::memcpy(it, prefix_.data(), prefix_size_);
+    std::advance(it, prefix_size_);
+    std::memcpy(it, payload.data(), payload_size_);
+    std::advance(it, payload_size_);
+    std::memcpy(it, suffix_.data(), suffix_size_);
+
+    return true;
+}
+}  // namespace opentxs::blockchain::script
 #undef BITMASK
@@ -14,7 +14,6 @@
 #include <iterator>
 #include <map>
 #include <memory>
-#include <numeric>
 #include <stdexcept>
 #include <string_view>
 #include <tuple>
@@ -22,7 +21,6 @@
 
 #include "Factory.hpp"
 #include "blockchain/client/UpdateTransaction.hpp"
-#include "core/Executor.hpp"
 #include "internal/api/Api.hpp"
 #include "internal/api/client/Client.hpp"
 #include "internal/blockchain/Blockchain.hpp"
@@ -42,8 +40,6 @@
 #include "opentxs/core/Data.hpp"
 #include "opentxs/core/Log.hpp"
 #include "opentxs/core/LogSource.hpp"
-#include "opentxs/network/zeromq/Message.hpp"
-#include "opentxs/network/zeromq/socket/Publish.hpp"
 #include "util/LMDB.hpp"
 
 #define OT_METHOD "opentxs::blockchain::implementation::Database::"
@@ -53,14 +49,13 @@ namespace opentxs::factory
 auto BlockchainDatabase(
     const api::internal::Core& api,
     const api::client::internal::Blockchain& blockchain,
-    const blockchain::client::internal::Network& network,
     const api::client::blockchain::database::implementation::Database& common,
     const blockchain::Type type) noexcept
     -> std::unique_ptr<blockchain::internal::Database>
 {
     using ReturnType = blockchain::implementation::Database;
 
-    return std::make_unique<ReturnType>(api, blockchain, network, common, type);
+    return std::make_unique<ReturnType>(api, blockchain, common, type);
 }
 }  // namespace opentxs::factory
 
@@ -78,6 +73,12 @@ ReadView tsv(const Input& in) noexcept
 }
 
 const std::size_t Database::db_version_{1};
+// Version 1 stored header metadata as serialized protobuf local data and the
+// headers themselves in the shared block header table
+const std::size_t Database::header_storage_version_{2};
+const std::size_t Database::upgrade_batch_{1000};
+const std::size_t Database::Wallet::max_unspent_log_{10000};
+const block::Height Database::Wallet::mempool_height_{-1};
 const opentxs::storage::lmdb::TableNames Database::table_names_{
     {Config, "config"},
     {BlockHeaderMetadata, "block_header_metadata"},
@@ -87,6 +88,19 @@ const opentxs::storage::lmdb::TableNames Database::table_names_{
     {BlockHeaderDisconnected, "disconnected_block_headers"},
     {BlockFilterBest, "filter_tips"},
     {BlockFilterHeaderBest, "filter_header_tips"},
+    {WalletPatterns, "wallet_patterns"},
+    {WalletSubchainPatterns, "wallet_subchain_patterns"},
+    {WalletSubchainLastIndexed, "wallet_subchain_last_indexed"},
+    {WalletSubchainVersion, "wallet_subchain_version"},
+    {WalletSubchainLastScanned, "wallet_subchain_last_scanned"},
+    {WalletSubchainLastProcessed, "wallet_subchain_last_processed"},
+    {WalletMatchIndex, "wallet_match_index"},
+    {WalletOutputs, "wallet_outputs"},
+    {WalletTransactions, "wallet_transactions"},
+    {WalletTransactionBlocks, "wallet_transaction_blocks"},
+    {WalletBlockTransactions, "wallet_block_transactions"},
+    {WalletElementKeys, "wallet_element_keys"},
+    {BlockFilterVerified, "filter_verified_tips"},
 };
 
 const std::map<
@@ -126,7 +140,6 @@ const std::map<
 Database::Database(
     const api::internal::Core& api,
     const api::client::internal::Blockchain& blockchain,
-    const client::internal::Network& network,
     const Common& common,
     const blockchain::Type type) noexcept
     : chain_(type)
@@ -142,12 +155,25 @@ Database::Database(
            {BlockHeaderSiblings, 0},
            {BlockHeaderDisconnected, MDB_DUPSORT},
            {BlockFilterBest, MDB_INTEGERKEY},
-           {BlockFilterHeaderBest, MDB_INTEGERKEY}},
+           {BlockFilterHeaderBest, MDB_INTEGERKEY},
+           {WalletPatterns, MDB_DUPSORT},
+           {WalletSubchainPatterns, MDB_DUPSORT},
+           {WalletSubchainLastIndexed, 0},
+           {WalletSubchainVersion, 0},
+           {WalletSubchainLastScanned, 0},
+           {WalletSubchainLastProcessed, 0},
+           {WalletMatchIndex, MDB_DUPSORT},
+           {WalletOutputs, 0},
+           {WalletTransactions, 0},
+           {WalletTransactionBlocks, MDB_DUPSORT},
+           {WalletBlockTransactions, MDB_DUPSORT},
+           {WalletElementKeys, 0},
+           {BlockFilterVerified, MDB_INTEGERKEY}},
           0)
     , blocks_(api, common_, type)
     , filters_(api, common_, lmdb_, type)
-    , headers_(api, network, common_, lmdb_, type)
-    , wallet_(api, blockchain, chain_)
+    , headers_(api, common_, lmdb_, type)
+    , wallet_(api, blockchain, lmdb_, chain_)
 {
     init_db();
 }
@@ -178,16 +204,15 @@ Database::Filters::Filters(
 
 Database::Headers::Headers(
     const api::internal::Core& api,
-    const client::internal::Network& network,
     const Common& common,
     const opentxs::storage::lmdb::LMDB& lmdb,
     const blockchain::Type type) noexcept
     : api_(api)
-    , network_(network)
     , common_(common)
     , lmdb_(lmdb)
     , lock_()
 {
+    upgrade();
     import_genesis(type);
 
     OT_ASSERT(HeaderExists(best().second));
@@ -196,9 +221,11 @@ Database::Headers::Headers(
 Database::Wallet::Wallet(
     const api::Core& api,
     const api::client::internal::Blockchain& blockchain,
+    const opentxs::storage::lmdb::LMDB& lmdb,
     const blockchain::Type chain) noexcept
     : api_(api)
     , blockchain_(blockchain)
+    , lmdb_(lmdb)
     , chain_(chain)
     , lock_()
     , patterns_()
@@ -207,7 +234,7 @@ Database::Wallet::Wallet(
     , subchain_version_()
     , subchain_last_scanned_()
     , subchain_last_processed_()
-    , match_index_()
+    , element_keys_()
     , outputs_()
     , unconfirmed_new_()
     , confirmed_new_()
@@ -215,10 +242,17 @@ Database::Wallet::Wallet(
     , confirmed_spend_()
     , orphaned_new_()
     , orphaned_spend_()
-    , transactions_()
-    , tx_to_block_()
-    , block_to_tx_()
-{
+    , mempool_()
+    , unspent_()
+    , unspent_epoch_(1)
+    , unspent_floor_(unspent_epoch_)
+    , unspent_log_()
+    , balance_lock_()
+    , balance_(0, 0)
+    , account_balance_()
+    , subchain_balance_()
+{
+    load();
 }
 
 auto Database::Blocks::LoadBitcoin(const block::Hash& block) const noexcept
@@ -286,6 +320,18 @@ auto Database::Filters::CurrentTip(const filter::Type type) const noexcept
     return output;
 }
 
+auto Database::Filters::CurrentVerifiedTip(const filter::Type type) const
+    noexcept -> block::Position
+{
+    auto output{blank_position_};
+    auto cb = [this, &output](const auto in) {
+        output = blockchain::internal::Deserialize(api_, in);
+    };
+    lmdb_.Load(Table::BlockFilterVerified, static_cast<std::size_t>(type), cb);
+
+    return output;
+}
+
 auto Database::Filters::import_genesis(const blockchain::Type chain) const
     noexcept -> void
 {
@@ -396,16 +442,21 @@ auto Database::Filters::SetTip(
         .first;
 }
 
+auto Database::Filters::SetVerifiedTip(
+    const filter::Type type,
+    const block::Position position) const noexcept -> bool
+{
+    return lmdb_
+        .Store(
+            Table::BlockFilterVerified,
+            static_cast<std::size_t>(type),
+            reader(blockchain::internal::Serialize(position)))
+        .first;
+}
+
 auto Database::Headers::ApplyUpdate(
     const client::UpdateTransaction& update) noexcept -> bool
 {
-    if (false == common_.StoreBlockHeaders(update.UpdatedHeaders())) {
-        LogOutput(OT_METHOD)(__FUNCTION__)(": Failed to save block headers")
-            .Flush();
-
-        return false;
-    }
-
     Lock lock(lock_);
     const auto initialHeight = best(lock).first;
     auto parentTxn = lmdb_.TransactionRW();
@@ -492,16 +543,17 @@ auto Database::Headers::ApplyUpdate(
 
     for (const auto& [hash, pair] : update.UpdatedHeaders()) {
         const auto& [header, newBlock] = pair;
-        const auto result = lmdb_.Store(
-            BlockHeaderMetadata,
-            hash->Bytes(),
-            proto::ToString(header->Serialize().local()),
-            parentTxn);
 
-        if (false == result.first) {
-            LogOutput(OT_METHOD)(__FUNCTION__)(
-                ": Failed to save block metadata")
-                .Flush();
+        try {
+            const auto record = block::internal::SerializedHeader{*header};
+            const auto result = lmdb_.Store(
+                BlockHeaderMetadata, hash->Bytes(), tsv(record), parentTxn);
+
+            if (false == result.first) {
+                throw std::runtime_error("Failed to save block header");
+            }
+        } catch (const std::exception& e) {
+            LogOutput(OT_METHOD)(__FUNCTION__)(": ")(e.what()).Flush();
 
             return false;
         }
@@ -540,24 +592,7 @@ auto Database::Headers::ApplyUpdate(
         }
     }
 
-    parentTxn.Finalize(true);
-
-    if (update.HaveReorg()) {
-        const auto [height, hash] = update.ReorgParent();
-        const auto bytes = hash->Bytes();
-        LogNormal("Blockchain reorg detected. Last common ancestor is ")(
-            hash->asHex())(" at height ")(height)
-            .Flush();
-        auto work = MakeWork(api_, OTZMQWorkType{OT_ZMQ_REORG_SIGNAL});
-        work->AddFrame(network_.Chain());
-        work->AddFrame(bytes.data(), bytes.size());
-        work->AddFrame(height);
-        network_.Reorg().Send(work);
-    }
-
-    network_.UpdateLocalHeight(best(lock));
-
-    return true;
+    return parentTxn.Finalize(true);
 }
 
 auto Database::Headers::BestBlock(const block::Height position) const
@@ -688,8 +723,7 @@ auto Database::Headers::HaveCheckpoint() const noexcept -> bool
 auto Database::Headers::header_exists(const Lock& lock, const block::Hash& hash)
     const noexcept -> bool
 {
-    return common_.BlockHeaderExists(hash) &&
-           lmdb_.Exists(BlockHeaderMetadata, hash.Bytes());
+    return lmdb_.Exists(BlockHeaderMetadata, hash.Bytes());
 }
 
 auto Database::Headers::HeaderExists(const block::Hash& hash) const noexcept
@@ -706,37 +740,15 @@ auto Database::Headers::import_genesis(const blockchain::Type type) const
     auto success{false};
     const auto& hash = client::HeaderOracle::GenesisBlockHash(type);
 
-    try {
-        const auto serialized = common_.LoadBlockHeader(hash);
-
-        if (false == lmdb_.Exists(BlockHeaderMetadata, hash.Bytes())) {
-            auto genesis = api_.Factory().BlockHeader(serialized);
-
-            OT_ASSERT(genesis);
-
-            const auto result = lmdb_.Store(
-                BlockHeaderMetadata,
-                hash.Bytes(),
-                proto::ToString(genesis->Serialize().local()));
-
-            OT_ASSERT(result.first);
-        }
-    } catch (...) {
+    if (false == lmdb_.Exists(BlockHeaderMetadata, hash.Bytes())) {
         auto genesis = std::unique_ptr<blockchain::block::Header>{
             opentxs::Factory::GenesisBlockHeader(api_, type)};
 
         OT_ASSERT(genesis);
 
-        success = common_.StoreBlockHeader(*genesis);
-
-        OT_ASSERT(success);
-
-        success = lmdb_
-                      .Store(
-                          BlockHeaderMetadata,
-                          hash.Bytes(),
-                          proto::ToString(genesis->Serialize().local()))
-                      .first;
+        const auto record = block::internal::SerializedHeader{*genesis};
+        success =
+            lmdb_.Store(BlockHeaderMetadata, hash.Bytes(), tsv(record)).first;
 
         OT_ASSERT(success);
     }
@@ -764,19 +776,71 @@ auto Database::Headers::IsSibling(const block::Hash& hash) const noexcept
 auto Database::Headers::load_header(const block::Hash& hash) const
     -> std::unique_ptr<block::Header>
 {
-    auto proto = common_.LoadBlockHeader(hash);
-    const auto haveMeta =
+    using Record = block::internal::SerializedHeader;
+    auto output = std::unique_ptr<block::Header>{};
+    auto legacy = std::optional<Space>{};
+    const auto found =
         lmdb_.Load(BlockHeaderMetadata, hash.Bytes(), [&](const auto data) {
-            proto.mutable_local()->ParseFromArray(data.data(), data.size());
+            if (Record::Valid(data)) {
+                output = opentxs::Factory::BlockHeader(
+                    api_, hash, Record::Read(data));
+            } else {
+                legacy = space(data);
+            }
         });
 
-    if (false == haveMeta) {
-        throw std::out_of_range("Block header metadata not found");
+    if (false == found) { throw std::out_of_range("Block header not found"); }
+
+    if (legacy.has_value()) {
+        return load_legacy(hash, reader(legacy.value()));
     }
 
+    if (false == bool(output)) {
+        throw std::out_of_range("Invalid block header record");
+    }
+
+    return output;
+}
+
+auto Database::Headers::load_legacy(
+    const block::Hash& hash,
+    const ReadView metadata) const -> std::unique_ptr<block::Header>
+{
+    auto proto = common_.LoadBlockHeader(hash);
+    proto.mutable_local()->ParseFromArray(metadata.data(), metadata.size());
     auto output = api_.Factory().BlockHeader(proto);
 
-    OT_ASSERT(output);
+    if (false == bool(output)) {
+        throw std::out_of_range("Invalid legacy block header");
+    }
+
+    return output;
+}
+
+auto Database::Headers::LoadHeaderView(const ReadView hash) const noexcept
+    -> std::optional<block::internal::HeaderView>
+{
+    using Record = block::internal::SerializedHeader;
+    auto output = std::optional<block::internal::HeaderView>{};
+
+    if (32 != hash.size()) { return output; }
+
+    auto legacy{false};
+    lmdb_.Load(BlockHeaderMetadata, hash, [&](const auto data) {
+        if (Record::Valid(data)) {
+            output.emplace(hash, Record::Read(data));
+        } else {
+            legacy = true;
+        }
+    });
+
+    if (legacy) {
+        try {
+            const auto header = load_header(api_.Factory().Data(hash));
+            output.emplace(hash, Record{*header});
+        } catch (...) {
+        }
+    }
 
     return output;
 }
@@ -851,6 +915,78 @@ auto Database::Headers::SiblingHashes() const noexcept -> client::Hashes
     return output;
 }
 
+auto Database::Headers::upgrade() const noexcept -> bool
+{
+    using Record = block::internal::SerializedHeader;
+    auto configured = std::size_t{1};
+    lmdb_.Load(
+        Config,
+        tsv(static_cast<std::size_t>(Key::HeaderStorageVersion)),
+        [&configured](const auto in) {
+            if (sizeof(configured) != in.size()) { return; }
+
+            std::memcpy(&configured, in.data(), in.size());
+        });
+
+    if (header_storage_version_ <= configured) { return true; }
+
+    auto legacy = std::vector<Space>{};
+    auto find = [&legacy](const auto key, const auto value) {
+        if (false == Record::Valid(value)) { legacy.emplace_back(space(key)); }
+
+        return true;
+    };
+    lmdb_.Read(
+        BlockHeaderMetadata, find, opentxs::storage::lmdb::LMDB::Dir::Forward);
+
+    if (false == legacy.empty()) {
+        LogNormal(OT_METHOD)(__FUNCTION__)(": Converting ")(legacy.size())(
+            " block headers to the current storage format")
+            .Flush();
+    }
+
+    auto it = legacy.cbegin();
+
+    while (legacy.cend() != it) {
+        // Records are converted before the write transaction is opened since
+        // a thread may only hold one transaction at a time
+        auto batch = std::vector<std::pair<ReadView, Record>>{};
+
+        for (; (legacy.cend() != it) && (batch.size() < upgrade_batch_); ++it) {
+            const auto key = reader(*it);
+
+            try {
+                const auto header = load_header(api_.Factory().Data(key));
+                batch.emplace_back(key, Record{*header});
+            } catch (...) {
+                LogOutput(OT_METHOD)(__FUNCTION__)(
+                    ": Failed to convert block header")
+                    .Flush();
+
+                return false;
+            }
+        }
+
+        auto parentTxn = lmdb_.TransactionRW();
+
+        for (const auto& [key, record] : batch) {
+            const auto stored =
+                lmdb_.Store(BlockHeaderMetadata, key, tsv(record), parentTxn);
+
+            if (false == stored.first) { return false; }
+        }
+
+        if (false == parentTxn.Finalize(true)) { return false; }
+    }
+
+    return lmdb_
+        .Store(
+            Config,
+            tsv(static_cast<std::size_t>(Key::HeaderStorageVersion)),
+            tsv(header_storage_version_))
+        .first;
+}
+
 auto Database::Headers::TryLoadHeader(const block::Hash& hash) const noexcept
     -> std::unique_ptr<block::Header>
 {
@@ -864,64 +1000,64 @@ auto Database::Headers::TryLoadHeader(const block::Hash& hash) const noexcept
 auto Database::Wallet::add_transaction(
     const Lock& lock,
     const block::Hash& block,
-    const block::bitcoin::Transaction& transaction) const noexcept -> bool
+    const block::bitcoin::Transaction& transaction,
+    const ReadView serialized,
+    MDB_txn* parent) const noexcept -> bool
 {
-    if (auto it = transactions_.find(transaction.ID());
-        transactions_.end() != it) {
-        auto& serialized = it->second;
-        transaction.MergeMetadata(serialized);
-        auto updated = transaction.Serialize();
+    const auto txid = transaction.ID().Bytes();
 
-        OT_ASSERT(updated.has_value());
+    if (false ==
+        lmdb_.Store(WalletTransactions, txid, serialized, parent).first) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(": Failed to save transaction")
+            .Flush();
 
-        serialized = std::move(updated.value());
-    } else {
-        auto serialized = transaction.Serialize();
+        return false;
+    }
 
-        OT_ASSERT(serialized.has_value());
+    if (false ==
+        lmdb_.Store(WalletTransactionBlocks, txid, block.Bytes(), parent)
+            .first) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(
+            ": Failed to save transaction to block index")
+            .Flush();
 
-        transactions_.emplace(transaction.ID(), std::move(serialized.value()));
+        return false;
     }
 
-    {
-        auto& index = tx_to_block_[transaction.ID()];
-        index.emplace_back(block);
-        dedup(index);
-    }
+    if (false ==
+        lmdb_.Store(WalletBlockTransactions, block.Bytes(), txid, parent)
+            .first) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(
+            ": Failed to save block to transaction index")
+            .Flush();
 
-    {
-        auto& index = block_to_tx_[block];
-        index.emplace_back(transaction.ID());
-        dedup(index);
+        return false;
     }
 
     return true;
 }
 
 auto Database::Wallet::AddConfirmedTransaction(
+    const NodeID& balanceNode,
+    const Subchain subchain,
     const block::Position& block,
     const std::vector<std::uint32_t> outputIndices,
     const block::bitcoin::Transaction& transaction) const noexcept -> bool
 {
     Lock lock(lock_);
     const auto& [height, blockHash] = block;
-
-    if (false == add_transaction(lock, blockHash, transaction)) {
-        LogOutput(__FUNCTION__)(": Error adding transaction to database")
-            .Flush();
-
-        return false;
-    }
+    auto changed = ChangedOutputs{};
 
     for (const auto& input : transaction.Inputs()) {
         const auto& outpoint = input.PreviousOutput();
 
         if (auto out = find_output(lock, outpoint); out.has_value()) {
-            auto& lastHeight = out.value()->second.first;
-
-            if (false ==
-                change_state(
-                    lock, outpoint, lastHeight, height, confirmed_spend_)) {
+            if (false == change_state(
+                             lock,
+                             outpoint,
+                             out.value()->second,
+                             height,
+                             OutputState::ConfirmedSpend)) {
                 LogOutput(__FUNCTION__)(
                     ": Error updating consumed output state")
                     .Flush();
@@ -929,7 +1065,7 @@ auto Database::Wallet::AddConfirmedTransaction(
                 return false;
             }
 
-            lastHeight = height;
+            changed.emplace_back(outpoint);
         }
 
         // NOTE consider the case of parallel chain scanning where one
@@ -950,73 +1086,284 @@ auto Database::Wallet::AddConfirmedTransaction(
             block::bitcoin::Outpoint{transaction.ID().Bytes(), index};
 
         if (auto out = find_output(lock, outpoint); out.has_value()) {
-            auto& lastHeight = out.value()->second.first;
-
-            if (false ==
-                change_state(
-                    lock, outpoint, lastHeight, height, confirmed_new_)) {
+            if (false == change_state(
+                             lock,
+                             outpoint,
+                             out.value()->second,
+                             height,
+                             OutputState::ConfirmedNew)) {
                 LogOutput(__FUNCTION__)(": Error updating created output state")
                     .Flush();
 
                 return false;
             }
-
-            lastHeight = height;
         } else {
             const auto& output = transaction.Outputs().at(index);
             auto serialized = block::bitcoin::Output::SerializeType{};
             output.Serialize(serialized);
-            outputs_.emplace(
-                std::piecewise_construct,
-                std::forward_as_tuple(outpoint),
-                std::forward_as_tuple(height, std::move(serialized)));
+            const auto& data =
+                outputs_
+                    .emplace(
+                        outpoint,
+                        OutputData{
+                            height,
+                            OutputState::ConfirmedNew,
+                            balanceNode,
+                            subchain,
+                            std::move(serialized)})
+                    .first->second;
             auto& map = confirmed_new_[height];
             map.emplace_back(outpoint);
             dedup(map);
+            set_unspent(lock, outpoint, data.state_);
+            update_balance(data, true);
         }
+
+        changed.emplace_back(outpoint);
     }
 
-    blockchain_.UpdateBalance(chain_, get_balance(lock));
+    // The confirmed state replaces anything recorded from the mempool
+    mempool_.erase(transaction.ID());
+
+    // NOTE the in-memory state is updated before the database. Processing a
+    // transaction is idempotent so if the commit fails the caller will not
+    // advance its last processed position and the block will be processed
+    // again after a restart.
+    try {
+        const auto serialized = merge_transaction(lock, transaction);
+        auto parentTxn = lmdb_.TransactionRW();
+
+        if (false == add_transaction(
+                         lock, blockHash, transaction, serialized, parentTxn)) {
+            LogOutput(OT_METHOD)(__FUNCTION__)(
+                ": Error adding transaction to database")
+                .Flush();
+
+            return false;
+        }
+
+        for (const auto& outpoint : changed) {
+            if (false == store_output(lock, outpoint, parentTxn)) {
+                LogOutput(OT_METHOD)(__FUNCTION__)(
+                    ": Error saving output state")
+                    .Flush();
+
+                return false;
+            }
+        }
+
+        if (false == parentTxn.Finalize(true)) {
+            LogOutput(OT_METHOD)(__FUNCTION__)(
+                ": Failed to commit database transaction")
+                .Flush();
+
+            return false;
+        }
+    } catch (const std::exception& e) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(": ")(e.what()).Flush();
+
+        return false;
+    }
+
+    blockchain_.UpdateBalance(chain_, GetBalance());
 
     return true;
 }
 
-auto Database::Wallet::change_state(
-    const Lock& lock,
-    const block::bitcoin::Outpoint& id,
-    const block::Height originalHeight,
-    const block::Height newHeight,
-    OutputStateMap& to) const noexcept -> bool
+auto Database::Wallet::AddMempoolTransaction(
+    const NodeID& balanceNode,
+    const Subchain subchain,
+    const std::vector<std::uint32_t> outputIndices,
+    const block::bitcoin::Transaction& transaction) const noexcept -> bool
 {
-    auto in = std::vector<OutputStateMap*>{};
+    Lock lock(lock_);
+    auto changed{false};
+    auto& record = mempool_[transaction.ID()];
 
-    if (&to != &unconfirmed_new_) { in.emplace_back(&unconfirmed_new_); }
+    for (const auto& input : transaction.Inputs()) {
+        const auto& outpoint = input.PreviousOutput();
+        auto out = find_output(lock, outpoint);
 
-    if (&to != &confirmed_new_) { in.emplace_back(&confirmed_new_); }
+        if (false == out.has_value()) { continue; }
 
-    if (&to != &unconfirmed_spend_) { in.emplace_back(&unconfirmed_spend_); }
+        auto& output = out.value()->second;
 
-    if (&to != &confirmed_spend_) { in.emplace_back(&confirmed_spend_); }
+        // NOTE an unconfirmed spend of an unconfirmed output is not recorded
+        // until one of the transactions is confirmed
+        if (OutputState::ConfirmedNew != output.state_) { continue; }
 
-    if (&to != &orphaned_new_) { in.emplace_back(&orphaned_new_); }
+        if (false == change_state(
+                         lock,
+                         outpoint,
+                         output,
+                         output.height_,
+                         OutputState::UnconfirmedSpend)) {
+            LogOutput(OT_METHOD)(__FUNCTION__)(
+                ": Error updating consumed output state")
+                .Flush();
 
-    if (&to != &orphaned_spend_) { in.emplace_back(&orphaned_spend_); }
+            return false;
+        }
 
-    for (auto& from : in) {
-        if (false == remove_state(lock, id, originalHeight, *from)) {
-            LogOutput(__FUNCTION__)(": Error updating output state").Flush();
+        record.spent_.emplace_back(outpoint);
+        changed = true;
+    }
 
-            return false;
+    for (const auto index : outputIndices) {
+        const auto outpoint =
+            block::bitcoin::Outpoint{transaction.ID().Bytes(), index};
+
+        if (find_output(lock, outpoint).has_value()) { continue; }
+
+        const auto& output = transaction.Outputs().at(index);
+        auto serialized = block::bitcoin::Output::SerializeType{};
+        output.Serialize(serialized);
+        const auto& data = outputs_
+                               .emplace(
+                                   outpoint,
+                                   OutputData{
+                                       mempool_height_,
+                                       OutputState::UnconfirmedNew,
+                                       balanceNode,
+                                       subchain,
+                                       std::move(serialized)})
+                               .first->second;
+        auto& map = unconfirmed_new_[mempool_height_];
+        map.emplace_back(outpoint);
+        dedup(map);
+        set_unspent(lock, outpoint, data.state_);
+        update_balance(data, true);
+        record.created_.emplace_back(outpoint);
+        changed = true;
+    }
+
+    if (record.created_.empty() && record.spent_.empty()) {
+        mempool_.erase(transaction.ID());
+    }
+
+    if (changed) { blockchain_.UpdateBalance(chain_, GetBalance()); }
+
+    return true;
+}
+
+auto Database::Wallet::balance(const OutputData& output) noexcept -> Balance
+{
+    const auto value = static_cast<Amount>(output.output_.value());
+
+    switch (output.state_) {
+        case OutputState::ConfirmedNew: {
+
+            return {value, value};
+        }
+        case OutputState::UnconfirmedNew: {
+
+            return {0, value};
+        }
+        case OutputState::UnconfirmedSpend: {
+
+            return {value, 0};
+        }
+        default: {
+
+            return {0, 0};
         }
     }
+}
 
-    auto& map = to[newHeight];
+auto Database::Wallet::change_state(
+    const Lock& lock,
+    const block::bitcoin::Outpoint& id,
+    OutputData& output,
+    const block::Height height,
+    const OutputState to) const noexcept -> bool
+{
+    if (false ==
+        remove_state(lock, id, output.height_, state_map(output.state_))) {
+        LogOutput(__FUNCTION__)(": Error updating output state").Flush();
+
+        return false;
+    }
+
+    update_balance(output, false);
+    output.height_ = height;
+    output.state_ = to;
+    update_balance(output, true);
+    auto& map = state_map(to)[height];
     map.emplace_back(id);
     dedup(map);
+    set_unspent(lock, id, to);
 
     return true;
 }
 
+auto Database::Wallet::DropMempoolTransaction(const block::Txid& txid) const
+    noexcept -> void
+{
+    Lock lock(lock_);
+    auto it = mempool_.find(txid);
+
+    if (mempool_.end() == it) { return; }
+
+    const auto& [created, spent] = it->second;
+
+    for (const auto& outpoint : created) {
+        auto out = find_output(lock, outpoint);
+
+        if (false == out.has_value()) { continue; }
+
+        const auto& output = out.value()->second;
+
+        if (OutputState::UnconfirmedNew != output.state_) { continue; }
+
+        remove_state(lock, outpoint, output.height_, unconfirmed_new_);
+        update_balance(output, false);
+        set_unspent(lock, outpoint, OutputState::OrphanedNew);
+        outputs_.erase(out.value());
+    }
+
+    for (const auto& outpoint : spent) {
+        auto out = find_output(lock, outpoint);
+
+        if (false == out.has_value()) { continue; }
+
+        auto& output = out.value()->second;
+
+        if (OutputState::UnconfirmedSpend != output.state_) { continue; }
+
+        change_state(
+            lock, outpoint, output, output.height_, OutputState::ConfirmedNew);
+    }
+
+    mempool_.erase(it);
+    lock.unlock();
+    blockchain_.UpdateBalance(chain_, GetBalance());
+}
+
+auto Database::Wallet::element_key(const KeyType type, const ReadView key)
+    -> std::string
+{
+    auto output = std::string{};
+    output.reserve(sizeof(type) + key.size());
+    output.append(reinterpret_cast<const char*>(&type), sizeof(type));
+    output.append(key.data(), key.size());
+
+    return output;
+}
+
+auto Database::Wallet::FindElement(const KeyType type, const ReadView key)
+    const noexcept -> std::optional<ElementID>
+{
+    Lock lock(lock_);
+
+    if (auto it = element_keys_.find(element_key(type, key));
+        element_keys_.end() != it) {
+
+        return it->second;
+    }
+
+    return {};
+}
+
 auto Database::Wallet::find_output(
     const Lock& lock,
     const block::bitcoin::Outpoint& id) const noexcept
@@ -1033,35 +1380,6 @@ auto Database::Wallet::find_output(
     }
 }
 
-auto Database::Wallet::get_balance(const Lock&) const noexcept -> Balance
-{
-    auto output = Balance{};
-    auto& [confirmed, unconfirmed] = output;
-    auto cb = [this](const auto previous, const auto& in) -> auto
-    {
-        const auto& outpoints = in.second;
-        auto cb = [this](const auto previous, const auto& in) -> auto
-        {
-            return previous + outputs_.at(in).second.value();
-        };
-
-        return std::accumulate(
-            std::begin(outpoints), std::end(outpoints), previous, cb);
-    };
-    confirmed = std::accumulate(
-        std::begin(confirmed_new_),
-        std::end(confirmed_new_),
-        std::uint64_t{0},
-        cb);
-    unconfirmed = std::accumulate(
-        std::begin(unconfirmed_new_),
-        std::end(unconfirmed_new_),
-        confirmed,
-        cb);
-
-    return output;
-}
-
 auto Database::Wallet::get_patterns(
     const Lock& lock,
     const NodeID& balanceNode,
@@ -1075,9 +1393,38 @@ auto Database::Wallet::get_patterns(
 
 auto Database::Wallet::GetBalance() const noexcept -> Balance
 {
-    Lock lock(lock_);
+    Lock lock(balance_lock_);
 
-    return get_balance(lock);
+    return balance_;
+}
+
+auto Database::Wallet::GetBalance(const NodeID& balanceNode) const noexcept
+    -> Balance
+{
+    Lock lock(balance_lock_);
+
+    if (auto it = account_balance_.find(balanceNode);
+        account_balance_.end() != it) {
+
+        return it->second;
+    }
+
+    return {};
+}
+
+auto Database::Wallet::GetBalance(
+    const NodeID& balanceNode,
+    const Subchain subchain) const noexcept -> Balance
+{
+    Lock lock(balance_lock_);
+
+    if (auto it = subchain_balance_.find({balanceNode, subchain});
+        subchain_balance_.end() != it) {
+
+        return it->second;
+    }
+
+    return {};
 }
 
 auto Database::Wallet::GetPatterns(
@@ -1109,26 +1456,48 @@ auto Database::Wallet::GetUnspentOutputs() const noexcept -> std::vector<UTXO>
 auto Database::Wallet::get_unspent_outputs(const Lock& lock) const noexcept
     -> std::vector<UTXO>
 {
-    auto retrieve = std::vector<block::bitcoin::Outpoint>{};
+    auto output = std::vector<UTXO>{};
+    output.reserve(unspent_.size());
 
-    for (const auto& [height, outpoints] : unconfirmed_new_) {
-        retrieve.insert(retrieve.end(), outpoints.begin(), outpoints.end());
+    for (const auto& outpoint : unspent_) {
+        output.emplace_back(outpoint, outputs_.at(outpoint).output_);
     }
 
-    for (const auto& [height, outpoints] : confirmed_new_) {
-        retrieve.insert(retrieve.end(), outpoints.begin(), outpoints.end());
-    }
+    return output;
+}
+
+auto Database::Wallet::GetUnspentOutputs(const std::size_t epoch) const
+    noexcept -> UTXOChanges
+{
+    Lock lock(lock_);
+    auto output = UTXOChanges{unspent_epoch_, false, {}, {}};
+
+    // Epochs are not persisted so an epoch newer than the current one was
+    // issued before the database was reopened
+    if ((epoch < unspent_floor_) || (unspent_epoch_ < epoch)) {
+        output.reset_ = true;
+        output.added_ = get_unspent_outputs(lock);
 
-    for (const auto& [height, outpoints] : unconfirmed_spend_) {
-        retrieve.insert(retrieve.end(), outpoints.begin(), outpoints.end());
+        return output;
     }
 
-    dedup(retrieve);
-    auto output = std::vector<UTXO>{};
+    // Only the most recent change to each outpoint matters
+    auto changes = std::map<block::bitcoin::Outpoint, bool>{};
+
+    for (auto i{unspent_log_.crbegin()}; i != unspent_log_.crend(); ++i) {
+        const auto& [changed, outpoint, unspent] = *i;
+
+        if (changed <= epoch) { break; }
 
-    for (const auto& outpoint : retrieve) {
-        const auto& [height, txout] = outputs_.at(outpoint);
-        output.emplace_back(outpoint, txout);
+        changes.emplace(outpoint, unspent);
+    }
+
+    for (const auto& [outpoint, unspent] : changes) {
+        if (unspent) {
+            output.added_.emplace_back(outpoint, outputs_.at(outpoint).output_);
+        } else {
+            output.spent_.emplace_back(outpoint);
+        }
     }
 
     return output;
@@ -1142,26 +1511,37 @@ auto Database::Wallet::GetUntestedPatterns(
     const VersionNumber version) const noexcept -> Patterns
 {
     Lock lock(lock_);
+    const auto subchainID = subchain_id(balanceNode, subchain, type, version);
 
     try {
         const auto& allPatterns =
             get_patterns(lock, balanceNode, subchain, type, version);
-        auto effectiveIDs = std::vector<pPatternID>{};
+        auto matchedPatterns = IDSet{};
+        // Each value is the block hash followed by the pattern id, so only
+        // the matches for this block are read
+        lmdb_.LoadPrefix(
+            WalletMatchIndex, subchainID->Bytes(), blockID, [&](const auto in) {
+                if (in.size() <= blockID.size()) { return; }
 
-        try {
-            const auto& matchedPatterns =
-                match_index_.at(api_.Factory().Data(blockID));
-            std::set_difference(
-                std::begin(allPatterns),
-                std::end(allPatterns),
-                std::begin(matchedPatterns),
-                std::end(matchedPatterns),
-                std::back_inserter(effectiveIDs));
-        } catch (...) {
+                auto id = api_.Factory().Identifier();
+                id->Assign(
+                    in.data() + blockID.size(), in.size() - blockID.size());
+                matchedPatterns.emplace(std::move(id));
+            });
+
+        if (matchedPatterns.empty()) {
 
             return load_patterns(lock, balanceNode, subchain, allPatterns);
         }
 
+        auto effectiveIDs = std::vector<pPatternID>{};
+        std::set_difference(
+            std::begin(allPatterns),
+            std::end(allPatterns),
+            std::begin(matchedPatterns),
+            std::end(matchedPatterns),
+            std::back_inserter(effectiveIDs));
+
         return load_patterns(lock, balanceNode, subchain, effectiveIDs);
     } catch (...) {
 
@@ -1169,6 +1549,236 @@ auto Database::Wallet::GetUntestedPatterns(
     }
 }
 
+auto Database::Wallet::IsUnspent(
+    const block::bitcoin::Outpoint& outpoint) const noexcept -> bool
+{
+    Lock lock(lock_);
+
+    return 0 < unspent_.count(outpoint);
+}
+
+auto Database::Wallet::load() noexcept -> void
+{
+    lmdb_.Read(
+        WalletPatterns,
+        [&](const auto key, const auto value) -> bool {
+            auto index = Bip32Index{};
+
+            if (sizeof(index) > value.size()) { return true; }
+
+            std::memcpy(&index, value.data(), sizeof(index));
+            auto id = api_.Factory().Identifier();
+            id->Assign(key.data(), key.size());
+            patterns_[id].emplace_back(
+                index,
+                space(ReadView{
+                    value.data() + sizeof(index),
+                    value.size() - sizeof(index)}));
+
+            return true;
+        },
+        Dir::Forward);
+    lmdb_.Read(
+        WalletSubchainPatterns,
+        [&](const auto key, const auto value) -> bool {
+            auto subchain = api_.Factory().Identifier();
+            subchain->Assign(key.data(), key.size());
+            auto pattern = api_.Factory().Identifier();
+            pattern->Assign(value.data(), value.size());
+            subchain_pattern_index_[subchain].emplace(std::move(pattern));
+
+            return true;
+        },
+        Dir::Forward);
+    lmdb_.Read(
+        WalletSubchainLastIndexed,
+        [&](const auto key, const auto value) -> bool {
+            auto index = Bip32Index{};
+
+            if (sizeof(index) != value.size()) { return true; }
+
+            std::memcpy(&index, value.data(), sizeof(index));
+            auto id = api_.Factory().Identifier();
+            id->Assign(key.data(), key.size());
+            subchain_last_indexed_[id] = index;
+
+            return true;
+        },
+        Dir::Forward);
+    lmdb_.Read(
+        WalletSubchainVersion,
+        [&](const auto key, const auto value) -> bool {
+            auto version = VersionNumber{};
+
+            if (sizeof(version) != value.size()) { return true; }
+
+            std::memcpy(&version, value.data(), sizeof(version));
+            auto id = api_.Factory().Identifier();
+            id->Assign(key.data(), key.size());
+            subchain_version_[id] = version;
+
+            return true;
+        },
+        Dir::Forward);
+    lmdb_.Read(
+        WalletSubchainLastScanned,
+        [&](const auto key, const auto value) -> bool {
+            return load_position(key, value, subchain_last_scanned_);
+        },
+        Dir::Forward);
+    lmdb_.Read(
+        WalletSubchainLastProcessed,
+        [&](const auto key, const auto value) -> bool {
+            return load_position(key, value, subchain_last_processed_);
+        },
+        Dir::Forward);
+    lmdb_.Read(
+        WalletElementKeys,
+        [&](const auto key, const auto value) -> bool {
+            return load_element_key(key, value);
+        },
+        Dir::Forward);
+    lmdb_.Read(
+        WalletOutputs,
+        [&](const auto key, const auto value) -> bool {
+            return load_output(key, value);
+        },
+        Dir::Forward);
+}
+
+// Element key records contain the index and subchain of the element followed
+// by the balance node
+auto Database::Wallet::load_element_key(
+    const ReadView key,
+    const ReadView value) noexcept -> bool
+{
+    auto index = Bip32Index{};
+    auto subchain = Subchain{};
+    constexpr auto fixed = sizeof(index) + sizeof(subchain);
+
+    if (fixed > value.size()) { return true; }
+
+    auto it = value.data();
+    std::memcpy(&index, it, sizeof(index));
+    std::advance(it, sizeof(index));
+    std::memcpy(&subchain, it, sizeof(subchain));
+    std::advance(it, sizeof(subchain));
+    auto balanceNode = api_.Factory().Identifier();
+    balanceNode->Assign(it, value.size() - fixed);
+    element_keys_.emplace(
+        std::string{key}, ElementID{index, {subchain, std::move(balanceNode)}});
+
+    return true;
+}
+
+// Output records contain the height and state of the output, the subchain and
+// length prefixed balance node which own it, and the serialized output
+auto Database::Wallet::load_output(
+    const ReadView key,
+    const ReadView value) noexcept -> bool
+{
+    auto height = block::Height{};
+    auto state = OutputState{};
+    auto subchain = Subchain{};
+    auto size = std::uint8_t{};
+    constexpr auto fixed =
+        sizeof(height) + sizeof(state) + sizeof(subchain) + sizeof(size);
+
+    if (fixed > value.size()) { return true; }
+
+    try {
+        const auto outpoint = block::bitcoin::Outpoint{key};
+        auto it = value.data();
+        std::memcpy(&height, it, sizeof(height));
+        std::advance(it, sizeof(height));
+        std::memcpy(&state, it, sizeof(state));
+        std::advance(it, sizeof(state));
+        std::memcpy(&subchain, it, sizeof(subchain));
+        std::advance(it, sizeof(subchain));
+        std::memcpy(&size, it, sizeof(size));
+        std::advance(it, sizeof(size));
+
+        if ((fixed + size) > value.size()) { return true; }
+
+        auto balanceNode = api_.Factory().Identifier();
+        balanceNode->Assign(it, size);
+        std::advance(it, size);
+        const auto& data =
+            outputs_
+                .emplace(
+                    outpoint,
+                    OutputData{
+                        height,
+                        state,
+                        std::move(balanceNode),
+                        subchain,
+                        proto::Factory<proto::BlockchainTransactionOutput>(
+                            it, value.size() - fixed - size)})
+                .first->second;
+        auto& map = state_map(state)[height];
+        map.emplace_back(outpoint);
+        dedup(map);
+        update_balance(data, true);
+
+        if ((OutputState::UnconfirmedNew == state) ||
+            (OutputState::ConfirmedNew == state) ||
+            (OutputState::UnconfirmedSpend == state)) {
+            unspent_.emplace(outpoint);
+        }
+    } catch (const std::exception& e) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(": ")(e.what()).Flush();
+    }
+
+    return true;
+}
+
+auto Database::Wallet::load_position(
+    const ReadView key,
+    const ReadView value,
+    PositionMap& map) noexcept -> bool
+{
+    auto id = api_.Factory().Identifier();
+    id->Assign(key.data(), key.size());
+    map.emplace(std::move(id), blockchain::internal::Deserialize(api_, value));
+
+    return true;
+}
+
+auto Database::Wallet::merge_transaction(
+    const Lock& lock,
+    const block::bitcoin::Transaction& transaction) const noexcept(false)
+    -> std::string
+{
+    auto existing = std::optional<proto::BlockchainTransaction>{};
+    lmdb_.Load(
+        WalletTransactions, transaction.ID().Bytes(), [&](const auto in) {
+            existing = proto::Factory<proto::BlockchainTransaction>(
+                in.data(), in.size());
+        });
+
+    if (existing.has_value()) {
+        auto& serialized = existing.value();
+        transaction.MergeMetadata(serialized);
+    }
+
+    auto updated = transaction.Serialize();
+
+    if (false == updated.has_value()) {
+        throw std::runtime_error("Failed to serialize transaction");
+    }
+
+    return proto::ToString(updated.value());
+}
+
+auto Database::Wallet::OutpointHash::operator()(
+    const block::bitcoin::Outpoint& outpoint) const noexcept -> std::size_t
+{
+    auto output = std::size_t{};
+    std::memcpy(&output, outpoint.txid_.data(), sizeof(output));
+
+    return output ^ outpoint.Index();
+}
+
 auto Database::Wallet::pattern_id(
     const SubchainID& subchain,
     const Bip32Index index) const noexcept -> pPatternID
@@ -1206,31 +1816,225 @@ auto Database::Wallet::remove_state(
     return true;
 }
 
+auto Database::Wallet::set_unspent(
+    const Lock& lock,
+    const block::bitcoin::Outpoint& id,
+    const OutputState state) const noexcept -> void
+{
+    const auto unspent = (OutputState::UnconfirmedNew == state) ||
+                         (OutputState::ConfirmedNew == state) ||
+                         (OutputState::UnconfirmedSpend == state);
+    const auto changed =
+        unspent ? unspent_.emplace(id).second : (0 < unspent_.erase(id));
+
+    if (false == changed) { return; }
+
+    unspent_log_.emplace_back(++unspent_epoch_, id, unspent);
+
+    while (max_unspent_log_ < unspent_log_.size()) {
+        unspent_floor_ = std::get<0>(unspent_log_.front());
+        unspent_log_.pop_front();
+    }
+}
+
+auto Database::Wallet::state_map(const OutputState state) const noexcept
+    -> OutputStateMap&
+{
+    switch (state) {
+        case OutputState::UnconfirmedNew: {
+
+            return unconfirmed_new_;
+        }
+        case OutputState::ConfirmedNew: {
+
+            return confirmed_new_;
+        }
+        case OutputState::UnconfirmedSpend: {
+
+            return unconfirmed_spend_;
+        }
+        case OutputState::ConfirmedSpend: {
+
+            return confirmed_spend_;
+        }
+        case OutputState::OrphanedNew: {
+
+            return orphaned_new_;
+        }
+        case OutputState::OrphanedSpend:
+        default: {
+
+            return orphaned_spend_;
+        }
+    }
+}
+
+auto Database::Wallet::store_output(
+    const Lock& lock,
+    const block::bitcoin::Outpoint& id,
+    MDB_txn* parent) const noexcept -> bool
+{
+    const auto& output = outputs_.at(id);
+    const auto balanceNode = output.balance_node_->Bytes();
+    const auto size = static_cast<std::uint8_t>(
+        std::min<std::size_t>(balanceNode.size(), 255u));
+    const auto serialized = proto::ToString(output.output_);
+    auto value = space(
+        sizeof(output.height_) + sizeof(output.state_) +
+        sizeof(output.subchain_) + sizeof(size) + size + serialized.size());
+    auto it = value.data();
+    std::memcpy(it, &output.height_, sizeof(output.height_));
+    std::advance(it, sizeof(output.height_));
+    std::memcpy(it, &output.state_, sizeof(output.state_));
+    std::advance(it, sizeof(output.state_));
+    std::memcpy(it, &output.subchain_, sizeof(output.subchain_));
+    std::advance(it, sizeof(output.subchain_));
+    std::memcpy(it, &size, sizeof(size));
+    std::advance(it, sizeof(size));
+    std::memcpy(it, balanceNode.data(), size);
+    std::advance(it, size);
+    std::memcpy(it, serialized.data(), serialized.size());
+
+    return lmdb_.Store(WalletOutputs, id.Bytes(), reader(value), parent).first;
+}
+
+auto Database::Wallet::store_position(
+    const opentxs::storage::lmdb::Table table,
+    const Identifier& id,
+    const block::Position& position) const noexcept -> bool
+{
+    return lmdb_
+        .Store(
+            table,
+            id.Bytes(),
+            reader(blockchain::internal::Serialize(position)))
+        .first;
+}
+
 auto Database::Wallet::SubchainAddElements(
     const NodeID& balanceNode,
     const Subchain subchain,
     const FilterType type,
     const ElementMap& elements,
+    const ElementKeys& keys,
     const VersionNumber version) const noexcept -> bool
 {
     Lock lock(lock_);
-    subchain_version_[subchain_version_index(balanceNode, subchain, type)] =
-        version;
-    auto subchainID = subchain_id(balanceNode, subchain, type, version);
+    const auto versionID = subchain_version_index(balanceNode, subchain, type);
+    const auto subchainID = subchain_id(balanceNode, subchain, type, version);
     auto newIndices = std::vector<OTIdentifier>{};
     auto highest = Bip32Index{};
+    const auto node = balanceNode.Bytes();
+
+    try {
+        auto parentTxn = lmdb_.TransactionRW();
+
+        for (const auto& [index, patterns] : elements) {
+            auto patternID = pattern_id(subchainID, index);
+            highest = std::max(highest, index);
+
+            for (const auto& pattern : patterns) {
+                auto value = space(sizeof(index) + pattern.size());
+                std::memcpy(value.data(), &index, sizeof(index));
+                std::memcpy(
+                    std::next(value.data(), sizeof(index)),
+                    pattern.data(),
+                    pattern.size());
+
+                if (false ==
+                    lmdb_
+                        .Store(
+                            WalletPatterns,
+                            patternID->Bytes(),
+                            reader(value),
+                            parentTxn)
+                        .first) {
+                    throw std::runtime_error("Failed to save pattern");
+                }
+            }
+
+            if (false == lmdb_
+                             .Store(
+                                 WalletSubchainPatterns,
+                                 subchainID->Bytes(),
+                                 patternID->Bytes(),
+                                 parentTxn)
+                             .first) {
+                throw std::runtime_error("Failed to save pattern index");
+            }
+
+            newIndices.emplace_back(std::move(patternID));
+        }
+
+        for (const auto& [index, list] : keys) {
+            auto value = space(sizeof(index) + sizeof(subchain) + node.size());
+            auto it = value.data();
+            std::memcpy(it, &index, sizeof(index));
+            std::advance(it, sizeof(index));
+            std::memcpy(it, &subchain, sizeof(subchain));
+            std::advance(it, sizeof(subchain));
+            std::memcpy(it, node.data(), node.size());
+
+            for (const auto& [keyType, key] : list) {
+                if (false == lmdb_
+                                 .Store(
+                                     WalletElementKeys,
+                                     element_key(keyType, reader(key)),
+                                     reader(value),
+                                     parentTxn)
+                                 .first) {
+                    throw std::runtime_error("Failed to save element key");
+                }
+            }
+        }
+
+        if (false == lmdb_
+                         .Store(
+                             WalletSubchainLastIndexed,
+                             subchainID->Bytes(),
+                             tsv(highest),
+                             parentTxn)
+                         .first) {
+            throw std::runtime_error("Failed to save last indexed");
+        }
+
+        if (false == lmdb_
+                         .Store(
+                             WalletSubchainVersion,
+                             versionID->Bytes(),
+                             tsv(version),
+                             parentTxn)
+                         .first) {
+            throw std::runtime_error("Failed to save subchain version");
+        }
+
+        if (false == parentTxn.Finalize(true)) {
+            throw std::runtime_error("Failed to commit database transaction");
+        }
+    } catch (const std::exception& e) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(": ")(e.what()).Flush();
+
+        return false;
+    }
+
+    subchain_version_[versionID] = version;
 
     for (const auto& [index, patterns] : elements) {
-        auto patternID = pattern_id(subchainID, index);
-        auto& vector = patterns_[patternID];
-        newIndices.emplace_back(std::move(patternID));
-        highest = std::max(highest, index);
+        auto& vector = patterns_[pattern_id(subchainID, index)];
 
         for (const auto& pattern : patterns) {
             vector.emplace_back(index, pattern);
         }
     }
 
+    for (const auto& [index, list] : keys) {
+        for (const auto& [keyType, key] : list) {
+            element_keys_.insert_or_assign(
+                element_key(keyType, reader(key)),
+                ElementID{index, {subchain, balanceNode}});
+        }
+    }
+
     subchain_last_indexed_[subchainID] = highest;
     auto& index = subchain_pattern_index_[subchainID];
 
@@ -1246,21 +2050,49 @@ auto Database::Wallet::SubchainDropIndex(
     const VersionNumber version) const noexcept -> bool
 {
     Lock lock(lock_);
+    const auto versionID = subchain_version_index(balanceNode, subchain, type);
     const auto subchainID = subchain_id(balanceNode, subchain, type, version);
+    auto dropped = IDSet{};
+
+    if (auto it = subchain_pattern_index_.find(subchainID);
+        subchain_pattern_index_.end() != it) {
+        dropped = it->second;
+    }
 
+    // NOTE the deletions below are allowed to fail since not every key is
+    // guaranteed to exist
     try {
-        for (const auto& patternID : subchain_pattern_index_.at(subchainID)) {
-            patterns_.erase(patternID);
+        auto parentTxn = lmdb_.TransactionRW();
 
-            for (auto& [block, set] : match_index_) { set.erase(patternID); }
+        for (const auto& patternID : dropped) {
+            lmdb_.Delete(WalletPatterns, patternID->Bytes(), parentTxn);
         }
-    } catch (...) {
+
+        lmdb_.Delete(WalletMatchIndex, subchainID->Bytes(), parentTxn);
+        lmdb_.Delete(WalletSubchainPatterns, subchainID->Bytes(), parentTxn);
+        lmdb_.Delete(WalletSubchainLastIndexed, subchainID->Bytes(), parentTxn);
+        lmdb_.Delete(WalletSubchainVersion, versionID->Bytes(), parentTxn);
+        // A new index must be scanned from the beginning of the chain
+        lmdb_.Delete(WalletSubchainLastScanned, versionID->Bytes(), parentTxn);
+        lmdb_.Delete(
+            WalletSubchainLastProcessed, versionID->Bytes(), parentTxn);
+
+        if (false == parentTxn.Finalize(true)) {
+            throw std::runtime_error("Failed to commit database transaction");
+        }
+    } catch (const std::exception& e) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(": ")(e.what()).Flush();
+
+        return false;
     }
 
+    for (const auto& patternID : dropped) { patterns_.erase(patternID); }
+
     subchain_pattern_index_.erase(subchainID);
     subchain_last_indexed_.erase(subchainID);
-    subchain_version_.erase(
-        subchain_version_index(balanceNode, subchain, type));
+    subchain_version_.erase(versionID);
+    subchain_last_scanned_.erase(versionID);
+    subchain_last_processed_.erase(versionID);
 
     return true;
 }
@@ -1337,6 +2169,15 @@ auto Database::Wallet::SubchainSetLastProcessed(
     Lock lock(lock_);
     auto& map = subchain_last_processed_;
     auto id = subchain_version_index(balanceNode, subchain, type);
+
+    if (false == store_position(WalletSubchainLastProcessed, id, position)) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(
+            ": Failed to save last processed position")
+            .Flush();
+
+        return false;
+    }
+
     auto it = map.find(id);
 
     if (map.end() == it) {
@@ -1359,11 +2200,36 @@ auto Database::Wallet::SubchainMatchBlock(
     const VersionNumber version) const noexcept -> bool
 {
     Lock lock(lock_);
-    auto& matchSet = match_index_[api_.Factory().Data(blockID)];
+    const auto subchainID = subchain_id(balanceNode, subchain, type, version);
 
-    for (const auto& index : indices) {
-        matchSet.emplace(pattern_id(
-            subchain_id(balanceNode, subchain, type, version), index));
+    try {
+        auto parentTxn = lmdb_.TransactionRW();
+
+        for (const auto& index : indices) {
+            const auto patternID = pattern_id(subchainID, index);
+            auto value = space(blockID);
+            const auto pattern = patternID->Bytes();
+            const auto* it = reinterpret_cast<const std::byte*>(pattern.data());
+            value.insert(value.end(), it, it + pattern.size());
+
+            if (false == lmdb_
+                             .Store(
+                                 WalletMatchIndex,
+                                 subchainID->Bytes(),
+                                 reader(value),
+                                 parentTxn)
+                             .first) {
+                throw std::runtime_error("Failed to save match");
+            }
+        }
+
+        if (false == parentTxn.Finalize(true)) {
+            throw std::runtime_error("Failed to commit database transaction");
+        }
+    } catch (const std::exception& e) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(": ")(e.what()).Flush();
+
+        return false;
     }
 
     return true;
@@ -1378,6 +2244,15 @@ auto Database::Wallet::SubchainSetLastScanned(
     Lock lock(lock_);
     auto& map = subchain_last_scanned_;
     auto id = subchain_version_index(balanceNode, subchain, type);
+
+    if (false == store_position(WalletSubchainLastScanned, id, position)) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(
+            ": Failed to save last scanned position")
+            .Flush();
+
+        return false;
+    }
+
     auto it = map.find(id);
 
     if (map.end() == it) {
@@ -1421,6 +2296,30 @@ auto Database::Wallet::subchain_id(
     return output;
 }
 
+auto Database::Wallet::update_balance(
+    const OutputData& output,
+    const bool add) const noexcept -> void
+{
+    const auto [confirmed, unconfirmed] = balance(output);
+
+    if ((0 == confirmed) && (0 == unconfirmed)) { return; }
+
+    auto apply = [&](Balance& target) {
+        if (add) {
+            target.first += confirmed;
+            target.second += unconfirmed;
+        } else {
+            target.first -= confirmed;
+            target.second -= unconfirmed;
+        }
+    };
+
+    Lock lock(balance_lock_);
+    apply(balance_);
+    apply(account_balance_[output.balance_node_]);
+    apply(subchain_balance_[{output.balance_node_, output.subchain_}]);
+}
+
 auto Database::init_db() noexcept -> void
 {
     if (false == lmdb_.Exists(Config, tsv(Key::Version))) {
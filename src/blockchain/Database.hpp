@@ -11,6 +11,7 @@
 #include <boost/container/flat_set.hpp>
 #include <algorithm>
 #include <cstdint>
+#include <deque>
 #include <iosfwd>
 #include <map>
 #include <memory>
@@ -18,6 +19,9 @@
 #include <optional>
 #include <set>
 #include <string>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -91,13 +95,25 @@ public:
     using Common = api::client::blockchain::database::implementation::Database;
 
     auto AddConfirmedTransaction(
+        const NodeID& balanceNode,
+        const Subchain subchain,
         const block::Position& block,
         const std::vector<std::uint32_t> outputIndices,
         const block::bitcoin::Transaction& transaction) const noexcept
         -> bool final
     {
         return wallet_.AddConfirmedTransaction(
-            block, outputIndices, transaction);
+            balanceNode, subchain, block, outputIndices, transaction);
+    }
+    auto AddMempoolTransaction(
+        const NodeID& balanceNode,
+        const Subchain subchain,
+        const std::vector<std::uint32_t> outputIndices,
+        const block::bitcoin::Transaction& transaction) const noexcept
+        -> bool final
+    {
+        return wallet_.AddMempoolTransaction(
+            balanceNode, subchain, outputIndices, transaction);
     }
     auto AddOrUpdate(Address address) const noexcept -> bool final
     {
@@ -114,6 +130,10 @@ public:
     {
         return headers_.BestBlock(position);
     }
+    auto BlockCacheSize() const noexcept -> std::size_t final
+    {
+        return common_.BlockCacheSize();
+    }
     auto BlockExists(const block::Hash& block) const noexcept -> bool final
     {
         return common_.BlockExists(block);
@@ -132,6 +152,14 @@ public:
     {
         return blocks_.Store(block);
     }
+    auto BootstrapExport() const noexcept -> const std::string& final
+    {
+        return common_.BootstrapExport();
+    }
+    auto BootstrapImport() const noexcept -> const std::string& final
+    {
+        return common_.BootstrapImport();
+    }
     auto CurrentBest() const noexcept -> std::unique_ptr<block::Header> final
     {
         return headers_.CurrentBest();
@@ -140,20 +168,39 @@ public:
     {
         return headers_.CurrentCheckpoint();
     }
+    auto FilterCacheSize() const noexcept -> std::size_t final
+    {
+        return common_.FilterCacheSize();
+    }
     auto FilterHeaderTip(const filter::Type type) const noexcept
         -> block::Position final
     {
         return filters_.CurrentHeaderTip(type);
     }
+    auto FilterPolicy() const noexcept
+        -> api::client::blockchain::FilterSource final
+    {
+        return common_.FilterPolicy();
+    }
     auto FilterTip(const filter::Type type) const noexcept
         -> block::Position final
     {
         return filters_.CurrentTip(type);
     }
+    auto FilterVerifiedTip(const filter::Type type) const noexcept
+        -> block::Position final
+    {
+        return filters_.CurrentVerifiedTip(type);
+    }
     auto DisconnectedHashes() const noexcept -> client::DisconnectedList final
     {
         return headers_.DisconnectedHashes();
     }
+    auto DropMempoolTransaction(const block::Txid& txid) const noexcept
+        -> void final
+    {
+        wallet_.DropMempoolTransaction(txid);
+    }
     auto Get(
         const Protocol protocol,
         const std::set<Type> onNetworks,
@@ -161,10 +208,24 @@ public:
     {
         return common_.Find(chain_, protocol, onNetworks, withServices);
     }
+    auto FindElement(const KeyType type, const ReadView key) const noexcept
+        -> std::optional<ElementID> final
+    {
+        return wallet_.FindElement(type, key);
+    }
     auto GetBalance() const noexcept -> Balance final
     {
         return wallet_.GetBalance();
     }
+    auto GetBalance(const NodeID& balanceNode) const noexcept -> Balance final
+    {
+        return wallet_.GetBalance(balanceNode);
+    }
+    auto GetBalance(const NodeID& balanceNode, const Subchain subchain) const
+        noexcept -> Balance final
+    {
+        return wallet_.GetBalance(balanceNode, subchain);
+    }
     auto GetPatterns(
         const NodeID& balanceNode,
         const Subchain subchain,
@@ -177,6 +238,11 @@ public:
     {
         return wallet_.GetUnspentOutputs();
     }
+    auto GetUnspentOutputs(const std::size_t epoch) const noexcept
+        -> UTXOChanges final
+    {
+        return wallet_.GetUnspentOutputs(epoch);
+    }
     auto GetUntestedPatterns(
         const NodeID& balanceNode,
         const Subchain subchain,
@@ -239,10 +305,35 @@ public:
     {
         return headers_.LoadHeader(hash);
     }
+    auto LoadHeaderView(const ReadView hash) const noexcept
+        -> std::optional<block::internal::HeaderView> final
+    {
+        return headers_.LoadHeaderView(hash);
+    }
+    auto MempoolSize() const noexcept -> std::size_t final
+    {
+        return common_.MempoolSize();
+    }
+    auto ReadFilter(
+        const filter::Type type,
+        const ReadView block,
+        const FilterCallback& cb) const noexcept -> bool final
+    {
+        return filters_.ReadFilter(type, block, cb);
+    }
     auto RecentHashes() const noexcept -> std::vector<block::pHash> final
     {
         return headers_.RecentHashes();
     }
+    auto IsUnspent(const block::bitcoin::Outpoint& outpoint) const noexcept
+        -> bool final
+    {
+        return wallet_.IsUnspent(outpoint);
+    }
+    auto ScanThreads() const noexcept -> std::size_t final
+    {
+        return common_.ScanThreads();
+    }
     auto SetFilterHeaderTip(
         const filter::Type type,
         const block::Position position) const noexcept -> bool final
@@ -254,6 +345,12 @@ public:
     {
         return filters_.SetTip(type, position);
     }
+    auto SetFilterVerifiedTip(
+        const filter::Type type,
+        const block::Position position) const noexcept -> bool final
+    {
+        return filters_.SetVerifiedTip(type, position);
+    }
     auto SiblingHashes() const noexcept -> client::Hashes final
     {
         return headers_.SiblingHashes();
@@ -275,10 +372,11 @@ public:
         const Subchain subchain,
         const FilterType type,
         const ElementMap& elements,
+        const ElementKeys& keys,
         const VersionNumber version) const noexcept -> bool final
     {
         return wallet_.SubchainAddElements(
-            balanceNode, subchain, type, elements, version);
+            balanceNode, subchain, type, elements, keys, version);
     }
     auto SubchainDropIndex(
         const NodeID& balanceNode,
@@ -358,7 +456,6 @@ public:
     Database(
         const api::internal::Core& api,
         const api::client::internal::Blockchain& blockchain,
-        const client::internal::Network& network,
         const Common& common,
         const blockchain::Type type) noexcept;
 
@@ -388,6 +485,8 @@ private:
             -> block::Position;
         auto CurrentTip(const filter::Type type) const noexcept
             -> block::Position;
+        auto CurrentVerifiedTip(const filter::Type type) const noexcept
+            -> block::Position;
         auto HaveFilter(const filter::Type type, const block::Hash& block) const
             noexcept -> bool
         {
@@ -407,11 +506,21 @@ private:
             noexcept -> Hash;
         auto LoadFilterHeader(const filter::Type type, const ReadView block)
             const noexcept -> Hash;
+        auto ReadFilter(
+            const filter::Type type,
+            const ReadView block,
+            const FilterCallback& cb) const noexcept -> bool
+        {
+            return common_.ReadFilter(type, block, cb);
+        }
         auto SetHeaderTip(
             const filter::Type type,
             const block::Position position) const noexcept -> bool;
         auto SetTip(const filter::Type type, const block::Position position)
             const noexcept -> bool;
+        auto SetVerifiedTip(
+            const filter::Type type,
+            const block::Position position) const noexcept -> bool;
         auto StoreHeaders(
             const filter::Type type,
             const ReadView previous,
@@ -465,6 +574,8 @@ private:
         {
             return load_header(hash);
         }
+        std::optional<block::internal::HeaderView> LoadHeaderView(
+            const ReadView hash) const noexcept;
         std::vector<block::pHash> RecentHashes() const noexcept;
         client::Hashes SiblingHashes() const noexcept;
         // Returns null pointer if the header does not exist
@@ -475,14 +586,12 @@ private:
 
         Headers(
             const api::internal::Core& api,
-            const client::internal::Network& network,
             const Common& common,
             const opentxs::storage::lmdb::LMDB& lmdb,
             const blockchain::Type type) noexcept;
 
     private:
         const api::internal::Core& api_;
-        const client::internal::Network& network_;
         const Common& common_;
         const opentxs::storage::lmdb::LMDB& lmdb_;
         mutable std::mutex lock_;
@@ -495,6 +604,10 @@ private:
         // Throws std::out_of_range if the header does not exist
         std::unique_ptr<block::Header> load_header(
             const block::Hash& hash) const noexcept(false);
+        // Throws std::out_of_range if the header does not exist
+        std::unique_ptr<block::Header> load_legacy(
+            const block::Hash& hash,
+            const ReadView metadata) const noexcept(false);
         bool pop_best(const std::size_t i, MDB_txn* parent) const noexcept;
         bool push_best(
             const block::Position next,
@@ -502,32 +615,53 @@ private:
             MDB_txn* parent) const noexcept;
         std::vector<block::pHash> recent_hashes(const Lock& lock) const
             noexcept;
+        bool upgrade() const noexcept;
     };
 
     struct Wallet {
         auto AddConfirmedTransaction(
+            const NodeID& balanceNode,
+            const Subchain subchain,
             const block::Position& block,
             const std::vector<std::uint32_t> outputIndices,
             const block::bitcoin::Transaction& transaction) const noexcept
             -> bool;
+        auto AddMempoolTransaction(
+            const NodeID& balanceNode,
+            const Subchain subchain,
+            const std::vector<std::uint32_t> outputIndices,
+            const block::bitcoin::Transaction& transaction) const noexcept
+            -> bool;
+        auto DropMempoolTransaction(const block::Txid& txid) const noexcept
+            -> void;
+        auto FindElement(const KeyType type, const ReadView key) const
+            noexcept -> std::optional<ElementID>;
         auto GetBalance() const noexcept -> Balance;
+        auto GetBalance(const NodeID& balanceNode) const noexcept -> Balance;
+        auto GetBalance(const NodeID& balanceNode, const Subchain subchain)
+            const noexcept -> Balance;
         auto GetPatterns(
             const NodeID& balanceNode,
             const Subchain subchain,
             const FilterType type,
             const VersionNumber version) const noexcept -> Patterns;
         auto GetUnspentOutputs() const noexcept -> std::vector<UTXO>;
+        auto GetUnspentOutputs(const std::size_t epoch) const noexcept
+            -> UTXOChanges;
         auto GetUntestedPatterns(
             const NodeID& balanceNode,
             const Subchain subchain,
             const FilterType type,
             const ReadView blockID,
             const VersionNumber version) const noexcept -> Patterns;
+        auto IsUnspent(const block::bitcoin::Outpoint& outpoint) const
+            noexcept -> bool;
         auto SubchainAddElements(
             const NodeID& balanceNode,
             const Subchain subchain,
             const FilterType type,
             const ElementMap& elements,
+            const ElementKeys& keys,
             const VersionNumber version) const noexcept -> bool;
         auto SubchainDropIndex(
             const NodeID& balanceNode,
@@ -573,9 +707,21 @@ private:
         Wallet(
             const api::Core& api,
             const api::client::internal::Blockchain& blockchain,
+            const opentxs::storage::lmdb::LMDB& lmdb,
             const blockchain::Type chain) noexcept;
 
     private:
+        enum class OutputState : std::uint8_t {
+            UnconfirmedNew = 0,
+            ConfirmedNew = 1,
+            UnconfirmedSpend = 2,
+            ConfirmedSpend = 3,
+            OrphanedNew = 4,
+            OrphanedSpend = 5,
+        };
+
+        using Dir = opentxs::storage::lmdb::LMDB::Dir;
+        using Mode = opentxs::storage::lmdb::LMDB::Mode;
         using SubchainID = Identifier;
         using pSubchainID = OTIdentifier;
         using PatternID = Identifier;
@@ -587,21 +733,58 @@ private:
         using SubchainIndexMap = std::map<pSubchainID, VersionNumber>;
         using VersionIndex = std::map<OTIdentifier, VersionNumber>;
         using PositionMap = std::map<OTIdentifier, block::Position>;
-        using MatchIndex = std::map<block::pHash, IDSet>;
-        using OutputMap = std::map<
-            block::bitcoin::Outpoint,
-            std::pair<block::Height, proto::BlockchainTransactionOutput>>;
+
+        struct OutputData {
+            block::Height height_;
+            OutputState state_;
+            pNodeID balance_node_;
+            Subchain subchain_;
+            proto::BlockchainTransactionOutput output_;
+        };
+
+        using OutputMap = std::map<block::bitcoin::Outpoint, OutputData>;
+
+        // Changes made by an unconfirmed transaction which must be reverted
+        // if it leaves the mempool without being confirmed
+        struct MempoolData {
+            std::vector<block::bitcoin::Outpoint> created_;
+            std::vector<block::bitcoin::Outpoint> spent_;
+        };
+
+        using MempoolMap = std::map<block::pTxid, MempoolData>;
         using OutputStateMap =
             std::map<block::Height, std::vector<block::bitcoin::Outpoint>>;
-        using TransactionMap =
-            std::map<block::pTxid, proto::BlockchainTransaction>;
-        using TransactionBlockMap =
-            std::map<block::pTxid, std::vector<block::pHash>>;
-        using BlockTransactionMap =
-            std::map<block::pHash, std::vector<block::pTxid>>;
+        using ChangedOutputs = std::vector<block::bitcoin::Outpoint>;
+
+        // Txids are uniformly distributed so any part of one is a good hash
+        struct OutpointHash {
+            auto operator()(const block::bitcoin::Outpoint& outpoint) const
+                noexcept -> std::size_t;
+        };
+
+        using UnspentIndex =
+            std::unordered_set<block::bitcoin::Outpoint, OutpointHash>;
+        // Epoch, outpoint, unspent
+        using UnspentLog = std::deque<
+            std::tuple<std::size_t, block::bitcoin::Outpoint, bool>>;
+
+        // Key type and key bytes to the owning element
+        using KeyIndex = std::unordered_map<std::string, ElementID>;
+        using AccountBalanceMap = std::map<pNodeID, Balance>;
+        using SubchainBalanceMap =
+            std::map<std::pair<pNodeID, Subchain>, Balance>;
+
+        static const std::size_t max_unspent_log_;
+        static const block::Height mempool_height_;
+
+        /// Contribution of an output to the confirmed and unconfirmed balance
+        static auto balance(const OutputData& output) noexcept -> Balance;
+        static auto element_key(const KeyType type, const ReadView key)
+            -> std::string;
 
         const api::Core& api_;
         const api::client::internal::Blockchain& blockchain_;
+        const opentxs::storage::lmdb::LMDB& lmdb_;
         const blockchain::Type chain_;
         mutable std::mutex lock_;
         mutable PatternMap patterns_;
@@ -610,7 +793,7 @@ private:
         mutable VersionIndex subchain_version_;
         mutable PositionMap subchain_last_scanned_;
         mutable PositionMap subchain_last_processed_;
-        mutable MatchIndex match_index_;
+        mutable KeyIndex element_keys_;
         mutable OutputMap outputs_;
         mutable OutputStateMap unconfirmed_new_;
         mutable OutputStateMap confirmed_new_;
@@ -618,11 +801,19 @@ private:
         mutable OutputStateMap confirmed_spend_;
         mutable OutputStateMap orphaned_new_;
         mutable OutputStateMap orphaned_spend_;
-        mutable TransactionMap transactions_;
-        mutable TransactionBlockMap tx_to_block_;
-        mutable BlockTransactionMap block_to_tx_;
+        // Unconfirmed changes are never written to the database
+        mutable MempoolMap mempool_;
+        mutable UnspentIndex unspent_;
+        mutable std::size_t unspent_epoch_;
+        // Changes at or before this epoch have been discarded from the log
+        mutable std::size_t unspent_floor_;
+        mutable UnspentLog unspent_log_;
+        // Running totals are read without acquiring lock_
+        mutable std::mutex balance_lock_;
+        mutable Balance balance_;
+        mutable AccountBalanceMap account_balance_;
+        mutable SubchainBalanceMap subchain_balance_;
 
-        auto get_balance(const Lock& lock) const noexcept -> Balance;
         auto get_patterns(
             const Lock& lock,
             const NodeID& balanceNode,
@@ -657,16 +848,30 @@ private:
         auto add_transaction(
             const Lock& lock,
             const block::Hash& block,
-            const block::bitcoin::Transaction& transaction) const noexcept
-            -> bool;
+            const block::bitcoin::Transaction& transaction,
+            const ReadView serialized,
+            MDB_txn* parent) const noexcept -> bool;
         auto change_state(
             const Lock& lock,
             const block::bitcoin::Outpoint& id,
-            const block::Height originalHeight,
-            const block::Height newHeight,
-            OutputStateMap& to) const noexcept -> bool;
+            OutputData& output,
+            const block::Height height,
+            const OutputState to) const noexcept -> bool;
         auto find_output(const Lock& lock, const block::bitcoin::Outpoint& id)
             const noexcept -> std::optional<OutputMap::iterator>;
+        auto load() noexcept -> void;
+        auto load_element_key(const ReadView key, const ReadView value) noexcept
+            -> bool;
+        auto load_output(const ReadView key, const ReadView value) noexcept
+            -> bool;
+        auto load_position(
+            const ReadView key,
+            const ReadView value,
+            PositionMap& map) noexcept -> bool;
+        auto merge_transaction(
+            const Lock& lock,
+            const block::bitcoin::Transaction& transaction) const
+            noexcept(false) -> std::string;
         auto pattern_id(const SubchainID& subchain, const Bip32Index index)
             const noexcept -> pPatternID;
         auto remove_state(
@@ -674,10 +879,26 @@ private:
             const block::bitcoin::Outpoint& id,
             const block::Height height,
             OutputStateMap& from) const noexcept -> bool;
+        auto set_unspent(
+            const Lock& lock,
+            const block::bitcoin::Outpoint& id,
+            const OutputState state) const noexcept -> void;
+        auto state_map(const OutputState state) const noexcept
+            -> OutputStateMap&;
+        auto store_output(
+            const Lock& lock,
+            const block::bitcoin::Outpoint& id,
+            MDB_txn* parent) const noexcept -> bool;
+        auto store_position(
+            const opentxs::storage::lmdb::Table table,
+            const Identifier& id,
+            const block::Position& position) const noexcept -> bool;
         auto subchain_version_index(
             const NodeID& balanceNode,
             const Subchain subchain,
             const FilterType type) const noexcept -> pSubchainID;
+        auto update_balance(const OutputData& output, const bool add) const
+            noexcept -> void;
         auto subchain_id(
             const NodeID& balanceNode,
             const Subchain subchain,
@@ -694,6 +915,19 @@ private:
         BlockHeaderDisconnected = 5,
         BlockFilterBest = 6,
         BlockFilterHeaderBest = 7,
+        WalletPatterns = 8,
+        WalletSubchainPatterns = 9,
+        WalletSubchainLastIndexed = 10,
+        WalletSubchainVersion = 11,
+        WalletSubchainLastScanned = 12,
+        WalletSubchainLastProcessed = 13,
+        WalletMatchIndex = 14,
+        WalletOutputs = 15,
+        WalletTransactions = 16,
+        WalletTransactionBlocks = 17,
+        WalletBlockTransactions = 18,
+        WalletElementKeys = 19,
+        BlockFilterVerified = 20,
     };
 
     enum class Key : std::size_t {
@@ -701,9 +935,12 @@ private:
         TipHeight = 1,
         CheckpointHeight = 2,
         CheckpointHash = 3,
+        HeaderStorageVersion = 4,
     };
 
     static const std::size_t db_version_;
+    static const std::size_t header_storage_version_;
+    static const std::size_t upgrade_batch_;
     static const opentxs::storage::lmdb::TableNames table_names_;
 
     const blockchain::Type chain_;
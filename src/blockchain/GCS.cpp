@@ -14,13 +14,14 @@
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <iterator>
 #include <limits>
-#include <map>
 #include <memory>
 #include <optional>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "Factory.hpp"
@@ -30,12 +31,9 @@
 #include "opentxs/Proto.hpp"
 #include "opentxs/api/Core.hpp"
 #include "opentxs/api/Factory.hpp"
-#include "opentxs/api/crypto/Crypto.hpp"
-#include "opentxs/api/crypto/Hash.hpp"
 #include "opentxs/core/Data.hpp"
 #include "opentxs/core/Log.hpp"
 #include "opentxs/core/LogSource.hpp"
-#include "opentxs/protobuf/Enums.pb.h"
 
 //#define OT_METHOD "opentxs::blockchain::implementation::GCS::"
 
@@ -79,6 +77,36 @@ auto Factory::GCS(
     }
 }
 
+auto Factory::GCS(
+    const api::Core& api,
+    const std::uint8_t bits,
+    const std::uint32_t fpRate,
+    const ReadView key,
+    const std::vector<Space>& elements) noexcept
+    -> std::unique_ptr<blockchain::internal::GCS>
+{
+    using ReturnType = blockchain::implementation::GCS;
+
+    try {
+        auto effective = std::vector<ReadView>{};
+
+        for (const auto& element : elements) {
+            if (element.empty()) { continue; }
+
+            effective.emplace_back(reader(element));
+        }
+
+        dedup(effective);
+
+        return std::make_unique<ReturnType>(api, bits, fpRate, key, effective);
+    } catch (const std::exception& e) {
+        LogVerbose("opentxs::Factory::GCS::")(__FUNCTION__)(": ")(e.what())
+            .Flush();
+
+        return nullptr;
+    }
+}
+
 auto Factory::GCS(const api::Core& api, const proto::GCS& in) noexcept
     -> std::unique_ptr<blockchain::internal::GCS>
 {
@@ -86,7 +114,13 @@ auto Factory::GCS(const api::Core& api, const proto::GCS& in) noexcept
 
     try {
         return std::make_unique<ReturnType>(
-            api, in.bits(), in.fprate(), in.count(), in.key(), in.filter());
+            api,
+            in.bits(),
+            in.fprate(),
+            in.count(),
+            in.key(),
+            in.filter(),
+            false);
     } catch (const std::exception& e) {
         LogVerbose("opentxs::Factory::GCS::")(__FUNCTION__)(": ")(e.what())
             .Flush();
@@ -108,7 +142,34 @@ auto Factory::GCS(
 
     try {
         return std::make_unique<ReturnType>(
-            api, bits, fpRate, filterElementCount, key, filter);
+            api, bits, fpRate, filterElementCount, key, filter, false);
+    } catch (const std::exception& e) {
+        LogVerbose("opentxs::Factory::GCS::")(__FUNCTION__)(": ")(e.what())
+            .Flush();
+
+        return nullptr;
+    }
+}
+
+auto Factory::GCS(
+    const api::Core& api,
+    const ReadView serialized,
+    const bool borrow) noexcept -> std::unique_ptr<blockchain::internal::GCS>
+{
+    using ReturnType = blockchain::implementation::GCS;
+    using Header = blockchain::internal::SerializedFilter;
+
+    try {
+        const auto& header = Header::Header(serialized);
+
+        return std::make_unique<ReturnType>(
+            api,
+            header.bits_.value(),
+            header.fp_rate_.value(),
+            header.count_.value(),
+            header.Key(),
+            Header::Filter(serialized),
+            borrow);
     } catch (const std::exception& e) {
         LogVerbose("opentxs::Factory::GCS::")(__FUNCTION__)(": ")(e.what())
             .Flush();
@@ -123,25 +184,29 @@ namespace opentxs::gcs
 using BitReader = blockchain::internal::BitReader;
 using BitWriter = blockchain::internal::BitWriter;
 
-auto golomb_decode(const std::uint8_t P, BitReader& stream) noexcept(false)
+auto golomb_decode(const std::uint8_t P, BitReader& stream) noexcept
     -> std::uint64_t;
 auto golomb_encode(
     const std::uint8_t P,
     const std::uint64_t value,
     BitWriter& stream) noexcept -> void;
-auto siphash(
-    const api::Core& api,
-    const ReadView key,
-    const ReadView item) noexcept(false) -> std::uint64_t;
+template <typename Iterator, typename Key, typename Callback>
+auto golomb_match(
+    const std::uint32_t N,
+    const std::uint8_t P,
+    const ReadView encoded,
+    Iterator target,
+    const Iterator end,
+    const Key& key,
+    const Callback& onMatch) noexcept -> void;
+auto hash_to_range(const std::uint64_t hash, const std::uint64_t range) noexcept
+    -> std::uint64_t;
 
-auto golomb_decode(const std::uint8_t P, BitReader& stream) noexcept(false)
+auto golomb_decode(const std::uint8_t P, BitReader& stream) noexcept
     -> std::uint64_t
 {
-    auto quotient = std::uint64_t{0};
-
-    while (1 == stream.read(1)) { quotient++; }
-
-    auto remainder = stream.read(P);
+    const auto quotient = stream.unary();
+    const auto remainder = stream.read(P);
 
     return std::uint64_t{(quotient << P) + remainder};
 }
@@ -163,13 +228,47 @@ auto golomb_encode(
     stream.write(P, remainder);
 }
 
+// Decodes the set one delta at a time straight from the encoded bytes and
+// merge-joins it against targets, which must be sorted by key. onMatch returns
+// false to stop early. Decoding also stops once the largest target has been
+// passed.
+template <typename Iterator, typename Key, typename Callback>
+auto golomb_match(
+    const std::uint32_t N,
+    const std::uint8_t P,
+    const ReadView encoded,
+    Iterator target,
+    const Iterator end,
+    const Key& key,
+    const Callback& onMatch) noexcept -> void
+{
+    if (target == end) { return; }
+
+    auto stream = BitReader{encoded};
+    auto value = std::uint64_t{0};
+
+    for (auto i = std::uint32_t{0}; i < N; ++i) {
+        value += golomb_decode(P, stream);
+
+        while (key(*target) < value) {
+            if (++target == end) { return; }
+        }
+
+        while (key(*target) == value) {
+            if (false == onMatch(*target)) { return; }
+            if (++target == end) { return; }
+        }
+    }
+}
+
 auto GolombDecode(
     const std::uint32_t N,
     const std::uint8_t P,
     const Space& encoded) noexcept(false) -> std::vector<std::uint64_t>
 {
     auto output = std::vector<std::uint64_t>{};
-    auto stream = BitReader(encoded);
+    output.reserve(N);
+    auto stream = BitReader{reader(encoded)};
     auto last = std::uint64_t{0};
 
     for (auto i = std::size_t{0}; i < N; ++i) {
@@ -204,54 +303,52 @@ auto GolombEncode(
     return output;
 }
 
-auto siphash(
-    const api::Core& api,
-    const ReadView key,
-    const ReadView item) noexcept(false) -> std::uint64_t
+auto hash_to_range(const std::uint64_t hash, const std::uint64_t range) noexcept
+    -> std::uint64_t
 {
-    if (16 != key.size()) { throw std::runtime_error("Invalid key"); }
-
-    auto output = std::uint64_t{};
-    auto writer = [&output](const auto size) -> WritableView {
-        if (sizeof(output) != size) { throw std::out_of_range("wrong size"); }
-
-        return {&output, sizeof(output)};
-    };
-
-    if (false == api.Crypto().Hash().HMAC(
-                     proto::HASHTYPE_SIPHASH24, key, item, writer)) {
-        throw std::runtime_error("siphash failed");
-    }
-
-    return output;
+#if defined(__SIZEOF_INT128__)
+    return static_cast<std::uint64_t>(
+        (static_cast<unsigned __int128>(hash) * range) >> 64u);
+#else
+    return ((mp::uint128_t{hash} * mp::uint128_t{range}) >> 64u)
+        .convert_to<std::uint64_t>();
+#endif
 }
 
 auto HashToRange(
-    const api::Core& api,
+    const api::Core&,
     const ReadView key,
     const std::uint64_t range,
     const ReadView item) noexcept(false) -> std::uint64_t
 {
-    return ((mp::uint128_t{siphash(api, key, item)} * mp::uint128_t{range}) >>
-            64u)
-        .convert_to<std::uint64_t>();
+    return hash_to_range(blockchain::internal::SipHash{key}(item), range);
 }
 
 auto HashedSetConstruct(
-    const api::Core& api,
+    const api::Core&,
     const ReadView key,
     const std::uint32_t N,
     const std::uint32_t M,
     const std::vector<ReadView> items) noexcept(false)
     -> std::vector<std::uint64_t>
 {
-    auto output = std::vector<std::uint64_t>{};
-    const auto range = std::uint64_t{N} * std::uint64_t{M};
+    return HashedSetConstruct(
+        blockchain::internal::SipHash{key},
+        std::uint64_t{N} * std::uint64_t{M},
+        items);
+}
+
+auto HashedSetConstruct(
+    const blockchain::internal::SipHash& hasher,
+    const std::uint64_t range,
+    const std::vector<ReadView>& items) noexcept -> std::vector<std::uint64_t>
+{
+    auto output = hasher.Batch(items);
     std::transform(
-        std::begin(items),
-        std::end(items),
-        std::back_inserter(output),
-        [&](const auto& item) { return HashToRange(api, key, range, item); });
+        std::begin(output),
+        std::end(output),
+        std::begin(output),
+        [&](const auto& hash) { return hash_to_range(hash, range); });
     std::sort(output.begin(), output.end());
 
     return output;
@@ -266,15 +363,19 @@ GCS::GCS(
     const std::uint32_t fpRate,
     const std::uint32_t filterElementCount,
     const ReadView key,
-    const ReadView encoded) noexcept(false)
+    const ReadView encoded,
+    const bool borrow) noexcept(false)
     : version_(1)
     , api_(api)
     , bits_(bits)
     , false_positive_rate_(fpRate)
     , count_(filterElementCount)
     , elements_()
-    , compressed_(api_.Factory().Data(encoded))
+    , compressed_(
+          borrow ? api_.Factory().Data() : api_.Factory().Data(encoded))
+    , filter_(borrow ? encoded : compressed_->Bytes())
     , key_(api_.Factory().Data(key))
+    , hasher_(key_->Bytes())
 {
     if (16u != key_->size()) {
         throw std::runtime_error(
@@ -294,14 +395,14 @@ GCS::GCS(
     , false_positive_rate_(fpRate)
     , count_(elements.size())
     , elements_(gcs::HashedSetConstruct(
-          api_,
-          key,
-          static_cast<std::uint32_t>(elements.size()),
-          false_positive_rate_,
+          internal::SipHash{key},
+          std::uint64_t{count_} * std::uint64_t{false_positive_rate_},
           elements))
     , compressed_(
           api_.Factory().Data(reader(gcs::GolombEncode(bits_, *elements_))))
+    , filter_(compressed_->Bytes())
     , key_(api_.Factory().Data(key))
+    , hasher_(key_->Bytes())
 {
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wtautological-type-limit-compare"
@@ -320,32 +421,14 @@ GCS::GCS(
 
 auto GCS::Compressed() const noexcept -> Space
 {
-    return {reinterpret_cast<const std::byte*>(compressed_->data()),
-            reinterpret_cast<const std::byte*>(compressed_->data()) +
-                compressed_->size()};
-}
-
-auto GCS::decompress() const noexcept -> const Elements&
-{
-    if (false == elements_.has_value()) {
-        auto& set = const_cast<std::optional<Elements>&>(elements_);
-        set = gcs::GolombDecode(
-            count_,
-            bits_,
-            Space{reinterpret_cast<const std::byte*>(compressed_->data()),
-                  reinterpret_cast<const std::byte*>(compressed_->data()) +
-                      compressed_->size()});
-        std::sort(set.value().begin(), set.value().end());
-    }
-
-    return elements_.value();
+    return space(filter_);
 }
 
 auto GCS::Encode() const noexcept -> OTData
 {
     const auto bytes = bitcoin::CompactSize(count_).Encode();
     auto output = Data::Factory(bytes.data(), bytes.size());
-    output->Concatenate(compressed_->data(), compressed_->size());
+    output->Concatenate(filter_.data(), filter_.size());
 
     return output;
 }
@@ -370,60 +453,81 @@ auto GCS::hashed_set_construct(const std::vector<Space>& elements) const
 auto GCS::hashed_set_construct(const std::vector<ReadView>& elements) const
     noexcept -> std::vector<std::uint64_t>
 {
-    return gcs::HashedSetConstruct(
-        api_, key_->Bytes(), count_, false_positive_rate_, elements);
-}
-
-auto GCS::hash_to_range(const ReadView in) const noexcept -> std::uint64_t
-{
-    return gcs::HashToRange(
-        api_, key_->Bytes(), count_ * false_positive_rate_, in);
+    return gcs::HashedSetConstruct(hasher_, range(), elements);
 }
 
 auto GCS::Match(const Targets& targets) const noexcept -> Matches
 {
     auto output = Matches{};
-    auto hashed = std::vector<std::uint64_t>{};
-    auto matches = std::vector<std::uint64_t>{};
-    auto map = std::map<std::uint64_t, Targets::const_iterator>{};
-    const auto& set = decompress();
-
-    for (auto i = targets.cbegin(); i != targets.cend(); ++i) {
-        const auto& hash = hashed.emplace_back(hash_to_range(*i));
-        map.emplace(hash, i);
+    const auto range = this->range();
+    auto hashed = std::vector<std::pair<std::uint64_t, std::size_t>>{};
+    hashed.reserve(targets.size());
+
+    {
+        const auto hashes = hasher_.Batch(targets);
+
+        for (auto i = std::size_t{0}; i < hashes.size(); ++i) {
+            hashed.emplace_back(gcs::hash_to_range(hashes[i], range), i);
+        }
     }
 
     std::sort(std::begin(hashed), std::end(hashed));
-    std::set_intersection(
+    gcs::golomb_match(
+        count_,
+        bits_,
+        filter_,
         std::begin(hashed),
         std::end(hashed),
-        std::begin(set),
-        std::end(set),
-        std::back_inserter(matches));
-    std::transform(
-        std::begin(matches),
-        std::end(matches),
-        std::back_inserter(output),
-        [&](const auto& in) { return map.at(in); });
+        [](const auto& item) { return item.first; },
+        [&](const auto& item) {
+            output.emplace_back(std::next(targets.cbegin(), item.second));
+
+            return true;
+        });
 
     return output;
 }
 
+auto GCS::range() const noexcept -> std::uint64_t
+{
+    return std::uint64_t{count_} * std::uint64_t{false_positive_rate_};
+}
+
 auto GCS::Serialize() const noexcept -> proto::GCS
 {
-    const auto encoded = Compressed();
     auto output = proto::GCS{};
     output.set_version(version_);
     output.set_bits(bits_);
     output.set_fprate(false_positive_rate_);
     output.set_key(key_->data(), key_->size());
     output.set_count(count_);
-    output.set_filter(
-        reinterpret_cast<const char*>(encoded.data()), encoded.size());
+    output.set_filter(filter_.data(), filter_.size());
 
     return output;
 }
 
+auto GCS::Serialize(AllocateOutput out) const noexcept -> bool
+{
+    using Header = internal::SerializedFilter;
+
+    if (false == bool(out)) { return false; }
+
+    const auto header =
+        Header{bits_, false_positive_rate_, count_, key_->Bytes()};
+    auto bytes = out(sizeof(header) + filter_.size());
+
+    if (false == bytes.valid(sizeof(header) + filter_.size())) {
+        return false;
+    }
+
+    auto* it = static_cast<std::byte*>(bytes.data());
+    std::memcpy(it, &header, sizeof(header));
+    std::advance(it, sizeof(header));
+    std::memcpy(it, filter_.data(), filter_.size());
+
+    return true;
+}
+
 auto GCS::Test(const Data& target) const noexcept -> bool
 {
     return Test(target.Bytes());
@@ -446,16 +550,21 @@ auto GCS::Test(const std::vector<Space>& targets) const noexcept -> bool
 
 auto GCS::test(const std::vector<std::uint64_t>& targets) const noexcept -> bool
 {
-    const auto& set = decompress();
-    auto matches = std::vector<std::uint64_t>{};
-    std::set_intersection(
+    auto output{false};
+    gcs::golomb_match(
+        count_,
+        bits_,
+        filter_,
         std::begin(targets),
         std::end(targets),
-        std::begin(set),
-        std::end(set),
-        std::back_inserter(matches));
+        [](const auto& item) { return item; },
+        [&](const auto&) {
+            output = true;
+
+            return false;
+        });
 
-    return 0 < matches.size();
+    return output;
 }
 
 auto GCS::transform(const std::vector<OTData>& in) noexcept
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <optional>
 #include <vector>
@@ -34,11 +35,16 @@ class GCS final : virtual public internal::GCS
 {
 public:
     auto Compressed() const noexcept -> Space final;
+    auto CompressedSize() const noexcept -> std::size_t final
+    {
+        return filter_.size();
+    }
     auto ElementCount() const noexcept -> std::uint32_t final { return count_; }
     auto Encode() const noexcept -> OTData final;
     auto Hash() const noexcept -> OTData final;
     auto Match(const Targets&) const noexcept -> Matches final;
     auto Serialize() const noexcept -> proto::GCS final;
+    auto Serialize(AllocateOutput out) const noexcept -> bool final;
     auto Test(const Data& target) const noexcept -> bool final;
     auto Test(const ReadView target) const noexcept -> bool final;
     auto Test(const std::vector<OTData>& targets) const noexcept -> bool final;
@@ -49,7 +55,8 @@ public:
         const std::uint32_t fpRate,
         const std::uint32_t filterElementCount,
         const ReadView key,
-        const ReadView encoded)
+        const ReadView encoded,
+        const bool borrow)
     noexcept(false);
     GCS(const api::Core& api,
         const std::uint8_t bits,
@@ -71,15 +78,17 @@ private:
     const std::uint32_t false_positive_rate_;
     const std::uint32_t count_;
     const std::optional<Elements> elements_;
+    // Empty if the encoded filter is borrowed
     const OTData compressed_;
+    const ReadView filter_;
     const OTData key_;
+    const internal::SipHash hasher_;
 
     static auto transform(const std::vector<OTData>& in) noexcept
         -> std::vector<ReadView>;
     static auto transform(const std::vector<Space>& in) noexcept
         -> std::vector<ReadView>;
 
-    auto decompress() const noexcept -> const Elements&;
     auto hashed_set_construct(const std::vector<OTData>& elements) const
         noexcept -> std::vector<std::uint64_t>;
     auto hashed_set_construct(const std::vector<Space>& elements) const noexcept
@@ -88,7 +97,7 @@ private:
         noexcept -> std::vector<std::uint64_t>;
     auto test(const std::vector<std::uint64_t>& targetHashes) const noexcept
         -> bool;
-    auto hash_to_range(const ReadView in) const noexcept -> std::uint64_t;
+    auto range() const noexcept -> std::uint64_t;
 
     GCS() = delete;
     GCS(const GCS&) = delete;
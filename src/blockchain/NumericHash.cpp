@@ -7,12 +7,8 @@
 #include "1_Internal.hpp"              // IWYU pragma: associated
 #include "blockchain/NumericHash.hpp"  // IWYU pragma: associated
 
-#include <boost/endian/buffers.hpp>
-#include <algorithm>
 #include <cstddef>
 #include <cstdint>
-#include <iterator>
-#include <vector>
 
 #include "Factory.hpp"
 #include "opentxs/Pimpl.hpp"
@@ -21,11 +17,8 @@
 #include "opentxs/core/Data.hpp"
 #include "opentxs/core/Log.hpp"
 #include "opentxs/core/LogSource.hpp"
-#include "opentxs/iterator/Bidirectional.hpp"
 
-#define OT_METHOD "opentxs::blockchain::implementation::NumericHash::"
-
-namespace be = boost::endian;
+// #define OT_METHOD "opentxs::blockchain::implementation::NumericHash::"
 
 namespace opentxs
 {
@@ -33,23 +26,18 @@ blockchain::NumericHash* Factory::NumericHashNBits(const std::int32_t input)
 {
     using ReturnType = blockchain::implementation::NumericHash;
     using ArgumentType = ReturnType::Type;
-    using MantissaType = mp::checked_cpp_int;
 
-    const be::big_int32_buf_t big{input};
-    const auto nBits = Data::Factory(&big, sizeof(big));
-    auto exponent{std::to_integer<std::uint8_t>(nBits->at(0))};
-    MantissaType mantissa{};
-    auto it = nBits->begin();
-    ++it;
-    mp::import_bits(mantissa, it, nBits->end(), 8, true);
+    const auto nBits = static_cast<std::uint32_t>(input);
+    const auto exponent = std::size_t{nBits >> 24};
+    const auto mantissa = ArgumentType{nBits & 0x00ffffff};
 
-    if (mantissa < 0) { return new ReturnType(); }
+    if (3 > exponent) {
+        return new ReturnType(mantissa >> (8 * (3 - exponent)));
+    }
 
-    ArgumentType value{};
+    const auto shift = 8 * (exponent - 3);
 
-    try {
-        value = ArgumentType{mantissa << (8 * (exponent - 3))};
-    } catch (...) {
+    if ((mantissa.Bits() + shift) > ArgumentType::bits_) {
         LogOutput("opentxs::Factory::")(__FUNCTION__)(
             ": Failed to calculate target")
             .Flush();
@@ -57,7 +45,7 @@ blockchain::NumericHash* Factory::NumericHashNBits(const std::int32_t input)
         return new ReturnType();
     }
 
-    return new ReturnType(value);
+    return new ReturnType(mantissa << shift);
 }
 
 blockchain::NumericHash* Factory::NumericHash(
@@ -70,7 +58,7 @@ blockchain::NumericHash* Factory::NumericHash(
 
     try {
         // Interpret hash as little endian
-        mp::import_bits(value, hash.begin(), hash.end(), 8, false);
+        value = ReturnType::Type::LittleEndian(hash.Bytes());
     } catch (...) {
         LogOutput("opentxs::Factory::")(__FUNCTION__)(": Failed to decode hash")
             .Flush();
@@ -163,18 +151,8 @@ bool NumericHash::operator<=(const blockchain::NumericHash& rhs) const noexcept
 
 std::string NumericHash::asHex(const std::size_t minimumBytes) const noexcept
 {
-    std::vector<unsigned char> bytes;
-
-    try {
-        // Export as big endian
-        mp::export_bits(data_, std::back_inserter(bytes), 8, true);
-    } catch (...) {
-        LogOutput(OT_METHOD)(__FUNCTION__)(": Failed to encode number").Flush();
-
-        return {};
-    }
-
-    while (minimumBytes > bytes.size()) { bytes.insert(bytes.begin(), 0x0); }
+    // Export as big endian
+    const auto bytes = data_.Encode(minimumBytes);
 
     return opentxs::Data::Factory(bytes.data(), bytes.size())->asHex();
 }
@@ -8,10 +8,10 @@
 
 #pragma once
 
-#include <boost/multiprecision/cpp_int.hpp>
 #include <iosfwd>
 #include <string>
 
+#include "internal/blockchain/Blockchain.hpp"
 #include "opentxs/blockchain/NumericHash.hpp"
 
 namespace opentxs
@@ -19,14 +19,12 @@ namespace opentxs
 class Factory;
 }  // namespace opentxs
 
-namespace mp = boost::multiprecision;
-
 namespace opentxs::blockchain::implementation
 {
 class NumericHash : virtual public blockchain::NumericHash
 {
 public:
-    using Type = mp::checked_cpp_int;
+    using Type = internal::UInt256;
 
     bool operator==(const blockchain::NumericHash& rhs) const noexcept final;
     bool operator!=(const blockchain::NumericHash& rhs) const noexcept final;
@@ -34,7 +32,7 @@ public:
     bool operator<=(const blockchain::NumericHash& rhs) const noexcept final;
 
     std::string asHex(const std::size_t minimumBytes) const noexcept final;
-    std::string Decimal() const noexcept final { return data_.str(); }
+    std::string Decimal() const noexcept final { return data_.Decimal(); }
 
     ~NumericHash() final = default;
 
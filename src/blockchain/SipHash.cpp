@@ -0,0 +1,459 @@
+// Copyright (c) 2010-2020 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "0_stdafx.hpp"                        // IWYU pragma: associated
+#include "1_Internal.hpp"                      // IWYU pragma: associated
+#include "internal/blockchain/Blockchain.hpp"  // IWYU pragma: associated
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) &&                              \
+    (defined(__GNUC__) || defined(__clang__))
+#define OT_SIPHASH_X86 1
+#include <immintrin.h>
+#else
+#define OT_SIPHASH_X86 0
+#endif
+
+// #define OT_METHOD "opentxs::blockchain::internal::SipHash::"
+
+namespace opentxs::blockchain::internal
+{
+namespace siphash
+{
+constexpr auto c0_ = std::uint64_t{0x736f6d6570736575};
+constexpr auto c1_ = std::uint64_t{0x646f72616e646f6d};
+constexpr auto c2_ = std::uint64_t{0x6c7967656e657261};
+constexpr auto c3_ = std::uint64_t{0x7465646279746573};
+// Items with fewer full blocks than this are eligible for SIMD batching
+constexpr auto staging_ = std::size_t{16};
+
+constexpr auto rotl(const std::uint64_t x, const int b) noexcept
+    -> std::uint64_t
+{
+    return (x << b) | (x >> (64 - b));
+}
+
+inline auto load(const std::byte* in) noexcept -> std::uint64_t
+{
+    const auto* p = reinterpret_cast<const std::uint8_t*>(in);
+
+    return std::uint64_t{p[0]} | (std::uint64_t{p[1]} << 8) |
+           (std::uint64_t{p[2]} << 16) | (std::uint64_t{p[3]} << 24) |
+           (std::uint64_t{p[4]} << 32) | (std::uint64_t{p[5]} << 40) |
+           (std::uint64_t{p[6]} << 48) | (std::uint64_t{p[7]} << 56);
+}
+
+inline auto blocks(const ReadView item) noexcept -> std::size_t
+{
+    return item.size() / 8u;
+}
+
+inline auto block(const ReadView item, const std::size_t i) noexcept
+    -> std::uint64_t
+{
+    return load(reinterpret_cast<const std::byte*>(item.data()) + (i * 8u));
+}
+
+// Last message word: remaining bytes plus the length in the high byte
+inline auto final_block(const ReadView item) noexcept -> std::uint64_t
+{
+    const auto size = item.size();
+    const auto* tail =
+        reinterpret_cast<const std::uint8_t*>(item.data()) + (size & ~0x7u);
+    auto output = std::uint64_t{size} << 56;
+
+    switch (size & 0x7u) {
+        case 7: {
+            output |= std::uint64_t{tail[6]} << 48;
+            [[fallthrough]];
+        }
+        case 6: {
+            output |= std::uint64_t{tail[5]} << 40;
+            [[fallthrough]];
+        }
+        case 5: {
+            output |= std::uint64_t{tail[4]} << 32;
+            [[fallthrough]];
+        }
+        case 4: {
+            output |= std::uint64_t{tail[3]} << 24;
+            [[fallthrough]];
+        }
+        case 3: {
+            output |= std::uint64_t{tail[2]} << 16;
+            [[fallthrough]];
+        }
+        case 2: {
+            output |= std::uint64_t{tail[1]} << 8;
+            [[fallthrough]];
+        }
+        case 1: {
+            output |= std::uint64_t{tail[0]};
+            [[fallthrough]];
+        }
+        default: {
+        }
+    }
+
+    return output;
+}
+
+struct Scalar {
+    std::uint64_t v0_;
+    std::uint64_t v1_;
+    std::uint64_t v2_;
+    std::uint64_t v3_;
+
+    auto compress(const std::uint64_t m) noexcept -> void
+    {
+        v3_ ^= m;
+        round();
+        round();
+        v0_ ^= m;
+    }
+    auto finalize() noexcept -> std::uint64_t
+    {
+        v2_ ^= 0xff;
+        round();
+        round();
+        round();
+        round();
+
+        return v0_ ^ v1_ ^ v2_ ^ v3_;
+    }
+    auto round() noexcept -> void
+    {
+        v0_ += v1_;
+        v1_ = rotl(v1_, 13);
+        v1_ ^= v0_;
+        v0_ = rotl(v0_, 32);
+        v2_ += v3_;
+        v3_ = rotl(v3_, 16);
+        v3_ ^= v2_;
+        v0_ += v3_;
+        v3_ = rotl(v3_, 21);
+        v3_ ^= v0_;
+        v2_ += v1_;
+        v1_ = rotl(v1_, 17);
+        v1_ ^= v2_;
+        v2_ = rotl(v2_, 32);
+    }
+
+    Scalar(const std::uint64_t k0, const std::uint64_t k1) noexcept
+        : v0_(k0 ^ c0_)
+        , v1_(k1 ^ c1_)
+        , v2_(k0 ^ c2_)
+        , v3_(k1 ^ c3_)
+    {
+    }
+};
+
+auto hash(
+    const std::uint64_t k0,
+    const std::uint64_t k1,
+    const ReadView item) noexcept -> std::uint64_t
+{
+    auto state = Scalar{k0, k1};
+
+    for (auto i = std::size_t{0}, end = blocks(item); i < end; ++i) {
+        state.compress(block(item, i));
+    }
+
+    state.compress(final_block(item));
+
+    return state.finalize();
+}
+
+#if OT_SIPHASH_X86
+// Each lane hashes a different item. All items in a group must contain the
+// same number of full 8 byte blocks so the lanes stay in lockstep.
+#define OT_SIPHASH_ROUND(ADD, XOR, ROTL, ROTL16, SWAP)                         \
+    v0 = ADD(v0, v1);                                                          \
+    v1 = ROTL(v1, 13);                                                         \
+    v1 = XOR(v1, v0);                                                          \
+    v0 = SWAP(v0);                                                             \
+    v2 = ADD(v2, v3);                                                          \
+    v3 = ROTL16(v3);                                                           \
+    v3 = XOR(v3, v2);                                                          \
+    v0 = ADD(v0, v3);                                                          \
+    v3 = ROTL(v3, 21);                                                         \
+    v3 = XOR(v3, v0);                                                          \
+    v2 = ADD(v2, v1);                                                          \
+    v1 = ROTL(v1, 17);                                                         \
+    v1 = XOR(v1, v2);                                                          \
+    v2 = SWAP(v2)
+
+#define OT_SIPHASH_SSE2_ROTL(x, b)                                             \
+    _mm_or_si128(_mm_slli_epi64((x), (b)), _mm_srli_epi64((x), 64 - (b)))
+#define OT_SIPHASH_SSE2_ROTL16(x)                                              \
+    _mm_shufflehi_epi16(                                                       \
+        _mm_shufflelo_epi16((x), _MM_SHUFFLE(2, 1, 0, 3)),                     \
+        _MM_SHUFFLE(2, 1, 0, 3))
+#define OT_SIPHASH_SSE2_SWAP(x) _mm_shuffle_epi32((x), _MM_SHUFFLE(2, 3, 0, 1))
+#define OT_SIPHASH_SSE2_ROUND()                                                \
+    OT_SIPHASH_ROUND(                                                          \
+        _mm_add_epi64,                                                         \
+        _mm_xor_si128,                                                         \
+        OT_SIPHASH_SSE2_ROTL,                                                  \
+        OT_SIPHASH_SSE2_ROTL16,                                                \
+        OT_SIPHASH_SSE2_SWAP)
+#define OT_SIPHASH_SSE2_COMPRESS(m)                                            \
+    v3 = _mm_xor_si128(v3, (m));                                               \
+    OT_SIPHASH_SSE2_ROUND();                                                   \
+    OT_SIPHASH_SSE2_ROUND();                                                   \
+    v0 = _mm_xor_si128(v0, (m))
+
+__attribute__((target("sse2"))) auto hash_sse2(
+    const std::uint64_t k0,
+    const std::uint64_t k1,
+    const ReadView* items,
+    const std::size_t count,
+    std::uint64_t* output) noexcept -> void
+{
+    const auto& a = items[0];
+    const auto& b = items[1];
+    auto v0 = _mm_set1_epi64x(static_cast<long long>(k0 ^ c0_));
+    auto v1 = _mm_set1_epi64x(static_cast<long long>(k1 ^ c1_));
+    auto v2 = _mm_set1_epi64x(static_cast<long long>(k0 ^ c2_));
+    auto v3 = _mm_set1_epi64x(static_cast<long long>(k1 ^ c3_));
+    auto m = __m128i{};
+
+    for (auto i = std::size_t{0}; i < count; ++i) {
+        m = _mm_set_epi64x(
+            static_cast<long long>(block(b, i)),
+            static_cast<long long>(block(a, i)));
+        OT_SIPHASH_SSE2_COMPRESS(m);
+    }
+
+    m = _mm_set_epi64x(
+        static_cast<long long>(final_block(b)),
+        static_cast<long long>(final_block(a)));
+    OT_SIPHASH_SSE2_COMPRESS(m);
+    v2 = _mm_xor_si128(v2, _mm_set1_epi64x(0xff));
+    OT_SIPHASH_SSE2_ROUND();
+    OT_SIPHASH_SSE2_ROUND();
+    OT_SIPHASH_SSE2_ROUND();
+    OT_SIPHASH_SSE2_ROUND();
+    const auto result =
+        _mm_xor_si128(_mm_xor_si128(v0, v1), _mm_xor_si128(v2, v3));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output), result);
+}
+
+#define OT_SIPHASH_AVX2_ROTL(x, b)                                             \
+    _mm256_or_si256(                                                           \
+        _mm256_slli_epi64((x), (b)), _mm256_srli_epi64((x), 64 - (b)))
+#define OT_SIPHASH_AVX2_ROTL16(x)                                              \
+    _mm256_shufflehi_epi16(                                                    \
+        _mm256_shufflelo_epi16((x), _MM_SHUFFLE(2, 1, 0, 3)),                  \
+        _MM_SHUFFLE(2, 1, 0, 3))
+#define OT_SIPHASH_AVX2_SWAP(x)                                                \
+    _mm256_shuffle_epi32((x), _MM_SHUFFLE(2, 3, 0, 1))
+#define OT_SIPHASH_AVX2_ROUND()                                                \
+    OT_SIPHASH_ROUND(                                                          \
+        _mm256_add_epi64,                                                      \
+        _mm256_xor_si256,                                                      \
+        OT_SIPHASH_AVX2_ROTL,                                                  \
+        OT_SIPHASH_AVX2_ROTL16,                                                \
+        OT_SIPHASH_AVX2_SWAP)
+#define OT_SIPHASH_AVX2_COMPRESS(m)                                            \
+    v3 = _mm256_xor_si256(v3, (m));                                            \
+    OT_SIPHASH_AVX2_ROUND();                                                   \
+    OT_SIPHASH_AVX2_ROUND();                                                   \
+    v0 = _mm256_xor_si256(v0, (m))
+
+__attribute__((target("avx2"))) auto hash_avx2(
+    const std::uint64_t k0,
+    const std::uint64_t k1,
+    const ReadView* items,
+    const std::size_t count,
+    std::uint64_t* output) noexcept -> void
+{
+    const auto& a = items[0];
+    const auto& b = items[1];
+    const auto& c = items[2];
+    const auto& d = items[3];
+    auto v0 = _mm256_set1_epi64x(static_cast<long long>(k0 ^ c0_));
+    auto v1 = _mm256_set1_epi64x(static_cast<long long>(k1 ^ c1_));
+    auto v2 = _mm256_set1_epi64x(static_cast<long long>(k0 ^ c2_));
+    auto v3 = _mm256_set1_epi64x(static_cast<long long>(k1 ^ c3_));
+    auto m = __m256i{};
+
+    for (auto i = std::size_t{0}; i < count; ++i) {
+        m = _mm256_set_epi64x(
+            static_cast<long long>(block(d, i)),
+            static_cast<long long>(block(c, i)),
+            static_cast<long long>(block(b, i)),
+            static_cast<long long>(block(a, i)));
+        OT_SIPHASH_AVX2_COMPRESS(m);
+    }
+
+    m = _mm256_set_epi64x(
+        static_cast<long long>(final_block(d)),
+        static_cast<long long>(final_block(c)),
+        static_cast<long long>(final_block(b)),
+        static_cast<long long>(final_block(a)));
+    OT_SIPHASH_AVX2_COMPRESS(m);
+    v2 = _mm256_xor_si256(v2, _mm256_set1_epi64x(0xff));
+    OT_SIPHASH_AVX2_ROUND();
+    OT_SIPHASH_AVX2_ROUND();
+    OT_SIPHASH_AVX2_ROUND();
+    OT_SIPHASH_AVX2_ROUND();
+    const auto result =
+        _mm256_xor_si256(_mm256_xor_si256(v0, v1), _mm256_xor_si256(v2, v3));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(output), result);
+}
+
+#undef OT_SIPHASH_AVX2_COMPRESS
+#undef OT_SIPHASH_AVX2_ROUND
+#undef OT_SIPHASH_AVX2_SWAP
+#undef OT_SIPHASH_AVX2_ROTL16
+#undef OT_SIPHASH_AVX2_ROTL
+#undef OT_SIPHASH_SSE2_COMPRESS
+#undef OT_SIPHASH_SSE2_ROUND
+#undef OT_SIPHASH_SSE2_SWAP
+#undef OT_SIPHASH_SSE2_ROTL16
+#undef OT_SIPHASH_SSE2_ROTL
+#undef OT_SIPHASH_ROUND
+#endif  // OT_SIPHASH_X86
+
+auto supported() noexcept -> SipHash::Lanes
+{
+#if OT_SIPHASH_X86
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2")) { return SipHash::Lanes::AVX2; }
+    if (__builtin_cpu_supports("sse2")) { return SipHash::Lanes::SSE2; }
+#endif  // OT_SIPHASH_X86
+
+    return SipHash::Lanes::Scalar;
+}
+
+auto capability() noexcept -> SipHash::Lanes
+{
+    static const auto lanes = supported();
+
+    return lanes;
+}
+}  // namespace siphash
+
+SipHash::SipHash(const ReadView key) noexcept(false)
+    : k0_()
+    , k1_()
+{
+    if (16u != key.size()) {
+        throw std::runtime_error(
+            "Invalid key size: " + std::to_string(key.size()));
+    }
+
+    const auto* bytes = reinterpret_cast<const std::byte*>(key.data());
+    k0_ = siphash::load(bytes);
+    k1_ = siphash::load(bytes + 8u);
+}
+
+auto SipHash::Best() noexcept -> Lanes
+{
+    const auto lanes = siphash::capability();
+
+#if defined(__x86_64__)
+    // Two lanes do not beat native 64 bit rotates
+    if (Lanes::SSE2 == lanes) { return Lanes::Scalar; }
+#endif  // __x86_64__
+
+    return lanes;
+}
+
+auto SipHash::operator()(const ReadView item) const noexcept -> std::uint64_t
+{
+    return siphash::hash(k0_, k1_, item);
+}
+
+auto SipHash::Batch(const std::vector<ReadView>& items) const noexcept
+    -> Hashes
+{
+    return Batch(items, Best());
+}
+
+auto SipHash::Batch(const std::vector<ReadView>& items, const Lanes requested)
+    const noexcept -> Hashes
+{
+    auto output = Hashes(items.size());
+    const auto lanes = static_cast<std::size_t>(
+        std::min(static_cast<std::uint8_t>(requested),
+                 static_cast<std::uint8_t>(siphash::capability())));
+
+    if ((1u == lanes) || (items.size() < lanes)) {
+        std::transform(
+            std::begin(items),
+            std::end(items),
+            std::begin(output),
+            [this](const auto& item) { return (*this)(item); });
+
+        return output;
+    }
+
+#if OT_SIPHASH_X86
+    // Items are staged by block count so that every lane in a SIMD batch
+    // runs the same number of compression rounds. Items longer than the
+    // staging table covers are hashed individually.
+    struct Pending {
+        std::array<std::size_t, 4> index_{};
+        std::array<ReadView, 4> item_{};
+        std::size_t size_{};
+    };
+
+    auto pending = std::array<Pending, siphash::staging_>{};
+    auto hashes = std::array<std::uint64_t, 4>{};
+    const auto run = [&](const std::size_t count, Pending& group) {
+        if (4u == lanes) {
+            siphash::hash_avx2(
+                k0_, k1_, group.item_.data(), count, hashes.data());
+        } else {
+            siphash::hash_sse2(
+                k0_, k1_, group.item_.data(), count, hashes.data());
+        }
+
+        for (auto j = std::size_t{0}; j < lanes; ++j) {
+            output[group.index_[j]] = hashes[j];
+        }
+
+        group.size_ = 0;
+    };
+
+    for (auto i = std::size_t{0}; i < items.size(); ++i) {
+        const auto& item = items[i];
+        const auto count = siphash::blocks(item);
+
+        if (count >= pending.size()) {
+            output[i] = siphash::hash(k0_, k1_, item);
+
+            continue;
+        }
+
+        auto& group = pending[count];
+        group.index_[group.size_] = i;
+        group.item_[group.size_] = item;
+
+        if (lanes == ++group.size_) { run(count, group); }
+    }
+
+    for (const auto& group : pending) {
+        for (auto j = std::size_t{0}; j < group.size_; ++j) {
+            output[group.index_[j]] =
+                siphash::hash(k0_, k1_, group.item_[j]);
+        }
+    }
+#endif  // OT_SIPHASH_X86
+
+    return output;
+}
+}  // namespace opentxs::blockchain::internal
@@ -0,0 +1,103 @@
+// Copyright (c) 2010-2020 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "0_stdafx.hpp"                        // IWYU pragma: associated
+#include "1_Internal.hpp"                      // IWYU pragma: associated
+#include "internal/blockchain/Blockchain.hpp"  // IWYU pragma: associated
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "opentxs/Bytes.hpp"
+
+// #define OT_METHOD "opentxs::blockchain::internal::UInt256::"
+
+namespace opentxs::blockchain::internal
+{
+auto UInt256::BigEndian(const ReadView bytes) noexcept(false) -> UInt256
+{
+    const auto* it = reinterpret_cast<const std::uint8_t*>(bytes.data());
+    const auto* end = it + bytes.size();
+
+    while ((it != end) && (0 == *it)) { ++it; }
+
+    if (static_cast<std::size_t>(end - it) > (bits_ / 8)) {
+        throw std::out_of_range("Input exceeds 256 bits");
+    }
+
+    auto output = Limbs{};
+
+    for (auto position = std::size_t{0}; end != it; ++position) {
+        --end;
+        output[position / 8] |= std::uint64_t{*end} << (8 * (position % 8));
+    }
+
+    return UInt256{output};
+}
+
+auto UInt256::LittleEndian(const ReadView bytes) noexcept(false) -> UInt256
+{
+    const auto* begin = reinterpret_cast<const std::uint8_t*>(bytes.data());
+    const auto* end = begin + bytes.size();
+
+    while ((begin != end) && (0 == *(end - 1))) { --end; }
+
+    if (static_cast<std::size_t>(end - begin) > (bits_ / 8)) {
+        throw std::out_of_range("Input exceeds 256 bits");
+    }
+
+    auto output = Limbs{};
+
+    for (auto position = std::size_t{0}; end != begin; ++position, ++begin) {
+        output[position / 8] |= std::uint64_t{*begin} << (8 * (position % 8));
+    }
+
+    return UInt256{output};
+}
+
+auto UInt256::Decimal() const noexcept -> std::string
+{
+    // Largest power of ten which fits in a limb
+    constexpr auto chunk = std::uint64_t{10000000000000000000u};
+    constexpr auto digits = std::size_t{19};
+
+    if (IsZero()) { return "0"; }
+
+    auto output = std::string{};
+    auto value = *this;
+
+    while (false == value.IsZero()) {
+        const auto [quotient, remainder] = value.DivMod(chunk);
+        auto part = std::to_string(remainder.limbs_[0]);
+
+        if (false == quotient.IsZero()) {
+            part.insert(0, digits - part.size(), '0');
+        }
+
+        output.insert(0, part);
+        value = quotient;
+    }
+
+    return output;
+}
+
+auto UInt256::Encode(const std::size_t minimumBytes) const noexcept -> Space
+{
+    const auto significant = std::max<std::size_t>((Bits() + 7) / 8, 1);
+    auto output = Space(std::max(significant, minimumBytes), std::byte{0x0});
+    auto it = output.rbegin();
+
+    for (auto position = std::size_t{0}; position < significant; ++position) {
+        const auto& limb = limbs_[position / 8];
+        *it++ = static_cast<std::byte>(limb >> (8 * (position % 8)));
+    }
+
+    return output;
+}
+}  // namespace opentxs::blockchain::internal
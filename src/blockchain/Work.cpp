@@ -7,11 +7,12 @@
 #include "1_Internal.hpp"       // IWYU pragma: associated
 #include "blockchain/Work.hpp"  // IWYU pragma: associated
 
-#include <iterator>
+#include <cstddef>
+#include <stdexcept>
 #include <utility>
-#include <vector>
 
 #include "Factory.hpp"
+#include "blockchain/NumericHash.hpp"
 #include "opentxs/Pimpl.hpp"
 #include "opentxs/blockchain/NumericHash.hpp"
 #include "opentxs/blockchain/Work.hpp"
@@ -33,12 +34,14 @@ blockchain::Work* Factory::Work(const std::string& hex)
     if (bytes->empty()) { return new ReturnType(); }
 
     ValueType value{};
-    mp::cpp_int i;
 
     try {
         // Interpret bytes as big endian
-        mp::import_bits(i, bytes->begin(), bytes->end(), 8, true);
-        value = ValueType{i};
+        value = ValueType::BigEndian(bytes->Bytes());
+
+        if (value.Bits() > (ValueType::bits_ - ReturnType::fraction_bits_)) {
+            throw std::out_of_range("Work exceeds fixed point range");
+        }
     } catch (...) {
         LogOutput("opentxs::Factory::")(__FUNCTION__)(": Failed to decode work")
             .Flush();
@@ -46,22 +49,40 @@ blockchain::Work* Factory::Work(const std::string& hex)
         return new ReturnType();
     }
 
-    return new ReturnType(std::move(value));
+    return new ReturnType(value << ReturnType::fraction_bits_);
 }
 
 blockchain::Work* Factory::Work(const blockchain::NumericHash& input)
 {
     using ReturnType = blockchain::implementation::Work;
-    using TargetType = mp::checked_cpp_int;
+    using TargetType = blockchain::implementation::NumericHash;
     using ValueType = ReturnType::Type;
     ValueType value{};
 
     try {
-        const auto maxTarget =
-            Factory::NumericHashNBits(blockchain::NumericHash::MaxTarget);
-        const TargetType targetOne{maxTarget->Decimal()};
-        const TargetType target{input.Decimal()};
-        value = ValueType{targetOne} / ValueType{target};
+        const auto maxTarget = OTNumericHash{
+            Factory::NumericHashNBits(blockchain::NumericHash::MaxTarget)};
+        const auto& targetOne =
+            dynamic_cast<const TargetType&>(maxTarget.get()).data_;
+        const auto& target = dynamic_cast<const TargetType&>(input).data_;
+        auto [integer, remainder] = ValueType::Divide(targetOne, target);
+
+        if (integer.Bits() > (ValueType::bits_ - ReturnType::fraction_bits_)) {
+            throw std::out_of_range("Difficulty exceeds fixed point range");
+        }
+
+        value = integer << ReturnType::fraction_bits_;
+
+        // Long division of the remainder produces the fractional bits
+        for (auto i = ReturnType::fraction_bits_; i > 0; --i) {
+            const auto carry = remainder.Bit(ValueType::bits_ - 1);
+            remainder = remainder << 1;
+
+            if (carry || (remainder >= target)) {
+                remainder = remainder - target;
+                value = value + (ValueType{1} << (i - 1));
+            }
+        }
     } catch (...) {
         LogOutput("opentxs::Factory::")(__FUNCTION__)(
             ": Failed to calculate difficulty")
@@ -172,23 +193,45 @@ bool Work::operator>=(const blockchain::Work& rhs) const noexcept
 OTWork Work::operator+(const blockchain::Work& rhs) const noexcept
 {
     const auto& input = dynamic_cast<const Work&>(rhs);
+    auto sum = data_ + input.data_;
 
-    return OTWork{new Work{data_ + input.data_}};
+    // Saturate rather than wrap
+    if (sum < data_) { sum = Type{} - Type{1}; }
+
+    return OTWork{new Work{std::move(sum)}};
 }
 
 std::string Work::asHex() const noexcept
 {
-    std::vector<unsigned char> bytes;
+    // Export the integer part as big endian
+    const auto bytes = (data_ >> fraction_bits_).Encode();
 
-    try {
-        // Export as big endian
-        mp::export_bits(mp::cpp_int(data_), std::back_inserter(bytes), 8, true);
-    } catch (...) {
-        LogOutput(OT_METHOD)(__FUNCTION__)(": Failed to encode number").Flush();
+    return opentxs::Data::Factory(bytes.data(), bytes.size())->asHex();
+}
 
-        return {};
+std::string Work::Decimal() const noexcept
+{
+    // Enough digits to represent every fractional bit of a limb
+    constexpr auto digits = std::size_t{19};
+    static_assert(64 == fraction_bits_);
+
+    auto output = (data_ >> fraction_bits_).Decimal();
+    auto fraction = data_.Limb(0);
+
+    if (0 == fraction) { return output; }
+
+    output += '.';
+
+    for (auto i = std::size_t{0}; (i < digits) && (0 != fraction); ++i) {
+        const auto scaled = Type{fraction} * 10u;
+        output += static_cast<char>('0' + scaled.Limb(1));
+        fraction = scaled.Limb(0);
     }
 
-    return opentxs::Data::Factory(bytes.data(), bytes.size())->asHex();
+    while ('0' == output.back()) { output.pop_back(); }
+
+    if ('.' == output.back()) { output.pop_back(); }
+
+    return output;
 }
 }  // namespace opentxs::blockchain::implementation
@@ -8,25 +8,37 @@
 
 #pragma once
 
-#include <boost/multiprecision/cpp_bin_float.hpp>
-#include <boost/multiprecision/cpp_int.hpp>
+#include <cstddef>
 #include <string>
 
+#include "internal/blockchain/Blockchain.hpp"
 #include "opentxs/blockchain/Work.hpp"
 
 namespace opentxs
 {
+namespace blockchain
+{
+namespace block
+{
+namespace internal
+{
+struct SerializedHeader;
+}  // namespace internal
+}  // namespace block
+}  // namespace blockchain
+
 class Factory;
 }  // namespace opentxs
 
-namespace mp = boost::multiprecision;
-
 namespace opentxs::blockchain::implementation
 {
 class Work : virtual public blockchain::Work
 {
 public:
-    using Type = mp::cpp_bin_float_double;
+    // Difficulty in fixed point with fraction_bits_ fractional bits
+    using Type = internal::UInt256;
+
+    static constexpr auto fraction_bits_ = std::size_t{64};
 
     bool operator==(const blockchain::Work& rhs) const noexcept final;
     bool operator!=(const blockchain::Work& rhs) const noexcept final;
@@ -37,12 +49,13 @@ public:
     OTWork operator+(const blockchain::Work& rhs) const noexcept final;
 
     std::string asHex() const noexcept final;
-    std::string Decimal() const noexcept final { return data_.str(); }
+    std::string Decimal() const noexcept final;
 
     ~Work() final = default;
 
 private:
     friend opentxs::Factory;
+    friend blockchain::block::internal::SerializedHeader;
 
     Type data_;
 
@@ -7,12 +7,17 @@
 #include "1_Internal.hpp"               // IWYU pragma: associated
 #include "blockchain/block/Header.hpp"  // IWYU pragma: associated
 
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <memory>
 #include <stdexcept>
+#include <string>
 #include <utility>
 
 #include "Factory.hpp"
+#include "blockchain/Work.hpp"
+#include "internal/blockchain/Blockchain.hpp"
 #include "internal/blockchain/block/Block.hpp"
 #include "opentxs/Pimpl.hpp"
 #include "opentxs/Proto.hpp"
@@ -27,6 +32,31 @@
 
 namespace opentxs
 {
+auto Factory::BlockHeader(
+    const api::internal::Core& api,
+    const blockchain::block::Hash& hash,
+    const blockchain::block::internal::SerializedHeader& record) noexcept
+    -> std::unique_ptr<blockchain::block::Header>
+{
+    const auto type = record.Chain();
+
+    switch (type) {
+        case blockchain::Type::Bitcoin:
+        case blockchain::Type::BitcoinCash:
+        case blockchain::Type::Bitcoin_testnet3:
+        case blockchain::Type::BitcoinCash_testnet3: {
+            return BitcoinBlockHeader(api, hash, record);
+        }
+        default: {
+            LogOutput("opentxs::Factory::")(__FUNCTION__)(
+                ": Unsupported type (")(static_cast<std::uint32_t>(type))(")")
+                .Flush();
+
+            return nullptr;
+        }
+    }
+}
+
 auto Factory::GenesisBlockHeader(
     const api::internal::Core& api,
     const blockchain::Type type) noexcept
@@ -63,6 +93,135 @@ pHash BlankHash() noexcept
 }
 }  // namespace opentxs::blockchain::block
 
+namespace opentxs::blockchain::block::internal
+{
+HeaderView::HeaderView(
+    const ReadView hash,
+    const SerializedHeader& record) noexcept(false)
+    : hash_()
+    , record_(record)
+{
+    if (hash_.size() != hash.size()) {
+        throw std::runtime_error(
+            "Invalid hash size: " + std::to_string(hash.size()));
+    }
+
+    std::memcpy(hash_.data(), hash.data(), hash_.size());
+}
+
+auto HeaderView::Work() const noexcept -> OTWork
+{
+    const auto parent = ParentHash();
+    const auto genesis = std::all_of(
+        parent.begin(), parent.end(), [](const auto c) { return 0 == c; });
+
+    if (genesis) {
+        return record_.Difficulty();
+    } else {
+        return record_.Difficulty() + record_.ParentWork();
+    }
+}
+
+SerializedHeader::SerializedHeader(const block::Header& header) noexcept(false)
+    : version_(current_version_)
+    , status_(static_cast<std::uint8_t>(header.LocalState()))
+    , inherit_status_(static_cast<std::uint8_t>(header.InheritedState()))
+    , reserved_()
+    , type_(static_cast<std::uint32_t>(header.Type()))
+    , height_(header.Height())
+    , work_()
+    , inherit_work_()
+    , raw_()
+{
+    static_assert(160 == sizeof(SerializedHeader));
+
+    const auto& bitcoin = dynamic_cast<const block::bitcoin::Header&>(header);
+
+    if (false == bitcoin.Serialize(preallocated(raw_.size(), raw_.data()))) {
+        throw std::runtime_error("Failed to serialize header");
+    }
+
+    encode(header.Difficulty(), work_);
+    encode(header.ParentWork(), inherit_work_);
+}
+
+SerializedHeader::SerializedHeader() noexcept
+    : version_()
+    , status_()
+    , inherit_status_()
+    , reserved_()
+    , type_()
+    , height_()
+    , work_()
+    , inherit_work_()
+    , raw_()
+{
+    static_assert(160 == sizeof(SerializedHeader));
+}
+
+auto SerializedHeader::decode(const WorkBytes& in) noexcept -> OTWork
+{
+    using Work = blockchain::implementation::Work;
+    const auto bytes =
+        ReadView{reinterpret_cast<const char*>(in.data()), in.size()};
+
+    return OTWork{new Work{Work::Type::BigEndian(bytes)}};
+}
+
+auto SerializedHeader::Difficulty() const noexcept -> OTWork
+{
+    return decode(work_);
+}
+
+auto SerializedHeader::encode(
+    const blockchain::Work& in,
+    WorkBytes& out) noexcept -> void
+{
+    using Work = blockchain::implementation::Work;
+    const auto& work = dynamic_cast<const Work&>(in);
+    const auto bytes = work.data_.Encode(out.size());
+    std::memcpy(out.data(), bytes.data(), out.size());
+}
+
+// Offset of the previous block hash in the 80 byte bitcoin header format
+auto SerializedHeader::ParentHash() const noexcept -> ReadView
+{
+    return {reinterpret_cast<const char*>(raw_.data()) + 4, 32};
+}
+
+auto SerializedHeader::ParentWork() const noexcept -> OTWork
+{
+    return decode(inherit_work_);
+}
+
+auto SerializedHeader::Raw() const noexcept -> ReadView
+{
+    return {reinterpret_cast<const char*>(raw_.data()), raw_.size()};
+}
+
+auto SerializedHeader::Read(const ReadView record) noexcept(false)
+    -> const SerializedHeader&
+{
+    if (false == Valid(record)) {
+        throw std::runtime_error("Invalid header record");
+    }
+
+    return *reinterpret_cast<const SerializedHeader*>(record.data());
+}
+
+// Serialized protobuf messages never begin with a byte smaller than 0x08, so
+// the version byte also distinguishes these records from the legacy format
+auto SerializedHeader::Valid(const ReadView record) noexcept -> bool
+{
+    if ((nullptr == record.data()) ||
+        (sizeof(SerializedHeader) != record.size())) {
+        return false;
+    }
+
+    return current_version_ == static_cast<std::uint8_t>(record.front());
+}
+}  // namespace opentxs::blockchain::block::internal
+
 namespace opentxs::blockchain::block::implementation
 {
 const Header::GenesisBlockMap Header::genesis_blocks_{
@@ -135,6 +294,25 @@ Header::Header(
 {
 }
 
+Header::Header(
+    const api::internal::Core& api,
+    const block::Hash& hash,
+    const block::Hash& parentHash,
+    const block::internal::SerializedHeader& serialized) noexcept
+    : Header(
+          api,
+          default_version_,
+          serialized.Chain(),
+          hash,
+          parentHash,
+          serialized.Height(),
+          serialized.LocalState(),
+          serialized.InheritedState(),
+          serialized.Difficulty(),
+          serialized.ParentWork())
+{
+}
+
 Header::Header(
     const api::internal::Core& api,
     const blockchain::Type type,
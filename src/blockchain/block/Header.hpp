@@ -23,6 +23,17 @@ namespace internal
 struct Core;
 }  // namespace internal
 }  // namespace api
+
+namespace blockchain
+{
+namespace block
+{
+namespace internal
+{
+struct SerializedHeader;
+}  // namespace internal
+}  // namespace block
+}  // namespace blockchain
 }  // namespace opentxs
 
 namespace opentxs::blockchain::block::implementation
@@ -81,6 +92,11 @@ protected:
         const block::Hash& hash,
         const block::Hash& parentHash,
         const SerializedType& serialized) noexcept;
+    Header(
+        const api::internal::Core& api,
+        const block::Hash& hash,
+        const block::Hash& parentHash,
+        const block::internal::SerializedHeader& serialized) noexcept;
     Header(const Header& rhs) noexcept;
 
 private:
@@ -16,6 +16,7 @@
 #include <iterator>
 #include <limits>
 #include <map>
+#include <mutex>
 #include <numeric>
 #include <optional>
 #include <stdexcept>
@@ -26,6 +27,7 @@
 
 #include "Factory.hpp"
 #include "blockchain/block/Block.hpp"
+#include "blockchain/block/bitcoin/Script.hpp"
 #include "internal/api/Api.hpp"
 #include "internal/blockchain/bitcoin/Bitcoin.hpp"
 #include "internal/blockchain/block/Block.hpp"
@@ -52,14 +54,13 @@ auto Factory::BitcoinBlock(
     const ReadView in) noexcept
     -> std::shared_ptr<blockchain::block::bitcoin::Block>
 {
-    auto data = api.Factory().Data(in);
-
     try {
         if ((nullptr == in.data()) || (0 == in.size())) {
             throw std::runtime_error("Invalid block input");
         }
 
-        auto it = reinterpret_cast<const std::byte*>(in.data());
+        const auto begin = reinterpret_cast<const std::byte*>(in.data());
+        auto it{begin};
         auto expectedSize = std::size_t{ReturnType::header_bytes_};
 
         if (in.size() < expectedSize) {
@@ -96,32 +97,43 @@ auto Factory::BitcoinBlock(
 
         if (0 == transactionCount) { throw std::runtime_error("Empty block"); }
 
-        auto counter = int{-1};
         auto index = ReturnType::TxidIndex{};
-        auto transactions = ReturnType::TransactionMap{};
-
-        while (transactions.size() < transactionCount) {
-            auto data = bb::EncodedTransaction::Deserialize(
+        auto preimage = Space{};
+        index.reserve(std::min<std::size_t>(
+            transactionCount, in.size() - expectedSize));
+
+        while (index.size() < transactionCount) {
+            const auto [bytes, witness] = ReturnType::Parse(
+                {reinterpret_cast<const char*>(it), in.size() - expectedSize},
+                index.empty(),
+                {});
+            auto& tx = index.emplace_back();
+            tx.position_ = static_cast<std::size_t>(std::distance(begin, it));
+            tx.size_ = bytes;
+            const auto hashed = ReturnType::CalculateTxid(
                 api,
                 chain,
-                ReadView{reinterpret_cast<const char*>(it),
-                         in.size() - expectedSize});
-            const auto txBytes = data.size();
-            std::advance(it, txBytes);
-            expectedSize += txBytes;
-            auto& txid = index.emplace_back(data.txid_);
-            transactions.emplace(
-                reader(txid),
-                BitcoinTransaction(
-                    api, chain, (0 == ++counter), std::move(data)));
+                {reinterpret_cast<const char*>(it), bytes},
+                witness,
+                preimage,
+                preallocated(tx.txid_.size(), tx.txid_.data()));
+
+            if (false == hashed) {
+                throw std::runtime_error("Failed to calculate txid");
+            }
+
+            std::advance(it, bytes);
+            expectedSize += bytes;
         }
 
+        size = expectedSize;
+
         return std::make_shared<ReturnType>(
             api,
             chain,
             std::move(pHeader),
+            Space{begin, it},
             std::move(index),
-            std::move(transactions),
             std::move(sizeData));
     } catch (const std::exception& e) {
         LogOutput("opentxs::Factory::")(__FUNCTION__)(": ")(e.what()).Flush();
@@ -225,24 +237,27 @@ Block::Block(
     const api::internal::Core& api,
     const blockchain::Type chain,
     std::unique_ptr<const internal::Header> header,
+    Space&& raw,
     TxidIndex&& index,
-    TransactionMap&& transactions,
-    std::optional<CalculatedSize>&& size) noexcept(false)
+    CalculatedSize&& size) noexcept(false)
     : block::implementation::Block(api, *header)
+    , chain_(chain)
     , header_p_(std::move(header))
     , header_(*header_p_)
+    , raw_(std::move(raw))
     , index_(std::move(index))
-    , transactions_(std::move(transactions))
+    , sorted_(sort(index_))
     , size_(std::move(size))
+    , lock_()
+    , transactions_()
+    , instantiated_(0)
 {
     if (false == bool(header_p_)) {
         throw std::runtime_error("Invalid header");
     }
 
-    for (const auto& [txid, tx] : transactions_) {
-        if (false == bool(tx)) {
-            throw std::runtime_error("Invalid transaction");
-        }
+    if (raw_.size() != size_.first) {
+        throw std::runtime_error("Wrong block size");
     }
 }
 
@@ -253,7 +268,28 @@ auto Block::at(const std::size_t index) const noexcept -> const value_type&
             throw std::out_of_range("invalid index " + std::to_string(index));
         }
 
-        return at(reader(index_.at(index)));
+        Lock lock(lock_);
+        auto it = transactions_.find(index);
+
+        if (transactions_.end() == it) {
+            auto pTx = opentxs::Factory::BitcoinTransaction(
+                api_,
+                chain_,
+                (0 == index),
+                bb::EncodedTransaction::Deserialize(
+                    api_, chain_, transaction(index)));
+
+            if (false == bool(pTx)) {
+                throw std::runtime_error(
+                    "failed to instantiate transaction " +
+                    std::to_string(index));
+            }
+
+            it = transactions_.emplace(index, std::move(pTx)).first;
+            instantiated_ += index_.at(index).size_;
+        }
+
+        return it->second;
     } catch (const std::exception& e) {
         LogOutput(OT_METHOD)(__FUNCTION__)(": ")(e.what()).Flush();
 
@@ -263,51 +299,185 @@ auto Block::at(const std::size_t index) const noexcept -> const value_type&
 
 auto Block::at(const ReadView txid) const noexcept -> const value_type&
 {
-    try {
+    const auto it = std::lower_bound(
+        sorted_.cbegin(),
+        sorted_.cend(),
+        txid,
+        [this](const auto& lhs, const auto& rhs) -> bool {
+            return index_.at(lhs).Txid() < rhs;
+        });
 
-        return transactions_.at(txid);
-    } catch (...) {
-        LogOutput(OT_METHOD)(__FUNCTION__)(": transaction ")(
-            api_.Factory().Data(txid)->asHex())(" not found in block ")(
-            header_.Hash().asHex())
-            .Flush();
+    if ((sorted_.cend() != it) && (index_.at(*it).Txid() == txid)) {
 
-        return null_tx_;
+        return at(*it);
     }
+
+    LogOutput(OT_METHOD)(__FUNCTION__)(": transaction ")(
+        api_.Factory().Data(txid)->asHex())(" not found in block ")(
+        header_.Hash().asHex())
+        .Flush();
+
+    return null_tx_;
+}
+
+auto Block::CalculateTxid(
+    const api::Core& api,
+    const blockchain::Type chain,
+    const ReadView tx,
+    const std::size_t witness,
+    Space& preimage,
+    const AllocateOutput txid) noexcept -> bool
+{
+    if (0 == witness) {
+        return blockchain::TransactionHash(api, chain, tx, txid);
+    }
+
+    // The txid preimage omits the segwit marker, segwit flag, and witness data
+    constexpr auto version = std::size_t{4};
+    constexpr auto marker = std::size_t{2};
+    constexpr auto locktime = std::size_t{4};
+
+    if ((version + marker > witness) || (witness + locktime > tx.size())) {
+        return false;
+    }
+
+    const auto* it = reinterpret_cast<const std::byte*>(tx.data());
+    const auto* end = it + tx.size();
+    preimage.clear();
+    preimage.insert(preimage.end(), it, it + version);
+    preimage.insert(preimage.end(), it + version + marker, it + witness);
+    preimage.insert(preimage.end(), end - locktime, end);
+
+    return blockchain::TransactionHash(api, chain, reader(preimage), txid);
 }
 
-auto Block::calculate_size() const noexcept -> CalculatedSize
+auto Block::data_push(const ReadView data, const Element& cb) noexcept -> void
 {
-    if (false == size_.has_value()) {
-        size_ = CalculatedSize{0, bb::CompactSize(transactions_.size())};
-        auto& [bytes, cs] = size_.value();
-        auto cb = [](const auto& previous, const auto& in) -> std::size_t {
-            return previous + in.second->CalculateSize();
+    auto it{data.data()};
+
+    switch (data.size()) {
+        case 65: {
+            std::advance(it, 1);
+            [[fallthrough]];
+        }
+        case 64: {
+            cb({it, 32});
+            std::advance(it, 32);
+            cb({it, 32});
+            [[fallthrough]];
+        }
+        case 33:
+        case 32:
+        case 20: {
+            cb(data);
+        } break;
+        default: {
+        }
+    }
+}
+
+auto Block::extract(
+    const FilterType style,
+    const std::size_t position,
+    const Element& elements,
+    const Element& outpoints) const noexcept(false) -> void
+{
+    const auto generation{0 == position};
+    auto visitor = Visitor{};
+    visitor.input_ = [&](const auto index,
+                         const auto outpoint,
+                         const auto script) {
+        const auto coinbase = generation && (0 == index);
+
+        switch (style) {
+            case filter::Type::Extended_opentxs: {
+                if (false == coinbase) { extract_input(script, elements); }
+
+                [[fallthrough]];
+            }
+            case filter::Type::Basic_BCHVariant: {
+                elements(outpoint);
+            } break;
+            case filter::Type::Basic_BIP158:
+            default: {
+            }
+        }
+
+        if (outpoints) { outpoints(outpoint); }
+    };
+
+    if (filter::Type::Extended_opentxs == style) {
+        visitor.witness_ = [&](const auto, const auto item) {
+            data_push(item, elements);
         };
-        bytes = std::accumulate(
-            std::begin(transactions_),
-            std::end(transactions_),
-            header_bytes_ + cs.Size(),
-            cb);
     }
 
-    return size_.value();
+    visitor.output_ = [&](const auto, const auto script) {
+        switch (style) {
+            case filter::Type::Extended_opentxs: {
+                parse_script(
+                    script,
+                    [&](const auto data) { data_push(data, elements); },
+                    false);
+            } break;
+            case filter::Type::Basic_BIP158:
+            case filter::Type::Basic_BCHVariant:
+            default: {
+                if (script.empty()) { return; }
+
+                static constexpr auto nullData =
+                    static_cast<std::uint8_t>(OP::RETURN);
+
+                if (nullData == static_cast<std::uint8_t>(script.front())) {
+                    return;
+                }
+
+                elements(script);
+            }
+        }
+    };
+
+    Parse(transaction(position), generation, visitor);
+}
+
+auto Block::extract_input(const ReadView script, const Element& cb) noexcept
+    -> void
+{
+    auto pushes = std::size_t{0};
+    auto last = ReadView{};
+    const auto elements = parse_script(
+        script,
+        [&](const auto data) {
+            data_push(data, cb);
+            last = data;
+            ++pushes;
+        },
+        false);
+
+    // A script consisting of a single data push may be a redeem script
+    if ((1 != elements.value_or(0)) || (1 != pushes)) { return; }
+
+    if (parse_script(last, {}, true).has_value()) { extract_input(last, cb); }
 }
 
 auto Block::ExtractElements(const FilterType style) const noexcept
     -> std::vector<Space>
 {
     auto output = std::vector<Space>{};
-    LogTrace(OT_METHOD)(__FUNCTION__)(": processing ")(transactions_.size())(
+    LogTrace(OT_METHOD)(__FUNCTION__)(": processing ")(index_.size())(
         " transactions")
         .Flush();
+    const auto cb = [&](const ReadView bytes) {
+        const auto it = reinterpret_cast<const std::byte*>(bytes.data());
+        output.emplace_back(it, it + bytes.size());
+    };
 
-    for (const auto& [txid, tx] : transactions_) {
-        auto temp = tx->ExtractElements(style);
-        output.insert(
-            output.end(),
-            std::make_move_iterator(temp.begin()),
-            std::make_move_iterator(temp.end()));
+    for (auto i = std::size_t{0}; i < index_.size(); ++i) {
+        try {
+            extract(style, i, cb, {});
+        } catch (const std::exception& e) {
+            LogOutput(OT_METHOD)(__FUNCTION__)(": ")(e.what()).Flush();
+        }
     }
 
     LogTrace(OT_METHOD)(__FUNCTION__)(": extracted ")(output.size())(
@@ -324,14 +494,40 @@ auto Block::FindMatches(
 {
     if (0 == (outpoints.size() + patterns.size())) { return {}; }
 
+    using Map = std::map<ReadView, Patterns::const_iterator>;
+    const auto map = [](const Patterns& in) -> Map {
+        auto output = Map{};
+
+        for (auto i{in.cbegin()}; i != in.cend(); std::advance(i, 1)) {
+            output.emplace(reader(i->second), i);
+        }
+
+        return output;
+    };
+    const auto elements = map(patterns);
+    const auto txos = map(outpoints);
     auto output = Matches{};
 
-    for (const auto& [txid, tx] : transactions_) {
-        auto temp = tx->FindMatches(style, outpoints, patterns);
-        output.insert(
-            output.end(),
-            std::make_move_iterator(temp.begin()),
-            std::make_move_iterator(temp.end()));
+    for (auto i = std::size_t{0}; i < index_.size(); ++i) {
+        const auto txid = index_.at(i).Txid();
+        const auto match = [&](const Map& targets) -> Element {
+            return [&](const ReadView bytes) {
+                if (auto it = targets.find(bytes); targets.end() != it) {
+                    output.emplace_back(
+                        api_.Factory().Data(txid), it->second->first);
+                }
+            };
+        };
+
+        try {
+            extract(
+                style,
+                i,
+                match(elements),
+                txos.empty() ? Element{} : match(txos));
+        } catch (const std::exception& e) {
+            LogOutput(OT_METHOD)(__FUNCTION__)(": ")(e.what()).Flush();
+        }
     }
 
     dedup(output);
@@ -339,85 +535,213 @@ auto Block::FindMatches(
     return output;
 }
 
-auto Block::Serialize(AllocateOutput bytes) const noexcept -> bool
+auto Block::InstantiatedSize() const noexcept -> std::size_t
 {
-    if (false == bool(bytes)) {
-        LogOutput(OT_METHOD)(__FUNCTION__)(": Invalid output allocator")
-            .Flush();
+    Lock lock(lock_);
 
-        return false;
+    return instantiated_;
+}
+
+auto Block::Parse(
+    const ReadView in,
+    const bool generation,
+    const Visitor& visitor) noexcept(false)
+    -> std::pair<std::size_t, std::size_t>
+{
+    if ((nullptr == in.data()) || (0 == in.size())) {
+        throw std::runtime_error("Invalid bytes");
     }
 
-    const auto [size, txCount] = calculate_size();
-    const auto out = bytes(size);
+    const auto start = reinterpret_cast<bb::ByteIterator>(in.data());
+    auto it{start};
+    auto expectedSize = std::size_t{0};
+    const auto read = [&](const std::size_t bytes,
+                          const char* error) -> ReadView {
+        expectedSize += bytes;
 
-    if (false == out.valid(size)) {
-        LogOutput(OT_METHOD)(__FUNCTION__)(": Failed to allocate output")
-            .Flush();
+        if (in.size() < expectedSize) { throw std::runtime_error(error); }
 
-        return false;
+        const auto output = ReadView{reinterpret_cast<const char*>(it), bytes};
+        std::advance(it, bytes);
+
+        return output;
+    };
+    const auto count = [&](const char* error) -> std::size_t {
+        auto output = std::size_t{};
+        expectedSize += 1;
+
+        if ((in.size() < expectedSize) ||
+            (false == bb::DecodeCompactSizeFromPayload(
+                          it, expectedSize, in.size(), output))) {
+            throw std::runtime_error(error);
+        }
+
+        return output;
+    };
+    read(sizeof(std::int32_t), "Partial transaction (version)");
+    const auto segwit = bb::HasSegwit(it, expectedSize, in.size()).has_value();
+    const auto inputs = count("Failed to decode txin count");
+
+    for (auto i = std::size_t{0}; i < inputs; ++i) {
+        const auto outpoint = read(36, "Partial input (outpoint)");
+        const auto script = read(
+            count("Failed to decode input script bytes"),
+            "Partial input (script)");
+        read(sizeof(std::uint32_t), "Partial input (sequence)");
+
+        if (visitor.input_) { visitor.input_(i, outpoint, script); }
     }
 
-    LogInsane(OT_METHOD)(__FUNCTION__)(": Serializing ")(txCount.Value())(
-        " transactions into ")(size)(" bytes.")
-        .Flush();
-    auto remaining{size};
-    auto it = static_cast<std::byte*>(out.data());
+    const auto outputs = count("Failed to decode txout count");
 
-    if (false == header_.Serialize(preallocated(remaining, it))) {
-        LogOutput(OT_METHOD)(__FUNCTION__)(": Failed to serialize header")
-            .Flush();
+    for (auto i = std::size_t{0}; i < outputs; ++i) {
+        const auto value = read(sizeof(std::int64_t), "Partial output (value)");
+        auto buf = be::little_int64_buf_t{};
+        std::memcpy(static_cast<void*>(&buf), value.data(), sizeof(buf));
 
-        return false;
+        if (0 > buf.value()) {
+            throw std::runtime_error("Invalid output value");
+        }
+
+        const auto script = read(
+            count("Failed to decode output script bytes"),
+            "Partial output (script)");
+
+        if (visitor.output_) { visitor.output_(i, script); }
     }
 
-    remaining -= header_bytes_;
-    std::advance(it, header_bytes_);
+    auto witness = std::size_t{0};
 
-    if (false == txCount.Encode(preallocated(remaining, it))) {
-        LogOutput(OT_METHOD)(__FUNCTION__)(
-            ": Failed to serialize transaction count")
-            .Flush();
+    if (segwit) {
+        witness = static_cast<std::size_t>(std::distance(start, it));
 
-        return false;
+        for (auto i = std::size_t{0}; i < inputs; ++i) {
+            const auto items = count("Failed to decode witness item count");
+
+            for (auto w = std::size_t{0}; w < items; ++w) {
+                const auto item = read(
+                    count("Failed to decode witness item bytes"),
+                    "Partial witness item");
+
+                if (visitor.witness_) { visitor.witness_(i, item); }
+            }
+        }
     }
 
-    remaining -= txCount.Size();
-    std::advance(it, txCount.Size());
+    read(sizeof(std::uint32_t), "Partial transaction (lock time)");
 
-    for (const auto& txid : index_) {
-        try {
-            const auto& pTX = transactions_.at(reader(txid));
+    return {static_cast<std::size_t>(std::distance(start, it)), witness};
+}
+
+auto Block::parse_script(
+    const ReadView script,
+    const Element& cb,
+    const bool strict) noexcept -> std::optional<std::size_t>
+{
+    auto it = reinterpret_cast<bb::ByteIterator>(script.data());
+    const auto end = std::next(it, script.size());
+    const auto remaining = [&] {
+        return static_cast<std::size_t>(std::distance(it, end));
+    };
+    auto elements = std::size_t{0};
+
+    try {
+        while (it != end) {
+            auto opcode = OP{};
+
+            try {
+                opcode = Script::decode(*it);
+            } catch (...) {
+                if (strict) { throw; }
 
-            OT_ASSERT(pTX);
+                opcode = OP::INVALIDOPCODE;
+            }
 
-            const auto& tx = *pTX;
-            const auto encoded = tx.Serialize(preallocated(remaining, it));
+            std::advance(it, 1);
+            ++elements;
+            auto push = std::size_t{};
+
+            if (const auto direct = Script::is_direct_push(opcode); direct) {
+                push = direct.value();
+            } else if (const auto bytes = Script::is_push(opcode); bytes) {
+                const auto& sizeBytes = bytes.value();
+
+                if (remaining() < sizeBytes) {
+                    if (strict) { return std::nullopt; }
+
+                    // Consensus allows a truncated push at the end of a
+                    // script but it does not contain any usable element
+                    break;
+                }
+
+                auto buf = be::little_uint32_buf_t{};
+                std::memcpy(static_cast<void*>(&buf), it, sizeBytes);
+                std::advance(it, sizeBytes);
+                push = buf.value();
+            } else {
+                continue;
+            }
 
-            if (false == encoded.has_value()) {
-                LogOutput(OT_METHOD)(__FUNCTION__)(
-                    ": failed to serialize transaction ")(tx.ID().asHex())
-                    .Flush();
+            if (remaining() < push) {
+                if (strict) { return std::nullopt; }
 
-                return false;
+                break;
             }
 
-            remaining -= encoded.value();
-            std::advance(it, encoded.value());
-        } catch (...) {
-            LogOutput(OT_METHOD)(__FUNCTION__)(": missing transaction").Flush();
+            if (cb) { cb({reinterpret_cast<const char*>(it), push}); }
 
-            return false;
+            std::advance(it, push);
         }
+    } catch (...) {
+
+        return std::nullopt;
+    }
+
+    return elements;
+}
+
+auto Block::Serialize(AllocateOutput bytes) const noexcept -> bool
+{
+    if (false == bool(bytes)) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(": Invalid output allocator")
+            .Flush();
+
+        return false;
     }
 
-    if (0 != remaining) {
-        LogOutput(OT_METHOD)(__FUNCTION__)(": Extra bytes: ")(remaining)
+    const auto size = raw_.size();
+    const auto out = bytes(size);
+
+    if (false == out.valid(size)) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(": Failed to allocate output")
             .Flush();
 
         return false;
     }
 
+    std::memcpy(out.data(), raw_.data(), size);
+
     return true;
 }
+
+auto Block::sort(const TxidIndex& index) noexcept -> std::vector<std::size_t>
+{
+    auto output = std::vector<std::size_t>(index.size());
+    std::iota(output.begin(), output.end(), std::size_t{0});
+    std::sort(
+        output.begin(),
+        output.end(),
+        [&](const auto& lhs, const auto& rhs) -> bool {
+            return index.at(lhs).Txid() < index.at(rhs).Txid();
+        });
+
+    return output;
+}
+
+auto Block::transaction(const std::size_t position) const noexcept -> ReadView
+{
+    const auto& [txid, offset, size] = index_.at(position);
+
+    return {reinterpret_cast<const char*>(raw_.data()) + offset, size};
+}
 }  // namespace opentxs::blockchain::block::bitcoin::implementation
@@ -5,9 +5,13 @@
 
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <functional>
 #include <iosfwd>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <utility>
 #include <vector>
@@ -29,6 +33,8 @@ namespace internal
 {
 struct Core;
 }  // namespace internal
+
+class Core;
 }  // namespace api
 }  // namespace opentxs
 
@@ -36,16 +42,59 @@ namespace bb = opentxs::blockchain::bitcoin;
 
 namespace opentxs::blockchain::block::bitcoin::implementation
 {
+// Transactions are kept in their serialized form and only instantiated when
+// they are accessed. Element extraction and pattern matching read directly
+// from the serialized bytes.
 class Block final : public bitcoin::Block, public block::implementation::Block
 {
 public:
     using CalculatedSize =
         std::pair<std::size_t, blockchain::bitcoin::CompactSize>;
-    using TxidIndex = std::vector<Space>;
-    using TransactionMap = std::map<ReadView, value_type>;
+
+    /// Location of a transaction within the serialized block
+    struct Offsets {
+        std::array<std::byte, 32> txid_{};
+        std::size_t position_{};
+        std::size_t size_{};
+
+        auto Txid() const noexcept -> ReadView
+        {
+            return {reinterpret_cast<const char*>(txid_.data()), txid_.size()};
+        }
+    };
+
+    /// Callbacks for the components of a serialized transaction. The
+    /// arguments are the input or output index and the relevant bytes.
+    struct Visitor {
+        std::function<void(const std::size_t, const ReadView, const ReadView)>
+            input_{};
+        std::function<void(const std::size_t, const ReadView)> witness_{};
+        std::function<void(const std::size_t, const ReadView)> output_{};
+    };
+
+    using TxidIndex = std::vector<Offsets>;
 
     static const std::size_t header_bytes_;
 
+    /// Calculates the txid of a serialized transaction. witness is the
+    /// position of the witness data returned by Parse and preimage is scratch
+    /// space which is reused between calls.
+    static auto CalculateTxid(
+        const api::Core& api,
+        const blockchain::Type chain,
+        const ReadView tx,
+        const std::size_t witness,
+        Space& preimage,
+        const AllocateOutput txid) noexcept -> bool;
+    /// Returns the number of bytes in the transaction and the position of the
+    /// witness data (zero if none). Throws if the transaction is truncated.
+    /// Scripts are not validated since consensus permits arbitrary bytes.
+    static auto Parse(
+        const ReadView tx,
+        const bool generation,
+        const Visitor& visitor) noexcept(false)
+        -> std::pair<std::size_t, std::size_t>;
+
     auto at(const std::size_t index) const noexcept -> const value_type& final;
     auto at(const ReadView txid) const noexcept -> const value_type& final;
     auto begin() const noexcept -> const_iterator final { return cbegin(); }
@@ -68,6 +117,7 @@ public:
         const FilterType type,
         const Patterns& outpoints,
         const Patterns& scripts) const noexcept -> Matches final;
+    auto InstantiatedSize() const noexcept -> std::size_t final;
     auto Serialize(AllocateOutput bytes) const noexcept -> bool final;
     auto size() const noexcept -> std::size_t final { return index_.size(); }
 
@@ -75,20 +125,47 @@ public:
         const api::internal::Core& api,
         const blockchain::Type chain,
         std::unique_ptr<const internal::Header> header,
+        Space&& raw,
         TxidIndex&& index,
-        TransactionMap&& transactions,
-        std::optional<CalculatedSize>&& size = {}) noexcept(false);
+        CalculatedSize&& size) noexcept(false);
 
 private:
+    using Element = std::function<void(const ReadView)>;
+
     static const value_type null_tx_;
 
+    const blockchain::Type chain_;
     const std::unique_ptr<const internal::Header> header_p_;
     const internal::Header& header_;
+    const Space raw_;
     const TxidIndex index_;
-    const TransactionMap transactions_;
-    mutable std::optional<CalculatedSize> size_;
+    const std::vector<std::size_t> sorted_;
+    const CalculatedSize size_;
+    mutable std::mutex lock_;
+    mutable std::map<std::size_t, value_type> transactions_;
+    mutable std::size_t instantiated_;
+
+    static auto data_push(const ReadView data, const Element& cb) noexcept
+        -> void;
+    static auto extract_input(const ReadView script, const Element& cb) noexcept
+        -> void;
+    // Unless strict is set unknown opcodes are skipped and a truncated push
+    // ends the script without being passed to cb, matching the tolerance of
+    // Factory::BitcoinScript. Strict parsing returns nullopt in both cases.
+    static auto parse_script(
+        const ReadView script,
+        const Element& cb,
+        const bool strict) noexcept -> std::optional<std::size_t>;
+    static auto sort(const TxidIndex& index) noexcept
+        -> std::vector<std::size_t>;
 
-    auto calculate_size() const noexcept -> CalculatedSize;
+    auto calculate_size() const noexcept -> CalculatedSize { return size_; }
+    auto extract(
+        const FilterType style,
+        const std::size_t position,
+        const Element& elements,
+        const Element& outpoints) const noexcept(false) -> void;
+    auto transaction(const std::size_t position) const noexcept -> ReadView;
 
     Block() = delete;
     Block(const Block&) = delete;
@@ -99,6 +99,22 @@ auto Factory::BitcoinBlockHeader(
 
     return std::make_unique<ReturnType>(api, chain, hash, parent, height);
 }
+
+auto Factory::BitcoinBlockHeader(
+    const api::internal::Core& api,
+    const blockchain::block::Hash& hash,
+    const blockchain::block::internal::SerializedHeader& record) noexcept
+    -> std::unique_ptr<blockchain::block::bitcoin::internal::Header>
+{
+    using ReturnType = blockchain::block::bitcoin::implementation::Header;
+
+    static_assert(sizeof(record.raw_) == sizeof(ReturnType::BitcoinFormat));
+
+    ReturnType::BitcoinFormat raw{};
+    std::memcpy(&raw, record.raw_.data(), sizeof(raw));
+
+    return std::make_unique<ReturnType>(api, hash, raw, record);
+}
 }  // namespace opentxs
 
 namespace opentxs::blockchain::block::bitcoin::implementation
@@ -173,6 +189,26 @@ Header::Header(
 {
 }
 
+Header::Header(
+    const api::internal::Core& api,
+    const block::Hash& hash,
+    const BitcoinFormat& raw,
+    const block::internal::SerializedHeader& serialized) noexcept
+    : bitcoin::Header()
+    , ot_super(
+          api,
+          hash,
+          Data::Factory(raw.previous_.data(), raw.previous_.size()),
+          serialized)
+    , subversion_(subversion_default_)
+    , block_version_(raw.version_.value())
+    , merkle_root_(Data::Factory(raw.merkle_.data(), raw.merkle_.size()))
+    , timestamp_(Clock::from_time_t(std::time_t(raw.time_.value())))
+    , nbits_(raw.nbits_.value())
+    , nonce_(raw.nonce_.value())
+{
+}
+
 Header::Header(const Header& rhs) noexcept
     : bitcoin::Header()
     , ot_super(rhs)
@@ -96,6 +96,11 @@ public:
     Header(
         const api::internal::Core& api,
         const SerializedType& serialized) noexcept;
+    Header(
+        const api::internal::Core& api,
+        const block::Hash& hash,
+        const BitcoinFormat& raw,
+        const block::internal::SerializedHeader& serialized) noexcept;
 
     ~Header() final = default;
 
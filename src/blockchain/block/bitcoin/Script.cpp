@@ -19,6 +19,7 @@
 #include <vector>
 
 #include "Factory.hpp"
+#include "internal/blockchain/Blockchain.hpp"
 #include "opentxs/blockchain/block/bitcoin/Script.hpp"
 #include "opentxs/core/Log.hpp"
 #include "opentxs/core/LogSource.hpp"
@@ -594,7 +595,10 @@ auto Script::ExtractElements(const filter::Type style) const noexcept
             LogTrace(OT_METHOD)(__FUNCTION__)(": processing serialized script")
                 .Flush();
             auto& script = output.emplace_back();
-            Serialize(writer(script));
+
+            if (false == serialize_template(writer(script))) {
+                Serialize(writer(script));
+            }
         }
     }
 
@@ -865,6 +869,47 @@ auto Script::Serialize(const AllocateOutput destination) const noexcept -> bool
     return true;
 }
 
+auto Script::serialize_template(const AllocateOutput destination) const
+    noexcept -> bool
+{
+    const auto write = [&](const auto& layout, const std::size_t position) {
+        const auto& element = elements_.at(position);
+
+        if (element.invalid_.has_value() || element.bytes_.has_value()) {
+
+            return false;
+        }
+
+        const auto data = get_data(position);
+
+        if (static_cast<std::uint8_t>(element.opcode_) != data.size()) {
+
+            return false;
+        }
+
+        return layout.Write(data, destination);
+    };
+
+    switch (type_) {
+        case Pattern::PayToPubkey: {
+
+            return write(blockchain::script::P2PK(get_data(0)), 0);
+        }
+        case Pattern::PayToPubkeyHash: {
+
+            return write(blockchain::script::P2PKH, 2);
+        }
+        case Pattern::PayToScriptHash: {
+
+            return write(blockchain::script::P2SH, 1);
+        }
+        default: {
+
+            return false;
+        }
+    }
+}
+
 auto Script::to_number(const OP opcode) noexcept -> std::uint8_t
 {
     if ((OP::ONE <= opcode) && (OP::SIXTEEN >= opcode)) {
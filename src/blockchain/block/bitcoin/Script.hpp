@@ -109,6 +109,9 @@ private:
 
     auto get_data(const std::size_t position) const noexcept(false) -> ReadView;
     auto get_opcode(const std::size_t position) const noexcept(false) -> OP;
+    // Returns false if the script is not encoded exactly as a standard template
+    auto serialize_template(const AllocateOutput destination) const noexcept
+        -> bool;
 
     Script() = delete;
     Script(const Script&) = delete;
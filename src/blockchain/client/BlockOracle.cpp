@@ -8,6 +8,7 @@
 #include "blockchain/client/BlockOracle.hpp"  // IWYU pragma: associated
 
 #include <algorithm>
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <type_traits>
@@ -17,8 +18,10 @@
 #include "internal/blockchain/Blockchain.hpp"
 #include "internal/blockchain/client/Client.hpp"
 #include "opentxs/Pimpl.hpp"
+#include "opentxs/blockchain/block/Header.hpp"
 #include "opentxs/blockchain/block/bitcoin/Block.hpp"
 #include "opentxs/blockchain/client/BlockOracle.hpp"
+#include "opentxs/blockchain/client/HeaderOracle.hpp"
 #include "opentxs/core/Flag.hpp"
 #include "opentxs/core/Log.hpp"
 #include "opentxs/core/LogSource.hpp"
@@ -45,50 +48,206 @@ namespace opentxs::factory
 auto BlockOracle(
     const api::internal::Core& api,
     const blockchain::client::internal::Network& network,
+    const blockchain::client::internal::BlockDatabase& database,
     const blockchain::Type type,
     const std::string& shutdown) noexcept
     -> std::unique_ptr<blockchain::client::internal::BlockOracle>
 {
     using ReturnType = blockchain::client::implementation::BlockOracle;
 
-    return std::make_unique<ReturnType>(api, network, type, shutdown);
+    return std::make_unique<ReturnType>(
+        api, network, database, type, shutdown);
 }
 }  // namespace opentxs::factory
 
 namespace opentxs::blockchain::client::implementation
 {
-const std::size_t BlockOracle::Cache::cache_limit_{16};
+const std::size_t BlockOracle::Cache::default_block_size_{1024 * 1024};
 const std::chrono::seconds BlockOracle::Cache::download_timeout_{30};
+const std::size_t BlockOracle::Cache::max_downloads_{32};
+const std::size_t BlockOracle::Cache::max_hints_{1000};
+const block::Height BlockOracle::Cache::mempool_depth_{6};
 
 BlockOracle::BlockOracle(
     const api::internal::Core& api,
     const internal::Network& network,
+    const internal::BlockDatabase& database,
     [[maybe_unused]] const blockchain::Type type,
     const std::string& shutdown) noexcept
     : Executor(api)
     , network_(network)
     , init_promise_()
     , init_(init_promise_.get_future())
-    , cache_(network_)
+    , cache_(network_, database.BlockCacheSize())
+    , compact_()
 {
     init_executor({shutdown});
 }
 
-BlockOracle::Cache::Cache(const internal::Network& network) noexcept
+BlockOracle::Cache::Cache(
+    const internal::Network& network,
+    const std::size_t budget) noexcept
     : network_(network)
+    , budget_(budget)
     , lock_()
     , pending_()
     , completed_()
+    , index_()
+    , hints_()
+    , used_(0)
+    , unrequested_(0)
+    , hits_(0)
+    , misses_(0)
     , running_(true)
 {
 }
 
+auto BlockOracle::CompactBlockFailed(const std::size_t received) const
+    noexcept -> void
+{
+    compact_.Failed(received);
+}
+
+auto BlockOracle::CompactBlocks::Failed(const std::size_t received) const
+    noexcept -> void
+{
+    Lock lock{lock_};
+    ++failed_;
+    received_bytes_ += received;
+    report(lock);
+}
+
+auto BlockOracle::CompactBlocks::Reconstructed(
+    const std::size_t size,
+    const std::size_t received,
+    const bool roundTrip) const noexcept -> void
+{
+    Lock lock{lock_};
+
+    if (roundTrip) {
+        ++round_trip_;
+    } else {
+        ++immediate_;
+    }
+
+    block_bytes_ += size;
+    received_bytes_ += received;
+    report(lock);
+}
+
+auto BlockOracle::CompactBlocks::report(const Lock&) const noexcept -> void
+{
+    const auto reconstructed = immediate_ + round_trip_;
+    const auto total = reconstructed + failed_;
+    const auto rate =
+        (0 == total) ? std::size_t{0} : ((100u * reconstructed) / total);
+    const auto saved = static_cast<std::int64_t>(block_bytes_) -
+                       static_cast<std::int64_t>(received_bytes_);
+    LogVerbose(OT_METHOD)("CompactBlocks::")(__FUNCTION__)(": ")(
+        reconstructed)(" of ")(total)(" compact blocks reconstructed (")(rate)(
+        "%), ")(immediate_)(" without a round trip, ")(failed_)(
+        " downloaded in full. Received ")(received_bytes_)(" bytes for ")(
+        block_bytes_)(" bytes of blocks, saved ")(saved)(" bytes")
+        .Flush();
+}
+
+// Transactions instantiated by users of a cached block stay in memory with the
+// block, so the charge for each block is brought up to date before evicting
+auto BlockOracle::Cache::charge(const Lock&, CompletedData& item) const
+    noexcept -> void
+{
+    auto& [hash, future, bytes, unrequested] = item;
+    const auto& pBlock = future.get();
+
+    if (false == bool(pBlock)) { return; }
+
+    const auto current = pBlock->CalculateSize() + pBlock->InstantiatedSize();
+    used_ = used_ - bytes + current;
+
+    if (unrequested) { unrequested_ = unrequested_ - bytes + current; }
+
+    bytes = current;
+}
+
 auto BlockOracle::Cache::download(const block::Hash& block) const noexcept
     -> bool
 {
     return network_.RequestBlock(block);
 }
 
+auto BlockOracle::Cache::evict(const Lock& lock) const noexcept -> void
+{
+    for (auto& item : completed_) { charge(lock, item); }
+
+    // The most recently stored block is kept even if it exceeds the budget
+    // by itself
+    while ((used_ > budget_) && (1 < completed_.size())) {
+        const auto& [hash, future, bytes, unrequested] = completed_.back();
+        used_ -= bytes;
+
+        if (unrequested) { unrequested_ -= bytes; }
+
+        index_.erase(hash);
+        completed_.pop_back();
+    }
+}
+
+auto BlockOracle::Cache::fetch(
+    const Lock& lock,
+    const block::Hash& block,
+    const bool prefetch) const noexcept -> BitcoinBlockFuture
+{
+    const auto& db = network_.DB();
+
+    if (auto pBlock = db.BlockLoadBitcoin(block); bool(pBlock)) {
+        const auto bytes = pBlock->CalculateSize();
+        auto promise = Promise{};
+        promise.set_value(std::move(pBlock));
+
+        return store(lock, block, promise.get_future(), bytes, prefetch);
+    }
+
+    auto& [time, promise, future, queued, prefetched] = pending_[block];
+    time = Clock::now();
+    future = promise.get_future();
+    queued = download(block);
+    prefetched = prefetch;
+
+    return future;
+}
+
+auto BlockOracle::Cache::Prefetch(
+    const std::vector<block::pHash>& blocks) const noexcept -> void
+{
+    Lock lock{lock_};
+
+    if (false == running_) { return; }
+
+    for (const auto& hash : blocks) {
+        if (hints_.size() >= max_hints_) { break; }
+        if (0 < index_.count(hash)) { continue; }
+        if (0 < pending_.count(hash)) { continue; }
+        if (hints_.cend() != std::find(hints_.cbegin(), hints_.cend(), hash)) {
+            continue;
+        }
+
+        hints_.emplace_back(hash);
+    }
+}
+
+auto BlockOracle::Cache::prefetch_bytes(const Lock&) const noexcept
+    -> std::size_t
+{
+    const auto average = completed_.empty() ? default_block_size_
+                                            : (used_ / completed_.size());
+    const auto downloading = std::count_if(
+        pending_.cbegin(), pending_.cend(), [](const auto& item) -> bool {
+            return std::get<4>(item.second);
+        });
+
+    return unrequested_ + (static_cast<std::size_t>(downloading) * average);
+}
+
 auto BlockOracle::Cache::ReceiveBlock(const zmq::Frame& in) const noexcept
     -> void
 {
@@ -102,8 +261,23 @@ auto BlockOracle::Cache::ReceiveBlock(const zmq::Frame& in) const noexcept
         return;
     }
 
-    Lock lock{lock_};
     auto& block = *pBlock;
+
+    // The header oracle only holds headers which passed validation so this
+    // also rejects blocks with an invalid proof of work. Historical blocks
+    // downloaded by a rescan can not affect the mempool.
+    const auto& headers = network_.HeaderOracle();
+
+    if (headers.IsInBestChain(block.ID())) {
+        const auto pHeader = headers.LoadHeader(block.ID());
+        const auto tip = headers.BestChain().first;
+
+        if (pHeader && ((pHeader->Height() + mempool_depth_) >= tip)) {
+            network_.Mempool().Prune(block);
+        }
+    }
+
+    Lock lock{lock_};
     const auto& db = network_.DB();
 
     if (api::client::blockchain::BlockStorage::None != db.BlockPolicy()) {
@@ -113,21 +287,38 @@ auto BlockOracle::Cache::ReceiveBlock(const zmq::Frame& in) const noexcept
     const auto& id = block.ID();
     auto pending = pending_.find(id);
 
+    // Blocks announced with high bandwidth compact block relay arrive
+    // without being requested
     if (pending_.end() == pending) {
-        LogOutput(OT_METHOD)("Cache::")(__FUNCTION__)(
+        LogVerbose(OT_METHOD)("Cache::")(__FUNCTION__)(
             ": Received block not in request list")
             .Flush();
 
         return;
     }
 
-    auto& [time, promise, future, queued] = pending->second;
+    const auto bytes = block.CalculateSize();
+    auto& [time, promise, future, queued, prefetched] = pending->second;
     promise.set_value(std::move(pBlock));
-    completed_.emplace_back(id, std::move(future));
+    store(lock, id, std::move(future), bytes, prefetched);
     pending_.erase(pending);
     LogVerbose(OT_METHOD)("Cache::")(__FUNCTION__)(": Cached block ")(
         id.asHex())
         .Flush();
+    report(lock);
+}
+
+auto BlockOracle::Cache::report(const Lock&) const noexcept -> void
+{
+    const auto requests = hits_ + misses_;
+    const auto rate = (0 == requests) ? std::size_t{0}
+                                      : ((100u * hits_) / requests);
+    LogVerbose(OT_METHOD)("Cache::")(__FUNCTION__)(": ")(completed_.size())(
+        " blocks cached in ")(used_)(" of ")(budget_)(" bytes, ")(
+        pending_.size())(" downloading, ")(hints_.size())(
+        " waiting to prefetch. Hit rate: ")(rate)("% of ")(requests)(
+        " requests")
+        .Flush();
 }
 
 auto BlockOracle::Cache::Request(const block::Hash& block) const noexcept
@@ -142,35 +333,34 @@ auto BlockOracle::Cache::Request(const block::Hash& block) const noexcept
         return promise.get_future();
     }
 
-    for (const auto& [hash, future] : completed_) {
-        if (block == hash) { return future; }
-    }
+    if (auto it = index_.find(block); index_.end() != it) {
+        ++hits_;
+        auto position = it->second;
+        auto& [hash, future, bytes, unrequested] = *position;
 
-    {
-        auto it = pending_.find(block);
+        if (unrequested) {
+            unrequested = false;
+            unrequested_ -= bytes;
+        }
 
-        if (pending_.end() != it) {
-            const auto& [time, promise, future, queued] = it->second;
+        completed_.splice(completed_.begin(), completed_, position);
+        auto output = future;
+        evict(lock);
 
-            return future;
-        }
+        return output;
     }
 
-    const auto& db = network_.DB();
-
-    if (auto pBlock = db.BlockLoadBitcoin(block); bool(pBlock)) {
-        auto promise = Promise{};
-        promise.set_value(std::move(pBlock));
+    if (auto it = pending_.find(block); pending_.end() != it) {
+        ++hits_;
+        auto& [time, promise, future, queued, prefetched] = it->second;
+        prefetched = false;
 
-        return completed_.emplace_back(block, promise.get_future()).second;
+        return future;
     }
 
-    auto& [time, promise, future, queued] = pending_[block];
-    time = Clock::now();
-    future = promise.get_future();
-    queued = download(block);
+    ++misses_;
 
-    return future;
+    return fetch(lock, block, false);
 }
 
 auto BlockOracle::Cache::Shutdown() noexcept -> void
@@ -180,9 +370,13 @@ auto BlockOracle::Cache::Shutdown() noexcept -> void
     if (running_) {
         running_ = false;
         completed_.clear();
+        index_.clear();
+        hints_.clear();
+        used_ = 0;
+        unrequested_ = 0;
 
         for (auto& [hash, item] : pending_) {
-            auto& [time, promise, future, queued] = item;
+            auto& [time, promise, future, queued, prefetched] = item;
             promise.set_value(nullptr);
         }
 
@@ -196,10 +390,8 @@ auto BlockOracle::Cache::StateMachine() const noexcept -> bool
 
     if (false == running_) { return false; }
 
-    while (completed_.size() > cache_limit_) { completed_.pop_front(); }
-
     for (auto& [hash, item] : pending_) {
-        auto& [time, promise, future, queued] = item;
+        auto& [time, promise, future, queued, prefetched] = item;
         const auto now = Clock::now();
         const auto timeout = download_timeout_ <= (now - time);
 
@@ -209,9 +401,43 @@ auto BlockOracle::Cache::StateMachine() const noexcept -> bool
         }
     }
 
+    const auto limit = budget_ / 2u;
+
+    while ((false == hints_.empty()) && (pending_.size() < max_downloads_) &&
+           (prefetch_bytes(lock) < limit)) {
+        auto hash = hints_.front();
+        hints_.pop_front();
+
+        if ((0 < index_.count(hash)) || (0 < pending_.count(hash))) {
+            continue;
+        }
+
+        fetch(lock, hash, true);
+    }
+
     return 0 < pending_.size();
 }
 
+auto BlockOracle::Cache::store(
+    const Lock& lock,
+    const block::Hash& block,
+    BitcoinBlockFuture future,
+    const std::size_t bytes,
+    const bool prefetch) const noexcept -> BitcoinBlockFuture
+{
+    auto& item =
+        completed_.emplace_front(block, std::move(future), bytes, prefetch);
+    index_[block] = completed_.begin();
+    used_ += bytes;
+
+    if (prefetch) { unrequested_ += bytes; }
+
+    auto output = std::get<1>(item);
+    evict(lock);
+
+    return output;
+}
+
 auto BlockOracle::Init() noexcept -> void
 {
     init_promise_.set_value();
@@ -227,6 +453,13 @@ auto BlockOracle::LoadBitcoin(const block::Hash& block) const noexcept
     return output;
 }
 
+auto BlockOracle::Prefetch(const std::vector<block::pHash>& blocks) const
+    noexcept -> void
+{
+    cache_.Prefetch(blocks);
+    Trigger();
+}
+
 auto BlockOracle::pipeline(const zmq::Message& in) noexcept -> void
 {
     init_.get();
@@ -307,5 +540,16 @@ auto BlockOracle::SubmitBlock(const zmq::Frame& in) const noexcept -> void
     pipeline_->Push(work);
 }
 
+auto BlockOracle::SubmitCompactBlock(
+    const ReadView block,
+    const std::size_t received,
+    const bool roundTrip) const noexcept -> void
+{
+    compact_.Reconstructed(block.size(), received, roundTrip);
+    auto work = MakeWork(Task::ProcessBlock);
+    work->AddFrame(block.data(), block.size());
+    pipeline_->Push(work);
+}
+
 BlockOracle::~BlockOracle() { Shutdown().get(); }
 }  // namespace opentxs::blockchain::client::implementation
@@ -6,14 +6,17 @@
 #pragma once
 
 #include <chrono>
+#include <cstddef>
 #include <deque>
 #include <future>
 #include <iosfwd>
+#include <list>
 #include <map>
 #include <mutex>
 #include <string>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 #include "core/Executor.hpp"
 #include "internal/blockchain/client/Client.hpp"
@@ -48,9 +51,17 @@ class BlockOracle final : public internal::BlockOracle,
                           public Executor<BlockOracle>
 {
 public:
+    auto CompactBlockFailed(const std::size_t received) const noexcept
+        -> void final;
     auto LoadBitcoin(const block::Hash& block) const noexcept
         -> BitcoinBlockFuture final;
+    auto Prefetch(const std::vector<block::pHash>& blocks) const noexcept
+        -> void final;
     auto SubmitBlock(const zmq::Frame& in) const noexcept -> void final;
+    auto SubmitCompactBlock(
+        const ReadView block,
+        const std::size_t received,
+        const bool roundTrip) const noexcept -> void final;
 
     auto Init() noexcept -> void final;
     auto Run() noexcept -> void final { Trigger(); }
@@ -62,6 +73,7 @@ public:
     BlockOracle(
         const api::internal::Core& api,
         const internal::Network& network,
+        const internal::BlockDatabase& database,
         const blockchain::Type type,
         const std::string& shutdown) noexcept;
 
@@ -71,11 +83,23 @@ private:
     friend Executor<BlockOracle>;
 
     using Promise = std::promise<BitcoinBlock_p>;
-    using PendingData = std::tuple<Time, Promise, BitcoinBlockFuture, bool>;
+    /// request time, promise, future, queued, prefetched
+    using PendingData =
+        std::tuple<Time, Promise, BitcoinBlockFuture, bool, bool>;
     using Pending = std::map<block::pHash, PendingData>;
-    using Completed = std::deque<std::pair<block::pHash, BitcoinBlockFuture>>;
-
+    /// hash, future, bytes, prefetched and not yet requested
+    using CompletedData =
+        std::tuple<block::pHash, BitcoinBlockFuture, std::size_t, bool>;
+    using Completed = std::list<CompletedData>;
+
+    // Blocks held in memory, shared by every subchain of every wallet on the
+    // chain. The least recently used blocks are evicted once the memory
+    // budget is exceeded. Prefetch hints are downloaded ahead of time, across
+    // all connected peers, as long as the unrequested blocks fit in half of
+    // the budget.
     struct Cache {
+        auto Prefetch(const std::vector<block::pHash>& blocks) const noexcept
+            -> void;
         auto ReceiveBlock(const zmq::Frame& in) const noexcept -> void;
         auto Request(const block::Hash& block) const noexcept
             -> BitcoinBlockFuture;
@@ -83,26 +107,78 @@ private:
 
         auto Shutdown() noexcept -> void;
 
-        Cache(const internal::Network& network) noexcept;
+        Cache(const internal::Network& network, const std::size_t budget)
+            noexcept;
         ~Cache() { Shutdown(); }
 
     private:
-        static const std::size_t cache_limit_;
+        using Index = std::map<block::pHash, Completed::iterator>;
+
+        static const std::size_t default_block_size_;
         static const std::chrono::seconds download_timeout_;
+        static const std::size_t max_downloads_;
+        static const std::size_t max_hints_;
+        // Blocks deeper than this below the best block are not used to prune
+        // the mempool
+        static const block::Height mempool_depth_;
 
         const internal::Network& network_;
+        const std::size_t budget_;
         mutable std::mutex lock_;
         mutable Pending pending_;
         mutable Completed completed_;
+        mutable Index index_;
+        mutable std::deque<block::pHash> hints_;
+        mutable std::size_t used_;
+        mutable std::size_t unrequested_;
+        mutable std::size_t hits_;
+        mutable std::size_t misses_;
         bool running_;
 
+        auto charge(const Lock& lock, CompletedData& item) const noexcept
+            -> void;
         auto download(const block::Hash& block) const noexcept -> bool;
+        auto evict(const Lock& lock) const noexcept -> void;
+        auto fetch(
+            const Lock& lock,
+            const block::Hash& block,
+            const bool prefetch) const noexcept -> BitcoinBlockFuture;
+        auto prefetch_bytes(const Lock& lock) const noexcept -> std::size_t;
+        auto report(const Lock& lock) const noexcept -> void;
+        auto store(
+            const Lock& lock,
+            const block::Hash& block,
+            BitcoinBlockFuture future,
+            const std::size_t bytes,
+            const bool prefetch) const noexcept -> BitcoinBlockFuture;
+    };
+
+    // Outcome of blocks announced with BIP152 compact blocks. The bytes
+    // saved are the size of the reconstructed blocks minus every payload
+    // byte received for compact blocks, including the ones which failed.
+    struct CompactBlocks {
+        auto Failed(const std::size_t received) const noexcept -> void;
+        auto Reconstructed(
+            const std::size_t size,
+            const std::size_t received,
+            const bool roundTrip) const noexcept -> void;
+
+    private:
+        mutable std::mutex lock_{};
+        mutable std::size_t immediate_{};
+        mutable std::size_t round_trip_{};
+        mutable std::size_t failed_{};
+        mutable std::size_t block_bytes_{};
+        mutable std::size_t received_bytes_{};
+
+        auto report(const Lock& lock) const noexcept -> void;
     };
 
     const internal::Network& network_;
     std::promise<void> init_promise_;
     std::shared_future<void> init_;
     Cache cache_;
+    CompactBlocks compact_;
 
     auto pipeline(const zmq::Message& in) noexcept -> void;
     auto shutdown(std::promise<void>& promise) noexcept -> void;
@@ -0,0 +1,737 @@
+// Copyright (c) 2010-2020 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "0_stdafx.hpp"                     // IWYU pragma: associated
+#include "1_Internal.hpp"                   // IWYU pragma: associated
+#include "blockchain/client/Bootstrap.hpp"  // IWYU pragma: associated
+
+#include <boost/filesystem.hpp>
+#if OPENTXS_BLOCK_STORAGE_ENABLED
+#include <boost/iostreams/device/mapped_file.hpp>
+#endif  // OPENTXS_BLOCK_STORAGE_ENABLED
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <tuple>
+#include <utility>
+
+#include "Factory.hpp"
+#include "blockchain/bitcoin/CompactSize.hpp"
+#include "internal/blockchain/Blockchain.hpp"
+#include "internal/blockchain/bitcoin/Bitcoin.hpp"
+#include "internal/blockchain/block/Block.hpp"
+#include "opentxs/Pimpl.hpp"
+#include "opentxs/api/Core.hpp"
+#include "opentxs/api/Factory.hpp"
+#include "opentxs/blockchain/block/Header.hpp"
+#include "opentxs/core/Data.hpp"
+#include "opentxs/core/Log.hpp"
+#include "opentxs/core/LogSource.hpp"
+
+#define OT_METHOD "opentxs::blockchain::client::Bootstrap::"
+
+namespace opentxs::blockchain::client
+{
+const std::size_t Bootstrap::header_batch_{20000};
+const std::size_t Bootstrap::filter_header_batch_{20000};
+const std::size_t Bootstrap::filter_batch_{1000};
+
+Bootstrap::Bootstrap(
+    const api::Core& api,
+    const Type chain,
+    internal::HeaderOracle& headers,
+    const internal::FilterDatabase& database) noexcept
+    : api_(api)
+    , chain_(chain)
+    , type_(blockchain::internal::DefaultFilter(chain))
+    , headers_(headers)
+    , database_(database)
+{
+}
+
+auto Bootstrap::best_hashes(const Height first, const Height last) const
+    noexcept -> std::vector<block::pHash>
+{
+    auto output = std::vector<block::pHash>{};
+
+    for (auto height{first}; height <= last; ++height) {
+        auto hash = headers_.BestHash(height);
+
+        if (hash->empty()) { break; }
+
+        output.emplace_back(std::move(hash));
+    }
+
+    return output;
+}
+
+auto Bootstrap::Enabled() noexcept -> bool
+{
+    return 1 == OPENTXS_BLOCK_STORAGE_ENABLED;
+}
+
+auto Bootstrap::Export(const std::string& directory) const noexcept -> bool
+{
+    const auto headers = headers_.BestChain().first;
+    const auto filterHeaders = filter_header_position().first;
+    const auto filters = std::min(filter_position().first, filterHeaders);
+    const auto manifest = file(directory, "tips");
+    const auto tips = [&] {
+        auto output = std::string{};
+
+        for (const auto height : {headers, filterHeaders, filters}) {
+            output += std::to_string(height) + ' ' +
+                      headers_.BestHash(height)->asHex() + '\n';
+        }
+
+        return output;
+    }();
+
+    if (exported(directory, manifest, tips)) {
+        LogVerbose(OT_METHOD)(__FUNCTION__)(
+            ": Bootstrap files are already up to date")
+            .Flush();
+
+        return true;
+    }
+
+    auto output = export_headers(file(directory, "headers"), headers);
+    output &=
+        export_filter_headers(file(directory, "cfheaders"), filterHeaders);
+    output &= export_filters(file(directory, "cfilters"), filters);
+
+    // Written last so an incomplete export is repeated on the next attempt
+    output &= save(manifest, [&](std::ostream& out) -> bool {
+        out << tips;
+
+        return out.good();
+    });
+
+    if (output) {
+        LogNormal(blockchain::internal::DisplayString(chain_))(
+            " bootstrap exported to ")(directory)(" up to height ")(headers)(
+            " with filter headers up to height ")(filterHeaders)(
+            " and filters up to height ")(filters)
+            .Flush();
+    }
+
+    return output;
+}
+
+auto Bootstrap::exported(
+    const std::string& directory,
+    const std::string& manifest,
+    const std::string& tips) const noexcept -> bool
+{
+    try {
+        for (const auto* extension : {"headers", "cfheaders", "cfilters"}) {
+            const auto path = file(directory, extension);
+
+            if (false == boost::filesystem::exists(path)) { return false; }
+        }
+
+        auto in = std::ifstream{manifest, std::ios::binary};
+
+        if (false == in.is_open()) { return false; }
+
+        const auto existing = std::string{
+            std::istreambuf_iterator<char>{in},
+            std::istreambuf_iterator<char>{}};
+
+        return existing == tips;
+    } catch (...) {
+
+        return false;
+    }
+}
+
+auto Bootstrap::export_filter_headers(
+    const std::string& file,
+    const Height last) const noexcept -> bool
+{
+    return save(file, [&](std::ostream& out) -> bool {
+        for (auto height = Height{0}; height <= last; ++height) {
+            const auto block = headers_.BestHash(height);
+            const auto hash = database_.LoadFilterHash(type_, block->Bytes());
+            const auto header =
+                database_.LoadFilterHeader(type_, block->Bytes());
+
+            if ((32 != hash->size()) || (32 != header->size())) {
+                LogOutput(OT_METHOD)(__FUNCTION__)(
+                    ": Missing filter header at height ")(height)
+                    .Flush();
+
+                return false;
+            }
+
+            out.write(static_cast<const char*>(hash->data()), hash->size());
+            out.write(static_cast<const char*>(header->data()), header->size());
+        }
+
+        return out.good();
+    });
+}
+
+auto Bootstrap::export_filters(const std::string& file, const Height last)
+    const noexcept -> bool
+{
+    return save(file, [&](std::ostream& out) -> bool {
+        auto record = Space{};
+
+        for (auto height = Height{0}; height <= last; ++height) {
+            const auto block = headers_.BestHash(height);
+            auto serialized{false};
+            database_.ReadFilter(
+                type_, block->Bytes(), [&](const auto& filter) {
+                    serialized = filter.Serialize(writer(record));
+                });
+
+            if (false == serialized) {
+                LogOutput(OT_METHOD)(__FUNCTION__)(
+                    ": Missing filter at height ")(height)
+                    .Flush();
+
+                return false;
+            }
+
+            const auto size =
+                blockchain::bitcoin::CompactSize(record.size()).Encode();
+            out.write(reinterpret_cast<const char*>(size.data()), size.size());
+            out.write(
+                reinterpret_cast<const char*>(record.data()), record.size());
+        }
+
+        return out.good();
+    });
+}
+
+auto Bootstrap::export_headers(const std::string& file, const Height last)
+    const noexcept -> bool
+{
+    return save(file, [&](std::ostream& out) -> bool {
+        for (auto height = Height{0}; height <= last; ++height) {
+            const auto hash = headers_.BestHash(height);
+            const auto view = headers_.LoadHeaderView(hash->Bytes());
+
+            if (false == view.has_value()) {
+                LogOutput(OT_METHOD)(__FUNCTION__)(
+                    ": Missing header at height ")(height)
+                    .Flush();
+
+                return false;
+            }
+
+            const auto raw = view->Record().Raw();
+            out.write(raw.data(), raw.size());
+        }
+
+        return out.good();
+    });
+}
+
+auto Bootstrap::file(
+    const std::string& directory,
+    const std::string& extension) const noexcept -> std::string
+{
+    const auto name = blockchain::internal::Ticker(chain_) + "." + extension;
+
+    return (boost::filesystem::path{directory} / name).string();
+}
+
+auto Bootstrap::filter_header_position() const noexcept -> block::Position
+{
+    return headers_.CommonParent(database_.FilterHeaderTip(type_)).first;
+}
+
+auto Bootstrap::filter_position() const noexcept -> block::Position
+{
+    return headers_.CommonParent(database_.FilterTip(type_)).first;
+}
+
+auto Bootstrap::Import(
+    const std::string& directory,
+    const Instantiate& instantiate,
+    internal::ParallelScan& job,
+    const Dispatch& dispatch) noexcept -> bool
+{
+#if OPENTXS_BLOCK_STORAGE_ENABLED
+    using File = boost::iostreams::mapped_file_source;
+
+    const auto map = [](const std::string& path) -> std::optional<File> {
+        try {
+            auto output = File{path};
+
+            if (output.is_open()) { return output; }
+        } catch (...) {
+        }
+
+        return std::nullopt;
+    };
+    const auto view = [](const File& file) -> ReadView {
+        return {file.data(), file.size()};
+    };
+    const auto headers = map(file(directory, "headers"));
+
+    if (false == headers.has_value()) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(": Failed to open ")(
+            file(directory, "headers"))
+            .Flush();
+
+        return false;
+    }
+
+    if (false ==
+        import_headers(view(headers.value()), instantiate, job, dispatch)) {
+
+        return false;
+    }
+
+    if (const auto cfheaders = map(file(directory, "cfheaders"));
+        cfheaders.has_value()) {
+        import_filter_headers(
+            view(headers.value()), view(cfheaders.value()), job, dispatch);
+    }
+
+    if (const auto cfilters = map(file(directory, "cfilters"));
+        cfilters.has_value()) {
+        import_filters(view(cfilters.value()), job, dispatch);
+    }
+
+    return true;
+#else
+    LogOutput(OT_METHOD)(__FUNCTION__)(
+        ": Memory mapped files are not supported on this platform")
+        .Flush();
+
+    return false;
+#endif  // OPENTXS_BLOCK_STORAGE_ENABLED
+}
+
+auto Bootstrap::import_filter_headers(
+    const ReadView blockHeaders,
+    const ReadView bytes,
+    internal::ParallelScan& job,
+    const Dispatch& dispatch) const noexcept -> void
+{
+    if ((0 == bytes.size()) || (0 != (bytes.size() % filter_header_bytes_))) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(": Invalid file size").Flush();
+
+        return;
+    }
+
+    // Records are only imported for blocks whose hash in the header file
+    // matches the local best chain at the same height
+    const auto blockHash = [&](const Height height) -> Space {
+        const auto offset = static_cast<std::size_t>(height) * header_bytes_;
+        auto output = Space{};
+        BlockHash(
+            api_,
+            chain_,
+            {blockHeaders.data() + offset, header_bytes_},
+            writer(output));
+
+        return output;
+    };
+
+    const auto hash = [&](const Height height) -> ReadView {
+        const auto offset = static_cast<std::size_t>(height) *
+                            filter_header_bytes_;
+
+        return {bytes.data() + offset, filter_header_bytes_ / 2};
+    };
+    const auto header = [&](const Height height) -> ReadView {
+        const auto offset = static_cast<std::size_t>(height) *
+                            filter_header_bytes_;
+
+        return {
+            bytes.data() + offset + (filter_header_bytes_ / 2),
+            filter_header_bytes_ / 2};
+    };
+    const auto count = std::min(
+        static_cast<Height>(bytes.size() / filter_header_bytes_),
+        static_cast<Height>(blockHeaders.size() / header_bytes_));
+    const auto end = std::min(count - 1, headers_.BestChain().first);
+    const auto [tip, tipHash] = filter_header_position();
+
+    if (tip >= end) { return; }
+
+    if ((reader(blockHash(tip)) != tipHash->Bytes()) ||
+        (database_.LoadFilterHeader(type_, tipHash->Bytes())->Bytes() !=
+         header(tip))) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(
+            ": File does not match local filter header at height ")(tip)
+            .Flush();
+
+        return;
+    }
+
+    for (auto next = tip + 1; next <= end;) {
+        const auto last =
+            std::min(next + static_cast<Height>(filter_header_batch_) - 1, end);
+        const auto blocks = best_hashes(next, last);
+        // Each filter header commits to its filter hash and the previous
+        // header so every record can be checked independently
+        const auto process = [&](const Height height) -> bool {
+            const auto index = static_cast<std::size_t>(height - next);
+
+            if (index >= blocks.size()) { return false; }
+
+            if (reader(blockHash(height)) != blocks.at(index)->Bytes()) {
+                return false;
+            }
+
+            const auto expected = blockchain::internal::FilterHashToHeader(
+                api_, hash(height), header(height - 1));
+
+            return expected->Bytes() == header(height);
+        };
+        const auto checked = job.Run(next, last, process, dispatch);
+        const auto valid = std::min(
+            checked.value_or(next - 1),
+            next + static_cast<Height>(blocks.size()) - 1);
+
+        if (valid < next) {
+            LogOutput(OT_METHOD)(__FUNCTION__)(
+                ": Invalid filter header at height ")(next)
+                .Flush();
+
+            return;
+        }
+
+        auto rows = std::vector<internal::FilterDatabase::Header>{};
+        rows.reserve(static_cast<std::size_t>(valid - next + 1));
+
+        for (auto height{next}; height <= valid; ++height) {
+            rows.emplace_back(
+                blocks.at(static_cast<std::size_t>(height - next)),
+                api_.Factory().Data(header(height)),
+                hash(height));
+        }
+
+        if (false == database_.StoreFilterHeaders(
+                         type_, header(next - 1), std::move(rows))) {
+            LogOutput(OT_METHOD)(__FUNCTION__)(": Database error").Flush();
+
+            return;
+        }
+
+        const auto position = block::Position{
+            valid, blocks.at(static_cast<std::size_t>(valid - next))};
+        database_.SetFilterHeaderTip(type_, position);
+        LogNormal(blockchain::internal::DisplayString(chain_))(
+            " bootstrap imported filter headers up to height ")(valid)
+            .Flush();
+
+        if (valid < last) {
+            LogOutput(OT_METHOD)(__FUNCTION__)(
+                ": Invalid filter header at height ")(valid + 1)
+                .Flush();
+
+            return;
+        }
+
+        next = valid + 1;
+    }
+}
+
+auto Bootstrap::import_filters(
+    const ReadView bytes,
+    internal::ParallelScan& job,
+    const Dispatch& dispatch) const noexcept -> void
+{
+    const auto end = filter_header_position().first;
+    const auto [tip, tipHash] = filter_position();
+
+    if (tip >= end) { return; }
+
+    // Records have variable length so their positions must be found in order
+    auto records = std::vector<ReadView>{};
+
+    {
+        auto it =
+            reinterpret_cast<blockchain::bitcoin::ByteIterator>(bytes.data());
+        auto expected = std::size_t{0};
+
+        while (static_cast<Height>(records.size()) <= end) {
+            auto size = std::size_t{};
+            ++expected;
+
+            if ((bytes.size() < expected) ||
+                (false == blockchain::bitcoin::DecodeCompactSizeFromPayload(
+                              it, expected, bytes.size(), size)) ||
+                (size > (bytes.size() - expected))) {
+                break;
+            }
+
+            records.emplace_back(reinterpret_cast<const char*>(it), size);
+            std::advance(it, size);
+            expected += size;
+        }
+    }
+
+    const auto available =
+        std::min(end, static_cast<Height>(records.size()) - 1);
+
+    for (auto next = tip + 1; next <= available;) {
+        const auto last =
+            std::min(next + static_cast<Height>(filter_batch_) - 1, available);
+        const auto blocks = best_hashes(next, last);
+        auto expected = std::vector<OTData>{};
+        expected.reserve(blocks.size());
+
+        for (const auto& block : blocks) {
+            expected.emplace_back(
+                database_.LoadFilterHash(type_, block->Bytes()));
+        }
+
+        auto filters =
+            std::vector<std::unique_ptr<const blockchain::internal::GCS>>(
+                blocks.size());
+        // The filters borrow the mapped file which outlives the batch
+        const auto process = [&](const Height height) -> bool {
+            const auto index = static_cast<std::size_t>(height - next);
+
+            if (index >= blocks.size()) { return false; }
+
+            const auto& record = records.at(static_cast<std::size_t>(height));
+            const auto& block = blocks.at(index);
+
+            try {
+                // The key is not covered by the filter hash
+                const auto& serialized =
+                    blockchain::internal::SerializedFilter::Header(record);
+                const auto key = blockchain::internal::BlockHashToFilterKey(
+                    block->Bytes());
+
+                if (serialized.Key() != key) { return false; }
+            } catch (...) {
+
+                return false;
+            }
+
+            auto pFilter = std::unique_ptr<const blockchain::internal::GCS>{
+                opentxs::Factory::GCS(api_, record, true)};
+
+            if (false == bool(pFilter)) { return false; }
+
+            if (pFilter->Hash()->Bytes() != expected.at(index)->Bytes()) {
+                return false;
+            }
+
+            filters.at(index) = std::move(pFilter);
+
+            return true;
+        };
+        const auto checked = job.Run(next, last, process, dispatch);
+        const auto valid = checked.value_or(next - 1);
+
+        if (valid < next) {
+            LogOutput(OT_METHOD)(__FUNCTION__)(": Invalid filter at height ")(
+                next)
+                .Flush();
+
+            return;
+        }
+
+        auto rows = std::vector<internal::FilterDatabase::Filter>{};
+        rows.reserve(static_cast<std::size_t>(valid - next + 1));
+
+        for (auto height{next}; height <= valid; ++height) {
+            const auto index = static_cast<std::size_t>(height - next);
+            rows.emplace_back(
+                blocks.at(index)->Bytes(), std::move(filters.at(index)));
+        }
+
+        if (false == database_.StoreFilters(type_, std::move(rows))) {
+            LogOutput(OT_METHOD)(__FUNCTION__)(": Database error").Flush();
+
+            return;
+        }
+
+        const auto position = block::Position{
+            valid, blocks.at(static_cast<std::size_t>(valid - next))};
+        database_.SetFilterTip(type_, position);
+        LogNormal(blockchain::internal::DisplayString(chain_))(
+            " bootstrap imported filters up to height ")(valid)
+            .Flush();
+
+        if (valid < last) {
+            LogOutput(OT_METHOD)(__FUNCTION__)(": Invalid filter at height ")(
+                valid + 1)
+                .Flush();
+
+            return;
+        }
+
+        next = valid + 1;
+    }
+}
+
+auto Bootstrap::import_headers(
+    const ReadView bytes,
+    const Instantiate& instantiate,
+    internal::ParallelScan& job,
+    const Dispatch& dispatch) noexcept -> bool
+{
+    if ((0 == bytes.size()) || (0 != (bytes.size() % header_bytes_))) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(": Invalid file size").Flush();
+
+        return false;
+    }
+
+    const auto record = [&](const Height height) -> ReadView {
+        const auto offset = static_cast<std::size_t>(height) * header_bytes_;
+
+        return {bytes.data() + offset, header_bytes_};
+    };
+    const auto hash = [&](const Height height) -> Space {
+        auto output = Space{};
+        BlockHash(api_, chain_, record(height), writer(output));
+
+        return output;
+    };
+
+    try {
+        const auto& genesis = HeaderOracle::GenesisBlockHash(chain_);
+
+        if (reader(hash(0)) != genesis.Bytes()) {
+            LogOutput(OT_METHOD)(__FUNCTION__)(
+                ": File does not contain headers for this chain")
+                .Flush();
+
+            return false;
+        }
+    } catch (...) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(": Unsupported chain").Flush();
+
+        return false;
+    }
+
+    const auto count = static_cast<Height>(bytes.size() / header_bytes_);
+    const auto [height, best] = headers_.BestChain();
+
+    if (height >= (count - 1)) {
+        LogVerbose(OT_METHOD)(__FUNCTION__)(
+            ": Local chain already contains every header")
+            .Flush();
+
+        return true;
+    }
+
+    // If the local chain has diverged from the file the header oracle decides
+    // between them as it would for headers received from a peer
+    auto next =
+        (reader(hash(height)) == best->Bytes()) ? height + 1 : Height{1};
+    auto previous = hash(next - 1);
+
+    while (next < count) {
+        const auto last =
+            std::min(next + static_cast<Height>(header_batch_) - 1, count - 1);
+        auto serialized = std::vector<ReadView>{};
+        serialized.reserve(static_cast<std::size_t>(last - next + 1));
+
+        for (auto i{next}; i <= last; ++i) {
+            serialized.emplace_back(record(i));
+        }
+
+        auto batch =
+            internal::PrepareHeaders(serialized, instantiate, job, dispatch);
+
+        if (false == batch.empty()) {
+            const auto linked = job.Run(
+                0,
+                static_cast<Height>(batch.size()) - 1,
+                [&](const Height i) -> bool {
+                    const auto index = static_cast<std::size_t>(i);
+                    const auto parent =
+                        (0 == index) ? reader(previous)
+                                     : batch.at(index - 1)->Hash().Bytes();
+
+                    return batch.at(index)->ParentHash().Bytes() == parent;
+                },
+                dispatch);
+            batch.resize(
+                linked.has_value() ? static_cast<std::size_t>(*linked + 1)
+                                   : std::size_t{0});
+        }
+
+        if (batch.empty()) {
+            LogOutput(OT_METHOD)(__FUNCTION__)(": Invalid header at height ")(
+                next)
+                .Flush();
+
+            break;
+        }
+
+        const auto complete = (batch.size() == serialized.size());
+        const auto imported = next + static_cast<Height>(batch.size()) - 1;
+        previous = space(batch.back()->Hash().Bytes());
+
+        if (false == headers_.AddHeaders(batch)) {
+            LogOutput(OT_METHOD)(__FUNCTION__)(": Failed to add headers")
+                .Flush();
+
+            return false;
+        }
+
+        LogNormal(blockchain::internal::DisplayString(chain_))(
+            " bootstrap imported headers up to height ")(imported)
+            .Flush();
+
+        if (false == complete) {
+            LogOutput(OT_METHOD)(__FUNCTION__)(": Invalid header at height ")(
+                imported + 1)
+                .Flush();
+
+            break;
+        }
+
+        next = imported + 1;
+    }
+
+    return true;
+}
+
+auto Bootstrap::save(
+    const std::string& file,
+    const std::function<bool(std::ostream&)>& write) noexcept -> bool
+{
+    // Written beside the destination so an interrupted export never replaces
+    // a complete file
+    const auto temp = file + ".tmp";
+
+    try {
+        {
+            auto out = std::ofstream{
+                temp, std::ios::binary | std::ios::out | std::ios::trunc};
+
+            if (false == out.is_open()) {
+                LogOutput(OT_METHOD)(__FUNCTION__)(": Failed to open ")(temp)
+                    .Flush();
+
+                return false;
+            }
+
+            if (false == write(out)) {
+                out.close();
+                boost::filesystem::remove(temp);
+
+                return false;
+            }
+        }
+
+        boost::filesystem::rename(temp, file);
+
+        return true;
+    } catch (const std::exception& e) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(": ")(e.what()).Flush();
+
+        return false;
+    }
+}
+}  // namespace opentxs::blockchain::client
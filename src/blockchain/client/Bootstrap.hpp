@@ -0,0 +1,141 @@
+// Copyright (c) 2010-2020 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "internal/blockchain/client/Client.hpp"
+#include "opentxs/Bytes.hpp"
+#include "opentxs/blockchain/Blockchain.hpp"
+
+namespace opentxs
+{
+namespace api
+{
+class Core;
+}  // namespace api
+
+namespace blockchain
+{
+namespace block
+{
+class Header;
+}  // namespace block
+}  // namespace blockchain
+}  // namespace opentxs
+
+namespace opentxs::blockchain::client
+{
+// Copies the best chain headers, filter headers and filters to and from flat
+// files so a new node can start from a trusted archive instead of downloading
+// them from peers. The directory holds up to three files per chain, each of
+// which contains one record per block starting from the genesis block:
+//
+//   <ticker>.headers    raw 80 byte block header
+//   <ticker>.cfheaders  32 byte filter hash followed by 32 byte filter header
+//   <ticker>.cfilters   CompactSize length followed by a serialized filter
+//
+// Filter records are for the default filter type of the chain. The filter
+// files are optional and may contain fewer records than the header file.
+// Exporting also writes <ticker>.tips which records the height and block hash
+// of the last record in each file.
+class Bootstrap
+{
+public:
+    using Dispatch = internal::ParallelScan::Dispatch;
+    using Instantiate =
+        std::function<std::unique_ptr<block::Header>(const ReadView)>;
+
+    static constexpr auto header_bytes_ = std::size_t{80};
+    static constexpr auto filter_header_bytes_ = std::size_t{64};
+
+    OPENTXS_EXPORT static auto Enabled() noexcept -> bool;
+
+    /// Writes every file for the chain unless the files already end at the
+    /// current tips. Returns false if any file could not be written, in which
+    /// case existing files are left unchanged.
+    OPENTXS_EXPORT auto Export(const std::string& directory) const noexcept
+        -> bool;
+
+    /// Validates and stores the records which extend the local chain.
+    /// Importing stops at the first invalid record. Returns false if the
+    /// header file is missing or invalid.
+    OPENTXS_EXPORT auto Import(
+        const std::string& directory,
+        const Instantiate& instantiate,
+        internal::ParallelScan& job,
+        const Dispatch& dispatch) noexcept -> bool;
+
+    OPENTXS_EXPORT Bootstrap(
+        const api::Core& api,
+        const Type chain,
+        internal::HeaderOracle& headers,
+        const internal::FilterDatabase& database) noexcept;
+
+    OPENTXS_EXPORT ~Bootstrap() = default;
+
+private:
+    using Height = block::Height;
+
+    // Records stored per database write transaction
+    static const std::size_t header_batch_;
+    static const std::size_t filter_header_batch_;
+    static const std::size_t filter_batch_;
+
+    const api::Core& api_;
+    const Type chain_;
+    const filter::Type type_;
+    internal::HeaderOracle& headers_;
+    const internal::FilterDatabase& database_;
+
+    static auto save(
+        const std::string& file,
+        const std::function<bool(std::ostream&)>& write) noexcept -> bool;
+
+    auto best_hashes(const Height first, const Height last) const noexcept
+        -> std::vector<block::pHash>;
+    auto exported(
+        const std::string& directory,
+        const std::string& manifest,
+        const std::string& tips) const noexcept -> bool;
+    auto export_filter_headers(const std::string& file, const Height last)
+        const noexcept -> bool;
+    auto export_filters(const std::string& file, const Height last) const
+        noexcept -> bool;
+    auto export_headers(const std::string& file, const Height last) const
+        noexcept -> bool;
+    auto file(const std::string& directory, const std::string& extension)
+        const noexcept -> std::string;
+    auto filter_position() const noexcept -> block::Position;
+    auto filter_header_position() const noexcept -> block::Position;
+    auto import_filter_headers(
+        const ReadView blockHeaders,
+        const ReadView bytes,
+        internal::ParallelScan& job,
+        const Dispatch& dispatch) const noexcept -> void;
+    auto import_filters(
+        const ReadView bytes,
+        internal::ParallelScan& job,
+        const Dispatch& dispatch) const noexcept -> void;
+
+    auto import_headers(
+        const ReadView bytes,
+        const Instantiate& instantiate,
+        internal::ParallelScan& job,
+        const Dispatch& dispatch) noexcept -> bool;
+
+    Bootstrap() = delete;
+    Bootstrap(const Bootstrap&) = delete;
+    Bootstrap(Bootstrap&&) = delete;
+    Bootstrap& operator=(const Bootstrap&) = delete;
+    Bootstrap& operator=(Bootstrap&&) = delete;
+};
+}  // namespace opentxs::blockchain::client
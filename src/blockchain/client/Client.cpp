@@ -10,22 +10,49 @@
 #include <boost/asio.hpp>
 #include <boost/bind.hpp>
 #include <algorithm>
+#include <cstdint>
 #include <functional>
+#include <map>
+#include <mutex>
+#include <memory>
+#include <optional>
 #include <thread>
+#include <utility>
+#include <vector>
 
 #include "opentxs/Pimpl.hpp"
 #include "opentxs/api/Core.hpp"
 #include "opentxs/api/Endpoints.hpp"
+#include "opentxs/blockchain/block/Header.hpp"
 #include "opentxs/core/Log.hpp"
 #include "opentxs/core/LogSource.hpp"
 #include "opentxs/network/zeromq/Context.hpp"
 #include "opentxs/network/zeromq/Frame.hpp"
 #include "opentxs/network/zeromq/FrameSection.hpp"
 #include "opentxs/network/zeromq/Message.hpp"
+#include "opentxs/network/zeromq/socket/Push.hpp"
 #include "opentxs/network/zeromq/socket/Socket.hpp"
 
 namespace opentxs::blockchain::client::internal
 {
+namespace
+{
+// Thread pool messages refer to a job by id since a queued helper may run
+// after the job has been destroyed
+struct Jobs {
+    std::mutex lock_{};
+    std::size_t next_{0};
+    std::map<std::size_t, ParallelScan*> map_{};
+};
+
+auto jobs() noexcept -> Jobs&
+{
+    static auto output = Jobs{};
+
+    return output;
+}
+}  // namespace
+
 IO::IO(const api::Core& api) noexcept
     : api_(api)
     , lock_()
@@ -153,4 +180,225 @@ auto IO::Shutdown() noexcept -> void
 }
 
 IO::~IO() { Shutdown(); }
+
+ParallelScan::ParallelScan(
+    const std::size_t threads,
+    const Height chunk) noexcept
+    : id_([] {
+        auto& jobs = internal::jobs();
+        Lock lock(jobs.lock_);
+
+        return ++jobs.next_;
+    }())
+    , threads_(
+          (0 < threads)
+              ? threads
+              : std::max(std::size_t{std::thread::hardware_concurrency()},
+                         std::size_t{1}))
+    , chunk_(std::max(chunk, Height{1}))
+    , lock_()
+    , finished_()
+    , generation_(0)
+    , running_(false)
+    , process_(nullptr)
+    , next_(0)
+    , last_(-1)
+    , stop_(0)
+    , active_(0)
+    , helpers_(0)
+{
+    auto& jobs = internal::jobs();
+    Lock lock(jobs.lock_);
+    jobs.map_.emplace(id_, this);
+}
+
+auto ParallelScan::Dispatcher(
+    const api::Core& api,
+    const zmq::socket::Push& socket,
+    const Type chain) noexcept -> Dispatch
+{
+    return [&api, &socket, chain](
+               ParallelScan& job, const std::size_t generation) {
+        auto work = api.ZeroMQ().Message(chain);
+        work->AddFrame(ThreadPool::Work::ParallelScan);
+        work->AddFrame();
+        work->AddFrame(job.id_);
+        work->AddFrame(generation);
+        socket.Send(work);
+    };
+}
+
+auto ParallelScan::Help(const std::size_t generation) noexcept -> void
+{
+    Lock lock(lock_);
+
+    if ((generation != generation_) || (false == running_)) { return; }
+
+    run(lock);
+}
+
+auto ParallelScan::ProcessTask(const zmq::Message& in) noexcept -> void
+{
+    const auto body = in.Body();
+
+    if (2 > body.size()) {
+        LogOutput("opentxs::blockchain::client::internal::ParallelScan::")(
+            __FUNCTION__)(": Invalid message")
+            .Flush();
+
+        OT_FAIL;
+    }
+
+    auto* pJob = [&]() -> ParallelScan* {
+        auto& jobs = internal::jobs();
+        Lock lock(jobs.lock_);
+        auto it = jobs.map_.find(body.at(0).as<std::size_t>());
+
+        if (jobs.map_.end() == it) { return nullptr; }
+
+        auto* output = it->second;
+        Lock job(output->lock_);
+        ++output->helpers_;
+
+        return output;
+    }();
+
+    if (nullptr == pJob) { return; }
+
+    auto& job = *pJob;
+    job.Help(body.at(1).as<std::size_t>());
+    Lock lock(job.lock_);
+
+    if (0 == --job.helpers_) { job.finished_.notify_all(); }
+}
+
+auto ParallelScan::run(Lock& lock) noexcept -> void
+{
+    OT_ASSERT(nullptr != process_);
+
+    const auto& process = *process_;
+
+    // Chunks are claimed in height order and never above a height which
+    // failed, so every block below stop_ is processed once all active chunks
+    // have finished
+    while (next_ <= std::min(last_, stop_ - 1)) {
+        const auto first = next_;
+        const auto last = std::min(first + chunk_ - 1, last_);
+        next_ = last + 1;
+        ++active_;
+        lock.unlock();
+        auto failed = std::optional<Height>{};
+
+        for (auto i{first}; i <= last; ++i) {
+            if (false == process(i)) {
+                failed = i;
+
+                break;
+            }
+        }
+
+        lock.lock();
+
+        if (failed.has_value()) { stop_ = std::min(stop_, failed.value()); }
+
+        if (0 == --active_) { finished_.notify_all(); }
+    }
+}
+
+auto ParallelScan::Run(
+    const Height first,
+    const Height last,
+    const Process& process,
+    const Dispatch& dispatch) noexcept -> std::optional<Height>
+{
+    if (last < first) { return {}; }
+
+    Lock lock(lock_);
+    const auto generation = ++generation_;
+    running_ = true;
+    process_ = &process;
+    next_ = first;
+    last_ = last;
+    stop_ = last + 1;
+    active_ = 0;
+    lock.unlock();
+
+    if (dispatch) {
+        const auto chunks =
+            static_cast<std::size_t>(((last - first) / chunk_) + 1);
+        const auto helpers = std::min(threads_, chunks) - 1;
+
+        for (auto i = std::size_t{0}; i < helpers; ++i) {
+            dispatch(*this, generation);
+        }
+    }
+
+    lock.lock();
+    run(lock);
+    finished_.wait(lock, [this] { return 0 == active_; });
+    running_ = false;
+    process_ = nullptr;
+
+    if (stop_ <= first) { return {}; }
+
+    return stop_ - 1;
+}
+
+ParallelScan::~ParallelScan()
+{
+    {
+        auto& jobs = internal::jobs();
+        Lock lock(jobs.lock_);
+        jobs.map_.erase(id_);
+    }
+
+    Lock lock(lock_);
+    finished_.wait(lock, [this] { return 0 == helpers_; });
+}
+
+auto PrepareHeaders(
+    const std::vector<ReadView>& serialized,
+    const std::function<std::unique_ptr<block::Header>(const ReadView)>&
+        instantiate,
+    ParallelScan& job,
+    const ParallelScan::Dispatch& dispatch) noexcept
+    -> std::vector<std::unique_ptr<block::Header>>
+{
+    using Height = ParallelScan::Height;
+    auto output =
+        std::vector<std::unique_ptr<block::Header>>(serialized.size());
+
+    if (serialized.empty()) { return output; }
+
+    // Every slot is written by exactly one thread
+    const auto process = [&](const Height height) -> bool {
+        const auto index = static_cast<std::size_t>(height);
+        auto pHeader = instantiate(serialized.at(index));
+
+        if (false == bool(pHeader)) { return false; }
+
+        if (false == pHeader->Valid()) { return false; }
+
+        output.at(index) = std::move(pHeader);
+
+        return true;
+    };
+    const auto last = static_cast<Height>(serialized.size()) - 1;
+    const auto prepared = job.Run(0, last, process, dispatch);
+    const auto count = prepared.has_value()
+                           ? static_cast<std::size_t>(prepared.value() + 1)
+                           : std::size_t{0};
+
+    if (count < serialized.size()) {
+        LogOutput("opentxs::blockchain::client::internal::")(__FUNCTION__)(
+            ": Header ")(count)(" of ")(serialized.size())(
+            " is invalid or does not meet its target")
+            .Flush();
+    }
+
+    // Headers after the first failure may have been prepared by other threads
+    output.resize(count);
+
+    return output;
+}
 }  // namespace opentxs::blockchain::client::internal
@@ -8,8 +8,12 @@
 #include "blockchain/client/FilterOracle.hpp"  // IWYU pragma: associated
 
 #include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <iterator>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
 #include <string_view>
 #include <tuple>
 #include <type_traits>
@@ -23,6 +27,7 @@
 #include "opentxs/api/Endpoints.hpp"
 #include "opentxs/api/Factory.hpp"
 #include "opentxs/blockchain/block/Header.hpp"
+#include "opentxs/blockchain/block/bitcoin/Block.hpp"
 #include "opentxs/blockchain/client/HeaderOracle.hpp"
 #include "opentxs/core/Flag.hpp"
 #include "opentxs/core/Log.hpp"
@@ -33,6 +38,8 @@
 #include "opentxs/network/zeromq/Message.hpp"
 #include "opentxs/network/zeromq/Pipeline.hpp"
 #include "opentxs/network/zeromq/socket/Publish.hpp"
+#include "opentxs/network/zeromq/socket/Push.hpp"
+#include "opentxs/network/zeromq/socket/Socket.hpp"
 
 #define OT_METHOD "opentxs::blockchain::client::implementation::FilterOracle::"
 
@@ -54,7 +61,15 @@ auto BlockchainFilterOracle(
 
 namespace opentxs::blockchain::client::implementation
 {
+const std::uint8_t FilterOracle::gcs_bits_{19};
+const std::uint32_t FilterOracle::gcs_fp_rate_{784931};
+const block::Height FilterOracle::block_batch_{100};
+const std::size_t FilterOracle::FilterCache::overhead_{256};
 const std::chrono::seconds FilterOracle::FilterQueue::timeout_{20};
+const std::size_t FilterOracle::FilterQueue::window_{4};
+const block::Height FilterOracle::HeaderSegments::interval_{1000};
+const std::chrono::seconds FilterOracle::HeaderSegments::timeout_{20};
+const std::size_t FilterOracle::HeaderSegments::window_{8};
 const std::chrono::seconds FilterOracle::RequestQueue::limit_{15};
 
 FilterOracle::FilterOracle(
@@ -68,9 +83,19 @@ FilterOracle::FilterOracle(
     , network_(network)
     , database_(database)
     , default_type_(blockchain::internal::DefaultFilter(type))
+    , source_(filter_source(database.FilterPolicy(), default_type_))
+    , cache_(database.FilterCacheSize())
     , header_requests_(api_)
-    , outstanding_filters_(api_)
+    , checkpoint_requests_(api_)
+    , header_segments_(api_)
+    , outstanding_filters_()
     , socket_(api.ZeroMQ().PublishSocket())
+    , thread_pool_(
+          api.ZeroMQ().PushSocket(zmq::socket::Socket::Direction::Connect))
+    , job_(0)
+    , dispatch_(internal::ParallelScan::Dispatcher(api_, thread_pool_, type))
+    , blocks_()
+    , verified_(-1)
     , init_promise_()
     , init_(init_promise_.get_future())
 {
@@ -79,19 +104,76 @@ FilterOracle::FilterOracle(
 
     OT_ASSERT(zmq);
 
+    zmq = thread_pool_->Start(api.Endpoints().InternalBlockchainThreadPool());
+
+    OT_ASSERT(zmq);
+
     init_executor({shutdown, api.Endpoints().BlockchainReorg()});
 }
 
-FilterOracle::FilterQueue::FilterQueue(const api::Core& api) noexcept
-    : error_(false)
-    , api_(api)
-    , running_(false)
-    , queued_(0)
+FilterOracle::BlockQueue::BlockQueue() noexcept
+    : first_(-1)
+    , blocks_()
+{
+}
+
+FilterOracle::FilterCache::FilterCache(const std::size_t budget) noexcept
+    : budget_(budget)
+    , lock_()
+    , hits_(0)
+    , misses_(0)
+    , probation_()
+    , protected_()
+    , index_()
+    , used_(0)
+{
+}
+
+FilterOracle::FilterQueue::Batch::Batch(
+    const block::Height first,
+    const int peer) noexcept
+    : first_(first)
     , filters_()
-    , last_received_()
-    , target_(make_blank<block::Position>::value(api))
+    , queued_(0)
+    , peer_(peer)
+    , sent_(Clock::now())
+    , last_received_(sent_)
+    , partial_(false)
+{
+}
+
+FilterOracle::FilterQueue::FilterQueue() noexcept
+    : assigned_(0)
+    , batches_()
+    , peers_()
+    , flushed_()
+{
+}
+
+FilterOracle::FilterQueue::Throughput::Throughput() noexcept
+    : rate_(0)
+    , batches_(0)
+{
+}
+
+FilterOracle::HeaderSegments::HeaderSegments(const api::Core& api) noexcept
+    : api_(api)
+    , conflict_(false)
+    , checkpoints_()
+    , unconfirmed_()
+    , requested_()
+    , received_()
+{
+}
+
+FilterOracle::HeaderSegments::Segment::Segment(
+    const api::Core& api,
+    const ReadView previous) noexcept
+    : previous_(api.Factory().Data(previous))
+    , hashes_()
+    , headers_()
+    , stop_(make_blank<block::Position>::value(api))
 {
-    filters_.reserve(1000);
 }
 
 FilterOracle::RequestQueue::RequestQueue(const api::Core& api) noexcept
@@ -99,156 +181,716 @@ FilterOracle::RequestQueue::RequestQueue(const api::Core& api) noexcept
 {
 }
 
+auto FilterOracle::BlockQueue::at(const block::Height height) const
+    noexcept(false) -> const Item&
+{
+    if (height < first_) { throw std::out_of_range("Height before batch"); }
+
+    return blocks_.at(static_cast<std::size_t>(height - first_));
+}
+
+auto FilterOracle::BlockQueue::Ready(
+    const client::HeaderOracle& headers,
+    const client::BlockOracle& blocks,
+    const block::Height first,
+    const block::Height last) noexcept -> bool
+{
+    const auto count = static_cast<std::size_t>(last - first + 1);
+
+    if ((first != first_) || (count != blocks_.size())) {
+        Reset();
+        first_ = first;
+        blocks_.reserve(count);
+
+        for (auto i{first}; i <= last; ++i) {
+            auto hash = headers.BestHash(i);
+
+            if (hash->empty()) {
+                Reset();
+
+                return false;
+            }
+
+            auto future = blocks.LoadBitcoin(hash);
+            blocks_.emplace_back(std::move(hash), std::move(future));
+        }
+    }
+
+    for (const auto& [hash, future] : blocks_) {
+        static constexpr auto zero = std::chrono::seconds{0};
+
+        if (std::future_status::ready != future.wait_for(zero)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+auto FilterOracle::BlockQueue::Reset() noexcept -> void
+{
+    first_ = -1;
+    blocks_.clear();
+}
+
+auto FilterOracle::build_filter(
+    const filter::Type type,
+    const block::Height height) const noexcept -> Pointer
+{
+    try {
+        const auto& [hash, future] = blocks_.at(height);
+        const auto pBlock = future.get();
+
+        if (false == bool(pBlock)) { return {}; }
+
+        return Factory::GCS(
+            api_,
+            gcs_bits_,
+            gcs_fp_rate_,
+            blockchain::internal::BlockHashToFilterKey(hash->Bytes()),
+            pBlock->ExtractElements(type));
+    } catch (...) {
+
+        return {};
+    }
+}
+
+auto FilterOracle::build_filters(
+    const filter::Type type,
+    Cleanup& repeat) noexcept -> void
+{
+    const auto& headers = network_.HeaderOracle();
+    const auto [start, best] = headers.CommonParent(database_.FilterTip(type));
+
+    if (start == best) {
+        repeat.Off();
+
+        return;
+    }
+
+    const auto first{start.first + static_cast<block::Height>(1)};
+    const auto last = std::min(first + block_batch_ - 1, best.first);
+
+    if (false == blocks_.Ready(headers, network_.BlockOracle(), first, last)) {
+        return;
+    }
+
+    const auto began = Clock::now();
+    auto filters =
+        std::vector<Pointer>(static_cast<std::size_t>(last - first + 1));
+    const auto process = [&](const block::Height height) -> bool {
+        auto& output = filters.at(static_cast<std::size_t>(height - first));
+        output = build_filter(type, height);
+
+        return bool(output);
+    };
+    const auto built = job_.Run(first, last, process, dispatch_);
+
+    if (false == built.has_value()) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(
+            ": Failed to build filter for block at height ")(first)
+            .Flush();
+        blocks_.Reset();
+
+        return;
+    }
+
+    const auto previous =
+        database_.LoadFilterHeader(type, start.second->Bytes());
+    auto prior = previous;
+    auto position = start;
+    auto hashes = std::vector<OTData>{};
+    auto headerRows = std::vector<internal::FilterDatabase::Header>{};
+    auto filterRows = std::vector<internal::FilterDatabase::Filter>{};
+    hashes.reserve(filters.size());
+
+    for (auto i{first}; i <= built.value(); ++i) {
+        const auto& blockHash = blocks_.at(i).first;
+        auto& pFilter = filters.at(static_cast<std::size_t>(i - first));
+        const auto& hash = hashes.emplace_back(pFilter->Hash());
+        auto header = blockchain::internal::FilterHashToHeader(
+            api_, hash->Bytes(), prior->Bytes());
+        prior = header;
+        headerRows.emplace_back(blockHash, std::move(header), hash->Bytes());
+        filterRows.emplace_back(blockHash->Bytes(), std::move(pFilter));
+        position = block::Position{i, blockHash};
+    }
+
+    auto stored = database_.StoreFilterHeaders(
+        type, previous->Bytes(), std::move(headerRows));
+    stored &= database_.StoreFilters(type, std::move(filterRows));
+    blocks_.Reset();
+
+    if (false == stored) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(": Database error").Flush();
+
+        return;
+    }
+
+    database_.SetFilterHeaderTip(type, position);
+    database_.SetFilterTip(type, position);
+    auto work = MakeWork(OTZMQWorkType{OT_ZMQ_NEW_FILTER_SIGNAL});
+    work->AddFrame(type);
+    work->AddFrame(position.first);
+    work->AddFrame(position.second);
+    socket_->Send(work);
+    LogNormal(blockchain::internal::DisplayString(network_.Chain()))(
+        " filter chain built to height ")(position.first)(" in ")(
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            Clock::now() - began)
+            .count())(" milliseconds")
+        .Flush();
+}
+
+auto FilterOracle::FilterCache::Clear() noexcept -> void
+{
+    Lock lock(lock_);
+    probation_.clear();
+    protected_.clear();
+    index_.clear();
+    used_ = 0;
+}
+
+auto FilterOracle::FilterCache::erase(const Lock&, Index::iterator it) noexcept
+    -> Index::iterator
+{
+    const auto& [filter, bytes, isProtected, position, height] = it->second;
+    used_ -= bytes;
+    (isProtected ? protected_ : probation_).erase(position);
+
+    return index_.erase(it);
+}
+
+auto FilterOracle::FilterCache::Find(
+    const filter::Type type,
+    const block::Hash& block) const noexcept -> Pointer
+{
+    Lock lock(lock_);
+    const auto it = index_.find(Key{type, block});
+
+    if (index_.end() == it) {
+        ++misses_;
+
+        return {};
+    }
+
+    ++hits_;
+    auto& [filter, bytes, isProtected, position, height] = it->second;
+    protected_.splice(
+        protected_.begin(), isProtected ? protected_ : probation_, position);
+    isProtected = true;
+
+    return filter;
+}
+
+auto FilterOracle::FilterCache::Reorg(const block::Height parent) noexcept
+    -> void
+{
+    Lock lock(lock_);
+
+    for (auto it = index_.begin(); it != index_.end();) {
+        if (std::get<4>(it->second) > parent) {
+            it = erase(lock, it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+auto FilterOracle::FilterCache::Store(
+    const filter::Type type,
+    const block::Height height,
+    const block::Hash& block,
+    Pointer filter) noexcept -> void
+{
+    if (false == bool(filter)) { return; }
+
+    const auto bytes = filter->CompressedSize() + overhead_;
+
+    if (bytes > budget_) { return; }
+
+    Lock lock(lock_);
+    auto key = Key{type, block};
+
+    if (0 < index_.count(key)) { return; }
+
+    while ((used_ + bytes) > budget_) {
+        if (false == probation_.empty()) {
+            erase(lock, index_.find(probation_.front()));
+        } else {
+            OT_ASSERT(false == protected_.empty());
+
+            erase(lock, index_.find(protected_.back()));
+        }
+    }
+
+    probation_.emplace_front(key);
+    index_.emplace(
+        std::move(key),
+        Entry{std::move(filter), bytes, false, probation_.begin(), height});
+    used_ += bytes;
+}
+
 auto FilterOracle::FilterQueue::AddFilter(
+    const int peer,
     const block::Height height,
     const block::Hash& hash,
-    std::unique_ptr<const blockchain::internal::GCS> filter) noexcept -> void
+    Pointer filter) noexcept -> bool
 {
     OT_ASSERT(filter);
 
-    const auto& target = target_.first;
+    auto it = batches_.upper_bound(height);
 
-    if (height > target) {
+    if (batches_.begin() == it) {
         LogVerbose(OT_METHOD)("FilterQueue::")(__FUNCTION__)(
-            ": Filter height (")(height)(") is after requested range")
+            ": Filter height (")(height)(") is before requested range")
             .Flush();
 
-        return;
+        return false;
     }
 
-    const auto offset = static_cast<std::size_t>(target - height);
+    std::advance(it, -1);
+    auto& batch = it->second;
 
-    if (offset >= filters_.size()) {
+    if (height > batch.Last()) {
         LogVerbose(OT_METHOD)("FilterQueue::")(__FUNCTION__)(
-            ": Filter height (")(height)(") is before requested range")
+            ": Filter height (")(height)(") was not requested")
             .Flush();
 
-        return;
+        return false;
     }
 
-    auto it{filters_.begin()};
-    std::advance(it, offset);
+    auto& [block, cachedFilter] =
+        batch.filters_.at(static_cast<std::size_t>(height - batch.first_));
 
-    if (hash != it->first) {
+    if (hash != block) {
         LogVerbose(OT_METHOD)("FilterQueue::")(__FUNCTION__)(
             ": Wrong block for filter at height ")(height)
             .Flush();
 
-        return;
+        return false;
     }
 
-    auto& cachedFilter = it->second;
+    if (-1 == batch.peer_) { batch.peer_ = peer; }
+
+    batch.last_received_ = Clock::now();
 
     if (false == bool(cachedFilter)) {
-        cachedFilter.reset(filter.release());
-        ++queued_;
+        cachedFilter = std::move(filter);
+        ++batch.queued_;
     }
 
-    OT_ASSERT(cachedFilter);
-
-    last_received_ = Clock::now();
-
-    if ((height == target) && (queued_ < filters_.size())) {
+    if (batch.Complete()) {
+        if (-1 != peer) {
+            auto& speed = peers_[peer];
+            speed.Update(batch.filters_.size(), batch.sent_);
+            LogVerbose(OT_METHOD)("FilterQueue::")(__FUNCTION__)(": Peer ")(
+                peer)(" delivered ")(batch.filters_.size())(
+                " filters. Average throughput: ")(speed.rate_)(
+                " filters per second")
+                .Flush();
+        }
+    } else if (height == batch.Last()) {
         LogOutput(OT_METHOD)("FilterQueue::")(__FUNCTION__)(
-            ": Last filter in range received, however only ")(queued_)(" of ")(
-            filters_.size())(" filters are queued.")
+            ": Last filter in range received, however only ")(batch.queued_)(
+            " of ")(batch.filters_.size())(" filters are queued.")
             .Flush();
+        batch.partial_ = true;
+    }
 
-        if (filters_.rbegin()->second) {
-            LogOutput(OT_METHOD)("FilterQueue::")(__FUNCTION__)(
-                ": Accepting partial filter batch.")
-                .Flush();
-            queued_ = filters_.size();
-        } else {
-            error_ = true;
-        }
+    return true;
+}
+
+auto FilterOracle::FilterQueue::Assign(const int exclude) noexcept -> int
+{
+    // Every window_ batches one is left to the peer manager so that peers
+    // which have not delivered any filters yet are measured too
+    if (0 == (++assigned_ % window_)) { return -1; }
+
+    auto total = double{0};
+
+    for (const auto& [peer, speed] : peers_) {
+        if (peer != exclude) { total += speed.rate_; }
+    }
+
+    if (0 >= total) { return -1; }
+
+    auto output{-1};
+    auto best = double{0};
+
+    for (const auto& [peer, speed] : peers_) {
+        if ((peer == exclude) || (speed.rate_ <= best)) { continue; }
+
+        const auto share = std::max(
+            std::size_t{1},
+            static_cast<std::size_t>(std::lround(
+                static_cast<double>(window_) * speed.rate_ / total)));
+
+        if (outstanding(peer) >= share) { continue; }
+
+        output = peer;
+        best = speed.rate_;
     }
+
+    return output;
+}
+
+auto FilterOracle::FilterQueue::First() const noexcept -> block::Height
+{
+    if (batches_.empty()) { return -1; }
+
+    return batches_.cbegin()->first;
 }
 
 auto FilterOracle::FilterQueue::Flush(Filters& filters) noexcept
-    -> block::Position
+    -> std::optional<block::Position>
 {
-    auto counter = target_.first - filters_.size();
+    auto output = std::optional<block::Position>{};
+    flushed_.clear();
 
-    for (auto it{filters_.rbegin()}; it != filters_.rend(); ++it) {
-        ++counter;
+    while (false == batches_.empty()) {
+        auto it = batches_.begin();
 
-        if (it->second) {
-            filters.emplace_back(internal::FilterDatabase::Filter{
-                it->first->Bytes(), std::move(it->second)});
-        } else {
-            LogOutput(OT_METHOD)("FilterQueue::")(__FUNCTION__)(
-                ": Filter for block ")(counter)(" is missing.")
-                .Flush();
+        if (false == it->second.Complete()) { break; }
 
-            OT_ASSERT(filters_.rbegin() != it);
+        auto& batch = flushed_.emplace_back(std::move(it->second));
+        batches_.erase(it);
 
-            std::advance(it, -1);
+        for (auto& [block, filter] : batch.filters_) {
+            OT_ASSERT(filter);
 
-            return {counter - 1, it->first};
+            filters.emplace_back(internal::FilterDatabase::Filter{
+                block->Bytes(), std::move(filter)});
         }
+
+        output = block::Position{batch.Last(), batch.filters_.back().first};
     }
 
-    return target_;
+    return output;
+}
+
+auto FilterOracle::FilterQueue::IsFull() const noexcept -> bool
+{
+    return batches_.size() >= window_;
+}
+
+auto FilterOracle::FilterQueue::Next() const noexcept -> block::Height
+{
+    if (batches_.empty()) { return -1; }
+
+    return batches_.crbegin()->second.Last() + 1;
 }
 
-auto FilterOracle::FilterQueue::IsFull() noexcept -> bool
+auto FilterOracle::FilterQueue::outstanding(const int peer) const noexcept
+    -> std::size_t
 {
-    return filters_.size() == queued_;
+    return static_cast<std::size_t>(std::count_if(
+        batches_.begin(), batches_.end(), [&](const auto& item) {
+            const auto& batch = item.second;
+
+            return (peer == batch.peer_) && (false == batch.Complete());
+        }));
+}
+
+auto FilterOracle::FilterQueue::Queue(
+    const block::Height startHeight,
+    const block::Hash& stopHash,
+    const internal::HeaderOracle& headers,
+    const int peer) noexcept -> void
+{
+    OT_ASSERT(0 == batches_.count(startHeight));
+
+    auto header = headers.LoadHeaderView(stopHash.Bytes());
+
+    OT_ASSERT(header.has_value());
+
+    auto hashes = std::vector<block::pHash>{stopHash};
+
+    while (header->Height() > startHeight) {
+        header = headers.LoadHeaderView(header->ParentHash());
+
+        OT_ASSERT(header.has_value());
+
+        hashes.emplace_back(Data::Factory(
+            header->Hash().data(), header->Hash().size()));
+    }
+
+    auto& batch =
+        batches_.try_emplace(startHeight, startHeight, peer).first->second;
+    batch.filters_.reserve(hashes.size());
+
+    for (auto i{hashes.rbegin()}; i != hashes.rend(); ++i) {
+        batch.filters_.emplace_back(FilterData{std::move(*i), nullptr});
+    }
 }
 
-auto FilterOracle::FilterQueue::IsRunning() noexcept -> bool
+auto FilterOracle::FilterQueue::Reset() noexcept -> void { batches_.clear(); }
+
+auto FilterOracle::FilterQueue::Retry() noexcept -> std::vector<Request>
 {
-    if (error_) { Reset(); }
+    auto output = std::vector<Request>{};
+    const auto now = Clock::now();
+
+    for (auto& [first, batch] : batches_) {
+        if (batch.Complete()) { continue; }
+
+        const auto expired = (now - batch.last_received_) > timeout_;
+
+        if (false == (expired || batch.partial_)) { continue; }
 
-    if (running_) {
-        if ((Clock::now() - last_received_) > timeout_) {
+        const auto previous = batch.peer_;
+
+        if (expired) {
             LogVerbose(OT_METHOD)("FilterQueue::")(__FUNCTION__)(
-                ": Filter request timed out after ")(timeout_.count())(
-                " seconds ")
+                ": Filter request for ")(first)(" to ")(batch.Last())(
+                " timed out after ")(timeout_.count())(" seconds")
                 .Flush();
-            Reset();
+            peers_.erase(previous);
         }
+
+        auto start{first};
+
+        for (const auto& [block, filter] : batch.filters_) {
+            if (filter) {
+                ++start;
+            } else {
+                break;
+            }
+        }
+
+        batch.peer_ = Assign(previous);
+        batch.sent_ = now;
+        batch.last_received_ = now;
+        batch.partial_ = false;
+        output.emplace_back(start, batch.filters_.back().first, batch.peer_);
     }
 
-    return running_;
+    return output;
 }
 
-auto FilterOracle::FilterQueue::Queue(
-    const block::Height startHeight,
-    const block::Hash& stopHash,
-    const client::HeaderOracle& headers) noexcept -> void
+auto FilterOracle::FilterQueue::Throughput::Update(
+    const std::size_t filters,
+    const Time& sent) noexcept -> void
+{
+    const auto seconds =
+        std::chrono::duration<double>(Clock::now() - sent).count();
+    const auto sample = static_cast<double>(filters) / std::max(seconds, 0.001);
+    rate_ = (0 == batches_) ? sample : (0.7 * rate_) + (0.3 * sample);
+    ++batches_;
+}
+
+auto FilterOracle::HeaderSegments::AddCheckpoints(
+    const int peer,
+    std::vector<OTData>&& checkpoints) noexcept -> Checkpoints
 {
-    OT_ASSERT(false == running_);
-    OT_ASSERT(0 == queued_);
-    OT_ASSERT(0 == filters_.size());
+    if (conflict_) { return Checkpoints::Conflict; }
+
+    const auto known = std::min(checkpoints.size(), checkpoints_.size());
+
+    for (auto i = std::size_t{0}; i < known; ++i) {
+        if (checkpoints.at(i) != checkpoints_.at(i)) {
+            return Checkpoints::Invalid;
+        }
+    }
+
+    auto confirmed = std::size_t{0};
+
+    for (const auto& [id, other] : unconfirmed_) {
+        if (id == peer) { continue; }
+
+        const auto overlap = std::min(checkpoints.size(), other.size());
+
+        for (auto i = std::size_t{0}; i < overlap; ++i) {
+            if (checkpoints.at(i) != other.at(i)) {
+                Reset(-1);
+                conflict_ = true;
+
+                return Checkpoints::Conflict;
+            }
+        }
+
+        confirmed = std::max(confirmed, overlap);
+    }
+
+    if (confirmed <= known) {
+        unconfirmed_[peer] = std::move(checkpoints);
+
+        return Checkpoints::Pending;
+    }
+
+    for (auto i{known}; i < confirmed; ++i) {
+        checkpoints_.emplace_back(std::move(checkpoints.at(i)));
+    }
+
+    unconfirmed_.clear();
+
+    return Checkpoints::Confirmed;
+}
+
+auto FilterOracle::HeaderSegments::AddSegment(
+    const client::HeaderOracle& headers,
+    const block::Height start,
+    const ReadView previous,
+    const std::vector<ReadView>& hashes) noexcept -> bool
+{
+    auto it = requested_.find(start);
+
+    if (requested_.end() == it) { return false; }
+
+    auto& [expectedStop, time] = it->second;
+    const auto stop = start + static_cast<block::Height>(hashes.size()) - 1;
+    const auto* first = checkpoint(start - 1);
+    const auto* last = checkpoint(stop);
+
+    if ((stop != expectedStop) || (nullptr == last) ||
+        ((nullptr != first) && (first->Bytes() != previous))) {
+        // Request the segment again immediately
+        time = Time{};
+
+        return false;
+    }
+
+    auto segment = Segment{api_, previous};
+    auto prior = (0 == start) ? ReadView{} : previous;
+    segment.hashes_.reserve(hashes.size());
+    segment.headers_.reserve(hashes.size());
+
+    for (auto i = std::size_t{0}; i < hashes.size(); ++i) {
+        const auto height = start + static_cast<block::Height>(i);
+        const auto& hash =
+            segment.hashes_.emplace_back(api_.Factory().Data(hashes.at(i)));
+        const auto& row =
+            segment.headers_.emplace_back(internal::FilterDatabase::Header{
+                headers.BestHash(height),
+                blockchain::internal::FilterHashToHeader(
+                    api_, hash->Bytes(), prior),
+                hash->Bytes()});
+        prior = std::get<1>(row)->Bytes();
+    }
+
+    if (std::get<1>(segment.headers_.back()).get() != *last) {
+        time = Time{};
+
+        return false;
+    }
+
+    segment.stop_ = block::Position{stop, headers.BestHash(stop)};
+    requested_.erase(it);
+    received_.emplace(start, std::move(segment));
+
+    return true;
+}
+
+auto FilterOracle::HeaderSegments::Anchored() const noexcept -> block::Height
+{
+    if (conflict_ || checkpoints_.empty()) { return -1; }
+
+    return static_cast<block::Height>(checkpoints_.size()) * interval_;
+}
+
+auto FilterOracle::HeaderSegments::checkpoint(
+    const block::Height height) const noexcept -> const Data*
+{
+    if ((0 >= height) || (0 != (height % interval_))) { return nullptr; }
+
+    const auto index = static_cast<std::size_t>((height / interval_) - 1);
+
+    if (index >= checkpoints_.size()) { return nullptr; }
+
+    return &checkpoints_.at(index).get();
+}
+
+auto FilterOracle::HeaderSegments::First() const noexcept -> block::Height
+{
+    auto output = block::Height{-1};
+
+    if (false == requested_.empty()) { output = requested_.cbegin()->first; }
+
+    if (false == received_.empty()) {
+        const auto height = received_.cbegin()->first;
+        output = (-1 == output) ? height : std::min(output, height);
+    }
+
+    return output;
+}
+
+auto FilterOracle::HeaderSegments::IsFull() const noexcept -> bool
+{
+    return (requested_.size() + received_.size()) >= window_;
+}
+
+auto FilterOracle::HeaderSegments::IsRunning(
+    const block::Height start) const noexcept -> bool
+{
+    return 0 < requested_.count(start);
+}
+
+auto FilterOracle::HeaderSegments::Next() const noexcept -> block::Height
+{
+    auto output = block::Height{-1};
+
+    if (false == requested_.empty()) {
+        output = requested_.crbegin()->second.first + 1;
+    }
+
+    if (false == received_.empty()) {
+        output =
+            std::max(output, received_.crbegin()->second.stop_.first + 1);
+    }
+
+    return output;
+}
 
-    auto header = headers.LoadHeader(stopHash);
+auto FilterOracle::HeaderSegments::Pop(const block::Height start) noexcept
+    -> std::optional<Segment>
+{
+    auto it = received_.find(start);
 
-    OT_ASSERT(header);
+    if (received_.end() == it) { return std::nullopt; }
 
-    target_ = header->Position();
-    filters_.emplace_back(FilterData{header->Hash(), nullptr});
+    auto output = std::optional<Segment>{std::move(it->second)};
+    received_.erase(it);
 
-    while (header->Height() > startHeight) {
-        header = headers.LoadHeader(header->ParentHash());
+    return output;
+}
 
-        OT_ASSERT(header);
+auto FilterOracle::HeaderSegments::Queue(const Range& range) noexcept -> void
+{
+    const auto& [first, last] = range;
+    requested_[first] = {last, Clock::now()};
+}
 
-        filters_.emplace_back(FilterData{header->Hash(), nullptr});
+auto FilterOracle::HeaderSegments::Reset(const block::Height height) noexcept
+    -> void
+{
+    conflict_ = false;
+    unconfirmed_.clear();
+    requested_.clear();
+    received_.clear();
+    const auto keep = static_cast<std::size_t>(
+        std::max(height, block::Height{0}) / interval_);
+
+    if (keep < checkpoints_.size()) {
+        checkpoints_.erase(
+            std::next(checkpoints_.begin(), keep), checkpoints_.end());
     }
-
-    running_ = true;
-    last_received_ = Clock::now();
 }
 
-auto FilterOracle::FilterQueue::Reset() noexcept -> void
+auto FilterOracle::HeaderSegments::Retry() noexcept -> std::vector<Range>
 {
-    running_ = false;
-    queued_ = 0;
-    filters_.clear();
-    last_received_ = Time{};
-    target_ = make_blank<block::Position>::value(api_);
+    auto output = std::vector<Range>{};
+    const auto now = Clock::now();
+
+    for (auto& [first, value] : requested_) {
+        auto& [last, time] = value;
+
+        if ((now - time) > timeout_) {
+            time = now;
+            output.emplace_back(first, last);
+        }
+    }
+
+    return output;
 }
 
 auto FilterOracle::RequestQueue::Finish(const block::Hash& block) noexcept
@@ -286,6 +928,22 @@ auto FilterOracle::RequestQueue::Start(const block::Hash& block) noexcept
     hashes_.emplace(block, Clock::now());
 }
 
+auto FilterOracle::AddCheckpoints(zmq::Message& work) const noexcept -> void
+{
+    if (false == running_.get()) { return; }
+
+    auto header = work.Header();
+
+    if (1 > header.size()) {
+        LogVerbose(OT_METHOD)(__FUNCTION__)(": Invalid work header").Flush();
+
+        return;
+    }
+
+    header.Replace(0, api_.ZeroMQ().Frame(Work::cfcheckpt));
+    pipeline_->Push(work);
+}
+
 auto FilterOracle::AddFilter(zmq::Message& work) const noexcept -> void
 {
     if (false == running_.get()) { return; }
@@ -325,6 +983,39 @@ auto FilterOracle::CheckBlocks() const noexcept -> void
     Trigger();
 }
 
+auto FilterOracle::LoadFilter(
+    const filter::Type type,
+    const block::Height height,
+    const block::Hash& block) const noexcept
+    -> std::shared_ptr<const blockchain::internal::GCS>
+{
+    auto output = cache_.Find(type, block);
+
+    if (output) { return output; }
+
+    output = database_.LoadFilter(type, block.Bytes());
+    cache_.Store(type, height, block, output);
+
+    return output;
+}
+
+auto FilterOracle::filter_source(
+    const Source configured,
+    const filter::Type type) noexcept -> Source
+{
+    if ((Source::Local == configured) &&
+        (filter::Type::Basic_BIP158 == type)) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(
+            ": BIP158 filters require previous output scripts which are not "
+            "available from blocks. Verifying downloaded filters instead.")
+            .Flush();
+
+        return Source::Verify;
+    }
+
+    return configured;
+}
+
 void FilterOracle::check_filters(
     const filter::Type type,
     const block::Height maxRequests,
@@ -336,26 +1027,39 @@ void FilterOracle::check_filters(
     if (start == best) { return; }
 
     repeat.On();
-
-    if (outstanding_filters_.IsRunning()) { return; }
-
-    const auto headerTip = database_.FilterHeaderTip(type).first;
+    auto& queue = outstanding_filters_;
     const auto begin{start.first + static_cast<block::Height>(1)};
-    const auto target{begin + maxRequests - static_cast<block::Height>(1)};
-    const auto stopHeight =
-        outstanding_filters_.error_
-            ? begin
-            : std::min(std::min(target, headerTip), best.first);
-    outstanding_filters_.error_ = false;
 
-    if (0 > (stopHeight - begin)) { return; }
+    if ((-1 != queue.First()) && (begin != queue.First())) {
+        LogVerbose(OT_METHOD)(__FUNCTION__)(
+            ": Filter tip changed, discarding outstanding requests")
+            .Flush();
+        queue.Reset();
+    }
+
+    for (const auto& [height, stopHash, peer] : queue.Retry()) {
+        LogVerbose(OT_METHOD)(__FUNCTION__)(": Requesting filters from ")(
+            height)(" to ")(stopHash->asHex())(" again")
+            .Flush();
+        network_.RequestFilters(type, height, stopHash, peer);
+    }
 
-    LogVerbose(OT_METHOD)(__FUNCTION__)(": Requesting filters from ")(begin)(
-        " to ")(stopHeight)
-        .Flush();
-    const auto stopHash = headers.BestHash(stopHeight);
-    outstanding_filters_.Queue(begin, stopHash, headers);
-    network_.RequestFilters(type, begin, stopHash);
+    const auto headerTip = database_.FilterHeaderTip(type).first;
+    const auto last = std::min(headerTip, best.first);
+    auto next = (-1 == queue.Next()) ? begin : queue.Next();
+
+    while ((false == queue.IsFull()) && (next <= last)) {
+        const auto stopHeight =
+            std::min(next + maxRequests - static_cast<block::Height>(1), last);
+        const auto stopHash = headers.BestHash(stopHeight);
+        const auto peer = queue.Assign();
+        LogVerbose(OT_METHOD)(__FUNCTION__)(": Requesting filters from ")(
+            next)(" to ")(stopHeight)
+            .Flush();
+        queue.Queue(next, stopHash, headers, peer);
+        network_.RequestFilters(type, next, stopHash, peer);
+        next = stopHeight + static_cast<block::Height>(1);
+    }
 }
 
 void FilterOracle::check_headers(
@@ -373,6 +1077,8 @@ void FilterOracle::check_headers(
         return;
     }
 
+    if (check_segments(type, start.first, best.first)) { return; }
+
     const auto begin{start.first + static_cast<block::Height>(1)};
     const auto target{begin + maxRequests - static_cast<block::Height>(1)};
     const auto stopHeight = std::min(target, best.first);
@@ -387,6 +1093,121 @@ void FilterOracle::check_headers(
     network_.RequestFilterHeaders(type, begin, stopHash);
 }
 
+auto FilterOracle::check_segments(
+    const filter::Type type,
+    const block::Height tip,
+    const block::Height best) noexcept -> bool
+{
+    const auto& headers = network_.HeaderOracle();
+    auto& segments = header_segments_;
+    const auto interval = HeaderSegments::interval_;
+    const auto target = (best / interval) * interval;
+
+    if (((best - tip) > interval) && (segments.Anchored() < target)) {
+        const auto stopHash = headers.BestHash(target);
+
+        // Expired requests are forgotten, so a request which timed out is
+        // sent again here and reaches a new sample of peers
+        if (false == checkpoint_requests_.IsRunning(stopHash)) {
+            LogVerbose(OT_METHOD)(__FUNCTION__)(
+                ": Requesting filter header checkpoints to height ")(target)
+                .Flush();
+            checkpoint_requests_.Start(stopHash);
+            network_.RequestFilterCheckpoints(type, stopHash);
+        }
+    }
+
+    const auto anchored = segments.Anchored();
+
+    if (anchored <= tip) { return false; }
+
+    if (const auto first = segments.First();
+        (-1 != first) && ((tip + 1) != first)) {
+        segments.Reset(anchored);
+    }
+
+    for (const auto& [first, last] : segments.Retry()) {
+        LogVerbose(OT_METHOD)(__FUNCTION__)(
+            ": Requesting filter headers from ")(first)(" to ")(last)(" again")
+            .Flush();
+        network_.RequestFilterHeaders(type, first, headers.BestHash(last));
+    }
+
+    auto next = std::max(tip + 1, segments.Next());
+
+    while ((false == segments.IsFull()) && (next <= anchored)) {
+        const auto checkpoint = ((next + interval - 1) / interval) * interval;
+        const auto range =
+            HeaderSegments::Range{next, std::min(checkpoint, anchored)};
+        const auto& [first, last] = range;
+        LogVerbose(OT_METHOD)(__FUNCTION__)(
+            ": Requesting filter headers from ")(first)(" to ")(last)
+            .Flush();
+        segments.Queue(range);
+        network_.RequestFilterHeaders(type, first, headers.BestHash(last));
+        next = last + 1;
+    }
+
+    return true;
+}
+
+auto FilterOracle::commit_segments(const filter::Type type) noexcept -> void
+{
+    const auto& headers = network_.HeaderOracle();
+    auto& segments = header_segments_;
+
+    while (true) {
+        const auto [height, hash] = database_.FilterHeaderTip(type);
+        auto next = segments.Pop(height + 1);
+
+        if (false == next.has_value()) { return; }
+
+        auto& segment = next.value();
+        const auto& stop = segment.stop_;
+        const auto previous = database_.LoadFilterHeader(type, hash->Bytes());
+
+        if (segment.previous_.get() != previous) {
+            LogOutput(OT_METHOD)(__FUNCTION__)(
+                ": Filter header checkpoints do not match stored filter "
+                "header at height ")(height)
+                .Flush();
+            segments.Reset(height);
+
+            return;
+        }
+
+        if (false == headers.IsInBestChain(stop.second)) {
+            segments.Reset(height);
+
+            return;
+        }
+
+        if (false == database_.StoreFilterHeaders(
+                         type,
+                         segment.previous_->Bytes(),
+                         std::move(segment.headers_))) {
+            LogOutput(OT_METHOD)(__FUNCTION__)(
+                ": Failed saving filter headers")
+                .Flush();
+            segments.Reset(height);
+
+            return;
+        }
+
+        if (false == database_.SetFilterHeaderTip(type, stop)) {
+            LogOutput(OT_METHOD)(__FUNCTION__)(
+                ": Failed updating filter header tip")
+                .Flush();
+
+            return;
+        }
+
+        LogNormal(blockchain::internal::DisplayString(network_.Chain()))(
+            " filter header chain updated to height ")(stop.first)
+            .Flush();
+    }
+}
+
 auto FilterOracle::pipeline(const zmq::Message& in) noexcept -> void
 {
     init_.get();
@@ -410,6 +1231,9 @@ auto FilterOracle::pipeline(const zmq::Message& in) noexcept -> void
         case Work::cfheader: {
             process_cfheader(in);
         } break;
+        case Work::cfcheckpt: {
+            process_cfcheckpt(in);
+        } break;
         case Work::reorg: {
             process_reorg(in);
         } break;
@@ -430,12 +1254,78 @@ auto FilterOracle::pipeline(const zmq::Message& in) noexcept -> void
     }
 }
 
+auto FilterOracle::process_cfcheckpt(const zmq::Message& in) noexcept -> void
+{
+    if (false == running_.get()) { return; }
+
+    const auto body = in.Body();
+
+    if (3 > body.size()) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(": Invalid cfcheckpt").Flush();
+
+        return;
+    }
+
+    const auto type = body.at(0).as<filter::Type>();
+    const auto stop = api_.Factory().Data(body.at(1).Bytes());
+    const auto peer = body.at(2).as<int>();
+
+    if ((default_type_ != type) ||
+        (false == checkpoint_requests_.IsRunning(stop))) {
+        LogVerbose(OT_METHOD)(__FUNCTION__)(": Ignoring unrequested cfcheckpt")
+            .Flush();
+
+        return;
+    }
+
+    auto checkpoints = std::vector<OTData>{};
+
+    for (auto i = std::size_t{3}; i < body.size(); ++i) {
+        checkpoints.emplace_back(api_.Factory().Data(body.at(i).Bytes()));
+    }
+
+    const auto count = checkpoints.size();
+    using Checkpoints = HeaderSegments::Checkpoints;
+
+    switch (header_segments_.AddCheckpoints(peer, std::move(checkpoints))) {
+        case Checkpoints::Pending: {
+            // Wait for another peer to send the same checkpoints
+
+            return;
+        }
+        case Checkpoints::Confirmed: {
+            LogVerbose(OT_METHOD)(__FUNCTION__)(": Received ")(count)(
+                " filter header checkpoints")
+                .Flush();
+        } break;
+        case Checkpoints::Invalid: {
+            LogOutput(OT_METHOD)(__FUNCTION__)(": Peer ")(peer)(
+                " sent invalid filter header checkpoints")
+                .Flush();
+            network_.DisconnectPeer(peer);
+
+            return;
+        }
+        case Checkpoints::Conflict:
+        default: {
+            LogOutput(OT_METHOD)(__FUNCTION__)(
+                ": Peers disagree about filter header checkpoints. Falling "
+                "back to sequential download.")
+                .Flush();
+        }
+    }
+
+    checkpoint_requests_.Finish(stop);
+    Trigger();
+}
+
 auto FilterOracle::process_cfheader(const zmq::Message& in) noexcept -> void
 {
     if (false == running_.get()) { return; }
 
     auto type = filter::Type{};
     auto stopBlock = ReadView{};
+    auto peer{-1};
     auto previousHeader = ReadView{};
     auto hashes = std::vector<ReadView>{};
 
@@ -443,7 +1333,7 @@ auto FilterOracle::process_cfheader(const zmq::Message& in) noexcept -> void
         auto counter{0};
         const auto body = in.Body();
 
-        if (body.size() < 3) {
+        if (body.size() < 4) {
             LogOutput(OT_METHOD)(__FUNCTION__)(": Invalid cfheader").Flush();
 
             return;
@@ -458,6 +1348,9 @@ auto FilterOracle::process_cfheader(const zmq::Message& in) noexcept -> void
                     stopBlock = frame.Bytes();
                 } break;
                 case 3: {
+                    peer = frame.as<int>();
+                } break;
+                case 4: {
                     previousHeader = frame.Bytes();
                 } break;
                 default: {
@@ -500,6 +1393,23 @@ auto FilterOracle::process_cfheader(const zmq::Message& in) noexcept -> void
         return;
     }
 
+    if (header_segments_.IsRunning(start)) {
+        if (header_segments_.AddSegment(
+                headers, start, previousHeader, hashes)) {
+            commit_segments(type);
+        } else {
+            LogOutput(OT_METHOD)(__FUNCTION__)(": Filter headers from ")(
+                start)(" to ")(header.Height())(" sent by peer ")(peer)(
+                " do not match checkpoints")
+                .Flush();
+            network_.DisconnectPeer(peer);
+        }
+
+        Trigger();
+
+        return;
+    }
+
     const auto [previousHeight, previousHash] = database_.FilterHeaderTip(type);
 
     if (header.Height() <= previousHeight) { return; }
@@ -569,6 +1479,7 @@ auto FilterOracle::process_cfilter(const zmq::Message& in) noexcept -> void
     const auto fpRate = body.at(3).as<std::uint32_t>();
     const auto count = body.at(4).as<std::uint32_t>();
     const auto bytes = body.at(5).Bytes();
+    const auto peer = (6 < body.size()) ? body.at(6).as<int>() : int{-1};
     auto gcs = std::unique_ptr<const blockchain::internal::GCS>{Factory::GCS(
         api_,
         bits,
@@ -584,7 +1495,6 @@ auto FilterOracle::process_cfilter(const zmq::Message& in) noexcept -> void
     }
 
     const auto pHeader = network_.HeaderOracle().LoadHeader(block);
-    const auto& header = *pHeader;
 
     if (false == bool(pHeader)) {
         LogOutput(OT_METHOD)(__FUNCTION__)(": Failed to load block header ")(
@@ -594,54 +1504,49 @@ auto FilterOracle::process_cfilter(const zmq::Message& in) noexcept -> void
         return;
     }
 
+    const auto& header = *pHeader;
     const auto hash = gcs->Hash();
     const auto expected = database_.LoadFilterHash(type, block->Bytes());
 
     if (hash != expected) {
+        // The batch will be requested from another peer once it times out
         LogOutput(OT_METHOD)(__FUNCTION__)(": Filter for block ")(
             block->asHex())(" at height ")(header.Height())(
             " does not match header. Received: ")(hash->asHex())(" expected: ")(
             expected->asHex())
             .Flush();
-        outstanding_filters_.Reset();
 
         return;
     }
 
-    outstanding_filters_.AddFilter(
-        header.Height(), header.Hash(), std::move(gcs));
+    auto& queue = outstanding_filters_;
 
-    if (outstanding_filters_.IsFull()) {
-        struct Cleanup {
-            FilterOracle& this_;
-
-            Cleanup(FilterOracle& parent)
-                : this_(parent)
-            {
-            }
+    if (false ==
+        queue.AddFilter(peer, header.Height(), header.Hash(), std::move(gcs))) {
 
-            ~Cleanup() { this_.outstanding_filters_.Reset(); }
-        };
+        return;
+    }
 
-        auto cleanup = Cleanup{*this};
-        auto filters = std::vector<internal::FilterDatabase::Filter>{};
-        auto position = outstanding_filters_.Flush(filters);
+    auto filters = std::vector<internal::FilterDatabase::Filter>{};
+    const auto position = queue.Flush(filters);
 
+    if (position.has_value()) {
         if (false == database_.StoreFilters(type, std::move(filters))) {
             LogOutput(OT_METHOD)(__FUNCTION__)(": Database error").Flush();
+            queue.Reset();
             Trigger();
 
             return;
         }
 
-        database_.SetFilterTip(type, position);
+        database_.SetFilterTip(type, position.value());
         auto work = MakeWork(OTZMQWorkType{OT_ZMQ_NEW_FILTER_SIGNAL});
         work->AddFrame(default_type_);
-        work->AddFrame(position.first);
-        work->AddFrame(position.second);
+        work->AddFrame(position->first);
+        work->AddFrame(position->second);
         socket_->Send(work);
         LogNormal(blockchain::internal::DisplayString(network_.Chain()))(
-            " filter chain updated to height ")(header.Height())
+            " filter chain updated to height ")(position->first)
             .Flush();
     } else {
         LogVerbose(blockchain::internal::DisplayString(network_.Chain()))(
@@ -671,7 +1576,17 @@ auto FilterOracle::process_reorg(const zmq::Message& in) noexcept -> void
     const auto height = body.at(2).as<block::Height>();
     const auto reorg = block::Position{height, std::move(hash)};
     header_requests_.Reset();
+    checkpoint_requests_.Reset();
+    header_segments_.Reset(reorg.first);
     outstanding_filters_.Reset();
+    blocks_.Reset();
+
+    if (reorg.first < verified_.load()) { set_verified(reorg); }
+
+    cache_.Reorg(reorg.first);
+    LogVerbose(OT_METHOD)(__FUNCTION__)(": Filter cache statistics: ")(
+        cache_.Hits())(" hits, ")(cache_.Misses())(" misses")
+        .Flush();
 
     {
         const auto existing = database_.FilterHeaderTip(default_type_);
@@ -700,15 +1615,88 @@ auto FilterOracle::process_reorg(const zmq::Message& in) noexcept -> void
     request();
 }
 
+// A cached filter is used if there is one. Otherwise the stored filter is
+// loaded into the cache so the other subchains which scan the same block find
+// it there, unless the cache is disabled in which case it is read in place.
+auto FilterOracle::ReadFilter(
+    const filter::Type type,
+    const block::Height height,
+    const block::Hash& block,
+    const internal::FilterDatabase::FilterCallback& cb) const noexcept -> bool
+{
+    if (false == bool(cb)) { return false; }
+
+    if (const auto pFilter = cache_.Find(type, block); pFilter) {
+        cb(*pFilter);
+
+        return true;
+    }
+
+    if (cache_.Disabled()) {
+        return database_.ReadFilter(type, block.Bytes(), cb);
+    }
+
+    const auto pFilter = std::shared_ptr<const blockchain::internal::GCS>{
+        database_.LoadFilter(type, block.Bytes())};
+
+    if (false == bool(pFilter)) { return false; }
+
+    cache_.Store(type, height, block, pFilter);
+    cb(*pFilter);
+
+    return true;
+}
+
 auto FilterOracle::request() noexcept -> bool
 {
     auto repeat = Cleanup{};
-    check_headers(default_type_, 2000, repeat);
-    check_filters(default_type_, 1000, repeat);
+
+    switch (source_) {
+        case Source::Local: {
+            build_filters(default_type_, repeat);
+        } break;
+        case Source::Verify: {
+            check_headers(default_type_, 2000, repeat);
+            check_filters(default_type_, 1000, repeat);
+            verify_filters(default_type_, repeat);
+        } break;
+        case Source::Peers:
+        default: {
+            check_headers(default_type_, 2000, repeat);
+            check_filters(default_type_, 1000, repeat);
+        }
+    }
 
     return repeat;
 }
 
+auto FilterOracle::ScanTip(const filter::Type type) const noexcept
+    -> block::Height
+{
+    const auto tip = database_.FilterTip(type).first;
+
+    if ((Source::Verify != source_) || (default_type_ != type)) { return tip; }
+
+    return std::min(tip, verified_.load());
+}
+
+auto FilterOracle::set_verified(const block::Position& position) noexcept
+    -> void
+{
+    const auto previous = verified_.exchange(position.first);
+    database_.SetFilterVerifiedTip(default_type_, position);
+
+    if ((Source::Verify != source_) || (position.first <= previous)) { return; }
+
+    // The wallet only scans verified filters so it is notified here instead
+    // of when the filters were downloaded
+    auto work = MakeWork(OTZMQWorkType{OT_ZMQ_NEW_FILTER_SIGNAL});
+    work->AddFrame(default_type_);
+    work->AddFrame(position.first);
+    work->AddFrame(position.second);
+    socket_->Send(work);
+}
+
 auto FilterOracle::shutdown(std::promise<void>& promise) noexcept -> void
 {
     if (running_->Off()) {
@@ -752,9 +1740,135 @@ auto FilterOracle::Start() noexcept -> void
         }
     }
 
+    {
+        auto verified = database_.FilterVerifiedTip(default_type_);
+
+        if (0 <= verified.first) {
+            verified = network_.HeaderOracle().CommonParent(verified).first;
+        }
+
+        if (verified.first > filters.first) { verified = filters; }
+
+        set_verified(verified);
+    }
+
     Trigger();
     init_promise_.set_value();
 }
 
+auto FilterOracle::verify_filter(
+    const filter::Type type,
+    const block::Hash& hash,
+    const block::bitcoin::Block& block) const noexcept -> bool
+{
+    const auto elements = block.ExtractElements(type);
+
+    switch (type) {
+        case filter::Type::Basic_BIP158: {
+            // Previous output scripts are not part of the block, so only the
+            // output scripts can be checked for membership
+            const auto pFilter =
+                LoadFilter(type, block.Header().Height(), hash);
+
+            if (false == bool(pFilter)) { return false; }
+
+            auto targets = blockchain::internal::GCS::Targets{};
+
+            for (const auto& element : elements) {
+                if (element.empty()) { continue; }
+
+                targets.emplace_back(reader(element));
+            }
+
+            dedup(targets);
+
+            return targets.size() == pFilter->Match(targets).size();
+        }
+        case filter::Type::Basic_BCHVariant:
+        case filter::Type::Extended_opentxs:
+        default: {
+            const auto pFilter = Factory::GCS(
+                api_,
+                gcs_bits_,
+                gcs_fp_rate_,
+                blockchain::internal::BlockHashToFilterKey(hash.Bytes()),
+                elements);
+
+            if (false == bool(pFilter)) { return false; }
+
+            return pFilter->Hash() ==
+                   database_.LoadFilterHash(type, hash.Bytes());
+        }
+    }
+}
+
+auto FilterOracle::verify_filters(
+    const filter::Type type,
+    Cleanup& repeat) noexcept -> void
+{
+    const auto& headers = network_.HeaderOracle();
+    const auto first{verified_ + static_cast<block::Height>(1)};
+    const auto last =
+        std::min(first + block_batch_ - 1, database_.FilterTip(type).first);
+
+    if (last < first) { return; }
+
+    repeat.On();
+
+    if (false == blocks_.Ready(headers, network_.BlockOracle(), first, last)) {
+        return;
+    }
+
+    // Written concurrently, one element per height
+    auto valid = std::vector<std::uint8_t>(
+        static_cast<std::size_t>(last - first + 1), 0);
+    const auto process = [&](const block::Height height) -> bool {
+        try {
+            const auto& [hash, future] = blocks_.at(height);
+            const auto pBlock = future.get();
+
+            if (false == bool(pBlock)) { return false; }
+
+            valid.at(static_cast<std::size_t>(height - first)) =
+                verify_filter(type, hash, *pBlock);
+
+            return true;
+        } catch (...) {
+
+            return false;
+        }
+    };
+    const auto checked = job_.Run(first, last, process, dispatch_);
+
+    if (false == checked.has_value()) {
+        blocks_.Reset();
+
+        return;
+    }
+
+    for (auto i{first}; i <= checked.value(); ++i) {
+        if (0 != valid.at(static_cast<std::size_t>(i - first))) { continue; }
+
+        LogOutput(OT_METHOD)(__FUNCTION__)(": Filter for block ")(
+            blocks_.at(i).first->asHex())(" at height ")(i)(
+            " does not match block contents. Downloading again.")
+            .Flush();
+        const auto parent = block::Position{i - 1, headers.BestHash(i - 1)};
+        database_.SetFilterHeaderTip(type, parent);
+        database_.SetFilterTip(type, parent);
+        cache_.Clear();
+        blocks_.Reset();
+        set_verified(parent);
+
+        return;
+    }
+
+    LogVerbose(OT_METHOD)(__FUNCTION__)(": Filters verified from height ")(
+        first)(" to ")(checked.value())
+        .Flush();
+    set_verified({checked.value(), blocks_.at(checked.value()).first});
+    blocks_.Reset();
+}
+
 FilterOracle::~FilterOracle() { Shutdown().get(); }
 }  // namespace opentxs::blockchain::client::implementation
@@ -5,12 +5,19 @@
 
 #pragma once
 
+#include <atomic>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <future>
 #include <iosfwd>
+#include <list>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -20,9 +27,11 @@
 #include "opentxs/Forward.hpp"
 #include "opentxs/Types.hpp"
 #include "opentxs/blockchain/Blockchain.hpp"
+#include "opentxs/blockchain/client/BlockOracle.hpp"
 #include "opentxs/core/Data.hpp"
 #include "opentxs/core/Log.hpp"
 #include "opentxs/network/zeromq/socket/Publish.hpp"
+#include "opentxs/network/zeromq/socket/Push.hpp"
 
 namespace opentxs
 {
@@ -38,6 +47,14 @@ class Core;
 
 namespace blockchain
 {
+namespace block
+{
+namespace bitcoin
+{
+class Block;
+}  // namespace bitcoin
+}  // namespace block
+
 namespace client
 {
 class HeaderOracle;
@@ -68,18 +85,31 @@ class FilterOracle final : virtual public internal::FilterOracle,
                            public Executor<FilterOracle>
 {
 public:
+    auto AddCheckpoints(zmq::Message& work) const noexcept -> void final;
     auto AddFilter(zmq::Message& work) const noexcept -> void final;
     auto AddHeaders(zmq::Message& work) const noexcept -> void final;
+    auto CacheStats() const noexcept -> CacheStatistics final
+    {
+        return {cache_.Hits(), cache_.Misses()};
+    }
     auto CheckBlocks() const noexcept -> void final;
     auto DefaultType() const noexcept -> filter::Type final
     {
         return default_type_;
     }
-    auto LoadFilter(const filter::Type type, const block::Hash& block) const
-        noexcept -> std::unique_ptr<const blockchain::internal::GCS> final
-    {
-        return database_.LoadFilter(type, block.Bytes());
-    }
+    auto LoadFilter(
+        const filter::Type type,
+        const block::Height height,
+        const block::Hash& block) const noexcept
+        -> std::shared_ptr<const blockchain::internal::GCS> final;
+    auto ReadFilter(
+        const filter::Type type,
+        const block::Height height,
+        const block::Hash& block,
+        const internal::FilterDatabase::FilterCallback& cb) const noexcept
+        -> bool final;
+    auto ScanTip(const filter::Type type) const noexcept
+        -> block::Height final;
 
     auto Shutdown() noexcept -> std::shared_future<void> final
     {
@@ -103,6 +133,7 @@ private:
     enum class Work : OTZMQWorkType {
         cfilter = 0,
         cfheader = 1,
+        cfcheckpt = 2,
         reorg = OT_ZMQ_REORG_SIGNAL,
         statemachine = OT_ZMQ_STATE_MACHINE_SIGNAL,
         shutdown = OT_ZMQ_SHUTDOWN_SIGNAL,
@@ -130,41 +161,244 @@ private:
         bool repeat_;
     };
 
-    struct FilterQueue {
-        bool error_;
+    // Blocks requested from the block oracle for one batch of locally built
+    // or verified filters
+    struct BlockQueue {
+        using Future = client::BlockOracle::BitcoinBlockFuture;
+        using Item = std::pair<block::pHash, Future>;
+
+        /// Throws std::out_of_range if the height is not in the batch
+        auto at(const block::Height height) const noexcept(false)
+            -> const Item&;
+
+        /// Requests every block in the range which has not been requested
+        /// yet. Returns true once all of them have arrived.
+        auto Ready(
+            const client::HeaderOracle& headers,
+            const client::BlockOracle& blocks,
+            const block::Height first,
+            const block::Height last) noexcept -> bool;
+        auto Reset() noexcept -> void;
+
+        BlockQueue() noexcept;
+
+    private:
+        block::Height first_;
+        std::vector<Item> blocks_;
+    };
+
+    // Filters loaded from the database, shared by every subchain of every
+    // account which scans the same blocks. New filters are probationary and
+    // become protected when they are found again. Once the memory budget is
+    // exceeded the newest probationary filter is evicted first, so a scan
+    // window larger than the budget keeps its first filters for the next
+    // subchain instead of flushing the whole cache. Protected filters are
+    // evicted least recently used first when no probationary filters remain.
+    struct FilterCache {
+        using Pointer = std::shared_ptr<const blockchain::internal::GCS>;
+
+        auto Disabled() const noexcept -> bool { return 0 == budget_; }
+        auto Find(const filter::Type type, const block::Hash& block) const
+            noexcept -> Pointer;
+        auto Hits() const noexcept -> std::size_t { return hits_.load(); }
+        auto Misses() const noexcept -> std::size_t { return misses_.load(); }
+
+        auto Clear() noexcept -> void;
+        /// Removes filters for blocks above the reorg parent
+        auto Reorg(const block::Height parent) noexcept -> void;
+        auto Store(
+            const filter::Type type,
+            const block::Height height,
+            const block::Hash& block,
+            Pointer filter) noexcept -> void;
+
+        FilterCache(const std::size_t budget) noexcept;
+
+    private:
+        using Key = std::pair<filter::Type, block::pHash>;
+        /// Most recently used or inserted first
+        using List = std::list<Key>;
+        /// filter, size, protected, position, height
+        using Entry = std::
+            tuple<Pointer, std::size_t, bool, List::iterator, block::Height>;
+        using Index = std::map<Key, Entry>;
+
+        static const std::size_t overhead_;
+
+        const std::size_t budget_;
+        mutable std::mutex lock_;
+        mutable std::atomic<std::size_t> hits_;
+        mutable std::atomic<std::size_t> misses_;
+        mutable List probation_;
+        mutable List protected_;
+        mutable Index index_;
+        std::size_t used_;
+
+        auto erase(const Lock& lock, Index::iterator it) noexcept
+            -> Index::iterator;
+    };
 
+    // Sliding window of getcfilters requests. Several batches are
+    // outstanding at once, spread across the peers which serve filters, and
+    // batches which complete out of order are held until every batch before
+    // them is complete.
+    struct FilterQueue {
         using Filters = std::vector<internal::FilterDatabase::Filter>;
+        using Pointer = std::unique_ptr<const blockchain::internal::GCS>;
+        using Request = std::tuple<block::Height, block::pHash, int>;
 
+        /// Height of the first filter in the window, or -1 if it is empty
+        auto First() const noexcept -> block::Height;
+        auto IsFull() const noexcept -> bool;
+        /// Height after the last filter in the window, or -1 if it is empty
+        auto Next() const noexcept -> block::Height;
+
+        /// Returns false if the filter is not part of an outstanding batch
         auto AddFilter(
+            const int peer,
             const block::Height height,
             const block::Hash& hash,
-            std::unique_ptr<const blockchain::internal::GCS> filter) noexcept
-            -> void;
+            Pointer filter) noexcept -> bool;
+        /// Selects the peer for a new batch, or -1 to let the peer manager
+        /// choose. Faster peers are allowed more outstanding batches.
+        auto Assign(const int exclude = -1) noexcept -> int;
+        /// Removes every complete batch from the front of the window
         // WARNING the lifetime of the objects added to filters ends the
-        // next time Queue is executed
-        auto Flush(Filters& filters) noexcept -> block::Position;
-        auto IsFull() noexcept -> bool;
-        auto IsRunning() noexcept -> bool;
+        // next time Flush is executed
+        auto Flush(Filters& filters) noexcept -> std::optional<block::Position>;
         auto Queue(
             const block::Height startHeight,
             const block::Hash& stopHash,
-            const client::HeaderOracle& headers) noexcept -> void;
+            const internal::HeaderOracle& headers,
+            const int peer) noexcept -> void;
         auto Reset() noexcept -> void;
+        /// Reassigns batches which timed out or were only partially answered
+        /// and returns the requests which must be sent again
+        auto Retry() noexcept -> std::vector<Request>;
 
-        FilterQueue(const api::Core& api) noexcept;
+        FilterQueue() noexcept;
 
     private:
-        using Pointer = std::unique_ptr<const blockchain::internal::GCS>;
         using FilterData = std::pair<block::pHash, Pointer>;
 
+        struct Batch {
+            const block::Height first_;
+            std::vector<FilterData> filters_;
+            std::size_t queued_;
+            int peer_;
+            Time sent_;
+            Time last_received_;
+            bool partial_;
+
+            auto Complete() const noexcept -> bool
+            {
+                return filters_.size() == queued_;
+            }
+            auto Last() const noexcept -> block::Height
+            {
+                return first_ + static_cast<block::Height>(filters_.size()) -
+                       1;
+            }
+
+            Batch(const block::Height first, const int peer) noexcept;
+        };
+
+        // Filters per second, averaged over the most recent batches
+        struct Throughput {
+            double rate_;
+            std::size_t batches_;
+
+            auto Update(const std::size_t filters, const Time& sent) noexcept
+                -> void;
+
+            Throughput() noexcept;
+        };
+
+        static const std::chrono::seconds timeout_;
+        static const std::size_t window_;
+
+        std::size_t assigned_;
+        std::map<block::Height, Batch> batches_;
+        std::map<int, Throughput> peers_;
+        std::vector<Batch> flushed_;
+
+        auto outstanding(const int peer) const noexcept -> std::size_t;
+    };
+
+    // Filter headers between cfcheckpt anchors. Segments are requested from
+    // several peers at once, checked against the checkpoints at both ends and
+    // committed to the database in height order. Checkpoints are only used
+    // once two peers have sent matching ones.
+    struct HeaderSegments {
+        using Headers = std::vector<internal::FilterDatabase::Header>;
+        /// first height, last height
+        using Range = std::pair<block::Height, block::Height>;
+
+        enum class Checkpoints {
+            /// No other peer has confirmed the checkpoints yet
+            Pending,
+            Confirmed,
+            /// The checkpoints conflict with ones already confirmed
+            Invalid,
+            /// Peers disagree, so checkpoints are no longer used
+            Conflict,
+        };
+
+        struct Segment {
+            OTData previous_;
+            std::vector<OTData> hashes_;
+            Headers headers_;
+            block::Position stop_;
+
+            Segment(const api::Core& api, const ReadView previous) noexcept;
+        };
+
+        static const block::Height interval_;
+
+        /// Height of the last known checkpoint, or -1 if none are known
+        auto Anchored() const noexcept -> block::Height;
+        /// Height of the first outstanding segment, or -1 if there are none
+        auto First() const noexcept -> block::Height;
+        auto IsFull() const noexcept -> bool;
+        auto IsRunning(const block::Height start) const noexcept -> bool;
+        /// Height after the last outstanding segment, or -1 if there are none
+        auto Next() const noexcept -> block::Height;
+
+        auto AddCheckpoints(
+            const int peer,
+            std::vector<OTData>&& checkpoints) noexcept -> Checkpoints;
+        /// Returns false if the segment does not match its checkpoints
+        auto AddSegment(
+            const client::HeaderOracle& headers,
+            const block::Height start,
+            const ReadView previous,
+            const std::vector<ReadView>& hashes) noexcept -> bool;
+        /// Removes the segment which starts at the given height, if it has
+        /// been received
+        auto Pop(const block::Height start) noexcept
+            -> std::optional<Segment>;
+        auto Queue(const Range& range) noexcept -> void;
+        /// Forgets every segment, every unconfirmed checkpoint, every
+        /// checkpoint after height and any earlier conflict
+        auto Reset(const block::Height height) noexcept -> void;
+        /// Returns segments which timed out and must be requested again
+        auto Retry() noexcept -> std::vector<Range>;
+
+        HeaderSegments(const api::Core& api) noexcept;
+
+    private:
         static const std::chrono::seconds timeout_;
+        static const std::size_t window_;
 
         const api::Core& api_;
-        bool running_;
-        std::size_t queued_;
-        std::vector<FilterData> filters_;
-        Time last_received_;
-        block::Position target_;
+        bool conflict_;
+        std::vector<OTData> checkpoints_;
+        std::map<int, std::vector<OTData>> unconfirmed_;
+        std::map<block::Height, std::pair<block::Height, Time>> requested_;
+        std::map<block::Height, Segment> received_;
+
+        auto checkpoint(const block::Height height) const noexcept
+            -> const Data*;
     };
 
     struct RequestQueue {
@@ -185,15 +419,45 @@ private:
         mutable std::map<block::pHash, Time> hashes_;
     };
 
+    using Source = api::client::blockchain::FilterSource;
+    using Pointer = std::unique_ptr<const blockchain::internal::GCS>;
+
+    static const std::uint8_t gcs_bits_;
+    static const std::uint32_t gcs_fp_rate_;
+    static const block::Height block_batch_;
+
     const internal::Network& network_;
     const internal::FilterDatabase& database_;
     const filter::Type default_type_;
+    const Source source_;
+    mutable FilterCache cache_;
     RequestQueue header_requests_;
+    RequestQueue checkpoint_requests_;
+    HeaderSegments header_segments_;
     FilterQueue outstanding_filters_;
     OTZMQPublishSocket socket_;
+    OTZMQPushSocket thread_pool_;
+    internal::ParallelScan job_;
+    const internal::ParallelScan::Dispatch dispatch_;
+    BlockQueue blocks_;
+    std::atomic<block::Height> verified_;
     std::promise<void> init_promise_;
     std::shared_future<void> init_;
 
+    static auto filter_source(
+        const Source configured,
+        const filter::Type type) noexcept -> Source;
+
+    auto build_filter(const filter::Type type, const block::Height height)
+        const noexcept -> Pointer;
+    auto verify_filter(
+        const filter::Type type,
+        const block::Hash& hash,
+        const block::bitcoin::Block& block) const noexcept -> bool;
+
+    auto build_filters(const filter::Type type, Cleanup& repeat) noexcept
+        -> void;
+
     auto check_filters(
         const filter::Type type,
         const block::Height maxRequests,
@@ -202,12 +466,22 @@ private:
         const filter::Type type,
         const block::Height maxRequests,
         Cleanup& repeat) noexcept -> void;
+    auto check_segments(
+        const filter::Type type,
+        const block::Height tip,
+        const block::Height best) noexcept -> bool;
+    auto commit_segments(const filter::Type type) noexcept -> void;
     auto pipeline(const zmq::Message& in) noexcept -> void;
+    auto process_cfcheckpt(const zmq::Message& in) noexcept -> void;
     auto process_cfheader(const zmq::Message& in) noexcept -> void;
     auto process_cfilter(const zmq::Message& in) noexcept -> void;
     auto process_reorg(const zmq::Message& in) noexcept -> void;
     auto request() noexcept -> bool;
+    /// Saves the verified tip and notifies the wallet if it advanced
+    auto set_verified(const block::Position& position) noexcept -> void;
     auto shutdown(std::promise<void>& promise) noexcept -> void;
+    auto verify_filters(const filter::Type type, Cleanup& repeat) noexcept
+        -> void;
 
     FilterOracle() = delete;
     FilterOracle(const FilterOracle&) = delete;
@@ -8,15 +8,17 @@
 #include "blockchain/client/HDStateData.hpp"  // IWYU pragma: associated
 
 #include <algorithm>
+#include <array>
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <future>
 #include <iterator>
 #include <memory>
-#include <set>
 #include <string>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 #include "internal/api/Api.hpp"
 #include "internal/blockchain/Blockchain.hpp"
@@ -32,6 +34,7 @@
 #include "opentxs/blockchain/block/bitcoin/Outputs.hpp"
 #include "opentxs/blockchain/block/bitcoin/Script.hpp"
 #include "opentxs/blockchain/block/bitcoin/Transaction.hpp"
+#include "opentxs/core/Identifier.hpp"
 #include "opentxs/core/Log.hpp"
 #include "opentxs/core/LogSource.hpp"
 #include "opentxs/crypto/key/EllipticCurve.hpp"
@@ -40,9 +43,36 @@
 
 namespace opentxs::blockchain::client::implementation
 {
+const std::size_t HDStateData::scan_threads_{2};
+
+UnspentCache::UnspentCache() noexcept
+    : epoch_(0)
+    , map_()
+{
+}
+
+auto UnspentCache::Update(const internal::WalletDatabase& db) noexcept
+    -> const Map&
+{
+    auto changes = db.GetUnspentOutputs(epoch_);
+
+    if (changes.reset_) { map_.clear(); }
+
+    for (const auto& outpoint : changes.spent_) { map_.erase(outpoint); }
+
+    for (auto& [outpoint, output] : changes.added_) {
+        map_.insert_or_assign(outpoint, std::move(output));
+    }
+
+    epoch_ = changes.epoch_;
+
+    return map_;
+}
+
 HDStateData::HDStateData(
     const internal::Network& network,
     const WalletDatabase& db,
+    const zmq::socket::Push& socket,
     const api::client::blockchain::HD& node,
     const filter::Type filter,
     const Subchain subchain) noexcept
@@ -51,12 +81,33 @@ HDStateData::HDStateData(
     , node_(node)
     , filter_type_(filter)
     , subchain_(subchain)
+    , scan_dispatch_(internal::ParallelScan::Dispatcher(
+          network_.API(),
+          socket,
+          network_.Chain()))
+    , scan_job_(std::make_unique<internal::ParallelScan>([&] {
+        // Subchains which are catching up scan at the same time as each
+        // other and the chain-wide scanner so each one uses fewer threads
+        const auto configured = db_.ScanThreads();
+
+        return (0 == configured) ? scan_threads_
+                                 : std::min(configured, scan_threads_);
+    }()))
     , running_(false)
     , last_indexed_()
-    , last_scanned_()
+    , last_scanned_([&]() -> std::optional<block::Position> {
+        auto output =
+            db_.SubchainLastProcessed(node_.ID(), subchain_, filter_type_);
+
+        if (0 > output.first) { return std::nullopt; }
+
+        return output;
+    }())
+    , scan_limit_()
     , blocks_to_request_()
     , outstanding_blocks_()
     , process_block_queue_()
+    , unspent_()
 {
 }
 
@@ -66,18 +117,22 @@ HDStateData::HDStateData(HDStateData&& rhs) noexcept
     , node_(rhs.node_)
     , filter_type_(rhs.filter_type_)
     , subchain_(rhs.subchain_)
+    , scan_dispatch_(rhs.scan_dispatch_)
+    , scan_job_(std::move(rhs.scan_job_))
     , running_(rhs.running_.load())
     , last_indexed_(std::move(rhs.last_indexed_))
     , last_scanned_(std::move(rhs.last_scanned_))
+    , scan_limit_(std::move(rhs.scan_limit_))
     , blocks_to_request_(std::move(rhs.blocks_to_request_))
     , outstanding_blocks_(std::move(rhs.outstanding_blocks_))
     , process_block_queue_(std::move(rhs.process_block_queue_))
+    , unspent_(std::move(rhs.unspent_))
 {
 }
 
 auto HDStateData::get_targets(
     const internal::WalletDatabase::Patterns& keys,
-    const std::vector<internal::WalletDatabase::UTXO>& unspent) const noexcept
+    const UnspentCache::Map& unspent) const noexcept
     -> blockchain::internal::GCS::Targets
 {
     auto output = blockchain::internal::GCS::Targets{};
@@ -115,63 +170,155 @@ auto HDStateData::index() noexcept -> void
         last_indexed_.has_value() ? last_indexed_.value() + 1 : Bip32Index{0};
     const auto last = node_.LastGenerated(subchain_);
     auto elements = WalletDatabase::ElementMap{};
+    auto keys = WalletDatabase::ElementKeys{};
 
     for (auto i{first}; i <= last; ++i) {
         const auto& element = node_.BalanceElement(subchain_, i);
-        index_element(filter_type_, element, i, elements);
+        index_element(filter_type_, element, i, elements, keys);
     }
 
-    db_.SubchainAddElements(node_.ID(), subchain_, filter_type_, elements);
+    db_.SubchainAddElements(
+        node_.ID(), subchain_, filter_type_, elements, keys);
 }
 
 auto HDStateData::index_element(
     const filter::Type type,
     const api::client::blockchain::BalanceNode::Element& input,
     const Bip32Index index,
-    WalletDatabase::ElementMap& output) noexcept -> void
+    WalletDatabase::ElementMap& output,
+    WalletDatabase::ElementKeys& keys) noexcept -> void
 {
-    const auto pubkeyHash = input.PubkeyHash();
+    const auto& api = network_.API();
+    const auto chain = network_.Chain();
+    const auto pKey = input.Key();
+
+    OT_ASSERT(pKey);
+
+    const auto pubkey = pKey->PublicKey();
+    const auto& p2pk = script::P2PK(pubkey);
+    auto pkh = Space{};
+    auto p2pkScript = std::array<std::uint8_t, script::Template::max_size_>{};
+    auto p2pkhScript = std::array<std::uint8_t, script::Template::max_size_>{};
+    auto p2pkHash = Space{};
+    auto p2pkhHash = Space{};
+    const auto p2pkView = ReadView{
+        reinterpret_cast<const char*>(p2pkScript.data()), p2pk.Size()};
+    const auto p2pkhView = ReadView{
+        reinterpret_cast<const char*>(p2pkhScript.data()),
+        script::P2PKH.Size()};
+
+    auto written = p2pk.Write(pubkey, p2pkScript.data());
+    written &= blockchain::PubkeyHash(api, chain, pubkey, writer(pkh));
+    written &= script::P2PKH.Write(reader(pkh), p2pkhScript.data());
+    written &= blockchain::ScriptHash(api, chain, p2pkView, writer(p2pkHash));
+    written &= blockchain::ScriptHash(api, chain, p2pkhView, writer(p2pkhHash));
+
+    OT_ASSERT(written);
+
     LogVerbose(OT_METHOD)(__FUNCTION__)(": Indexing public key with hash ")(
-        pubkeyHash->asHex())
+        api.Factory().Data(reader(pkh))->asHex())
         .Flush();
     auto& list = output[index];
-    auto scripts = std::vector<std::unique_ptr<const block::bitcoin::Script>>{};
-    scripts.reserve(4);  // WARNING keep this number up to date if new scripts
-                         // are added
-    const auto& p2pk =
-        scripts.emplace_back(network_.API().Factory().BitcoinScriptP2PK(
-            network_.Chain(), *input.Key()));
-    const auto& p2pkh =
-        scripts.emplace_back(network_.API().Factory().BitcoinScriptP2PKH(
-            network_.Chain(), *input.Key()));
-    const auto& p2sh_p2pk = scripts.emplace_back(
-        network_.API().Factory().BitcoinScriptP2SH(network_.Chain(), *p2pk));
-    const auto& p2sh_p2pkh = scripts.emplace_back(
-        network_.API().Factory().BitcoinScriptP2SH(network_.Chain(), *p2pkh));
-
-    OT_ASSERT(p2pk);
-    OT_ASSERT(p2pkh);
-    OT_ASSERT(p2sh_p2pk);
-    OT_ASSERT(p2sh_p2pkh);
 
     switch (type) {
         case filter::Type::Extended_opentxs: {
-            OT_ASSERT(p2pk->Pubkey().has_value());
-            OT_ASSERT(p2pkh->PubkeyHash().has_value());
-            OT_ASSERT(p2sh_p2pk->ScriptHash().has_value());
-            OT_ASSERT(p2sh_p2pkh->ScriptHash().has_value());
-
-            list.emplace_back(space(p2pk->Pubkey().value()));
-            list.emplace_back(space(p2pkh->PubkeyHash().value()));
-            list.emplace_back(space(p2sh_p2pk->ScriptHash().value()));
-            list.emplace_back(space(p2sh_p2pkh->ScriptHash().value()));
+            list.reserve(list.size() + 4);
+            list.emplace_back(space(pubkey));
+            list.emplace_back(pkh);
+            list.emplace_back(p2pkHash);
+            list.emplace_back(p2pkhHash);
         } break;
         case filter::Type::Basic_BIP158:
         case filter::Type::Basic_BCHVariant:
         default: {
-            for (const auto& script : scripts) {
-                script->Serialize(writer(list.emplace_back()));
+            list.reserve(list.size() + 5);
+            list.emplace_back(space(p2pkView));
+            list.emplace_back(space(p2pkhView));
+            written &= script::P2SH.Write(
+                reader(p2pkHash), writer(list.emplace_back()));
+            written &= script::P2SH.Write(
+                reader(p2pkhHash), writer(list.emplace_back()));
+            written &=
+                script::P2WPKH.Write(reader(pkh), writer(list.emplace_back()));
+
+            OT_ASSERT(written);
+        }
+    }
+
+    using Key = WalletDatabase::KeyType;
+    auto& owned = keys[index];
+    owned.reserve(owned.size() + 4);
+    owned.emplace_back(Key::Pubkey, space(pubkey));
+    // Also identifies P2WPKH outputs since the witness program is the same hash
+    owned.emplace_back(Key::PubkeyHash, std::move(pkh));
+    owned.emplace_back(Key::ScriptHash, std::move(p2pkHash));
+    owned.emplace_back(Key::ScriptHash, std::move(p2pkhHash));
+}
+
+auto HDStateData::owns(const block::bitcoin::Script& script) const noexcept
+    -> bool
+{
+    using Key = WalletDatabase::KeyType;
+    using Pattern = block::bitcoin::Script::Pattern;
+
+    const auto mine = [&](const Key type, const auto& key) -> bool {
+        if (false == key.has_value()) { return false; }
+
+        const auto element = db_.FindElement(type, key.value());
+
+        if (false == element.has_value()) { return false; }
+
+        const auto& [index, subchainID] = element.value();
+        const auto& [subchain, nodeID] = subchainID;
+
+        return (subchain_ == subchain) && (node_.ID() == nodeID.get());
+    };
+
+    switch (script.Type()) {
+        case Pattern::PayToPubkey: {
+
+            return mine(Key::Pubkey, script.Pubkey());
+        }
+        case Pattern::PayToPubkeyHash: {
+
+            return mine(Key::PubkeyHash, script.PubkeyHash());
+        }
+        case Pattern::PayToScriptHash: {
+
+            return mine(Key::ScriptHash, script.ScriptHash());
+        }
+        case Pattern::PayToMultisig: {
+            const auto n = script.N().value_or(0);
+
+            for (auto i = std::size_t{0}; i < n; ++i) {
+                if (mine(Key::Pubkey, script.MultisigPubkey(i))) {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+        case Pattern::Custom: {
+            // Version 0 witness program which pays to a key hash
+            if (2 != script.size()) { return false; }
+
+            const auto& version = script.at(0);
+            const auto& program = script.at(1);
+
+            if ((block::bitcoin::OP::ZERO != version.opcode_) ||
+                (false == program.data_.has_value()) ||
+                (20 != program.data_.value().size())) {
+
+                return false;
             }
+
+            const auto hash = std::make_optional(reader(program.data_.value()));
+
+            return mine(Key::PubkeyHash, hash);
+        }
+        default: {
+
+            return false;
         }
     }
 }
@@ -189,6 +336,7 @@ auto HDStateData::process() noexcept -> void
         {
             data_.outstanding_blocks_.erase(it_);
             data_.process_block_queue_.pop();
+            data_.update_processed();
         }
 
     private:
@@ -226,20 +374,36 @@ auto HDStateData::process() noexcept -> void
             patterns.emplace_back(reader(data));
         });
 
-    const auto pFilter = filters.LoadFilter(filter_type_, blockHash);
+    auto potential = WalletDatabase::Patterns{};
+    const auto read = filters.ReadFilter(
+        filter_type_,
+        block.Header().Height(),
+        blockHash,
+        [&](const auto& filter) {
+            for (const auto& it : filter.Match(patterns)) {
+                const auto pos = std::distance(patterns.cbegin(), it);
+                auto& [id, element] = elements.at(pos);
+                potential.emplace_back(std::move(id), std::move(element));
+            }
+        });
 
-    OT_ASSERT(pFilter);
+    OT_ASSERT(read);
 
-    const auto& filter = *pFilter;
-    auto potential = WalletDatabase::Patterns{};
+    // Transactions which spend a wallet output are found through the outpoint
+    // index of the block so no other transaction is instantiated
+    const auto& utxos = unspent_.Update(db_);
+    auto outpoints = WalletDatabase::Patterns{};
+    outpoints.reserve(utxos.size());
 
-    for (const auto& it : filter.Match(patterns)) {
-        const auto pos = std::distance(patterns.cbegin(), it);
-        auto& [id, element] = elements.at(pos);
-        potential.emplace_back(std::move(id), std::move(element));
+    for (const auto& [outpoint, output] : utxos) {
+        outpoints.emplace_back(
+            WalletDatabase::ElementID{
+                0, {subchain_, Identifier::Factory(node_.ID())}},
+            space(outpoint.Bytes()));
     }
 
-    const auto confirmed = block.FindMatches(filter_type_, {}, potential);
+    const auto confirmed =
+        block.FindMatches(filter_type_, outpoints, potential);
     const auto& oracle = network_.HeaderOracle();
     const auto pHeader = oracle.LoadHeader(blockHash);
 
@@ -262,10 +426,63 @@ auto HDStateData::process() noexcept -> void
     if (0 < confirmed.size()) {
         // Re-scan the last 1000 blocks
         const auto height = std::max(header.Height() - 1000, block::Height{0});
-        last_scanned_ = block::Position{height, oracle.BestHash(height)};
+        set_scanned(block::Position{height, oracle.BestHash(height)});
+    }
+}
+
+auto HDStateData::process_mempool(
+    const block::bitcoin::Transaction& transaction) const noexcept -> void
+{
+    auto outputs = std::vector<Bip32Index>{};
+    auto spends{false};
+    auto i = Bip32Index{0};
+
+    for (const auto& output : transaction.Outputs()) {
+        if (owns(output.Script())) { outputs.emplace_back(i); }
+
+        ++i;
+    }
+
+    for (const auto& input : transaction.Inputs()) {
+        if (db_.IsUnspent(input.PreviousOutput())) {
+            spends = true;
+
+            break;
+        }
+    }
+
+    if (outputs.empty() && (false == spends)) { return; }
+
+    const auto added =
+        db_.AddMempoolTransaction(node_.ID(), subchain_, outputs, transaction);
+
+    if (false == added) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(": Failed to record transaction ")(
+            transaction.ID().asHex())
+            .Flush();
     }
 }
 
+auto HDStateData::retest(
+    const block::Hash& block,
+    const blockchain::internal::GCS& filter,
+    const UnspentCache::Map& unspent) noexcept -> bool
+{
+    const auto untested = db_.GetUntestedPatterns(
+        node_.ID(), subchain_, filter_type_, block.Bytes());
+    const auto targets = get_targets(untested, unspent);
+    const auto matches = filter.Match(targets);
+    LogVerbose(OT_METHOD)(__FUNCTION__)(": ")(matches.size())(
+        " new matches for block ")(block.asHex())
+        .Flush();
+
+    if (matches.empty()) { return false; }
+
+    blocks_to_request_.emplace_back(block);
+
+    return true;
+}
+
 auto HDStateData::scan() noexcept -> void
 {
     const auto start = Clock::now();
@@ -279,59 +496,80 @@ auto HDStateData::scan() noexcept -> void
         last_scanned_.has_value()
             ? block::Position{startHeight, headers.BestHash(startHeight)}
             : block::Position{1, headers.BestHash(1)};
-    const auto stopHeight = std::min(startHeight + 9999, best.first);
+    const auto stopHeight = std::min(
+        std::min(startHeight + 9999, best.first),
+        std::min(
+            scan_limit_.value_or(best.first), filters.ScanTip(filter_type_)));
 
     if (first.second->empty()) { return; }  // Reorg occured while processing
 
     const auto elements = db_.GetPatterns(node_.ID(), subchain_, filter_type_);
-    const auto utxos = db_.GetUnspentOutputs();
+    const auto& utxos = unspent_.Update(db_);
+    const auto patterns = get_targets(elements, utxos);
+    auto hashes = std::vector<block::pHash>{};
+
+    for (auto i{startHeight}; i <= stopHeight; ++i) {
+        auto hash = headers.BestHash(i);
+
+        if (hash->empty()) { break; }  // Reorg occured while processing
+
+        hashes.emplace_back(std::move(hash));
+    }
+
+    // Heights which match are recorded until the results are merged in height
+    // order and those filters are read again from the filter cache for the
+    // retest. Each slot is written by exactly one thread.
+    auto matches = std::vector<std::uint8_t>(hashes.size(), 0);
+    const auto process = [&](const block::Height height) -> bool {
+        const auto index = static_cast<std::size_t>(height - startHeight);
+
+        return filters.ReadFilter(
+            filter_type_, height, hashes.at(index), [&](const auto& filter) {
+                if (false == filter.Match(patterns).empty()) {
+                    matches.at(index) = 1;
+                }
+            });
+    };
+    const auto last = startHeight + static_cast<block::Height>(hashes.size());
+    const auto scanned =
+        scan_job_->Run(startHeight, last - 1, process, scan_dispatch_);
     auto highestTested = last_scanned_.value_or(
         make_blank<block::Position>::value(network_.API()));
     auto atLeastOnce{false};
 
-    for (auto i{startHeight}; i <= stopHeight; ++i) {
-        auto blockHash = headers.BestHash(i);
-        const auto pFilter = filters.LoadFilter(filter_type_, blockHash);
-
-        if (false == bool(pFilter)) { break; }
+    if (scanned.has_value()) {
+        for (auto i{startHeight}; i <= scanned.value(); ++i) {
+            const auto index = static_cast<std::size_t>(i - startHeight);
+            if (0 == matches.at(index)) { continue; }
 
-        atLeastOnce = true;
-        highestTested.first = i;
-        highestTested.second = blockHash;
-        const auto& filter = *pFilter;
-        auto patterns = get_targets(elements, utxos);
-        auto matches = filter.Match(patterns);
-        const auto size{matches.size()};
-
-        if (0 < matches.size()) {
+            const auto& blockHash = hashes.at(index);
             LogVerbose(OT_METHOD)(__FUNCTION__)(": GCS for block ")(
                 blockHash->asHex())(" at height ")(i)(
                 " matches at least one of the ")(patterns.size())(
                 " target elements for this subchain")
                 .Flush();
-            const auto retest = db_.GetUntestedPatterns(
-                node_.ID(), subchain_, filter_type_, blockHash->Bytes());
-            patterns = get_targets(retest, utxos);
-            matches = filter.Match(patterns);
-            LogVerbose(OT_METHOD)(__FUNCTION__)(": ")(matches.size())(" of ")(
-                size)(" matches are new")
-                .Flush();
-
-            if (0 < matches.size()) {
-                blocks_to_request_.emplace_back(std::move(blockHash));
-            }
+            filters.ReadFilter(
+                filter_type_, i, blockHash, [&](const auto& filter) {
+                    retest(blockHash, filter, utxos);
+                });
         }
+
+        atLeastOnce = true;
+        highestTested.first = scanned.value();
+        highestTested.second = hashes.at(
+            static_cast<std::size_t>(scanned.value() - startHeight));
     }
 
     if (atLeastOnce) {
         LogVerbose(OT_METHOD)(__FUNCTION__)(": Found ")(
             blocks_to_request_.size())(" potential matches between blocks ")(
-            startHeight)(" and ")(highestTested.first)(" in ")(
+            startHeight)(" and ")(highestTested.first)(" on ")(
+            scan_job_->Threads())(" threads in ")(
             std::chrono::duration_cast<std::chrono::milliseconds>(
                 Clock::now() - start)
                 .count())(" milliseconds")
             .Flush();
-        last_scanned_ = std::move(highestTested);
+        set_scanned(highestTested);
     } else {
         LogVerbose(OT_METHOD)(__FUNCTION__)(
             ": Missing filter for block at height ")(startHeight)
@@ -339,6 +577,51 @@ auto HDStateData::scan() noexcept -> void
     }
 }
 
+auto HDStateData::set_scanned(const block::Position& position) noexcept -> void
+{
+    last_scanned_ = position;
+    const auto saved = db_.SubchainSetLastScanned(
+        node_.ID(), subchain_, filter_type_, position);
+
+    if (false == saved) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(": Failed to save scan progress")
+            .Flush();
+    }
+
+    update_processed();
+}
+
+auto HDStateData::update_processed() noexcept -> void
+{
+    if (false == last_scanned_.has_value()) { return; }
+
+    const auto& oracle = network_.HeaderOracle();
+    auto height = last_scanned_.value().first;
+    const auto pending = [&](const block::Hash& hash) {
+        const auto pHeader = oracle.LoadHeader(hash);
+
+        if (pHeader) { height = std::min(height, pHeader->Height() - 1); }
+    };
+
+    for (const auto& hash : blocks_to_request_) { pending(hash); }
+
+    for (const auto& [hash, future] : outstanding_blocks_) { pending(hash); }
+
+    const auto& scanned = last_scanned_.value();
+    const auto position =
+        (height == scanned.first)
+            ? scanned
+            : block::Position{height, oracle.BestHash(height)};
+    const auto saved = db_.SubchainSetLastProcessed(
+        node_.ID(), subchain_, filter_type_, position);
+
+    if (false == saved) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(
+            ": Failed to save processing progress")
+            .Flush();
+    }
+}
+
 auto HDStateData::update_utxos(
     const block::bitcoin::Block& block,
     const block::Position& position,
@@ -350,83 +633,47 @@ auto HDStateData::update_utxos(
             std::vector<Bip32Index>,
             const block::bitcoin::Transaction*>>{};
 
+    // Each output is claimed with a single lookup in the element key index
+    // regardless of which element or outpoint caused the transaction to match
     for (const auto& [txid, elementID] : matches) {
-        const auto& [index, subchainID] = elementID;
-        const auto& [subchain, accountID] = subchainID;
-        const auto& element = node_.BalanceElement(subchain, index);
+        if (0 < transactions.count(txid)) { continue; }
+
         const auto& pTransaction = block.at(txid->Bytes());
 
         OT_ASSERT(pTransaction);
 
-        auto& arg = transactions[txid];
-        auto& [outputs, pTX] = arg;
-        const auto& transaction = *pTransaction;
+        auto& [outputs, pTX] = transactions[txid];
         auto i = Bip32Index{0};
 
-        for (const auto& output : transaction.Outputs()) {
-            const auto& script = output.Script();
-
-            switch (script.Type()) {
-                case block::bitcoin::Script::Pattern::PayToPubkey: {
-                    const auto pKey = element.Key();
+        for (const auto& output : pTransaction->Outputs()) {
+            if (owns(output.Script())) {
+                outputs.emplace_back(i);
 
-                    OT_ASSERT(pKey);
-                    OT_ASSERT(script.Pubkey().has_value());
-
-                    const auto& key = *pKey;
-
-                    if (key.PublicKey() == script.Pubkey().value()) {
-                        outputs.emplace_back(i);
-
-                        if (nullptr == pTX) { pTX = pTransaction.get(); }
-                    }
-
-                    // TODO mark key as used
-                } break;
-                case block::bitcoin::Script::Pattern::PayToPubkeyHash: {
-                    const auto hash = element.PubkeyHash();
-
-                    OT_ASSERT(script.PubkeyHash().has_value());
-
-                    if (hash->Bytes() == script.PubkeyHash().value()) {
-                        outputs.emplace_back(i);
-
-                        if (nullptr == pTX) { pTX = pTransaction.get(); }
-                    }
-
-                    // TODO mark key as used
-                } break;
-                case block::bitcoin::Script::Pattern::PayToScriptHash:
-                case block::bitcoin::Script::Pattern::PayToMultisig:
-                default: {
-                }
-            };
+                if (nullptr == pTX) { pTX = pTransaction.get(); }
+            }
 
+            // TODO mark key as used
             ++i;
         }
-    }
-
-    auto unspent = std::set<blockchain::block::bitcoin::Outpoint>{};
 
-    for (const auto& utxo : db_.GetUnspentOutputs()) {
-        unspent.insert(utxo.first);
-    }
-
-    for (const auto& transaction : block) {
-        OT_ASSERT(transaction);
+        if (nullptr != pTX) { continue; }
 
-        for (const auto& input : transaction->Inputs()) {
-            if (0 < unspent.count(input.PreviousOutput())) {
-                auto& pTx = transactions[transaction->ID()].second;
+        for (const auto& input : pTransaction->Inputs()) {
+            if (db_.IsUnspent(input.PreviousOutput())) {
+                pTX = pTransaction.get();
 
-                if (nullptr == pTx) { pTx = transaction.get(); }
+                break;
             }
         }
     }
 
     for (const auto& [txid, data] : transactions) {
         auto& [outputs, pTX] = data;
-        auto updated = db_.AddConfirmedTransaction(position, outputs, *pTX);
+
+        if (nullptr == pTX) { continue; }
+
+        auto updated = db_.AddConfirmedTransaction(
+            node_.ID(), subchain_, position, outputs, *pTX);
 
         OT_ASSERT(updated);  // TODO handle database errors
     }
@@ -6,7 +6,9 @@
 #pragma once
 
 #include <atomic>
+#include <cstddef>
 #include <map>
+#include <memory>
 #include <optional>
 #include <queue>
 #include <vector>
@@ -18,6 +20,7 @@
 #include "opentxs/api/client/blockchain/HD.hpp"
 #include "opentxs/blockchain/Blockchain.hpp"
 #include "opentxs/blockchain/block/Block.hpp"
+#include "opentxs/blockchain/block/bitcoin/Input.hpp"
 #include "opentxs/blockchain/client/BlockOracle.hpp"
 #include "opentxs/core/Data.hpp"
 
@@ -41,13 +44,42 @@ namespace block
 namespace bitcoin
 {
 class Block;
+class Script;
+class Transaction;
 }  // namespace bitcoin
 }  // namespace block
 }  // namespace blockchain
+
+namespace network
+{
+namespace zeromq
+{
+namespace socket
+{
+class Push;
+}  // namespace socket
+}  // namespace zeromq
+}  // namespace network
 }  // namespace opentxs
 
 namespace opentxs::blockchain::client::implementation
 {
+/// Local copy of the wallet's unspent outputs which is kept current using the
+/// database change feed instead of being reloaded for every scan
+struct UnspentCache {
+    using Map = std::map<
+        block::bitcoin::Outpoint,
+        internal::WalletDatabase::UTXO::second_type>;
+
+    auto Update(const internal::WalletDatabase& db) noexcept -> const Map&;
+
+    UnspentCache() noexcept;
+
+private:
+    std::size_t epoch_;
+    Map map_;
+};
+
 struct HDStateData {
     using OutstandingMap =
         std::map<block::pHash, BlockOracle::BitcoinBlockFuture>;
@@ -59,35 +91,61 @@ struct HDStateData {
     const api::client::blockchain::HD& node_;
     const filter::Type filter_type_;
     const Subchain subchain_;
+    const internal::ParallelScan::Dispatch scan_dispatch_;
+    std::unique_ptr<internal::ParallelScan> scan_job_;
     std::atomic<bool> running_;
     std::optional<Bip32Index> last_indexed_;
     std::optional<block::Position> last_scanned_;
+    // Individual scans stop here so the subchain can join the chain-wide scan
+    std::optional<block::Height> scan_limit_;
     std::vector<block::pHash> blocks_to_request_;
     OutstandingMap outstanding_blocks_;
     std::queue<OutstandingMap::iterator> process_block_queue_;
+    UnspentCache unspent_;
 
     auto index() noexcept -> void;
     auto process() noexcept -> void;
+    /// Records the outputs of an unconfirmed transaction which belong to
+    /// this subchain and any wallet outputs it spends
+    auto process_mempool(const block::bitcoin::Transaction& transaction) const
+        noexcept -> void;
+    /// Queues the block for download if it matches an untested element
+    auto retest(
+        const block::Hash& block,
+        const blockchain::internal::GCS& filter,
+        const UnspentCache::Map& unspent) noexcept -> bool;
     auto scan() noexcept -> void;
+    /// Saves the scan progress of the subchain. The processed position saved
+    /// with it stops before the first matching block which has not been
+    /// processed yet so those blocks are scanned again after a restart.
+    auto set_scanned(const block::Position& position) noexcept -> void;
+
+    auto get_targets(
+        const internal::WalletDatabase::Patterns& keys,
+        const UnspentCache::Map& unspent) const noexcept
+        -> blockchain::internal::GCS::Targets;
 
     HDStateData(
         const internal::Network& network,
         const WalletDatabase& db,
+        const zmq::socket::Push& socket,
         const api::client::blockchain::HD& node,
         const filter::Type filter,
         const Subchain subchain) noexcept;
     HDStateData(HDStateData&&) noexcept;
 
 private:
-    auto get_targets(
-        const internal::WalletDatabase::Patterns& keys,
-        const std::vector<internal::WalletDatabase::UTXO>& unspent) const
-        noexcept -> blockchain::internal::GCS::Targets;
+    static const std::size_t scan_threads_;
+
     auto index_element(
         const filter::Type type,
         const api::client::blockchain::BalanceNode::Element& input,
         const Bip32Index index,
-        WalletDatabase::ElementMap& output) noexcept -> void;
+        WalletDatabase::ElementMap& output,
+        WalletDatabase::ElementKeys& keys) noexcept -> void;
+    /// True if the output script pays to an element of this subchain
+    auto owns(const block::bitcoin::Script& script) const noexcept -> bool;
+    auto update_processed() noexcept -> void;
     auto update_utxos(
         const block::bitcoin::Block& block,
         const block::Position& position,
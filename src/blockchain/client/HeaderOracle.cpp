@@ -8,12 +8,20 @@
 #include "blockchain/client/HeaderOracle.hpp"  // IWYU pragma: associated
 
 #include <algorithm>
+#include <array>
 #include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <cstdint>
 #include <functional>
+#include <limits>
 #include <map>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "blockchain/client/UpdateTransaction.hpp"
+#include "core/Executor.hpp"
 #include "internal/api/Api.hpp"
 #include "internal/core/Core.hpp"
 #include "opentxs/blockchain/Work.hpp"
@@ -22,6 +30,8 @@
 #include "opentxs/core/Data.hpp"
 #include "opentxs/core/Log.hpp"
 #include "opentxs/core/LogSource.hpp"
+#include "opentxs/network/zeromq/Message.hpp"
+#include "opentxs/network/zeromq/socket/Publish.hpp"
 
 #define OT_METHOD "opentxs::blockchain::client::implementation::HeaderOracle::"
 
@@ -99,6 +109,155 @@ HeaderOracle::HeaderOracle(
     , database_(database)
     , chain_(type)
     , lock_()
+    , best_chain_(database)
+{
+}
+
+// Hashes are stored by height in fixed size chunks. Heights are also indexed
+// by hash prefix, split into shards by the byte following the prefix, so
+// membership tests do not need to look up the header. Chunks and shards
+// shared with an earlier snapshot are copied the first time they are
+// modified.
+struct HeaderOracle::BestChainIndex::Snapshot {
+    static constexpr auto chunk_size_ = std::size_t{2048};
+    static constexpr auto shard_count_ = std::size_t{256};
+
+    using Hash = std::array<std::byte, 32>;
+    using Chunk = std::array<Hash, chunk_size_>;
+    using Key = std::uint64_t;
+    using Shard = std::vector<std::pair<Key, block::Height>>;
+
+    struct Copied {
+        std::set<std::size_t> chunks_{};
+        std::set<std::size_t> shards_{};
+    };
+
+    block::Height height_{-1};
+    std::vector<std::shared_ptr<Chunk>> chunks_{};
+    std::array<std::shared_ptr<Shard>, shard_count_> shards_{};
+
+    static auto prefix(const void* hash) noexcept -> std::pair<std::size_t, Key>
+    {
+        auto output = std::pair<std::size_t, Key>{};
+        auto& [shard, key] = output;
+        const auto* bytes = static_cast<const std::byte*>(hash);
+        std::memcpy(&key, bytes, sizeof(key));
+        shard = std::to_integer<std::size_t>(bytes[sizeof(key)]);
+
+        return output;
+    }
+
+    auto contains(const block::Hash& hash) const noexcept -> bool
+    {
+        if (sizeof(Hash) != hash.size()) { return false; }
+
+        const auto [index, key] = prefix(hash.data());
+        const auto& shard = shards_.at(index);
+
+        if (false == bool(shard)) { return false; }
+
+        const auto first = Shard::value_type{
+            key, std::numeric_limits<block::Height>::min()};
+        auto it = std::lower_bound(shard->begin(), shard->end(), first);
+
+        // Several heights may share a prefix
+        for (; (shard->end() != it) && (key == it->first); ++it) {
+            const auto* stored = get(it->second);
+
+            OT_ASSERT(nullptr != stored);
+
+            if (0 == std::memcmp(stored->data(), hash.data(), sizeof(Hash))) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+    auto get(const block::Height height) const noexcept -> const Hash*
+    {
+        if ((0 > height) || (height > height_)) { return nullptr; }
+
+        const auto position = static_cast<std::size_t>(height);
+
+        return &chunks_.at(position / chunk_size_)->at(position % chunk_size_);
+    }
+
+    auto set(
+        const block::Height height,
+        const block::Hash& hash,
+        Copied& copied) noexcept -> void
+    {
+        OT_ASSERT(0 <= height);
+        OT_ASSERT(sizeof(Hash) == hash.size());
+
+        if (height <= height_) { unindex(height, copied); }
+
+        const auto position = static_cast<std::size_t>(height);
+        const auto index = position / chunk_size_;
+
+        while (chunks_.size() <= index) {
+            chunks_.emplace_back(std::make_shared<Chunk>());
+            copied.chunks_.emplace(chunks_.size() - 1);
+        }
+
+        auto& chunk = chunks_.at(index);
+
+        if (0 == copied.chunks_.count(index)) {
+            chunk = std::make_shared<Chunk>(*chunk);
+            copied.chunks_.emplace(index);
+        }
+
+        auto& output = chunk->at(position % chunk_size_);
+        std::memcpy(output.data(), hash.data(), output.size());
+        height_ = std::max(height_, height);
+        const auto [shardIndex, key] = prefix(hash.data());
+        auto& shard = modify(shardIndex, copied);
+        const auto value = Shard::value_type{key, height};
+        shard.insert(
+            std::upper_bound(shard.begin(), shard.end(), value), value);
+    }
+    /// Removes every height above the specified height
+    auto truncate(const block::Height height, Copied& copied) noexcept -> void
+    {
+        while (height_ > height) {
+            unindex(height_, copied);
+            --height_;
+        }
+    }
+
+private:
+    auto modify(const std::size_t index, Copied& copied) noexcept -> Shard&
+    {
+        auto& shard = shards_.at(index);
+
+        if (false == bool(shard)) {
+            shard = std::make_shared<Shard>();
+            copied.shards_.emplace(index);
+        } else if (0 == copied.shards_.count(index)) {
+            shard = std::make_shared<Shard>(*shard);
+            copied.shards_.emplace(index);
+        }
+
+        return *shard;
+    }
+    auto unindex(const block::Height height, Copied& copied) noexcept -> void
+    {
+        const auto* stored = get(height);
+
+        OT_ASSERT(nullptr != stored);
+
+        const auto [index, key] = prefix(stored->data());
+        auto& shard = modify(index, copied);
+        const auto value = Shard::value_type{key, height};
+        const auto it = std::lower_bound(shard.begin(), shard.end(), value);
+
+        if ((shard.end() != it) && (value == *it)) { shard.erase(it); }
+    }
+};
+
+HeaderOracle::BestChainIndex::BestChainIndex(
+    const internal::HeaderDatabase& database) noexcept
+    : snapshot_(load(database))
 {
 }
 
@@ -126,7 +285,7 @@ auto HeaderOracle::AddCheckpoint(
 
     if (apply_checkpoint(lock, position, update)) {
 
-        return database_.ApplyUpdate(update);
+        return apply_update(lock, update);
     } else {
 
         return false;
@@ -163,7 +322,7 @@ auto HeaderOracle::AddHeaders(
         }
     }
 
-    return database_.ApplyUpdate(update);
+    return apply_update(lock, update);
 }
 
 auto HeaderOracle::add_header(
@@ -265,6 +424,34 @@ auto HeaderOracle::apply_checkpoint(
     }
 }
 
+// The index is published once the update is committed and before the reorg
+// signal, so subscribers never see an index which disagrees with the database
+auto HeaderOracle::apply_update(
+    const Lock& lock,
+    UpdateTransaction& update) noexcept -> bool
+{
+    if (false == database_.ApplyUpdate(update)) { return false; }
+
+    best_chain_.Apply(update);
+
+    if (update.HaveReorg()) {
+        const auto [height, hash] = update.ReorgParent();
+        const auto bytes = hash->Bytes();
+        LogNormal("Blockchain reorg detected. Last common ancestor is ")(
+            hash->asHex())(" at height ")(height)
+            .Flush();
+        auto work = MakeWork(api_, OTZMQWorkType{OT_ZMQ_REORG_SIGNAL});
+        work->AddFrame(chain_);
+        work->AddFrame(bytes.data(), bytes.size());
+        work->AddFrame(height);
+        network_.Reorg().Send(work);
+    }
+
+    network_.UpdateLocalHeight(best_chain(lock));
+
+    return true;
+}
+
 auto HeaderOracle::best_chain(const Lock& lock) const noexcept
     -> block::Position
 {
@@ -278,16 +465,68 @@ auto HeaderOracle::BestChain() const noexcept -> block::Position
     return best_chain(lock);
 }
 
-auto HeaderOracle::BestHash(const block::Height height) const noexcept
-    -> block::pHash
+auto HeaderOracle::BestChainIndex::Apply(
+    const UpdateTransaction& update) noexcept -> void
 {
-    Lock lock(lock_);
+    auto next = std::make_shared<Snapshot>(*std::atomic_load(&snapshot_));
+    auto copied = Snapshot::Copied{};
 
-    try {
-        return database_.BestBlock(height);
-    } catch (...) {
-        return make_blank<block::pHash>::value(api_);
+    if (update.HaveReorg()) {
+        next->truncate(update.ReorgParent().first, copied);
     }
+
+    for (const auto& [height, hash] : update.BestChain()) {
+        next->set(height, hash, copied);
+    }
+
+    std::atomic_store(&snapshot_, Pointer{std::move(next)});
+}
+
+auto HeaderOracle::BestChainIndex::Contains(const block::Hash& hash) const
+    noexcept -> bool
+{
+    return std::atomic_load(&snapshot_)->contains(hash);
+}
+
+auto HeaderOracle::BestChainIndex::Get(const block::Height height) const
+    noexcept -> block::pHash
+{
+    const auto snapshot = std::atomic_load(&snapshot_);
+    const auto* hash = snapshot->get(height);
+
+    if (nullptr == hash) { return Data::Factory(); }
+
+    return Data::Factory(hash->data(), hash->size());
+}
+
+auto HeaderOracle::BestChainIndex::load(
+    const internal::HeaderDatabase& database) noexcept -> Pointer
+{
+    auto output = std::make_shared<Snapshot>();
+    auto copied = Snapshot::Copied{};
+    const auto best = database.CurrentBest();
+
+    if (false == bool(best)) { return output; }
+
+    for (auto height = block::Height{0}; height <= best->Height(); ++height) {
+        try {
+            const auto hash = database.BestBlock(height);
+
+            if (hash->empty()) { break; }
+
+            output->set(height, hash, copied);
+        } catch (...) {
+            break;
+        }
+    }
+
+    return output;
+}
+
+auto HeaderOracle::BestHash(const block::Height height) const noexcept
+    -> block::pHash
+{
+    return best_chain_.Get(height);
 }
 
 auto HeaderOracle::choose_candidate(
@@ -370,21 +609,21 @@ auto HeaderOracle::CommonParent(const block::Position& position) const noexcept
         {0, GenesisBlockHash(chain_)}, best_chain(lock)};
     auto& [parent, best] = output;
     auto test{position};
-    auto pHeader = database.TryLoadHeader(test.second);
+    auto header = database.LoadHeaderView(test.second->Bytes());
 
-    if (false == bool(pHeader)) { return output; }
+    if (false == header.has_value()) { return output; }
 
     while (0 < test.first) {
-        if (is_in_best_chain(lock, test.second)) {
+        if (best_chain_.Contains(test.second)) {
             parent = test;
 
             return output;
         }
 
-        pHeader = database.TryLoadHeader(pHeader->ParentHash());
+        header = database.LoadHeaderView(header->ParentHash());
 
-        if (pHeader) {
-            test = pHeader->Position();
+        if (header.has_value()) {
+            test = {header->Height(), api_.Factory().Data(header->Hash())};
         } else {
             return output;
         }
@@ -460,7 +699,7 @@ auto HeaderOracle::DeleteCheckpoint() noexcept -> bool
 
     if (apply_checkpoint(lock, position, update)) {
 
-        return database_.ApplyUpdate(update);
+        return apply_update(lock, update);
     } else {
 
         return false;
@@ -522,9 +761,7 @@ auto HeaderOracle::initialize_candidate(
 
 auto HeaderOracle::IsInBestChain(const block::Hash& hash) const noexcept -> bool
 {
-    Lock lock(lock_);
-
-    return is_in_best_chain(lock, hash);
+    return best_chain_.Contains(hash);
 }
 
 auto HeaderOracle::is_disconnected(
@@ -547,24 +784,6 @@ auto HeaderOracle::is_disconnected(
     }
 }
 
-auto HeaderOracle::is_in_best_chain(const Lock& lock, const block::Hash& hash)
-    const noexcept -> bool
-{
-    const auto pHeader = database_.TryLoadHeader(hash);
-
-    if (false == bool(pHeader)) { return false; }
-
-    const auto& header = *pHeader;
-
-    try {
-        return hash == database_.BestBlock(header.Height());
-
-    } catch (...) {
-
-        return false;
-    }
-}
-
 auto HeaderOracle::LoadHeader(const block::Hash& hash) const noexcept
     -> std::unique_ptr<block::Header>
 {
@@ -8,12 +8,15 @@
 #include <map>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <set>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "internal/blockchain/block/Block.hpp"
 #include "internal/blockchain/client/Client.hpp"
+#include "opentxs/Bytes.hpp"
 #include "opentxs/Pimpl.hpp"
 #include "opentxs/Types.hpp"
 #include "opentxs/blockchain/Blockchain.hpp"
@@ -58,6 +61,11 @@ public:
     bool IsInBestChain(const block::Hash& hash) const noexcept final;
     std::unique_ptr<block::Header> LoadHeader(const block::Hash& hash) const
         noexcept final;
+    auto LoadHeaderView(const ReadView hash) const noexcept
+        -> std::optional<block::internal::HeaderView> final
+    {
+        return database_.LoadHeaderView(hash);
+    }
     std::vector<block::pHash> RecentHashes() const noexcept final
     {
         return database_.RecentHashes();
@@ -83,6 +91,34 @@ public:
 private:
     friend opentxs::Factory;
 
+    // Memory resident copy of the best chain hashes, indexed by height and
+    // by hash. Readers take a snapshot without locking or reading the
+    // database. The oracle mutex serializes writers, which copy only the
+    // parts they modify before publishing a new snapshot.
+    class BestChainIndex
+    {
+    public:
+        struct Snapshot;
+
+        using Pointer = std::shared_ptr<const Snapshot>;
+
+        bool Contains(const block::Hash& hash) const noexcept;
+        /// Returns a blank hash if height is not in the best chain
+        block::pHash Get(const block::Height height) const noexcept;
+
+        /// Call only after the update has been committed
+        void Apply(const UpdateTransaction& update) noexcept;
+
+        BestChainIndex(const internal::HeaderDatabase& database) noexcept;
+
+    private:
+        Pointer snapshot_;
+
+        static Pointer load(const internal::HeaderDatabase& database) noexcept;
+
+        BestChainIndex() = delete;
+    };
+
     struct Candidate {
         bool blacklisted_{false};
         std::vector<block::Position> chain_{};
@@ -99,19 +135,19 @@ private:
     const internal::HeaderDatabase& database_;
     const blockchain::Type chain_;
     mutable std::mutex lock_;
+    BestChainIndex best_chain_;
 
     static bool evaluate_candidate(
         const block::Header& current,
         const block::Header& candidate) noexcept;
 
     block::Position best_chain(const Lock& lock) const noexcept;
-    bool is_in_best_chain(const Lock& lock, const block::Hash& hash) const
-        noexcept;
 
     bool add_header(
         const Lock& lock,
         UpdateTransaction& update,
         std::unique_ptr<block::Header> header) noexcept;
+    bool apply_update(const Lock& lock, UpdateTransaction& update) noexcept;
     bool apply_checkpoint(
         const Lock& lock,
         const block::Height height,
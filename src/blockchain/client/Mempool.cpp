@@ -0,0 +1,245 @@
+// Copyright (c) 2010-2020 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "0_stdafx.hpp"                   // IWYU pragma: associated
+#include "1_Internal.hpp"                 // IWYU pragma: associated
+#include "blockchain/client/Mempool.hpp"  // IWYU pragma: associated
+
+#include <iterator>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "opentxs/Pimpl.hpp"
+#include "opentxs/blockchain/block/bitcoin/Block.hpp"
+#include "opentxs/blockchain/block/bitcoin/Inputs.hpp"
+#include "opentxs/blockchain/block/bitcoin/Transaction.hpp"
+#include "opentxs/core/Data.hpp"
+#include "opentxs/core/Identifier.hpp"
+#include "opentxs/core/Log.hpp"
+#include "opentxs/core/LogSource.hpp"
+
+#define OT_METHOD "opentxs::blockchain::client::implementation::Mempool::"
+
+namespace opentxs::factory
+{
+auto Mempool(
+    const api::Core& api,
+    const blockchain::client::internal::WalletDatabase& database,
+    const std::size_t budget) noexcept
+    -> std::unique_ptr<blockchain::client::internal::Mempool>
+{
+    using ReturnType = blockchain::client::implementation::Mempool;
+
+    return std::make_unique<ReturnType>(api, database, budget);
+}
+}  // namespace opentxs::factory
+
+namespace opentxs::blockchain::client::implementation
+{
+const std::size_t Mempool::overhead_{256};
+const std::chrono::seconds Mempool::request_timeout_{60};
+const std::chrono::hours Mempool::expiry_{336};
+
+Mempool::Mempool(
+    const api::Core& api,
+    const internal::WalletDatabase& db,
+    const std::size_t budget) noexcept
+    : api_(api)
+    , db_(db)
+    , budget_(budget)
+    , lock_()
+    , sequence_(0)
+    , used_(0)
+    , index_()
+    , feed_()
+    , spends_()
+    , requested_()
+    , request_queue_()
+{
+}
+
+auto Mempool::Dump(std::size_t& sequence) const noexcept -> Transactions
+{
+    auto output = Transactions{};
+    Lock lock(lock_);
+
+    for (auto i = feed_.upper_bound(sequence); i != feed_.end(); ++i) {
+        output.emplace_back(std::get<1>(i->second->second));
+    }
+
+    sequence = sequence_;
+
+    return output;
+}
+
+auto Mempool::drop(const Lock& lock, Index::iterator it) const noexcept
+    -> void
+{
+    const auto txid = block::pTxid{it->first};
+    erase(lock, it);
+    db_.DropMempoolTransaction(txid);
+}
+
+auto Mempool::drop(const Lock& lock, const block::Txid& txid) const noexcept
+    -> void
+{
+    if (auto it = index_.find(txid); index_.end() != it) { drop(lock, it); }
+}
+
+auto Mempool::erase(const Lock& lock, Index::iterator it) const noexcept
+    -> void
+{
+    const auto& [sequence, transaction, size, received] = it->second;
+
+    for (const auto& input : transaction->Inputs()) {
+        auto [first, last] = spends_.equal_range(input.PreviousOutput());
+
+        while (first != last) {
+            if (first->second == it) {
+                first = spends_.erase(first);
+            } else {
+                ++first;
+            }
+        }
+    }
+
+    used_ -= size;
+    feed_.erase(sequence);
+    index_.erase(it);
+}
+
+auto Mempool::expire_requests(const Lock& lock) const noexcept -> void
+{
+    const auto limit = Clock::now() - request_timeout_;
+
+    while (false == request_queue_.empty()) {
+        auto it = request_queue_.front();
+
+        if (it->second > limit) { break; }
+
+        requested_.erase(it);
+        request_queue_.pop_front();
+    }
+}
+
+auto Mempool::expire_transactions(const Lock& lock) const noexcept -> void
+{
+    const auto limit = Clock::now() - expiry_;
+
+    while (false == feed_.empty()) {
+        auto it = feed_.begin()->second;
+
+        if (std::get<3>(it->second) > limit) { break; }
+
+        drop(lock, it);
+    }
+}
+
+auto Mempool::Prune(const block::bitcoin::Block& block) const noexcept -> void
+{
+    using ElementID = block::Block::ElementID;
+
+    auto conflicts = std::set<block::pTxid>{};
+    Lock lock(lock_);
+    // Every transaction spends at least one outpoint so transactions which
+    // were confirmed by the block are found the same way as transactions
+    // which conflict with it. The outpoint index of the block is searched
+    // without instantiating its transactions. The index of each pattern
+    // identifies the outpoint it was created from.
+    auto outpoints = std::vector<const block::bitcoin::Outpoint*>{};
+    auto patterns = block::Block::Patterns{};
+
+    for (auto it{spends_.cbegin()}; spends_.cend() != it;
+         it = spends_.upper_bound(it->first)) {
+        const auto index = static_cast<Bip32Index>(outpoints.size());
+        patterns.emplace_back(
+            ElementID{index, {block::Block::Subchain{}, Identifier::Factory()}},
+            space(it->first.Bytes()));
+        outpoints.emplace_back(&it->first);
+    }
+
+    const auto matches =
+        block.FindMatches(filter::Type::Basic_BIP158, patterns, {});
+
+    for (const auto& [txid, id] : matches) {
+        const auto& outpoint = *outpoints.at(id.first);
+        auto [first, last] = spends_.equal_range(outpoint);
+
+        for (auto i{first}; i != last; ++i) {
+            conflicts.emplace(i->second->first);
+        }
+    }
+
+    for (const auto& txid : conflicts) {
+        LogVerbose(OT_METHOD)(__FUNCTION__)(": Removing transaction ")(
+            txid->asHex())(" which was confirmed by or conflicts with block ")(
+            block.ID().asHex())
+            .Flush();
+        drop(lock, txid);
+    }
+
+    expire_transactions(lock);
+}
+
+auto Mempool::Request(const block::Txid& txid) const noexcept -> bool
+{
+    Lock lock(lock_);
+    expire_requests(lock);
+
+    if (0 < index_.count(txid)) { return false; }
+
+    auto [it, added] = requested_.try_emplace(txid, Clock::now());
+
+    if (false == added) { return false; }
+
+    request_queue_.emplace_back(it);
+
+    return true;
+}
+
+auto Mempool::Submit(Transaction transaction) const noexcept -> bool
+{
+    if (false == bool(transaction)) { return false; }
+
+    const auto& txid = transaction->ID();
+    const auto size = transaction->CalculateSize() + overhead_;
+    Lock lock(lock_);
+    expire_transactions(lock);
+
+    if (0 < index_.count(txid)) { return false; }
+
+    // NOTE the request entry is left to expire so a transaction which is
+    // evicted for space is not immediately requested again
+
+    if (size > budget_) {
+        LogVerbose(OT_METHOD)(__FUNCTION__)(": Transaction ")(txid.asHex())(
+            " exceeds memory budget")
+            .Flush();
+
+        return false;
+    }
+
+    while ((used_ + size) > budget_) {
+        OT_ASSERT(false == feed_.empty());
+
+        drop(lock, feed_.begin()->second);
+    }
+
+    const auto sequence = ++sequence_;
+    const auto received = Clock::now();
+    auto [it, added] = index_.try_emplace(
+        txid, sequence, std::move(transaction), size, received);
+    feed_.emplace(sequence, it);
+
+    for (const auto& input : std::get<1>(it->second)->Inputs()) {
+        spends_.emplace(input.PreviousOutput(), it);
+    }
+
+    used_ += size;
+
+    return true;
+}
+}  // namespace opentxs::blockchain::client::implementation
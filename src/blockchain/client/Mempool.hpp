@@ -0,0 +1,99 @@
+// Copyright (c) 2010-2020 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <utility>
+
+#include "internal/blockchain/client/Client.hpp"
+#include "opentxs/Types.hpp"
+#include "opentxs/blockchain/Blockchain.hpp"
+#include "opentxs/blockchain/block/bitcoin/Input.hpp"
+
+namespace opentxs
+{
+namespace api
+{
+class Core;
+}  // namespace api
+
+namespace blockchain
+{
+namespace block
+{
+namespace bitcoin
+{
+class Block;
+}  // namespace bitcoin
+}  // namespace block
+}  // namespace blockchain
+}  // namespace opentxs
+
+namespace opentxs::blockchain::client::implementation
+{
+class Mempool final : public internal::Mempool
+{
+public:
+    auto Dump(std::size_t& sequence) const noexcept -> Transactions final;
+    auto Prune(const block::bitcoin::Block& block) const noexcept
+        -> void final;
+    auto Request(const block::Txid& txid) const noexcept -> bool final;
+    auto Submit(Transaction transaction) const noexcept -> bool final;
+
+    Mempool(
+        const api::Core& api,
+        const internal::WalletDatabase& db,
+        const std::size_t budget) noexcept;
+
+    ~Mempool() final = default;
+
+private:
+    // Sequence number, transaction, serialized size, time received
+    using Entry = std::tuple<std::size_t, Transaction, std::size_t, Time>;
+    using Index = std::map<block::pTxid, Entry>;
+    // Ordered by sequence number so the oldest transaction is evicted first
+    using Feed = std::map<std::size_t, Index::iterator>;
+    // Outpoints spent by each transaction in the pool
+    using Spends = std::multimap<block::bitcoin::Outpoint, Index::iterator>;
+    using Requests = std::map<block::pTxid, Time>;
+    using RequestQueue = std::deque<Requests::iterator>;
+
+    static const std::size_t overhead_;
+    static const std::chrono::seconds request_timeout_;
+    static const std::chrono::hours expiry_;
+
+    const api::Core& api_;
+    const internal::WalletDatabase& db_;
+    const std::size_t budget_;
+    mutable std::mutex lock_;
+    mutable std::size_t sequence_;
+    mutable std::size_t used_;
+    mutable Index index_;
+    mutable Feed feed_;
+    mutable Spends spends_;
+    mutable Requests requested_;
+    mutable RequestQueue request_queue_;
+
+    /// Removes the transaction and reverts any wallet changes it caused
+    auto drop(const Lock& lock, Index::iterator it) const noexcept -> void;
+    auto drop(const Lock& lock, const block::Txid& txid) const noexcept
+        -> void;
+    auto erase(const Lock& lock, Index::iterator it) const noexcept -> void;
+    auto expire_requests(const Lock& lock) const noexcept -> void;
+    auto expire_transactions(const Lock& lock) const noexcept -> void;
+
+    Mempool() = delete;
+    Mempool(const Mempool&) = delete;
+    Mempool(Mempool&&) = delete;
+    Mempool& operator=(const Mempool&) = delete;
+    Mempool& operator=(Mempool&&) = delete;
+};
+}  // namespace opentxs::blockchain::client::implementation
@@ -10,12 +10,18 @@
 #include <algorithm>
 #include <chrono>
 #include <cstdint>
+#include <stdexcept>
 #include <utility>
 #include <vector>
 
+#include "Factory.hpp"
+#include "blockchain/client/Bootstrap.hpp"
 #include "internal/api/Api.hpp"
+#include "internal/blockchain/bitcoin/Bitcoin.hpp"
 #include "opentxs/Pimpl.hpp"
+#include "opentxs/api/Endpoints.hpp"
 #include "opentxs/blockchain/block/Header.hpp"
+#include "opentxs/blockchain/block/bitcoin/Transaction.hpp"
 #include "opentxs/core/Data.hpp"
 #include "opentxs/core/Identifier.hpp"
 #include "opentxs/core/Log.hpp"
@@ -25,9 +31,34 @@
 #include "opentxs/network/zeromq/FrameSection.hpp"
 #include "opentxs/network/zeromq/Message.hpp"
 #include "opentxs/network/zeromq/Pipeline.hpp"
+#include "opentxs/network/zeromq/socket/Push.hpp"
+#include "opentxs/network/zeromq/socket/Socket.hpp"
 
 #define OT_METHOD "opentxs::blockchain::client::implementation::Network::"
 
+namespace opentxs::blockchain::client::internal
+{
+auto Network::ProcessTask(const zmq::Message& in) noexcept -> void
+{
+    const auto body = in.Body();
+
+    if (1 > body.size()) {
+        LogOutput("opentxs::blockchain::client::internal::Network::")(
+            __FUNCTION__)(": Invalid message")
+            .Flush();
+
+        OT_FAIL;
+    }
+
+    auto* pNetwork = reinterpret_cast<implementation::Network*>(
+        body.at(0).as<std::uintptr_t>());
+
+    OT_ASSERT(nullptr != pNetwork);
+
+    pNetwork->ExportBootstrap();
+}
+}  // namespace opentxs::blockchain::client::internal
+
 namespace opentxs::blockchain::client::implementation
 {
 Network::Network(
@@ -41,9 +72,10 @@ Network::Network(
     , database_p_(factory::BlockchainDatabase(
           api,
           blockchain,
-          *this,
           blockchain.BlockchainDB(),
           type))
+    , mempool_p_(
+          factory::Mempool(api, *database_p_, database_p_->MempoolSize()))
     , header_p_(factory::HeaderOracle(api, *this, *database_p_, type))
     , peer_p_(factory::BlockchainPeerManager(
           api,
@@ -53,8 +85,12 @@ Network::Network(
           type,
           seednode,
           shutdown_sender_.endpoint_))
-    , block_p_(
-          factory::BlockOracle(api, *this, type, shutdown_sender_.endpoint_))
+    , block_p_(factory::BlockOracle(
+          api,
+          *this,
+          *database_p_,
+          type,
+          shutdown_sender_.endpoint_))
     , filter_p_(factory::BlockchainFilterOracle(
           api,
           *this,
@@ -80,14 +116,26 @@ Network::Network(
     , remote_chain_height_(0)
     , processing_headers_(Flag::Factory(false))
     , task_id_(-1)
+    , thread_pool_(
+          api.ZeroMQ().PushSocket(zmq::socket::Socket::Direction::Connect))
+    , header_job_(0)
+    , header_dispatch_(
+          internal::ParallelScan::Dispatcher(api_, thread_pool_, type))
+    , export_lock_()
 {
     OT_ASSERT(database_p_);
+    OT_ASSERT(mempool_p_);
     OT_ASSERT(filter_p_);
     OT_ASSERT(header_p_);
     OT_ASSERT(peer_p_);
     OT_ASSERT(block_p_);
     OT_ASSERT(wallet_p_);
 
+    const auto zmq =
+        thread_pool_->Start(api.Endpoints().InternalBlockchainThreadPool());
+
+    OT_ASSERT(zmq);
+
     init_executor({});
 }
 
@@ -98,6 +146,22 @@ auto Network::AddPeer(const p2p::Address& address) const noexcept -> bool
     return peer_.AddPeer(address);
 }
 
+// Runs before any peer is started so the imported records are not competing
+// with headers and filters arriving from the network
+auto Network::bootstrap() noexcept -> void
+{
+    const auto& import = database_.BootstrapImport();
+
+    if (import.empty()) { return; }
+
+    auto files = Bootstrap{api_, chain_, header_, database_};
+    files.Import(
+        import,
+        [this](const auto bytes) { return instantiate_header(bytes); },
+        header_job_,
+        header_dispatch_);
+}
+
 auto Network::Connect() noexcept -> bool
 {
     if (false == running_.get()) { return false; }
@@ -112,6 +176,16 @@ auto Network::Disconnect() noexcept -> bool
     return false;
 }
 
+auto Network::ExportBootstrap() noexcept -> void
+{
+    Lock lock(export_lock_);
+
+    if (false == running_.get()) { return; }
+
+    auto files = Bootstrap{api_, chain_, header_, database_};
+    files.Export(database_.BootstrapExport());
+}
+
 auto Network::GetConfirmations(const std::string& txid) const noexcept
     -> ChainHeight
 {
@@ -129,6 +203,7 @@ auto Network::GetPeerCount() const noexcept -> std::size_t
 
 auto Network::init() noexcept -> void
 {
+    bootstrap();
     local_chain_height_.store(header_.BestChain().first);
 
     {
@@ -147,6 +222,7 @@ auto Network::init() noexcept -> void
     block_.Init();
     filters_.Start();
     wallet_.Init();
+    queue_export();
     task_id_ = api_.Schedule(std::chrono::seconds(30), [this]() { Trigger(); });
     Trigger();
 }
@@ -172,6 +248,12 @@ auto Network::pipeline(zmq::Message& in) noexcept -> void
         case Task::SubmitBlock: {
             process_block(in);
         } break;
+        case Task::SubmitFilterCheckpoints: {
+            process_cfcheckpt(in);
+        } break;
+        case Task::SubmitTransaction: {
+            process_transaction(in);
+        } break;
         case Task::StateMachine: {
             process_state_machine();
         } break;
@@ -199,6 +281,14 @@ auto Network::process_block(network::zeromq::Message& in) noexcept -> void
     block_.SubmitBlock(body.at(0));
 }
 
+auto Network::process_cfcheckpt(network::zeromq::Message& in) noexcept
+    -> void
+{
+    if (false == running_.get()) { return; }
+
+    filters_.AddCheckpoints(in);
+}
+
 auto Network::process_cfheader(network::zeromq::Message& in) noexcept -> void
 {
     if (false == running_.get()) { return; }
@@ -261,11 +351,11 @@ auto Network::process_header(network::zeromq::Message& in) noexcept -> void
     OT_ASSERT(pPromise);
 
     auto& promise = *pPromise;
-    auto headers = std::vector<std::unique_ptr<block::Header>>{};
-
-    for (const auto& header : input) {
-        headers.emplace_back(instantiate_header(header));
-    }
+    auto headers = internal::PrepareHeaders(
+        input,
+        [this](const auto bytes) { return instantiate_header(bytes); },
+        header_job_,
+        header_dispatch_);
 
     if (false == headers.empty()) { header_.AddHeaders(headers); }
 
@@ -295,6 +385,50 @@ auto Network::process_state_machine() noexcept -> void
     }
 }
 
+auto Network::process_transaction(network::zeromq::Message& in) noexcept
+    -> void
+{
+    if (false == running_.get()) { return; }
+
+    const auto body = in.Body();
+
+    if (1 > body.size()) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(": Invalid transaction").Flush();
+
+        return;
+    }
+
+    try {
+        auto pTx = opentxs::Factory::BitcoinTransaction(
+            api_,
+            chain_,
+            false,
+            blockchain::bitcoin::EncodedTransaction::Deserialize(
+                api_, chain_, body.at(0).Bytes()));
+
+        if (false == bool(pTx)) {
+            throw std::runtime_error("failed to instantiate transaction");
+        }
+
+        if (mempool_p_->Submit(std::move(pTx))) { wallet_.Run(); }
+    } catch (const std::exception& e) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(": ")(e.what()).Flush();
+    }
+}
+
+// Exporting a long chain takes a while, so it runs once in the background
+// instead of holding up startup
+auto Network::queue_export() noexcept -> void
+{
+    if (database_.BootstrapExport().empty()) { return; }
+
+    auto work = api_.ZeroMQ().Message(chain_);
+    work->AddFrame(internal::ThreadPool::Work::Bootstrap);
+    work->AddFrame();
+    work->AddFrame(reinterpret_cast<std::uintptr_t>(this));
+    thread_pool_->Send(work);
+}
+
 auto Network::RequestBlock(const block::Hash& block) const noexcept -> bool
 {
     if (false == running_.get()) { return false; }
@@ -302,6 +436,15 @@ auto Network::RequestBlock(const block::Hash& block) const noexcept -> bool
     return peer_.RequestBlock(block);
 }
 
+auto Network::RequestFilterCheckpoints(
+    const filter::Type type,
+    const block::Hash& stop) const noexcept -> bool
+{
+    if (false == running_.get()) { return false; }
+
+    return peer_.RequestFilterCheckpoints(type, stop);
+}
+
 auto Network::RequestFilterHeaders(
     const filter::Type type,
     const block::Height start,
@@ -315,11 +458,12 @@ auto Network::RequestFilterHeaders(
 auto Network::RequestFilters(
     const filter::Type type,
     const block::Height start,
-    const block::Hash& stop) const noexcept -> bool
+    const block::Hash& stop,
+    const int peer) const noexcept -> bool
 {
     if (false == running_.get()) { return false; }
 
-    return peer_.RequestFilters(type, start, stop);
+    return peer_.RequestFilters(type, start, stop, peer);
 }
 
 auto Network::SendToAddress(
@@ -353,6 +497,12 @@ auto Network::shutdown(std::promise<void>& promise) noexcept -> void
         }
 
         api_.Cancel(task_id_);
+
+        {
+            // Wait for an export which already started
+            Lock lock(export_lock_);
+        }
+
         shutdown_sender_.Activate();
         wallet_.Shutdown().get();
         block_.Shutdown().get();
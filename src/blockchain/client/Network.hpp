@@ -9,6 +9,7 @@
 #include <future>
 #include <iosfwd>
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include "core/Executor.hpp"
@@ -26,6 +27,7 @@
 #include "opentxs/network/zeromq/Message.hpp"
 #include "opentxs/network/zeromq/Pipeline.hpp"
 #include "opentxs/network/zeromq/socket/Publish.hpp"
+#include "opentxs/network/zeromq/socket/Push.hpp"
 #include "opentxs/network/zeromq/socket/Subscribe.hpp"
 
 namespace opentxs
@@ -98,6 +100,10 @@ public:
     {
         return *database_p_;
     }
+    auto DisconnectPeer(const int peer) const noexcept -> void final
+    {
+        peer_.Disconnect(peer);
+    }
     auto GetBalance() const noexcept -> Balance final
     {
         return database_.GetBalance();
@@ -122,11 +128,18 @@ public:
     {
         return local_chain_height_.load() >= remote_chain_height_.load();
     }
+    auto Mempool() const noexcept -> const internal::Mempool& final
+    {
+        return *mempool_p_;
+    }
     auto Reorg() const noexcept -> const network::zeromq::socket::Publish& final
     {
         return parent_.Reorg();
     }
     auto RequestBlock(const block::Hash& block) const noexcept -> bool final;
+    auto RequestFilterCheckpoints(
+        const filter::Type type,
+        const block::Hash& stop) const noexcept -> bool final;
     auto RequestFilterHeaders(
         const filter::Type type,
         const block::Height start,
@@ -134,7 +147,8 @@ public:
     auto RequestFilters(
         const filter::Type type,
         const block::Height start,
-        const block::Hash& stop) const noexcept -> bool final;
+        const block::Hash& stop,
+        const int peer) const noexcept -> bool final;
     auto SendToAddress(
         const std::string& address,
         const Amount amount,
@@ -162,11 +176,15 @@ public:
         return stop_executor();
     }
 
+    /// Writes the bootstrap files on a thread pool thread
+    auto ExportBootstrap() noexcept -> void;
+
     ~Network() override;
 
 private:
     opentxs::internal::ShutdownSender shutdown_sender_;
     std::unique_ptr<blockchain::internal::Database> database_p_;
+    std::unique_ptr<internal::Mempool> mempool_p_;
     std::unique_ptr<internal::HeaderOracle> header_p_;
     std::unique_ptr<internal::PeerManager> peer_p_;
     std::unique_ptr<internal::BlockOracle> block_p_;
@@ -201,18 +219,28 @@ private:
     mutable std::atomic<block::Height> remote_chain_height_;
     OTFlag processing_headers_;
     int task_id_;
+    OTZMQPushSocket thread_pool_;
+    internal::ParallelScan header_job_;
+    const internal::ParallelScan::Dispatch header_dispatch_;
+    // Held while the bootstrap files are exported so shutdown can wait
+    std::mutex export_lock_;
 
     static auto shutdown_endpoint() noexcept -> std::string;
 
+    /// Called concurrently from the thread pool
     virtual auto instantiate_header(const ReadView payload) const noexcept
         -> std::unique_ptr<block::Header> = 0;
 
+    auto bootstrap() noexcept -> void;
+    auto queue_export() noexcept -> void;
     auto pipeline(zmq::Message& in) noexcept -> void;
     auto process_block(zmq::Message& in) noexcept -> void;
+    auto process_cfcheckpt(zmq::Message& in) noexcept -> void;
     auto process_cfheader(zmq::Message& in) noexcept -> void;
     auto process_filter(zmq::Message& in) noexcept -> void;
     auto process_header(zmq::Message& in) noexcept -> void;
     auto process_state_machine() noexcept -> void;
+    auto process_transaction(zmq::Message& in) noexcept -> void;
     auto shutdown(std::promise<void>& promise) noexcept -> void;
 
     Network() = delete;
@@ -65,6 +65,9 @@ auto BlockchainPeerManager(
 
 namespace opentxs::blockchain::client::implementation
 {
+const std::size_t PeerManager::checkpoint_peers_{2};
+// BIP152 recommends at most three high bandwidth peers
+const std::size_t PeerManager::high_bandwidth_peers_{3};
 const std::map<Type, std::uint16_t> PeerManager::default_port_map_{
     {Type::Unknown, 0},
     {Type::Bitcoin, 8333},
@@ -145,6 +148,8 @@ PeerManager::PeerManager(
           seednode,
           io_context_)
     , heartbeat_task_()
+    , high_bandwidth_lock_()
+    , high_bandwidth_()
 {
     init_executor({shutdown});
 }
@@ -156,6 +161,8 @@ PeerManager::Jobs::Jobs(const api::internal::Core& api) noexcept
           api.ZeroMQ().PushSocket(zmq::socket::Socket::Direction::Bind))
     , getcfilters_(
           api.ZeroMQ().PushSocket(zmq::socket::Socket::Direction::Bind))
+    , getcfcheckpt_(
+          api.ZeroMQ().PushSocket(zmq::socket::Socket::Direction::Bind))
     , heartbeat_(api.ZeroMQ().PublishSocket())
     , getblock_(api.ZeroMQ().PushSocket(zmq::socket::Socket::Direction::Bind))
     , endpoint_map_()
@@ -165,6 +172,7 @@ PeerManager::Jobs::Jobs(const api::internal::Core& api) noexcept
           {Task::Getcfilters, &getcfilters_.get()},
           {Task::Heartbeat, &heartbeat_.get()},
           {Task::Getblock, &getblock_.get()},
+          {Task::Getcfcheckpt, &getcfcheckpt_.get()},
       })
 {
     // NOTE endpoint_map_ should never be modified after construction
@@ -173,6 +181,7 @@ PeerManager::Jobs::Jobs(const api::internal::Core& api) noexcept
     listen(Task::Getcfilters, getcfilters_);
     listen(Task::Heartbeat, heartbeat_);
     listen(Task::Getblock, getblock_);
+    listen(Task::Getcfcheckpt, getcfcheckpt_);
 }
 
 PeerManager::Peers::Peers(
@@ -584,6 +593,39 @@ auto PeerManager::Peers::Shutdown() noexcept -> void
     active_.clear();
 }
 
+auto PeerManager::Peers::Sample(
+    const p2p::Service service,
+    const std::size_t count) const noexcept -> std::vector<int>
+{
+    auto ids = std::vector<int>{};
+    auto output = std::vector<int>{};
+
+    for (const auto& [id, peer] : peers_) {
+        if (1 == peer->Services().count(service)) { ids.emplace_back(id); }
+    }
+
+    std::sample(
+        std::begin(ids),
+        std::end(ids),
+        std::back_inserter(output),
+        count,
+        std::mt19937{std::random_device{}()});
+
+    return output;
+}
+
+auto PeerManager::Peers::Submit(const int id, zmq::Message& work) noexcept
+    -> bool
+{
+    auto it = peers_.find(id);
+
+    if (peers_.end() == it) { return false; }
+
+    it->second->Submit(work);
+
+    return true;
+}
+
 auto PeerManager::AddPeer(const p2p::Address& address) const noexcept -> bool
 {
     if (false == running_.get()) { return false; }
@@ -619,6 +661,19 @@ auto PeerManager::Disconnect(const int id) const noexcept -> void
     pipeline_->Push(work);
 }
 
+auto PeerManager::HighBandwidth(const int peer) const noexcept -> bool
+{
+    Lock lock(high_bandwidth_lock_);
+
+    if (0 < high_bandwidth_.count(peer)) { return true; }
+
+    if (high_bandwidth_peers_ <= high_bandwidth_.size()) { return false; }
+
+    high_bandwidth_.emplace(peer);
+
+    return true;
+}
+
 auto PeerManager::init() noexcept -> void
 {
     heartbeat_task_ = api_.Schedule(
@@ -640,7 +695,51 @@ auto PeerManager::pipeline(zmq::Message& message) noexcept -> void
 
             OT_ASSERT(0 < body.size());
 
-            peers_.Disconnect(body.at(0).as<int>());
+            const auto id = body.at(0).as<int>();
+            peers_.Disconnect(id);
+            Lock lock(high_bandwidth_lock_);
+            high_bandwidth_.erase(id);
+        } break;
+        case Work::RequestFilters: {
+            const auto body = message.Body();
+
+            OT_ASSERT(3 < body.size());
+
+            auto work = jobs_.Work(Task::Getcfilters);
+            work->AddFrame(body.at(1).as<filter::Type>());
+            work->AddFrame(body.at(2).as<block::Height>());
+            work->AddFrame(body.at(3).data(), body.at(3).size());
+
+            // Fall back to any peer if the requested peer disconnected
+            if (false == peers_.Submit(body.at(0).as<int>(), work)) {
+                jobs_.Dispatch(work);
+            }
+        } break;
+        case Work::RequestCheckpoints: {
+            const auto body = message.Body();
+
+            OT_ASSERT(1 < body.size());
+
+            // Checkpoints are only trusted once two peers agree about them.
+            // A request which times out is sent again by the filter oracle to
+            // a new sample of peers.
+            const auto sample = peers_.Sample(
+                p2p::Service::CompactFilters, checkpoint_peers_);
+
+            for (const auto id : sample) {
+                auto work = jobs_.Work(Task::Getcfcheckpt);
+                work->AddFrame(body.at(0).as<filter::Type>());
+                work->AddFrame(body.at(1).data(), body.at(1).size());
+                peers_.Submit(id, work);
+            }
+
+            // Until a filter peer is known let the first one to ask take it
+            if (sample.empty()) {
+                auto work = jobs_.Work(Task::Getcfcheckpt);
+                work->AddFrame(body.at(0).as<filter::Type>());
+                work->AddFrame(body.at(1).data(), body.at(1).size());
+                jobs_.Dispatch(work);
+            }
         } break;
         case Work::AddPeer: {
             const auto body = message.Body();
@@ -685,6 +784,22 @@ auto PeerManager::RequestBlock(const block::Hash& block) const noexcept -> bool
     return true;
 }
 
+auto PeerManager::RequestFilterCheckpoints(
+    const filter::Type type,
+    const block::Hash& stop) const noexcept -> bool
+{
+    if (false == running_.get()) { return false; }
+
+    if (0 == peers_.Count()) { return false; }
+
+    auto work = MakeWork(Work::RequestCheckpoints);
+    work->AddFrame(type);
+    work->AddFrame(stop);
+    pipeline_->Push(work);
+
+    return true;
+}
+
 auto PeerManager::RequestFilterHeaders(
     const filter::Type type,
     const block::Height start,
@@ -706,17 +821,27 @@ auto PeerManager::RequestFilterHeaders(
 auto PeerManager::RequestFilters(
     const filter::Type type,
     const block::Height start,
-    const block::Hash& stop) const noexcept -> bool
+    const block::Hash& stop,
+    const int peer) const noexcept -> bool
 {
     if (false == running_.get()) { return false; }
 
     if (0 == peers_.Count()) { return false; }
 
-    auto work = jobs_.Work(Task::Getcfilters);
-    work->AddFrame(type);
-    work->AddFrame(start);
-    work->AddFrame(stop);
-    jobs_.Dispatch(work);
+    if (0 > peer) {
+        auto work = jobs_.Work(Task::Getcfilters);
+        work->AddFrame(type);
+        work->AddFrame(start);
+        work->AddFrame(stop);
+        jobs_.Dispatch(work);
+    } else {
+        auto work = MakeWork(Work::RequestFilters);
+        work->AddFrame(peer);
+        work->AddFrame(type);
+        work->AddFrame(start);
+        work->AddFrame(stop);
+        pipeline_->Push(work);
+    }
 
     return true;
 }
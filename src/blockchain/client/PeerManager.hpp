@@ -13,6 +13,8 @@
 #include <iosfwd>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -62,6 +64,7 @@ class Sender;
 }  // namespace socket
 
 class Context;
+class Message;
 }  // namespace zeromq
 }  // namespace network
 
@@ -97,7 +100,11 @@ public:
         return peers_.Count();
     }
     auto Heartbeat() const noexcept -> void { jobs_.Dispatch(Task::Heartbeat); }
+    auto HighBandwidth(const int peer) const noexcept -> bool final;
     auto RequestBlock(const block::Hash& block) const noexcept -> bool final;
+    auto RequestFilterCheckpoints(
+        const filter::Type type,
+        const block::Hash& stop) const noexcept -> bool final;
     auto RequestFilterHeaders(
         const filter::Type type,
         const block::Height start,
@@ -105,7 +112,8 @@ public:
     auto RequestFilters(
         const filter::Type type,
         const block::Height start,
-        const block::Hash& stop) const noexcept -> bool final;
+        const block::Hash& stop,
+        const int peer) const noexcept -> bool final;
     auto RequestHeaders() const noexcept -> bool final;
     auto Shutdown() noexcept -> std::shared_future<void> final
     {
@@ -149,6 +157,7 @@ private:
         OTZMQPushSocket getheaders_;
         OTZMQPushSocket getcfheaders_;
         OTZMQPushSocket getcfilters_;
+        OTZMQPushSocket getcfcheckpt_;
         OTZMQPublishSocket heartbeat_;
         OTZMQPushSocket getblock_;
         const EndpointMap endpoint_map_;
@@ -167,8 +176,14 @@ private:
             const p2p::Address& address,
             std::promise<bool>& promise) noexcept -> void;
         auto Disconnect(const int id) noexcept -> void;
+        /// Ids of up to count randomly chosen connected peers which advertise
+        /// the specified service
+        auto Sample(const p2p::Service service, const std::size_t count)
+            const noexcept -> std::vector<int>;
         auto Run(std::promise<bool>& promise) noexcept -> void;
         auto Shutdown() noexcept -> void;
+        /// Returns false if the peer is not connected
+        auto Submit(const int id, zmq::Message& work) noexcept -> bool;
 
         Peers(
             const api::internal::Core& api,
@@ -225,17 +240,23 @@ private:
     enum class Work : OTZMQWorkType {
         Disconnect = 0,
         AddPeer = 1,
+        RequestFilters = 2,
+        RequestCheckpoints = 3,
         StateMachine = OT_ZMQ_STATE_MACHINE_SIGNAL,
         Shutdown = OT_ZMQ_SHUTDOWN_SIGNAL,
     };
 
     static const unsigned int peer_target_{2};
+    static const std::size_t checkpoint_peers_;
+    static const std::size_t high_bandwidth_peers_;
 
     const internal::PeerDatabase& database_;
     const internal::IO& io_context_;
     mutable Jobs jobs_;
     mutable Peers peers_;
     int heartbeat_task_;
+    mutable std::mutex high_bandwidth_lock_;
+    mutable std::set<int> high_bandwidth_;
 
     auto pipeline(zmq::Message& message) noexcept -> void;
     auto shutdown(std::promise<void>& promise) noexcept -> void;
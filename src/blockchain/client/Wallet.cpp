@@ -8,11 +8,15 @@
 #include "blockchain/client/Wallet.hpp"  // IWYU pragma: associated
 
 #include <atomic>
+#include <algorithm>
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
+#include <iterator>
 #include <future>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <queue>
 #include <set>
@@ -20,6 +24,7 @@
 #include <utility>
 #include <vector>
 
+#include "Factory.hpp"
 #include "blockchain/client/HDStateData.hpp"
 #include "core/Executor.hpp"
 #include "internal/api/Api.hpp"
@@ -33,6 +38,9 @@
 #include "opentxs/api/Wallet.hpp"
 #include "opentxs/api/client/blockchain/BalanceTree.hpp"
 #include "opentxs/api/client/blockchain/HD.hpp"
+#include "opentxs/blockchain/block/bitcoin/Input.hpp"
+#include "opentxs/blockchain/block/bitcoin/Inputs.hpp"
+#include "opentxs/blockchain/block/bitcoin/Transaction.hpp"
 #include "opentxs/core/Data.hpp"
 #include "opentxs/core/Flag.hpp"
 #include "opentxs/core/Log.hpp"
@@ -44,6 +52,7 @@
 #include "opentxs/network/zeromq/Message.hpp"
 #include "opentxs/network/zeromq/socket/Push.hpp"
 #include "opentxs/network/zeromq/socket/Socket.hpp"
+#include "opentxs/protobuf/BlockchainTransactionOutput.pb.h"
 
 #define OT_METHOD "opentxs::blockchain::client::implementation::Wallet::"
 
@@ -90,6 +99,19 @@ auto Wallet::ProcessTask(const zmq::Message& in) noexcept -> void
         OT_FAIL;
     }
 
+    const auto task = body.at(1).as<Task>();
+
+    if (Task::scan_chain == task) {
+        auto* pScanner = reinterpret_cast<implementation::Wallet::Scanner*>(
+            body.at(0).as<std::uintptr_t>());
+
+        OT_ASSERT(nullptr != pScanner);
+
+        pScanner->Run();
+
+        return;
+    }
+
     auto* pData = reinterpret_cast<implementation::HDStateData*>(
         body.at(0).as<std::uintptr_t>());
 
@@ -98,7 +120,7 @@ auto Wallet::ProcessTask(const zmq::Message& in) noexcept -> void
     auto& data = *pData;
     auto cleanup = Cleanup{data.running_};
 
-    switch (body.at(1).as<Task>()) {
+    switch (task) {
         case Task::index: {
             data.index();
         } break;
@@ -117,6 +139,10 @@ auto Wallet::ProcessTask(const zmq::Message& in) noexcept -> void
 
 namespace opentxs::blockchain::client::implementation
 {
+const std::uint8_t Wallet::Mempool::bits_{19};
+const std::uint32_t Wallet::Mempool::fp_rate_{784931};
+const block::Height Wallet::Scanner::batch_{10000};
+
 Wallet::Wallet(
     const api::internal::Core& api,
     const api::client::internal::Blockchain& blockchain,
@@ -131,12 +157,16 @@ Wallet::Wallet(
     , init_promise_()
     , init_(init_promise_.get_future())
     , socket_(api_.ZeroMQ().PushSocket(zmq::socket::Socket::Direction::Connect))
+    , scanner_(api_, parent_, db_, socket_)
+    , mempool_(api_, parent_, db_)
     , accounts_(api_, blockchain_api_, parent_, db_, socket_, chain_)
 {
     auto zmq = socket_->Start(blockchain.ThreadPool().Endpoint());
 
     OT_ASSERT(zmq);
 
+    scanner_.Load(accounts_.subchains());
+
     init_executor({
         shutdown,
         api.Endpoints().BlockchainReorg(),
@@ -163,9 +193,21 @@ Wallet::Account::Account(
     for (const auto& subaccount : ref_.GetHD()) {
         const auto& id = subaccount.ID();
         internal_.try_emplace(
-            id, network_, db_, subaccount, filter_type_, Subchain::Internal);
+            id,
+            network_,
+            db_,
+            socket_,
+            subaccount,
+            filter_type_,
+            Subchain::Internal);
         external_.try_emplace(
-            id, network_, db_, subaccount, filter_type_, Subchain::External);
+            id,
+            network_,
+            db_,
+            socket_,
+            subaccount,
+            filter_type_,
+            Subchain::External);
     }
 }
 
@@ -198,6 +240,46 @@ Wallet::Accounts::Accounts(
 {
 }
 
+Wallet::Scanner::Scanner(
+    const api::Core& api,
+    const internal::Network& network,
+    const internal::WalletDatabase& db,
+    const zmq::socket::Push& socket) noexcept
+    : api_(api)
+    , network_(network)
+    , db_(db)
+    , filter_type_(network.FilterOracle().DefaultType())
+    , socket_(socket)
+    , lock_()
+    , running_(false)
+    , position_()
+    , participants_()
+    , unspent_()
+    , job_(db_.ScanThreads())
+    , dispatch_(
+          internal::ParallelScan::Dispatcher(api_, socket_, network_.Chain()))
+{
+}
+
+Wallet::Mempool::Mempool(
+    const api::Core& api,
+    const internal::Network& network,
+    const internal::WalletDatabase& db) noexcept
+    : api_(api)
+    , network_(network)
+    , db_(db)
+    , filter_type_(network.FilterOracle().DefaultType())
+    , key_([&] {
+        auto output = api.Factory().Data();
+        output->Randomize(16);
+
+        return output;
+    }())
+    , sequence_(0)
+    , unspent_()
+{
+}
+
 auto Wallet::Account::queue_work(
     const Task task,
     const HDStateData& data) noexcept -> void
@@ -210,7 +292,8 @@ auto Wallet::Account::queue_work(
     socket_.Send(work);
 }
 
-auto Wallet::Account::state_machine() noexcept -> bool
+auto Wallet::Account::state_machine(const Watermark& watermark) noexcept
+    -> bool
 {
     auto output{false};
 
@@ -228,13 +311,14 @@ auto Wallet::Account::state_machine() noexcept -> bool
                     id,
                     network_,
                     db_,
+                    socket_,
                     subaccount,
                     filter_type_,
                     Subchain::Internal);
                 it = it2;
             }
 
-            output |= state_machine_hd(it->second);
+            output |= state_machine_hd(it->second, watermark);
         }
 
         {
@@ -245,20 +329,23 @@ auto Wallet::Account::state_machine() noexcept -> bool
                     id,
                     network_,
                     db_,
+                    socket_,
                     subaccount,
                     filter_type_,
                     Subchain::External);
                 it = it2;
             }
 
-            output |= state_machine_hd(it->second);
+            output |= state_machine_hd(it->second, watermark);
         }
     }
 
     return output;
 }
 
-auto Wallet::Account::state_machine_hd(HDStateData& data) noexcept -> bool
+auto Wallet::Account::state_machine_hd(
+    HDStateData& data,
+    const Watermark& watermark) noexcept -> bool
 {
     const auto& node = data.node_;
     const auto subchain = data.subchain_;
@@ -272,23 +359,43 @@ auto Wallet::Account::state_machine_hd(HDStateData& data) noexcept -> bool
     if (running) { return true; }
 
     {
-        for (const auto& hash : requestBlocks) {
+        // Each subchain only holds a few blocks at once. The blocks after
+        // those are passed to the block oracle as a prefetch hint so they are
+        // already cached by the time the subchain requests them.
+        static constexpr auto window = std::size_t{8};
+        static constexpr auto lookahead = std::size_t{64};
+        const auto& oracle = network_.BlockOracle();
+        auto next = requestBlocks.begin();
+
+        while ((requestBlocks.end() != next) && (outstanding.size() < window)) {
+            const auto& hash = *next;
             LogVerbose(OT_METHOD)("Account::")(__FUNCTION__)(
                 ": Requesting block ")(hash->asHex())(" queue position: ")(
                 outstanding.size())
                 .Flush();
 
             if (0 == outstanding.count(hash)) {
-                auto [it, added] = outstanding.emplace(
-                    hash, network_.BlockOracle().LoadBitcoin(hash));
+                auto [it, added] =
+                    outstanding.emplace(hash, oracle.LoadBitcoin(hash));
 
                 OT_ASSERT(added);
 
                 queue.push(it);
             }
+
+            ++next;
         }
 
-        requestBlocks.clear();
+        requestBlocks.erase(requestBlocks.begin(), next);
+
+        if (false == requestBlocks.empty()) {
+            const auto count = std::min(lookahead, requestBlocks.size());
+            oracle.Prefetch(
+                {requestBlocks.begin(),
+                 std::next(
+                     requestBlocks.begin(),
+                     static_cast<std::ptrdiff_t>(count))});
+        }
     }
 
     {
@@ -324,6 +431,19 @@ auto Wallet::Account::state_machine_hd(HDStateData& data) noexcept -> bool
                 network_.HeaderOracle().CommonParent(lastScanned.value());
             lastScanned = ancestor;
 
+            if (watermark.has_value() &&
+                (lastScanned.value().first > watermark.value().first)) {
+                lastScanned = watermark;
+            }
+        }
+
+        if (lastScanned == watermark) {
+            LogVerbose(OT_METHOD)("Account::")(__FUNCTION__)(
+                ": Subchain is scanned by the chain scanner")
+                .Flush();
+        } else if (lastScanned.has_value()) {
+            const auto best = network_.HeaderOracle().BestChain();
+
             if (lastScanned == best) {
                 LogVerbose(OT_METHOD)("Account::")(__FUNCTION__)(
                     ": Subchain has been scanned to current best block ")(
@@ -344,6 +464,12 @@ auto Wallet::Account::state_machine_hd(HDStateData& data) noexcept -> bool
         }
 
         if (needScan) {
+            if (watermark.has_value()) {
+                data.scan_limit_ = watermark.value().first;
+            } else {
+                data.scan_limit_ = std::nullopt;
+            }
+
             running.store(true);
             queue_work(Task::scan, data);
 
@@ -373,6 +499,13 @@ auto Wallet::Account::state_machine_hd(HDStateData& data) noexcept -> bool
     return false;
 }
 
+auto Wallet::Account::subchains(Subchains& output) noexcept -> void
+{
+    for (auto& [id, data] : internal_) { output.emplace_back(&data); }
+
+    for (auto& [id, data] : external_) { output.emplace_back(&data); }
+}
+
 auto Wallet::Accounts::Add(const identifier::Nym& nym) noexcept -> bool
 {
     auto [it, added] = map_.try_emplace(
@@ -423,15 +556,331 @@ auto Wallet::Accounts::init(
     return output;
 }
 
-auto Wallet::Accounts::state_machine() noexcept -> bool
+auto Wallet::Accounts::state_machine(const Watermark& watermark) noexcept
+    -> bool
 {
     auto output{false};
 
-    for (auto& [nym, account] : map_) { output |= account.state_machine(); }
+    for (auto& [nym, account] : map_) {
+        output |= account.state_machine(watermark);
+    }
+
+    return output;
+}
+
+auto Wallet::Accounts::subchains() noexcept -> Subchains
+{
+    auto output = Subchains{};
+
+    for (auto& [nym, account] : map_) { account.subchains(output); }
 
     return output;
 }
 
+auto Wallet::Mempool::state_machine(const Subchains& subchains) noexcept
+    -> bool
+{
+    if (subchains.empty()) { return false; }
+
+    const auto transactions = network_.Mempool().Dump(sequence_);
+
+    if (transactions.empty()) { return false; }
+
+    const auto& utxos = unspent_.Update(db_);
+    auto elements = std::vector<Space>{};
+    // Transactions which consume at least one wallet output
+    auto spends = std::set<std::size_t>{};
+
+    for (auto i = std::size_t{0}; i < transactions.size(); ++i) {
+        const auto& pTransaction = transactions.at(i);
+
+        OT_ASSERT(pTransaction);
+
+        auto temp = pTransaction->ExtractElements(filter_type_);
+        elements.insert(
+            elements.end(),
+            std::make_move_iterator(temp.begin()),
+            std::make_move_iterator(temp.end()));
+
+        for (const auto& input : pTransaction->Inputs()) {
+            if (0 < utxos.count(input.PreviousOutput())) {
+                spends.emplace(i);
+
+                break;
+            }
+        }
+    }
+
+    const auto none = UnspentCache::Map{};
+    auto targets = blockchain::internal::GCS::Targets{};
+    // Index of the subchain which owns each target
+    auto owners = std::vector<std::size_t>{};
+    // Patterns must outlive the targets which refer to them
+    auto patterns = std::vector<internal::WalletDatabase::Patterns>{};
+    patterns.reserve(subchains.size());
+
+    for (auto i = std::size_t{0}; i < subchains.size(); ++i) {
+        const auto* data = subchains.at(i);
+
+        OT_ASSERT(nullptr != data);
+
+        const auto& keys = patterns.emplace_back(
+            db_.GetPatterns(data->node_.ID(), data->subchain_, filter_type_));
+        const auto subset = data->get_targets(keys, none);
+        targets.insert(targets.end(), subset.begin(), subset.end());
+        owners.insert(owners.end(), subset.size(), i);
+    }
+
+    auto hits = std::set<std::size_t>{};
+
+    if ((false == elements.empty()) && (false == targets.empty())) {
+        const auto pFilter = Factory::GCS(
+            api_, bits_, fp_rate_, key_->Bytes(), elements);
+
+        if (pFilter) {
+            for (const auto& it : pFilter->Match(targets)) {
+                hits.emplace(owners.at(std::distance(targets.cbegin(), it)));
+            }
+        } else {
+            LogOutput(OT_METHOD)("Mempool::")(__FUNCTION__)(
+                ": Failed to construct filter")
+                .Flush();
+        }
+    }
+
+    LogVerbose(OT_METHOD)("Mempool::")(__FUNCTION__)(": ")(
+        transactions.size())(" new transactions matched ")(hits.size())(
+        " subchains")
+        .Flush();
+
+    // A filter match only identifies the subchains which may be affected by
+    // some transaction in the batch so each transaction is checked exactly
+    for (auto i = std::size_t{0}; i < transactions.size(); ++i) {
+        const auto& transaction = *transactions.at(i);
+
+        for (const auto owner : hits) {
+            subchains.at(owner)->process_mempool(transaction);
+        }
+
+        if (hits.empty() && (0 < spends.count(i))) {
+            subchains.front()->process_mempool(transaction);
+        }
+    }
+
+    return false;
+}
+
+auto Wallet::Scanner::Load(const Subchains& subchains) noexcept -> void
+{
+    Lock lock(lock_);
+
+    if (subchains.empty()) { return; }
+
+    // Subchains resume from their saved positions so the chain-wide scan
+    // resumes from the lowest of them. Subchains which are ahead of it are
+    // rewound to the watermark by the account state machine.
+    auto position = Watermark{};
+
+    for (const auto* data : subchains) {
+        OT_ASSERT(nullptr != data);
+
+        const auto& scanned = data->last_scanned_;
+
+        if (false == scanned.has_value()) { return; }
+
+        if ((false == position.has_value()) ||
+            (scanned.value().first < position.value().first)) {
+            position = scanned;
+        }
+    }
+
+    position_ = std::move(position);
+}
+
+auto Wallet::Scanner::Position() noexcept -> Watermark
+{
+    Lock lock(lock_);
+
+    if ((false == running_.load()) && position_.has_value()) {
+        position_ =
+            network_.HeaderOracle().CommonParent(position_.value()).first;
+    }
+
+    return position_;
+}
+
+auto Wallet::Scanner::Run() noexcept -> void
+{
+    struct Cleanup {
+        Cleanup(std::atomic<bool>& running, Subchains& participants) noexcept
+            : running_(running)
+            , participants_(participants)
+        {
+        }
+
+        ~Cleanup()
+        {
+            for (auto* data : participants_) { data->running_.store(false); }
+
+            participants_.clear();
+            running_.store(false);
+        }
+
+    private:
+        std::atomic<bool>& running_;
+        Subchains& participants_;
+    };
+
+    auto cleanup = Cleanup{running_, participants_};
+
+    if (participants_.empty()) { return; }
+
+    const auto start = Clock::now();
+    const auto& headers = network_.HeaderOracle();
+    const auto& filters = network_.FilterOracle();
+    const auto best = headers.BestChain();
+    auto position = [&] {
+        Lock lock(lock_);
+
+        return position_;
+    }();
+    const auto startHeight =
+        position.has_value() ? position.value().first + 1 : block::Height{1};
+    const auto stopHeight = std::min(
+        std::min(startHeight + batch_ - 1, best.first),
+        filters.ScanTip(filter_type_));
+    const auto& utxos = unspent_.Update(db_);
+    const auto none = UnspentCache::Map{};
+    auto elements = std::vector<internal::WalletDatabase::Patterns>{};
+    auto targets = blockchain::internal::GCS::Targets{};
+    // Index of the participant which owns each target
+    auto owners = std::vector<std::size_t>{};
+    elements.reserve(participants_.size());
+
+    for (auto i = std::size_t{0}; i < participants_.size(); ++i) {
+        const auto& data = *participants_.at(i);
+        const auto& keys = elements.emplace_back(
+            db_.GetPatterns(data.node_.ID(), data.subchain_, filter_type_));
+        // Unspent outputs are only included once. Spends are detected for
+        // the whole wallet by whichever subchain processes the block, so the
+        // first participant owns them.
+        const auto subset = data.get_targets(keys, (0 == i) ? utxos : none);
+        targets.insert(targets.end(), subset.begin(), subset.end());
+        owners.insert(owners.end(), subset.size(), i);
+    }
+
+    auto hashes = std::vector<block::pHash>{};
+
+    for (auto i{startHeight}; i <= stopHeight; ++i) {
+        auto hash = headers.BestHash(i);
+
+        if (hash->empty()) { break; }  // Reorg occured while processing
+
+        hashes.emplace_back(std::move(hash));
+    }
+
+    // Filled concurrently by the scan job, one slot per height. The few
+    // filters which match are read again from the filter cache for the retest.
+    auto results = std::vector<std::set<std::size_t>>(hashes.size());
+    const auto process = [&](const block::Height height) -> bool {
+        const auto index = static_cast<std::size_t>(height - startHeight);
+        auto& hits = results.at(index);
+
+        return filters.ReadFilter(
+            filter_type_, height, hashes.at(index), [&](const auto& filter) {
+                for (const auto& it : filter.Match(targets)) {
+                    hits.emplace(
+                        owners.at(std::distance(targets.cbegin(), it)));
+                }
+            });
+    };
+    const auto last = startHeight + static_cast<block::Height>(hashes.size());
+    const auto scanned = job_.Run(startHeight, last - 1, process, dispatch_);
+    auto matched = std::size_t{0};
+
+    if (scanned.has_value()) {
+        // Matches are handled in height order so blocks are requested in the
+        // same order as a sequential scan would request them
+        for (auto i{startHeight}; i <= scanned.value(); ++i) {
+            const auto index = static_cast<std::size_t>(i - startHeight);
+            const auto& blockHash = hashes.at(index);
+            const auto& hits = results.at(index);
+
+            if (hits.empty()) { continue; }
+
+            filters.ReadFilter(
+                filter_type_, i, blockHash, [&](const auto& filter) {
+                    for (const auto owner : hits) {
+                        if (participants_.at(owner)->retest(
+                                blockHash, filter, utxos)) {
+                            ++matched;
+                        }
+                    }
+                });
+        }
+
+        const auto height = scanned.value();
+        position = block::Position{
+            height,
+            hashes.at(static_cast<std::size_t>(height - startHeight))};
+    }
+
+    LogVerbose(OT_METHOD)("Scanner::")(__FUNCTION__)(": Scanned ")(
+        participants_.size())(" subchains to height ")(
+        position.has_value() ? position.value().first : 0)(" with ")(
+        targets.size())(" targets on ")(job_.Threads())(" threads in ")(
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            Clock::now() - start)
+            .count())(" milliseconds. ")(matched)(" blocks requested")
+        .Flush();
+
+    for (auto* data : participants_) {
+        if (position.has_value()) {
+            data->set_scanned(position.value());
+        } else {
+            data->last_scanned_ = position;
+        }
+    }
+
+    Lock lock(lock_);
+    position_ = std::move(position);
+}
+
+auto Wallet::Scanner::state_machine(const Subchains& subchains) noexcept
+    -> bool
+{
+    if (running_.load()) { return true; }
+
+    const auto position = Position();
+
+    if (position == network_.HeaderOracle().BestChain()) { return false; }
+
+    for (auto* data : subchains) {
+        OT_ASSERT(nullptr != data);
+
+        if (data->running_.load()) { continue; }
+
+        if (data->last_scanned_ != position) { continue; }
+
+        participants_.emplace_back(data);
+    }
+
+    if (participants_.empty()) { return false; }
+
+    running_.store(true);
+
+    for (auto* data : participants_) { data->running_.store(true); }
+
+    auto work = api_.ZeroMQ().Message(network_.Chain());
+    work->AddFrame(internal::ThreadPool::Work::Wallet);
+    work->AddFrame();
+    work->AddFrame(reinterpret_cast<std::uintptr_t>(this));
+    work->AddFrame(internal::Wallet::Task::scan_chain);
+    socket_.Send(work);
+
+    return true;
+}
+
 auto Wallet::Init() noexcept -> void
 {
     init_promise_.set_value();
@@ -504,7 +953,10 @@ auto Wallet::state_machine() noexcept -> void
 {
     static const auto rateLimit = std::chrono::milliseconds{1};
 
-    auto repeat = accounts_.state_machine();
+    auto repeat = accounts_.state_machine(scanner_.Position());
+    const auto subchains = accounts_.subchains();
+    repeat |= scanner_.state_machine(subchains);
+    repeat |= mempool_.state_machine(subchains);
     Sleep(rateLimit);
 
     if (repeat) { Sleep(rateLimit); }
@@ -5,9 +5,16 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <future>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <vector>
 
 #include "1_Internal.hpp"
 #include "blockchain/client/HDStateData.hpp"
@@ -15,6 +22,8 @@
 #include "internal/api/client/blockchain/Blockchain.hpp"
 #include "internal/blockchain/client/Client.hpp"
 #include "opentxs/Types.hpp"
+#include "opentxs/blockchain/Blockchain.hpp"
+#include "opentxs/core/Data.hpp"
 #include "opentxs/core/Identifier.hpp"
 #include "opentxs/core/identifier/Nym.hpp"
 #include "opentxs/network/zeromq/socket/Push.hpp"
@@ -54,6 +63,9 @@ namespace opentxs::blockchain::client::implementation
 class Wallet final : virtual public internal::Wallet, Executor<Wallet>
 {
 public:
+    using Subchains = std::vector<HDStateData*>;
+    using Watermark = std::optional<block::Position>;
+
     struct Account {
         using Subchain = internal::WalletDatabase::Subchain;
         using Task = internal::Wallet::Task;
@@ -61,7 +73,8 @@ public:
 
         auto queue_work(const Task task, const HDStateData& data) noexcept
             -> void;
-        auto state_machine() noexcept -> bool;
+        auto state_machine(const Watermark& watermark) noexcept -> bool;
+        auto subchains(Subchains& output) noexcept -> void;
 
         Account(
             const api::Core& api,
@@ -81,11 +94,83 @@ public:
         std::map<OTIdentifier, HDStateData> internal_;
         std::map<OTIdentifier, HDStateData> external_;
 
-        auto state_machine_hd(HDStateData& data) noexcept -> bool;
+        auto state_machine_hd(
+            HDStateData& data,
+            const Watermark& watermark) noexcept -> bool;
 
         Account(const Account&) = delete;
     };
 
+    // Scans every subchain which has reached the shared watermark with a
+    // single filter match per block. Subchains which are behind the
+    // watermark, such as newly added accounts, catch up with their own scans
+    // and then join.
+    struct Scanner {
+        /// Resumes from the positions saved by the existing subchains
+        auto Load(const Subchains& subchains) noexcept -> void;
+        /// Executed by the thread pool
+        auto Run() noexcept -> void;
+        auto Position() noexcept -> Watermark;
+        auto state_machine(const Subchains& subchains) noexcept -> bool;
+
+        Scanner(
+            const api::Core& api,
+            const internal::Network& network,
+            const internal::WalletDatabase& db,
+            const zmq::socket::Push& socket) noexcept;
+
+    private:
+        static const block::Height batch_;
+
+        const api::Core& api_;
+        const internal::Network& network_;
+        const internal::WalletDatabase& db_;
+        const filter::Type filter_type_;
+        const zmq::socket::Push& socket_;
+        mutable std::mutex lock_;
+        std::atomic<bool> running_;
+        Watermark position_;
+        Subchains participants_;
+        UnspentCache unspent_;
+        internal::ParallelScan job_;
+        const internal::ParallelScan::Dispatch dispatch_;
+
+        Scanner() = delete;
+        Scanner(const Scanner&) = delete;
+        Scanner(Scanner&&) = delete;
+        Scanner& operator=(const Scanner&) = delete;
+        Scanner& operator=(Scanner&&) = delete;
+    };
+
+    // Matches unconfirmed transactions against every subchain using a single
+    // filter constructed from each new batch of mempool transactions
+    struct Mempool {
+        auto state_machine(const Subchains& subchains) noexcept -> bool;
+
+        Mempool(
+            const api::Core& api,
+            const internal::Network& network,
+            const internal::WalletDatabase& db) noexcept;
+
+    private:
+        static const std::uint8_t bits_;
+        static const std::uint32_t fp_rate_;
+
+        const api::Core& api_;
+        const internal::Network& network_;
+        const internal::WalletDatabase& db_;
+        const filter::Type filter_type_;
+        const OTData key_;
+        std::size_t sequence_;
+        UnspentCache unspent_;
+
+        Mempool() = delete;
+        Mempool(const Mempool&) = delete;
+        Mempool(Mempool&&) = delete;
+        Mempool& operator=(const Mempool&) = delete;
+        Mempool& operator=(Mempool&&) = delete;
+    };
+
     auto Init() noexcept -> void final;
     auto Run() noexcept -> void final { Trigger(); }
     auto Shutdown() noexcept -> std::shared_future<void> final
@@ -117,7 +202,8 @@ private:
         auto Add(const identifier::Nym& nym) noexcept -> bool;
         auto Add(const zmq::Frame& message) noexcept -> bool;
 
-        auto state_machine() noexcept -> bool;
+        auto state_machine(const Watermark& watermark) noexcept -> bool;
+        auto subchains() noexcept -> Subchains;
 
         Accounts(
             const api::Core& api,
@@ -154,6 +240,8 @@ private:
     std::promise<void> init_promise_;
     std::shared_future<void> init_;
     OTZMQPushSocket socket_;
+    Scanner scanner_;
+    Mempool mempool_;
     Accounts accounts_;
 
     auto pipeline(const zmq::Message& in) noexcept -> void;
@@ -10,7 +10,6 @@
 #include "Factory.hpp"
 #include "internal/blockchain/block/Block.hpp"
 #include "internal/blockchain/client/Client.hpp"
-#include "opentxs/Proto.tpp"
 #include "opentxs/blockchain/block/Header.hpp"
 
 // #define OT_METHOD
@@ -49,10 +48,8 @@ Network::Network(
 std::unique_ptr<block::Header> Network::instantiate_header(
     const ReadView payload) const noexcept
 {
-    using Type = block::Header::SerializedType;
-
-    return std::unique_ptr<block::Header>{opentxs::Factory::BitcoinBlockHeader(
-        api_, proto::Factory<Type>(payload))};
+    return std::unique_ptr<block::Header>{
+        opentxs::Factory::BitcoinBlockHeader(api_, chain_, payload)};
 }
 
 Network::~Network() { Shutdown(); }
@@ -439,6 +439,9 @@ auto Peer::pipeline(zmq::Message& message) noexcept -> void
         case Task::Getheaders: {
             request_headers();
         } break;
+        case Task::Getcfcheckpt: {
+            request_cfcheckpt(message);
+        } break;
         case Task::Getcfheaders: {
             request_cfheaders(message);
         } break;
@@ -664,6 +667,9 @@ void Peer::subscribe_work() noexcept
             case Task::Getheaders: {
                 pipeline_->Start(manager_.Endpoint(Task::Getheaders));
             } break;
+            case Task::Getcfcheckpt: {
+                pipeline_->Start(manager_.Endpoint(Task::Getcfcheckpt));
+            } break;
             case Task::Getcfheaders: {
                 pipeline_->Start(manager_.Endpoint(Task::Getcfheaders));
             } break;
@@ -70,7 +70,12 @@ public:
     OTIdentifier AddressID() const noexcept final { return address_.ID(); }
     ConnectionStatus Connected() const noexcept final { return connected_; }
     Handshake HandshakeComplete() const noexcept final { return handshake_; }
+    std::set<Service> Services() const noexcept final
+    {
+        return address_.Services();
+    }
     std::shared_future<void> Shutdown() noexcept final;
+    void Submit(zmq::Message& work) noexcept final { pipeline_->Push(work); }
 
     ~Peer() override;
 
@@ -137,6 +142,7 @@ protected:
 
     void check_handshake() noexcept;
     void disconnect() noexcept;
+    int id() const noexcept { return id_; }
     auto local_endpoint() noexcept -> tcp::socket::endpoint_type;
     // NOTE call init in every final child class constructor
     void init() noexcept;
@@ -233,6 +239,7 @@ private:
     void pipeline_d(zmq::Message& message) noexcept;
     virtual void process_message(const zmq::Message& message) noexcept = 0;
     void process_state_machine() noexcept;
+    virtual void request_cfcheckpt(zmq::Message& message) noexcept = 0;
     virtual void request_cfheaders(zmq::Message& message) noexcept = 0;
     virtual void request_cfilter(zmq::Message& message) noexcept = 0;
     void run() noexcept;
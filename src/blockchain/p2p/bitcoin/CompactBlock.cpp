@@ -0,0 +1,440 @@
+// Copyright (c) 2010-2020 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "0_stdafx.hpp"                             // IWYU pragma: associated
+#include "1_Internal.hpp"                           // IWYU pragma: associated
+#include "blockchain/p2p/bitcoin/CompactBlock.hpp"  // IWYU pragma: associated
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+#include "blockchain/bitcoin/CompactSize.hpp"
+#include "blockchain/block/bitcoin/Block.hpp"
+#include "internal/blockchain/bitcoin/Bitcoin.hpp"
+#include "opentxs/api/Core.hpp"
+#include "opentxs/api/crypto/Crypto.hpp"
+#include "opentxs/api/crypto/Hash.hpp"
+#include "opentxs/blockchain/block/bitcoin/Transaction.hpp"
+#include "opentxs/core/Data.hpp"
+#include "opentxs/core/Log.hpp"
+#include "opentxs/core/LogSource.hpp"
+#include "opentxs/protobuf/Enums.pb.h"
+
+#define OT_METHOD "opentxs::blockchain::p2p::bitcoin::CompactBlock::"
+
+namespace opentxs::blockchain::p2p::bitcoin
+{
+using BlockType = blockchain::block::bitcoin::implementation::Block;
+
+constexpr auto short_id_mask_ = std::uint64_t{0x0000ffffffffffff};
+constexpr auto nonce_bytes_ = sizeof(std::uint64_t);
+constexpr auto merkle_offset_ = std::size_t{36};
+
+CompactBlock::CompactBlock(
+    const api::Core& api,
+    const blockchain::Type chain,
+    const std::uint64_t version,
+    const ReadView payload) noexcept(false)
+    : api_(api)
+    , chain_(chain)
+    , version_(version)
+    , header_(header(payload))
+    , siphash_(reader(key(api, payload)))
+    , hash_()
+    , slots_()
+    , short_ids_()
+    , collisions_()
+    , received_(payload.size())
+{
+    const auto hashed = BlockHash(
+        api_,
+        chain_,
+        {reinterpret_cast<const char*>(header_.data()), header_.size()},
+        preallocated(hash_.size(), hash_.data()));
+
+    if (false == hashed) { throw std::runtime_error("Failed to hash header"); }
+
+    auto it = reinterpret_cast<blockchain::bitcoin::ByteIterator>(
+        payload.data() + header_bytes_ + nonce_bytes_);
+    auto expectedSize = header_bytes_ + nonce_bytes_;
+    const auto remaining = [&] { return payload.size() - expectedSize; };
+    const auto count = [&](const char* error) -> std::size_t {
+        auto output = std::size_t{};
+        expectedSize += 1;
+
+        if ((payload.size() < expectedSize) ||
+            (false == blockchain::bitcoin::DecodeCompactSizeFromPayload(
+                          it, expectedSize, payload.size(), output))) {
+            throw std::runtime_error(error);
+        }
+
+        return output;
+    };
+    const auto shortCount = count("Failed to decode short id count");
+
+    if (shortCount > (remaining() / short_id_bytes_)) {
+        throw std::runtime_error("Short ids incomplete");
+    }
+
+    auto ids = std::vector<std::uint64_t>{};
+    ids.reserve(shortCount);
+
+    for (auto i = std::size_t{0}; i < shortCount; ++i) {
+        auto& id = ids.emplace_back(0);
+
+        for (auto b = std::size_t{0}; b < short_id_bytes_; ++b, ++it) {
+            id |= std::uint64_t{std::to_integer<std::uint8_t>(*it)} << (8 * b);
+        }
+
+        expectedSize += short_id_bytes_;
+    }
+
+    const auto prefilled = count("Failed to decode prefilled count");
+
+    // Every prefilled transaction occupies more than one byte
+    if (prefilled > remaining()) {
+        throw std::runtime_error("Prefilled transactions incomplete");
+    }
+
+    const auto total = shortCount + prefilled;
+
+    if ((0 == total) || (max_transactions_ < total)) {
+        throw std::runtime_error("Invalid transaction count");
+    }
+
+    slots_.resize(total);
+    auto preimage = Space{};
+    auto next = std::size_t{0};
+
+    for (auto i = std::size_t{0}; i < prefilled; ++i) {
+        // Indices are differentially encoded
+        const auto position = next + count("Failed to decode prefilled index");
+
+        if ((position < next) || (position >= total)) {
+            throw std::runtime_error("Invalid prefilled index");
+        }
+
+        const auto bytes = fill(
+            position,
+            {reinterpret_cast<const char*>(it), remaining()},
+            preimage);
+        std::advance(it, bytes);
+        expectedSize += bytes;
+        next = position + 1u;
+    }
+
+    if (payload.size() != expectedSize) {
+        throw std::runtime_error("Unexpected bytes after prefilled");
+    }
+
+    auto id = ids.cbegin();
+
+    for (auto position = std::size_t{0}; position < total; ++position) {
+        if (slots_.at(position).filled_) { continue; }
+
+        const auto [i, added] = short_ids_.try_emplace(*id++, position);
+
+        // The sender is expected to choose a new nonce when this happens, so
+        // the block must be downloaded in full
+        if (false == added) { throw std::runtime_error("Duplicate short id"); }
+    }
+}
+
+auto CompactBlock::fill(
+    const std::size_t position,
+    const ReadView tx,
+    Space& preimage) noexcept(false) -> std::size_t
+{
+    const auto [bytes, witness] = BlockType::Parse(tx, 0 == position, {});
+    auto& slot = slots_.at(position);
+    const auto raw = ReadView{tx.data(), bytes};
+    const auto hashed = BlockType::CalculateTxid(
+        api_,
+        chain_,
+        raw,
+        witness,
+        preimage,
+        preallocated(slot.txid_.size(), slot.txid_.data()));
+
+    if (false == hashed) {
+        throw std::runtime_error("Failed to calculate txid");
+    }
+
+    const auto* begin = reinterpret_cast<const std::byte*>(raw.data());
+    slot.raw_.assign(begin, begin + raw.size());
+    slot.filled_ = true;
+
+    return bytes;
+}
+
+auto CompactBlock::Hash() const noexcept -> ReadView
+{
+    return {reinterpret_cast<const char*>(hash_.data()), hash_.size()};
+}
+
+auto CompactBlock::header(const ReadView payload) noexcept(false)
+    -> std::array<std::byte, header_bytes_>
+{
+    if ((header_bytes_ + nonce_bytes_) > payload.size()) {
+        throw std::runtime_error("Payload too short (header)");
+    }
+
+    auto output = std::array<std::byte, header_bytes_>{};
+    std::memcpy(output.data(), payload.data(), output.size());
+
+    return output;
+}
+
+auto CompactBlock::IsComplete() const noexcept -> bool
+{
+    return std::all_of(slots_.cbegin(), slots_.cend(), [](const auto& slot) {
+        return slot.filled_;
+    });
+}
+
+auto CompactBlock::key(const api::Core& api, const ReadView payload) noexcept(
+    false) -> Space
+{
+    constexpr auto keyBytes = std::size_t{16};
+
+    if ((header_bytes_ + nonce_bytes_) > payload.size()) {
+        throw std::runtime_error("Payload too short (nonce)");
+    }
+
+    // The short id key is the first 128 bits of the single sha256 of the
+    // header followed by the nonce
+    auto output = Space{};
+    const auto hashed = api.Crypto().Hash().Digest(
+        proto::HASHTYPE_SHA256,
+        {payload.data(), header_bytes_ + nonce_bytes_},
+        writer(output));
+
+    if ((false == hashed) || (keyBytes > output.size())) {
+        throw std::runtime_error("Failed to calculate short id key");
+    }
+
+    output.resize(keyBytes);
+
+    return output;
+}
+
+auto CompactBlock::Match(const Transactions& candidates) noexcept
+    -> std::size_t
+{
+    auto ids = std::vector<ReadView>{};
+    auto transactions = std::vector<const block::bitcoin::Transaction*>{};
+    ids.reserve(candidates.size());
+    transactions.reserve(candidates.size());
+
+    for (const auto& pTransaction : candidates) {
+        if (false == bool(pTransaction)) { continue; }
+
+        const auto& tx = *pTransaction;
+        ids.emplace_back((1 < version_) ? tx.WTXID().Bytes() : tx.ID().Bytes());
+        transactions.emplace_back(&tx);
+    }
+
+    const auto hashes = siphash_.Batch(ids);
+    // slot position, candidate position
+    auto matches = std::map<std::size_t, std::size_t>{};
+
+    for (auto i = std::size_t{0}; i < hashes.size(); ++i) {
+        const auto found = short_ids_.find(hashes.at(i) & short_id_mask_);
+
+        if (short_ids_.end() == found) { continue; }
+
+        const auto position = found->second;
+
+        if (slots_.at(position).filled_) { continue; }
+        if (0 < collisions_.count(position)) { continue; }
+
+        if (auto [it, added] = matches.try_emplace(position, i); !added) {
+            matches.erase(it);
+            collisions_.emplace(position);
+        }
+    }
+
+    auto output = std::size_t{0};
+
+    for (const auto& [position, i] : matches) {
+        const auto& tx = *transactions.at(i);
+        auto& slot = slots_.at(position);
+        slot.raw_.clear();
+
+        if (false == tx.Serialize(writer(slot.raw_)).has_value()) { continue; }
+
+        const auto txid = tx.ID().Bytes();
+
+        if (slot.txid_.size() != txid.size()) { continue; }
+
+        std::memcpy(slot.txid_.data(), txid.data(), txid.size());
+        slot.filled_ = true;
+        ++output;
+    }
+
+    return output;
+}
+
+auto CompactBlock::merkle_root() const noexcept -> std::optional<Txid>
+{
+    if (slots_.empty()) { return {}; }
+
+    auto level = std::vector<Txid>{};
+    level.reserve(slots_.size() + 1u);
+
+    for (const auto& slot : slots_) { level.emplace_back(slot.txid_); }
+
+    auto preimage = std::array<std::byte, 64>{};
+
+    while (1 < level.size()) {
+        if (1 == (level.size() % 2)) { level.emplace_back(level.back()); }
+
+        auto next = std::vector<Txid>(level.size() / 2u);
+
+        for (auto i = std::size_t{0}; i < next.size(); ++i) {
+            auto& hash = next.at(i);
+            std::memcpy(preimage.data(), level.at(2u * i).data(), 32);
+            std::memcpy(preimage.data() + 32, level.at(2u * i + 1u).data(), 32);
+            const auto hashed = MerkleHash(
+                api_,
+                chain_,
+                {reinterpret_cast<const char*>(preimage.data()),
+                 preimage.size()},
+                preallocated(hash.size(), hash.data()));
+
+            if (false == hashed) { return {}; }
+        }
+
+        level.swap(next);
+    }
+
+    return level.front();
+}
+
+auto CompactBlock::Missing() const noexcept -> Indices
+{
+    auto output = Indices{};
+
+    for (auto i = std::size_t{0}; i < slots_.size(); ++i) {
+        if (false == slots_.at(i).filled_) { output.emplace_back(i); }
+    }
+
+    return output;
+}
+
+auto CompactBlock::Receive(const ReadView blocktxn) noexcept -> bool
+{
+    try {
+        if (hash_.size() > blocktxn.size()) {
+            throw std::runtime_error("Payload too short (block hash)");
+        }
+
+        if (0 != std::memcmp(blocktxn.data(), hash_.data(), hash_.size())) {
+            throw std::runtime_error("Wrong block");
+        }
+
+        auto it = reinterpret_cast<blockchain::bitcoin::ByteIterator>(
+            blocktxn.data() + hash_.size());
+        auto expectedSize = hash_.size() + 1u;
+        auto count = std::size_t{};
+
+        if ((blocktxn.size() < expectedSize) ||
+            (false == blockchain::bitcoin::DecodeCompactSizeFromPayload(
+                          it, expectedSize, blocktxn.size(), count))) {
+            throw std::runtime_error("Failed to decode transaction count");
+        }
+
+        const auto missing = Missing();
+
+        if (missing.size() != count) {
+            throw std::runtime_error("Wrong number of transactions");
+        }
+
+        auto preimage = Space{};
+
+        for (const auto position : missing) {
+            const auto bytes = fill(
+                position,
+                {reinterpret_cast<const char*>(it),
+                 blocktxn.size() - expectedSize},
+                preimage);
+            std::advance(it, bytes);
+            expectedSize += bytes;
+        }
+
+        if (blocktxn.size() != expectedSize) {
+            throw std::runtime_error("Unexpected bytes after transactions");
+        }
+
+        received_ += blocktxn.size();
+
+        return true;
+    } catch (const std::exception& e) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(": ")(e.what()).Flush();
+
+        return false;
+    }
+}
+
+auto CompactBlock::Serialize() const noexcept -> std::optional<Space>
+{
+    if (false == IsComplete()) { return {}; }
+
+    const auto root = merkle_root();
+
+    if ((false == root.has_value()) ||
+        (0 != std::memcmp(
+                  root.value().data(),
+                  header_.data() + merkle_offset_,
+                  root.value().size()))) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(
+            ": Reconstructed transactions do not match merkle root")
+            .Flush();
+
+        return {};
+    }
+
+    const auto count =
+        blockchain::bitcoin::CompactSize(slots_.size()).Encode();
+    auto bytes = header_.size() + count.size();
+
+    for (const auto& slot : slots_) { bytes += slot.raw_.size(); }
+
+    auto output = Space{};
+    output.reserve(bytes);
+    output.insert(output.end(), header_.cbegin(), header_.cend());
+    output.insert(output.end(), count.cbegin(), count.cend());
+
+    for (const auto& slot : slots_) {
+        output.insert(output.end(), slot.raw_.cbegin(), slot.raw_.cend());
+    }
+
+    return output;
+}
+
+auto CompactBlock::ShortID(const ReadView id) const noexcept -> std::uint64_t
+{
+    return siphash_(id) & short_id_mask_;
+}
+
+auto CompactBlock::Version(const blockchain::Type chain) noexcept
+    -> std::uint64_t
+{
+    // Version 2 short ids use the wtxid and the transactions include witness
+    // data
+    switch (chain) {
+        case blockchain::Type::Bitcoin:
+        case blockchain::Type::Bitcoin_testnet3: {
+            return 2;
+        }
+        default: {
+            return 1;
+        }
+    }
+}
+}  // namespace opentxs::blockchain::p2p::bitcoin
@@ -0,0 +1,137 @@
+// Copyright (c) 2010-2020 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <vector>
+
+#include "internal/blockchain/Blockchain.hpp"
+#include "opentxs/Bytes.hpp"
+#include "opentxs/Types.hpp"
+#include "opentxs/blockchain/Blockchain.hpp"
+
+namespace opentxs
+{
+namespace api
+{
+class Core;
+}  // namespace api
+
+namespace blockchain
+{
+namespace block
+{
+namespace bitcoin
+{
+class Transaction;
+}  // namespace bitcoin
+}  // namespace block
+}  // namespace blockchain
+}  // namespace opentxs
+
+namespace opentxs::blockchain::p2p::bitcoin
+{
+// Reconstructs a block announced with a BIP152 cmpctblock message. Slots
+// which the sender did not prefill are matched by short id against
+// transactions which are already known, and the remainder must be supplied by
+// a blocktxn message.
+class CompactBlock
+{
+public:
+    using Indices = std::vector<std::size_t>;
+    using Transaction = std::shared_ptr<const block::bitcoin::Transaction>;
+    using Transactions = std::vector<Transaction>;
+
+    static constexpr auto short_id_bytes_ = std::size_t{6};
+
+    /// Highest compact block version supported for the chain
+    OPENTXS_EXPORT static auto Version(const blockchain::Type chain) noexcept
+        -> std::uint64_t;
+
+    OPENTXS_EXPORT auto Hash() const noexcept -> ReadView;
+    OPENTXS_EXPORT auto IsComplete() const noexcept -> bool;
+    /// Positions of the transactions which must be requested with getblocktxn
+    OPENTXS_EXPORT auto Missing() const noexcept -> Indices;
+    /// Payload bytes received from the peer for this block
+    OPENTXS_EXPORT auto Received() const noexcept -> std::size_t
+    {
+        return received_;
+    }
+    /// Returns the serialized block, or nothing if transactions are missing
+    /// or the reconstructed transactions do not match the merkle root
+    OPENTXS_EXPORT auto Serialize() const noexcept -> std::optional<Space>;
+    OPENTXS_EXPORT auto ShortID(const ReadView id) const noexcept
+        -> std::uint64_t;
+    OPENTXS_EXPORT auto size() const noexcept -> std::size_t
+    {
+        return slots_.size();
+    }
+
+    /// Fills empty slots from the candidates and returns the number filled.
+    /// Slots matched by more than one candidate are left to be requested.
+    OPENTXS_EXPORT auto Match(const Transactions& candidates) noexcept
+        -> std::size_t;
+    /// Fills the missing slots from a blocktxn payload. Returns false if the
+    /// payload does not contain exactly the missing transactions.
+    OPENTXS_EXPORT auto Receive(const ReadView blocktxn) noexcept -> bool;
+
+    /// Throws if the cmpctblock payload is not valid
+    OPENTXS_EXPORT CompactBlock(
+        const api::Core& api,
+        const blockchain::Type chain,
+        const std::uint64_t version,
+        const ReadView payload) noexcept(false);
+
+    OPENTXS_EXPORT ~CompactBlock() = default;
+
+private:
+    using Txid = std::array<std::byte, 32>;
+
+    struct Slot {
+        Txid txid_{};
+        Space raw_{};
+        bool filled_{};
+    };
+
+    static constexpr auto header_bytes_ = std::size_t{80};
+    static constexpr auto max_transactions_ = std::size_t{100000};
+
+    const api::Core& api_;
+    const blockchain::Type chain_;
+    const std::uint64_t version_;
+    const std::array<std::byte, header_bytes_> header_;
+    const blockchain::internal::SipHash siphash_;
+    Txid hash_;
+    std::vector<Slot> slots_;
+    std::map<std::uint64_t, std::size_t> short_ids_;
+    std::set<std::size_t> collisions_;
+    std::size_t received_;
+
+    static auto header(const ReadView payload) noexcept(false)
+        -> std::array<std::byte, header_bytes_>;
+    static auto key(const api::Core& api, const ReadView payload) noexcept(
+        false) -> Space;
+
+    auto merkle_root() const noexcept -> std::optional<Txid>;
+
+    auto fill(
+        const std::size_t position,
+        const ReadView tx,
+        Space& preimage) noexcept(false) -> std::size_t;
+
+    CompactBlock() = delete;
+    CompactBlock(const CompactBlock&) = delete;
+    CompactBlock(CompactBlock&&) = delete;
+    CompactBlock& operator=(const CompactBlock&) = delete;
+    CompactBlock& operator=(CompactBlock&&) = delete;
+};
+}  // namespace opentxs::blockchain::p2p::bitcoin
@@ -10,12 +10,14 @@
 #include <boost/asio.hpp>
 #include <algorithm>
 #include <cstdint>
+#include <exception>
 #include <utility>
 #include <vector>
 
 #include "Factory.hpp"
 #include "blockchain/bitcoin/Inventory.hpp"
 #include "blockchain/p2p/Peer.hpp"
+#include "blockchain/p2p/bitcoin/CompactBlock.hpp"
 #include "blockchain/p2p/bitcoin/Header.hpp"
 #include "blockchain/p2p/bitcoin/Message.hpp"
 #include "blockchain/p2p/bitcoin/message/Cmpctblock.hpp"
@@ -28,6 +30,7 @@
 #include "blockchain/p2p/bitcoin/message/Tx.hpp"
 #include "internal/api/Api.hpp"
 #include "internal/blockchain/Blockchain.hpp"
+#include "internal/blockchain/bitcoin/Bitcoin.hpp"
 #include "internal/blockchain/p2p/P2P.hpp"
 #include "internal/blockchain/p2p/bitcoin/message/Message.hpp"
 #include "opentxs/Bytes.hpp"
@@ -127,6 +130,7 @@ const std::map<Command, Peer::CommandFunction> Peer::command_map_{
     {Command::version, &Peer::process_version},
 };
 
+const std::size_t Peer::max_compact_blocks_{8};
 const std::string Peer::user_agent_{"/opentxs:" OPENTXS_VERSION_STRING "/"};
 
 Peer::Peer(
@@ -157,10 +161,48 @@ Peer::Peer(
     , local_services_(get_local_services(protocol_, chain_, localServices))
     , relay_(relay)
     , get_headers_()
+    , compact_(false)
+    , compact_blocks_()
+    , compact_sequence_(0)
 {
     init();
 }
 
+auto Peer::compact_block_failed(
+    const block::Hash& hash,
+    const std::size_t received) noexcept -> void
+{
+    LogVerbose(OT_METHOD)(__FUNCTION__)(": Downloading block ")(hash.asHex())(
+        " in full")
+        .Flush();
+    network_.BlockOracle().CompactBlockFailed(received);
+    get_block(hash, false);
+}
+
+auto Peer::get_block(const block::Hash& hash, const bool compact) noexcept
+    -> void
+{
+    using Inventory = blockchain::bitcoin::Inventory;
+    using Type = Inventory::Type;
+    auto blocks = std::vector<Inventory>{};
+    blocks.emplace_back(
+        compact ? Type::MsgCmpctBlock : Type::MsgBlock,
+        api_.Factory().Data(hash.Bytes()));
+
+    auto pMessage = std::unique_ptr<Message>{
+        Factory::BitcoinP2PGetdata(api_, chain_, std::move(blocks))};
+
+    if (false == bool(pMessage)) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(": Failed to construct getdata")
+            .Flush();
+
+        return;
+    }
+
+    const auto& message = *pMessage;
+    send(message.Encode());
+}
+
 auto Peer::get_body_size(const zmq::Frame& header) const noexcept -> std::size_t
 {
     OT_ASSERT(HeaderType::Size() == header.size());
@@ -312,7 +354,37 @@ auto Peer::process_blocktxn(
         return;
     }
 
-    // TODO
+    const auto& message = *pMessage;
+    const auto transactions = message.BlockTransactions();
+    const auto bytes = transactions->Bytes();
+    constexpr auto hashBytes = sizeof(bitcoin::BlockHeaderHashField);
+
+    if (hashBytes > bytes.size()) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(": Invalid payload").Flush();
+
+        return;
+    }
+
+    const auto hash = api_.Factory().Data(ReadView{bytes.data(), hashBytes});
+    auto it = compact_blocks_.find(hash);
+
+    if (compact_blocks_.end() == it) {
+        LogVerbose(OT_METHOD)(__FUNCTION__)(": Unexpected transactions for ")(
+            hash->asHex())
+            .Flush();
+
+        return;
+    }
+
+    const auto pBlock = std::move(it->second.second);
+    compact_blocks_.erase(it);
+    auto& block = *pBlock;
+
+    if (block.Receive(bytes)) {
+        submit_compact_block(hash, block, true);
+    } else {
+        compact_block_failed(hash, block.Received());
+    }
 }
 
 auto Peer::process_cfcheckpt(
@@ -334,7 +406,16 @@ auto Peer::process_cfcheckpt(
         return;
     }
 
-    // TODO
+    const auto& message = *pMessage;
+    using Task = client::internal::Network::Task;
+    auto work = network_.Work(Task::SubmitFilterCheckpoints);
+    work->AddFrame(message.Type());
+    work->AddFrame(message.Stop());
+    work->AddFrame(id());
+
+    for (const auto& checkpoint : message) { work->AddFrame(checkpoint); }
+
+    network_.Submit(work);
 }
 
 auto Peer::process_cfheaders(
@@ -362,6 +443,7 @@ auto Peer::process_cfheaders(
     auto work = network_.Work(Task::SubmitFilterHeader);
     work->AddFrame(type);
     work->AddFrame(message.Stop());
+    work->AddFrame(id());
     work->AddFrame(message.Previous());
 
     for (const auto& header : message) { work->AddFrame(header); }
@@ -398,6 +480,7 @@ auto Peer::process_cfilter(
     work->AddFrame(message.FPRate());
     work->AddFrame(message.ElementCount());
     work->AddFrame(message.Filter().data(), message.Filter().size());
+    work->AddFrame(id());
     network_.Submit(work);
 }
 
@@ -420,7 +503,73 @@ auto Peer::process_cmpctblock(
         return;
     }
 
-    // TODO
+    const auto& message = *pMessage;
+    const auto raw = message.getRawCmpctblock();
+    const auto bytes = raw->Bytes();
+    auto pBlock = std::unique_ptr<bitcoin::CompactBlock>{};
+
+    try {
+        pBlock = std::make_unique<bitcoin::CompactBlock>(
+            api_, chain_, bitcoin::CompactBlock::Version(chain_), bytes);
+    } catch (const std::exception& e) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(": ")(e.what()).Flush();
+        constexpr auto headerBytes = std::size_t{80};
+        auto hash = api_.Factory().Data();
+
+        if (headerBytes > bytes.size()) { return; }
+
+        const auto hashed = blockchain::BlockHash(
+            api_,
+            chain_,
+            {bytes.data(), headerBytes},
+            hash->WriteInto());
+
+        if (hashed) { compact_block_failed(hash, bytes.size()); }
+
+        return;
+    }
+
+    auto& block = *pBlock;
+    const auto hash = api_.Factory().Data(block.Hash());
+    // A compact block is also an announcement of a new header
+    request_headers(hash);
+    auto sequence = std::size_t{0};
+    const auto matched = block.Match(network_.Mempool().Dump(sequence));
+    LogVerbose(OT_METHOD)(__FUNCTION__)(": Matched ")(matched)(" of ")(
+        block.size())(" transactions in block ")(hash->asHex())
+        .Flush();
+
+    if (block.IsComplete()) {
+        submit_compact_block(hash, block, false);
+
+        return;
+    }
+
+    auto pRequest = std::unique_ptr<Message>{
+        Factory::BitcoinP2PGetblocktxn(api_, chain_, hash, block.Missing())};
+
+    if (false == bool(pRequest)) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(
+            ": Failed to construct getblocktxn")
+            .Flush();
+        compact_block_failed(hash, block.Received());
+
+        return;
+    }
+
+    send(pRequest->Encode());
+
+    // Give up on the block which has waited longest
+    while (max_compact_blocks_ <= compact_blocks_.size()) {
+        compact_blocks_.erase(std::min_element(
+            compact_blocks_.begin(),
+            compact_blocks_.end(),
+            [](const auto& lhs, const auto& rhs) {
+                return lhs.second.first < rhs.second.first;
+            }));
+    }
+
+    compact_blocks_[hash] = {++compact_sequence_, std::move(pBlock)};
 }
 
 auto Peer::process_feefilter(
@@ -682,21 +831,61 @@ auto Peer::process_headers(
     const zmq::Frame& payload) -> void
 {
     get_headers_.Finish();
-    const auto pMessage =
-        std::unique_ptr<message::internal::Headers>{Factory::BitcoinP2PHeaders(
-            api_,
-            std::move(header),
-            protocol_.load(),
-            payload.data(),
-            payload.size())};
+    // The serialized headers are forwarded without being instantiated so the
+    // network can hash and validate the whole batch on several threads
+    const auto size = payload.size();
+    auto expectedSize = sizeof(std::byte);
 
-    if (false == bool(pMessage)) {
-        LogOutput(OT_METHOD)(__FUNCTION__)(": Failed to decode message payload")
+    if (expectedSize > size) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(": Payload too short (compactsize)")
             .Flush();
 
         return;
     }
 
+    auto* it{static_cast<const std::byte*>(payload.data())};
+    auto count = std::size_t{0};
+    const auto decodedSize = blockchain::bitcoin::DecodeCompactSizeFromPayload(
+        it, expectedSize, size, count);
+
+    if (false == decodedSize) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(": CompactSize incomplete").Flush();
+
+        return;
+    }
+
+    // Each entry is a header followed by an empty transaction count
+    static constexpr auto serialized = std::size_t{80};
+    static constexpr auto entry = serialized + 1;
+    static constexpr auto limit = std::size_t{2000};
+
+    if (limit < count) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(": Too many block headers (")(
+            count)(")")
+            .Flush();
+
+        return;
+    }
+
+    if ((expectedSize > size) || (count > ((size - expectedSize) / entry))) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(": Block header entries incomplete")
+            .Flush();
+
+        return;
+    }
+
+    for (auto i = std::size_t{0}; i < count; ++i) {
+        const auto& txCount = *(it + (i * entry) + serialized);
+
+        if (std::byte{0x0} != txCount) {
+            LogOutput(OT_METHOD)(__FUNCTION__)(
+                ": Block header entry contains transactions")
+                .Flush();
+
+            return;
+        }
+    }
+
     using Promise = std::promise<void>;
     auto* promise = new Promise{};
 
@@ -704,12 +893,14 @@ auto Peer::process_headers(
 
     auto future = promise->get_future();
     auto pointer = reinterpret_cast<std::uintptr_t>(promise);
-    const auto& message = *pMessage;
     using Task = client::internal::Network::Task;
     auto work = network_.Work(Task::SubmitBlockHeader);
     work->AddFrame(pointer);
 
-    for (const auto& header : message) { work->AddFrame(header.Serialize()); }
+    for (auto i = std::size_t{0}; i < count; ++i) {
+        work->AddFrame(it, serialized);
+        it += entry;
+    }
 
     network_.Submit(work);
 
@@ -739,6 +930,8 @@ auto Peer::process_inv(
     }
 
     const auto& message = *pMessage;
+    using Inventory = blockchain::bitcoin::Inventory;
+    auto transactions = std::vector<Inventory>{};
 
     for (const auto& inv : message) {
         if (false == running_.get()) { return; }
@@ -746,17 +939,36 @@ auto Peer::process_inv(
         LogVerbose("Received ")(blockchain::internal::DisplayString(chain_))(
             " ")(inv.DisplayType())(" (")(inv.hash_->asHex())(")")
             .Flush();
-        using Inventory = blockchain::bitcoin::Inventory;
 
         switch (inv.type_) {
             case Inventory::Type::MsgBlock:
             case Inventory::Type::MsgWitnessBlock: {
                 request_headers(inv.hash_);
             } break;
+            case Inventory::Type::MsgTx:
+            case Inventory::Type::MsgWitnessTx: {
+                if (network_.Mempool().Request(inv.hash_)) {
+                    transactions.emplace_back(inv.type_, inv.hash_);
+                }
+            } break;
             default: {
             }
         }
     }
+
+    if (transactions.empty()) { return; }
+
+    auto pGetdata = std::unique_ptr<Message>{
+        Factory::BitcoinP2PGetdata(api_, chain_, std::move(transactions))};
+
+    if (false == bool(pGetdata)) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(": Failed to construct getdata")
+            .Flush();
+
+        return;
+    }
+
+    send(pGetdata->Encode());
 }
 
 auto Peer::process_mempool(
@@ -975,7 +1187,11 @@ auto Peer::process_sendcmpct(
         return;
     }
 
-    // TODO
+    const auto& message = *pMessage;
+
+    if (bitcoin::CompactBlock::Version(chain_) == message.version()) {
+        compact_.store(true);
+    }
 }
 
 auto Peer::process_sendheaders(
@@ -1013,7 +1229,10 @@ auto Peer::process_tx(
         return;
     }
 
-    // TODO
+    using Task = client::internal::Network::Task;
+    auto work = network_.Work(Task::SubmitTransaction);
+    work->AddFrame(payload);
+    network_.Submit(work);
 }
 
 auto Peer::process_verack(
@@ -1032,6 +1251,24 @@ auto Peer::process_verack(
 
     incoming_handshake_ = true;
     check_handshake();
+
+    if (compact_blocks_version_ > protocol_.load()) { return; }
+
+    // Only a few peers are asked to announce new blocks with cmpctblock
+    // messages. The others announce with headers or inv and compact blocks
+    // are requested from them when needed.
+    const auto highBandwidth = manager_.HighBandwidth(id());
+    auto pSendcmpct = std::unique_ptr<Message>{Factory::BitcoinP2PSendcmpct(
+        api_, chain_, highBandwidth, bitcoin::CompactBlock::Version(chain_))};
+
+    if (false == bool(pSendcmpct)) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(": Failed to construct sendcmpct")
+            .Flush();
+
+        return;
+    }
+
+    send(pSendcmpct->Encode());
 }
 
 auto Peer::process_version(
@@ -1089,6 +1326,7 @@ auto Peer::process_version(
     }
 
     if (1 == services.count(p2p::Service::CompactFilters)) {
+        subscribe.emplace_back(Task::Getcfcheckpt);
         subscribe.emplace_back(Task::Getcfheaders);
         subscribe.emplace_back(Task::Getcfilters);
     }
@@ -1123,24 +1361,46 @@ auto Peer::request_block(zmq::Message& in) noexcept -> void
         OT_FAIL;
     }
 
-    auto id = api_.Factory().Data(body.at(0));
-    using Inventory = blockchain::bitcoin::Inventory;
-    using Type = Inventory::Type;
-    auto blocks = std::vector<Inventory>{};
-    blocks.emplace_back(Type::MsgBlock, std::move(id));
+    // Peers answer compact block requests for old blocks with a full block,
+    // so compact blocks are only worth requesting near the tip
+    get_block(
+        api_.Factory().Data(body.at(0)),
+        compact_.load() && network_.IsSynchronized());
+}
 
-    auto pMessage = std::unique_ptr<Message>{
-        Factory::BitcoinP2PGetdata(api_, chain_, std::move(blocks))};
+auto Peer::request_cfcheckpt(zmq::Message& in) noexcept -> void
+{
+    if (false == running_.get()) { return; }
 
-    if (false == bool(pMessage)) {
-        LogOutput(OT_METHOD)(__FUNCTION__)(": Failed to construct getdata")
-            .Flush();
+    const auto body = in.Body();
+
+    if (2 > body.size()) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(": Invalid work").Flush();
 
         return;
     }
 
-    const auto& message = *pMessage;
-    send(message.Encode());
+    try {
+        auto pMessage =
+            std::unique_ptr<Message>{Factory::BitcoinP2PGetcfcheckpt(
+                api_,
+                chain_,
+                body.at(0).as<filter::Type>(),
+                Data::Factory(body.at(1)))};
+
+        if (false == bool(pMessage)) {
+            LogOutput(OT_METHOD)(__FUNCTION__)(
+                ": Failed to construct getcfcheckpt")
+                .Flush();
+
+            return;
+        }
+
+        const auto& message = *pMessage;
+        send(message.Encode());
+    } catch (...) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(": Invalid parameters").Flush();
+    }
 }
 
 auto Peer::request_cfheaders(zmq::Message& in) noexcept -> void
@@ -1284,5 +1544,22 @@ auto Peer::start_handshake() noexcept -> void
     }
 }
 
+auto Peer::submit_compact_block(
+    const block::Hash& hash,
+    const bitcoin::CompactBlock& block,
+    const bool roundTrip) noexcept -> void
+{
+    const auto serialized = block.Serialize();
+
+    if (false == serialized.has_value()) {
+        compact_block_failed(hash, block.Received());
+
+        return;
+    }
+
+    network_.BlockOracle().SubmitCompactBlock(
+        reader(serialized.value()), block.Received(), roundTrip);
+}
+
 Peer::~Peer() { Shutdown(); }
 }  // namespace opentxs::blockchain::p2p::bitcoin::implementation
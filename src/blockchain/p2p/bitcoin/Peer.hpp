@@ -19,6 +19,7 @@
 #include <type_traits>
 
 #include "blockchain/p2p/Peer.hpp"
+#include "blockchain/p2p/bitcoin/CompactBlock.hpp"
 #include "blockchain/p2p/bitcoin/Header.hpp"
 #include "blockchain/p2p/bitcoin/Message.hpp"
 #include "internal/blockchain/client/Client.hpp"
@@ -75,6 +76,10 @@ private:
     using CommandFunction =
         void (Peer::*)(std::unique_ptr<HeaderType>, const zmq::Frame&);
     using Nonce = bitcoin::Nonce;
+    /// arrival sequence, block
+    using CompactBlocks = std::map<
+        block::pHash,
+        std::pair<std::size_t, std::unique_ptr<bitcoin::CompactBlock>>>;
 
     struct Request {
     public:
@@ -110,7 +115,9 @@ private:
     };
 
     static const std::map<Command, CommandFunction> command_map_;
+    static const ProtocolVersion compact_blocks_version_{70014};
     static const ProtocolVersion default_protocol_version_{70015};
+    static const std::size_t max_compact_blocks_;
     static const std::string user_agent_;
 
     const blockchain::Type chain_;
@@ -120,6 +127,12 @@ private:
     const std::set<p2p::Service> local_services_;
     std::atomic<bool> relay_;
     Request get_headers_;
+    // The remote peer accepted the compact block version used for the chain
+    std::atomic<bool> compact_;
+    // Compact blocks waiting for a blocktxn reply. Only accessed while
+    // processing messages.
+    CompactBlocks compact_blocks_;
+    std::size_t compact_sequence_;
 
     static std::set<p2p::Service> get_local_services(
         const ProtocolVersion version,
@@ -129,17 +142,26 @@ private:
 
     std::size_t get_body_size(const zmq::Frame& header) const noexcept final;
 
+    void compact_block_failed(
+        const block::Hash& hash,
+        const std::size_t received) noexcept;
+    void get_block(const block::Hash& hash, const bool compact) noexcept;
     void ping() noexcept final;
     void pong() noexcept final;
     void process_message(const zmq::Message& message) noexcept final;
     void request_addresses() noexcept final;
     void request_block(zmq::Message& message) noexcept final;
+    void request_cfcheckpt(zmq::Message& message) noexcept final;
     void request_cfheaders(zmq::Message& message) noexcept final;
     void request_cfilter(zmq::Message& message) noexcept final;
     using p2p::implementation::Peer::request_headers;
     void request_headers() noexcept final;
     void request_headers(const block::Hash& hash) noexcept;
     void start_handshake() noexcept final;
+    void submit_compact_block(
+        const block::Hash& hash,
+        const bitcoin::CompactBlock& block,
+        const bool roundTrip) noexcept;
 
     void process_addr(
         std::unique_ptr<HeaderType> header,
@@ -78,6 +78,7 @@ blockchain::p2p::bitcoin::message::Getblocktxn* Factory::BitcoinP2PGetblocktxn(
         return nullptr;
     }
 
+    // Indices are differentially encoded on the wire (BIP152)
     std::vector<std::size_t> txn_indices;
 
     if (indicesCount > 0) {
@@ -103,6 +104,18 @@ blockchain::p2p::bitcoin::message::Getblocktxn* Factory::BitcoinP2PGetblocktxn(
                 return nullptr;
             }
 
+            if (false == txn_indices.empty()) {
+                txnIndex += txn_indices.back() + 1u;
+
+                if (txnIndex <= txn_indices.back()) {
+                    LogOutput("opentxs::Factory::")(__FUNCTION__)(
+                        ": Txn index overflow at entry index ")(ii)
+                        .Flush();
+
+                    return nullptr;
+                }
+            }
+
             txn_indices.push_back(txnIndex);
         }
     }
@@ -142,9 +155,12 @@ OTData Getblocktxn::payload() const noexcept
         const auto size = CompactSize(txn_indices_.size()).Encode();
         output->Concatenate(size.data(), size.size());
         // ---------------------------
+        auto next = std::size_t{0};
+
         for (const auto& index : txn_indices_) {
-            const auto size = CompactSize(index).Encode();
+            const auto size = CompactSize(index - next).Encode();
             output->Concatenate(size.data(), size.size());
+            next = index + 1u;
         }
 
         return output;
@@ -49,6 +49,7 @@ class Getblocktxn final : virtual public bitcoin::Message
 {
 public:
     OTData getBlockHash() const noexcept { return Data::Factory(block_hash_); }
+    /// Absolute transaction positions in ascending order
     const std::vector<std::size_t>& getIndices() const noexcept
     {
         return txn_indices_;
@@ -17,11 +17,13 @@
 #include <string>
 #include <string_view>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 #include "crypto/HDNode.hpp"
 #include "opentxs/Pimpl.hpp"
 #include "opentxs/Proto.hpp"
+#include "opentxs/api/crypto/Config.hpp"
 #include "opentxs/api/crypto/Crypto.hpp"
 #include "opentxs/api/crypto/Encode.hpp"
 #include "opentxs/api/crypto/Hash.hpp"
@@ -60,9 +62,90 @@ auto Print(const proto::HDPath& node) -> std::string
 
 namespace opentxs::crypto::implementation
 {
+// private key, chain code, public key
+const std::size_t Bip32::Cache::node_size_{32 + 32 + 33};
+
 Bip32::Bip32(const api::Crypto& crypto) noexcept
     : crypto_(crypto)
+#if OT_CRYPTO_WITH_BIP32
+    , cache_(crypto_.Config().Bip32CacheSize())
+#endif  // OT_CRYPTO_WITH_BIP32
+{
+}
+
+Bip32::Cache::Cache(const std::size_t capacity) noexcept
+    : capacity_(capacity)
+    , lock_()
+    , lru_()
+    , map_()
+{
+}
+
+auto Bip32::Cache::Load(
+    const std::string& seed,
+    const Path& path,
+    HDNode& node,
+    Bip32Fingerprint& parent) noexcept -> std::size_t
+{
+    Lock lock(lock_);
+
+    for (auto depth = path.size(); 0 < depth; --depth) {
+        const auto end = std::next(path.cbegin(), depth);
+        auto it = map_.find(Index{seed, Path{path.cbegin(), end}});
+
+        if (map_.end() == it) { continue; }
+
+        auto& [data, fingerprint, position] = it->second;
+        lru_.splice(lru_.end(), lru_, position);
+        auto start = data.Bytes().data();
+        std::memcpy(node.InitPrivate()(32), start, 32);
+        std::advance(start, 32);
+        std::memcpy(node.InitCode()(32), start, 32);
+        std::advance(start, 32);
+        std::memcpy(node.InitPublic()(33), start, 33);
+        parent = fingerprint;
+
+        return depth;
+    }
+
+    return 0;
+}
+
+auto Bip32::Cache::Store(
+    const std::string& seed,
+    const Path& path,
+    const std::size_t depth,
+    const HDNode& node,
+    const Bip32Fingerprint parent) noexcept -> void
 {
+    if (0 == capacity_) { return; }
+
+    OT_ASSERT(depth <= path.size());
+
+    auto index =
+        Index{seed, Path{path.cbegin(), std::next(path.cbegin(), depth)}};
+    Lock lock(lock_);
+
+    if (0 < map_.count(index)) { return; }
+
+    while (map_.size() >= capacity_) {
+        map_.erase(lru_.front());
+        lru_.pop_front();
+    }
+
+    auto& [data, fingerprint, position] = map_[index];
+    auto out = data.WriteInto(OTPassword::Mode::Mem)(node_size_);
+
+    OT_ASSERT(out.valid(node_size_));
+
+    auto it = out.as<std::byte>();
+    std::memcpy(it, node.ParentPrivate().data(), 32);
+    std::advance(it, 32);
+    std::memcpy(it, node.ParentCode().data(), 32);
+    std::advance(it, 32);
+    std::memcpy(it, node.ParentPublic().data(), 33);
+    fingerprint = parent;
+    position = lru_.insert(lru_.end(), std::move(index));
 }
 
 auto Bip32::ckd_private_hardened(
@@ -98,126 +181,269 @@ auto Bip32::decode(const std::string& serialized) const noexcept -> OTData
 }
 
 #if OT_CRYPTO_WITH_BIP32
-auto Bip32::DeriveKey(
-    const EcdsaCurve& curve,
-    const OTPassword& seed,
-    const Path& path) const -> Key
+auto Bip32::ckd_private(HDNode& node, const Bip32Index child) const noexcept
+    -> bool
 {
-    auto output = Key{OTPassword{}, OTPassword{}, Data::Factory(), path, 0};
-    auto& [privateKey, chainCode, publicKey, pathOut, parent] = output;
-    auto node = HDNode{crypto_};
     auto& hash = node.hash_;
     auto& data = node.data_;
+    auto i = be::big_uint32_buf_t{child};
 
-    {
-        const auto init = root_node(
-            EcdsaCurve::secp256k1,
-            seed.Bytes(),
-            node.InitPrivate(),
-            node.InitCode(),
-            node.InitPublic());
+    if (IsHard(child)) {
+        ckd_private_hardened(node, i, data);
+    } else {
+        ckd_private_normal(node, i, data);
+    }
 
-        if (false == init) { return output; }
+    auto success = crypto_.Hash().HMAC(
+        proto::HASHTYPE_SHA512,
+        node.ParentCode(),
+        reader(data),
+        [&hash](const auto) {
+            return WritableView{hash.data(), 64};
+        });
 
-        if (false == data.valid(33 + 4)) {
-            LogOutput(OT_METHOD)(__FUNCTION__)(
-                ": Failed to allocate temporary data space")
-                .Flush();
+    if (false == success) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(": Failed to calculate hash")
+            .Flush();
+
+        return false;
+    }
 
-            return output;
+    try {
+        const auto& ecdsa = provider(EcdsaCurve::secp256k1);
+        success = ecdsa.ScalarAdd(
+            node.ParentPrivate(), {hash.as<char>(), 32}, node.ChildPrivate());
+
+        if (false == success) {
+            LogOutput(OT_METHOD)(__FUNCTION__)(": Invalid scalar").Flush();
+
+            return false;
         }
 
-        if (false == hash.valid(64)) {
+        success = ecdsa.ScalarMultiplyBase(
+            reader(node.ChildPrivate()(32)), node.ChildPublic());
+
+        if (false == success) {
             LogOutput(OT_METHOD)(__FUNCTION__)(
-                ": Failed to allocate temporary hash space")
+                ": Failed to calculate public key")
                 .Flush();
 
-            return output;
+            return false;
         }
+    } catch (const std::exception& e) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(": ")(e.what()).Flush();
+
+        return false;
     }
 
-    for (const auto& child : path) {
-        parent = node.Fingerprint();
-        auto i = be::big_uint32_buf_t{child};
+    auto code = hash.as<std::byte>();
+    std::advance(code, 32);
+    std::memcpy(node.ChildCode().data(), code, 32);
 
-        if (IsHard(child)) {
-            ckd_private_hardened(node, i, data);
-        } else {
-            ckd_private_normal(node, i, data);
-        }
+    return true;
+}
+
+auto Bip32::ckd_public(HDNode& node, const Bip32Index child) const noexcept
+    -> bool
+{
+    if (IsHard(child)) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(
+            ": Hardened children require a private key")
+            .Flush();
 
-        auto success = crypto_.Hash().HMAC(
-            proto::HASHTYPE_SHA512,
-            node.ParentCode(),
-            reader(data),
-            [&hash](const auto) {
-                return WritableView{hash.data(), 64};
-            });
+        return false;
+    }
+
+    auto& hash = node.hash_;
+    auto& data = node.data_;
+    ckd_private_normal(node, be::big_uint32_buf_t{child}, data);
+    auto success = crypto_.Hash().HMAC(
+        proto::HASHTYPE_SHA512,
+        node.ParentCode(),
+        reader(data),
+        [&hash](const auto) {
+            return WritableView{hash.data(), 64};
+        });
+
+    if (false == success) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(": Failed to calculate hash")
+            .Flush();
+
+        return false;
+    }
+
+    try {
+        success = provider(EcdsaCurve::secp256k1)
+                      .PubkeyAdd(
+                          node.ParentPublic(),
+                          {hash.as<char>(), 32},
+                          node.ChildPublic());
 
         if (false == success) {
-            LogOutput(OT_METHOD)(__FUNCTION__)(": Failed to calculate hash")
+            LogOutput(OT_METHOD)(__FUNCTION__)(
+                ": Failed to calculate public key")
                 .Flush();
 
-            return output;
+            return false;
         }
+    } catch (const std::exception& e) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(": ")(e.what()).Flush();
 
-        try {
-            const auto& ecdsa = provider(EcdsaCurve::secp256k1);
-            success = ecdsa.ScalarAdd(
-                node.ParentPrivate(),
-                {hash.as<char>(), 32},
-                node.ChildPrivate());
+        return false;
+    }
 
-            if (false == success) {
-                LogOutput(OT_METHOD)(__FUNCTION__)(": Invalid scalar").Flush();
+    auto code = hash.as<std::byte>();
+    std::advance(code, 32);
+    std::memcpy(node.ChildCode().data(), code, 32);
 
-                return output;
-            }
+    return true;
+}
+#endif  // OT_CRYPTO_WITH_BIP32
+#if OT_CRYPTO_WITH_BIP32
+auto Bip32::derive(
+    const std::string& seedID,
+    const OTPassword& seed,
+    const Path& path,
+    const bool cacheTarget,
+    HDNode& node,
+    Bip32Fingerprint& parent) const noexcept -> bool
+{
+    const auto cached = cache_.Load(seedID, path, node, parent);
 
-            success = ecdsa.ScalarMultiplyBase(
-                reader(node.ChildPrivate()(32)), node.ChildPublic());
+    if (0 == cached) {
+        const auto init = root_node(
+            EcdsaCurve::secp256k1,
+            seed.Bytes(),
+            node.InitPrivate(),
+            node.InitCode(),
+            node.InitPublic());
 
-            if (false == success) {
-                LogOutput(OT_METHOD)(__FUNCTION__)(
-                    ": Failed to calculate public key")
-                    .Flush();
+        if (false == init) { return false; }
+    }
 
-                return output;
-            }
-        } catch (const std::exception& e) {
-            LogOutput(OT_METHOD)(__FUNCTION__)(": ")(e.what()).Flush();
+    for (auto depth = cached; depth < path.size(); ++depth) {
+        parent = node.Fingerprint();
 
-            return output;
-        }
+        if (false == ckd_private(node, path.at(depth))) { return false; }
 
-        auto code = hash.as<std::byte>();
-        std::advance(code, 32);
-        std::memcpy(node.ChildCode().data(), code, 32);
         node.Next();
+        const auto next = depth + 1;
+
+        // Every ancestor of the target is cached so that siblings and cousins
+        // of the target cost a single derivation step
+        if (cacheTarget || (next < path.size())) {
+            cache_.Store(seedID, path, next, node, parent);
+        }
     }
 
-    const auto privateOut = node.ParentPrivate();
-    const auto chainOut = node.ParentCode();
-    const auto publicOut = node.ParentPublic();
+    return true;
+}
 
-    if (EcdsaCurve::secp256k1 == curve) {
-        privateKey.setMemory(privateOut.data(), privateOut.size());
-        publicKey->Assign(publicOut);
-    } else {
-        const auto expanded = sodium::ExpandSeed(
-            {reinterpret_cast<const char*>(privateOut.data()),
-             privateOut.size()},
-            privateKey.WriteInto(OTPassword::Mode::Mem),
-            publicKey->WriteInto());
+auto Bip32::DeriveKey(
+    const EcdsaCurve& curve,
+    const OTPassword& seed,
+    const Path& path) const -> Key
+{
+    auto output = Key{OTPassword{}, OTPassword{}, Data::Factory(), path, 0};
+    auto& parent = std::get<4>(output);
+    auto node = HDNode{crypto_};
+    const auto seedID = SeedID(seed.Bytes())->str();
 
-        if (false == expanded) {
-            LogOutput(OT_METHOD)(__FUNCTION__)(": Failed to expand seed")
-                .Flush();
-            return output;
+    if (false == derive(seedID, seed, path, false, node, parent)) {
+        return output;
+    }
+
+    serialize(curve, node, output);
+
+    return output;
+}
+
+auto Bip32::DeriveKeys(
+    const EcdsaCurve& curve,
+    const OTPassword& seed,
+    const Path& parent,
+    const Bip32Index first,
+    const Bip32Index count) const -> std::vector<Key>
+{
+    auto output = std::vector<Key>{};
+    auto node = HDNode{crypto_};
+    auto grandparent = Bip32Fingerprint{};
+    const auto seedID = SeedID(seed.Bytes())->str();
+
+    if (false == derive(seedID, seed, parent, true, node, grandparent)) {
+        return output;
+    }
+
+    const auto fingerprint = node.Fingerprint();
+    output.reserve(count);
+
+    for (auto i = Bip32Index{0}; i < count; ++i) {
+        const auto index = first + i;
+
+        if (false == ckd_private(node, index)) { break; }
+
+        auto path{parent};
+        path.emplace_back(index);
+        auto& key = output.emplace_back(
+            OTPassword{}, OTPassword{}, Data::Factory(), path, fingerprint);
+        node.Next();
+        const auto serialized = serialize(curve, node, key);
+        node.Previous();
+
+        if (false == serialized) {
+            output.pop_back();
+
+            break;
         }
     }
 
-    chainCode.setMemory(chainOut.data(), chainOut.size());
+    return output;
+}
+
+auto Bip32::DerivePublicKeys(
+    const EcdsaCurve& curve,
+    const ReadView publicKey,
+    const ReadView chainCode,
+    const Path& parent,
+    const Bip32Index first,
+    const Bip32Index count) const -> std::vector<Key>
+{
+    auto output = std::vector<Key>{};
+
+    if (EcdsaCurve::secp256k1 != curve) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(": Unsupported curve").Flush();
+
+        return output;
+    }
+
+    if ((33 != publicKey.size()) || (32 != chainCode.size())) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(": Invalid parent key").Flush();
+
+        return output;
+    }
+
+    auto node = HDNode{crypto_};
+    std::memcpy(node.InitCode()(32), chainCode.data(), 32);
+    std::memcpy(node.InitPublic()(33), publicKey.data(), 33);
+    const auto fingerprint = node.Fingerprint();
+    output.reserve(count);
+
+    for (auto i = Bip32Index{0}; i < count; ++i) {
+        const auto index = first + i;
+
+        if (false == ckd_public(node, index)) { break; }
+
+        auto path{parent};
+        path.emplace_back(index);
+        auto& [privateOut, codeOut, publicOut, pathOut, parentOut] =
+            output.emplace_back(
+                OTPassword{}, OTPassword{}, Data::Factory(), path, fingerprint);
+        node.Next();
+        const auto code = node.ParentCode();
+        codeOut.setMemory(code.data(), code.size());
+        publicOut->Assign(node.ParentPublic());
+        node.Previous();
+    }
 
     return output;
 }
@@ -394,6 +620,39 @@ auto Bip32::root_node(
         return false;
     }
 }
+
+auto Bip32::serialize(
+    const EcdsaCurve& curve,
+    const HDNode& node,
+    Key& output) const noexcept -> bool
+{
+    auto& [privateKey, chainCode, publicKey, path, parent] = output;
+    const auto privateOut = node.ParentPrivate();
+    const auto chainOut = node.ParentCode();
+    const auto publicOut = node.ParentPublic();
+
+    if (EcdsaCurve::secp256k1 == curve) {
+        privateKey.setMemory(privateOut.data(), privateOut.size());
+        publicKey->Assign(publicOut);
+    } else {
+        const auto expanded = sodium::ExpandSeed(
+            {reinterpret_cast<const char*>(privateOut.data()),
+             privateOut.size()},
+            privateKey.WriteInto(OTPassword::Mode::Mem),
+            publicKey->WriteInto());
+
+        if (false == expanded) {
+            LogOutput(OT_METHOD)(__FUNCTION__)(": Failed to expand seed")
+                .Flush();
+
+            return false;
+        }
+    }
+
+    chainCode.setMemory(chainOut.data(), chainOut.size());
+
+    return true;
+}
 #endif  // OT_CRYPTO_WITH_BIP32
 
 auto Bip32::SeedID(const ReadView entropy) const -> OTIdentifier
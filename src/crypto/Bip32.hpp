@@ -6,7 +6,14 @@
 #pragma once
 
 #include <boost/endian/buffers.hpp>
+#include <cstddef>
+#include <list>
+#include <map>
+#include <mutex>
 #include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 #include "HDNode.hpp"
 #include "opentxs/Bytes.hpp"
@@ -43,6 +50,19 @@ public:
         const EcdsaCurve& curve,
         const OTPassword& seed,
         const Path& path) const final;
+    std::vector<Key> DeriveKeys(
+        const EcdsaCurve& curve,
+        const OTPassword& seed,
+        const Path& parent,
+        const Bip32Index first,
+        const Bip32Index count) const final;
+    std::vector<Key> DerivePublicKeys(
+        const EcdsaCurve& curve,
+        const ReadView publicKey,
+        const ReadView chainCode,
+        const Path& parent,
+        const Bip32Index first,
+        const Bip32Index count) const final;
 #endif  // OT_CRYPTO_WITH_BIP32
     bool DeserializePrivate(
         const std::string& serialized,
@@ -79,7 +99,47 @@ public:
     Bip32(const api::Crypto& crypto) noexcept;
 
 private:
+    // Least recently used extended private nodes, keyed by seed id and
+    // derivation path. Node contents are held in secure memory.
+    class Cache
+    {
+    public:
+        /// Copies the deepest cached node on path into node
+        ///
+        /// Returns the depth of that node, or 0 if none was found
+        auto Load(
+            const std::string& seed,
+            const Path& path,
+            HDNode& node,
+            Bip32Fingerprint& parent) noexcept -> std::size_t;
+        /// Caches the node found at the first depth elements of path
+        auto Store(
+            const std::string& seed,
+            const Path& path,
+            const std::size_t depth,
+            const HDNode& node,
+            const Bip32Fingerprint parent) noexcept -> void;
+
+        Cache(const std::size_t capacity) noexcept;
+
+    private:
+        using Index = std::pair<std::string, Path>;
+        using LRU = std::list<Index>;
+        using Node = std::tuple<OTPassword, Bip32Fingerprint, LRU::iterator>;
+        using Map = std::map<Index, Node>;
+
+        static const std::size_t node_size_;
+
+        const std::size_t capacity_;
+        std::mutex lock_;
+        LRU lru_;
+        Map map_;
+    };
+
     const api::Crypto& crypto_;
+#if OT_CRYPTO_WITH_BIP32
+    mutable Cache cache_;
+#endif  // OT_CRYPTO_WITH_BIP32
 
     static auto IsHard(const Bip32Index) noexcept -> bool;
 
@@ -91,7 +151,26 @@ private:
         const HDNode& node,
         const be::big_uint32_buf_t i,
         const WritableView& data) const noexcept -> void;
+#if OT_CRYPTO_WITH_BIP32
+    /// Writes the child of the parent node into the child node
+    auto ckd_private(HDNode& node, const Bip32Index child) const noexcept
+        -> bool;
+    /// Writes the public key and chain code of a non-hardened child of the
+    /// parent node into the child node without reading the private key
+    auto ckd_public(HDNode& node, const Bip32Index child) const noexcept
+        -> bool;
+#endif  // OT_CRYPTO_WITH_BIP32
     auto decode(const std::string& serialized) const noexcept -> OTData;
+#if OT_CRYPTO_WITH_BIP32
+    /// Leaves the node for path as the parent node
+    auto derive(
+        const std::string& seedID,
+        const OTPassword& seed,
+        const Path& path,
+        const bool cacheTarget,
+        HDNode& node,
+        Bip32Fingerprint& parent) const noexcept -> bool;
+#endif  // OT_CRYPTO_WITH_BIP32
     auto extract(
         const Data& input,
         Bip32Network& network,
@@ -108,6 +187,8 @@ private:
         const AllocateOutput privateKey,
         const AllocateOutput code,
         const AllocateOutput publicKey) const noexcept -> bool;
+    auto serialize(const EcdsaCurve& curve, const HDNode& node, Key& output)
+        const noexcept -> bool;
 #endif  // OT_CRYPTO_WITH_BIP32
 
     Bip32() = delete;
@@ -98,6 +98,13 @@ auto HDNode::InitPublic() noexcept -> AllocateOutput
 
 auto HDNode::Next() noexcept -> void { ++switch_; }
 
+auto HDNode::Previous() noexcept -> void
+{
+    OT_ASSERT(0 < switch_);
+
+    --switch_;
+}
+
 auto HDNode::parent() const noexcept -> const OTPassword&
 {
     return (0 == (switch_ % 2)) ? a_ : b_;
@@ -42,6 +42,8 @@ public:
     auto InitPublic() noexcept -> AllocateOutput;
 
     auto Next() noexcept -> void;
+    /// Undoes the most recent call to Next
+    auto Previous() noexcept -> void;
 
     HDNode(const api::Crypto& crypto) noexcept;
 
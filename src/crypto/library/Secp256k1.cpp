@@ -57,6 +57,61 @@ Secp256k1::Secp256k1(const api::Crypto& crypto, const api::crypto::Util& ssl)
 {
 }
 
+bool Secp256k1::PubkeyAdd(
+    const ReadView pubkey,
+    const ReadView scalar,
+    const AllocateOutput result) const noexcept
+{
+    if (false == bool(result)) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(": Invalid output allocator")
+            .Flush();
+
+        return false;
+    }
+
+    if (PrivateKeySize != scalar.size()) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(": Invalid scalar").Flush();
+
+        return false;
+    }
+
+    try {
+        auto key = parsed_public_key(pubkey);
+
+        if (1 != ::secp256k1_ec_pubkey_tweak_add(
+                     context_,
+                     &key,
+                     reinterpret_cast<const unsigned char*>(scalar.data()))) {
+            LogOutput(OT_METHOD)(__FUNCTION__)(": Invalid tweak").Flush();
+
+            return false;
+        }
+
+        auto pub = result(PublicKeySize);
+
+        if (false == pub.valid(PublicKeySize)) {
+            LogOutput(OT_METHOD)(__FUNCTION__)(
+                ": Failed to allocate space for public key")
+                .Flush();
+
+            return false;
+        }
+
+        auto size{pub.size()};
+
+        return 1 == ::secp256k1_ec_pubkey_serialize(
+                        context_,
+                        pub.as<unsigned char>(),
+                        &size,
+                        &key,
+                        SECP256K1_EC_COMPRESSED);
+    } catch (const std::exception& e) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(": ")(e.what()).Flush();
+
+        return false;
+    }
+}
+
 bool Secp256k1::RandomKeypair(
     const AllocateOutput privateKey,
     const AllocateOutput publicKey,
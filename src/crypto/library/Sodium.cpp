@@ -336,6 +336,16 @@ std::size_t Sodium::KeySize(const proto::SymmetricMode mode) const
 }
 
 #if OT_CRYPTO_SUPPORTED_KEY_ED25519
+bool Sodium::PubkeyAdd(
+    const ReadView,
+    const ReadView,
+    const AllocateOutput) const noexcept
+{
+    LogOutput(OT_METHOD)(__FUNCTION__)(": Not supported for ed25519").Flush();
+
+    return false;
+}
+
 bool Sodium::RandomKeypair(
     const AllocateOutput privateKey,
     const AllocateOutput publicKey,
@@ -55,6 +55,8 @@ namespace opentxs::api::client::blockchain
 using Address = opentxs::blockchain::p2p::internal::Address;
 using Address_p = std::unique_ptr<Address>;
 using Chain = opentxs::blockchain::Type;
+using FilterCallback =
+    opentxs::blockchain::client::internal::FilterDatabase::FilterCallback;
 using FilterData =
     opentxs::blockchain::client::internal::FilterDatabase::Filter;
 using FilterHash = opentxs::blockchain::client::internal::FilterDatabase::Hash;
@@ -166,6 +168,12 @@ struct BalanceTree : virtual public blockchain::BalanceTree {
 
 struct Deterministic : virtual public blockchain::Deterministic,
                        virtual public BalanceNode {
+#if OT_BLOCKCHAIN
+    static void ProcessTask(const zmq::Message& task) noexcept;
+#endif  // OT_BLOCKCHAIN
+
+    /// Derives any keys missing from the lookahead window of the subchain
+    virtual void GenerateLookahead(const Subchain type) const noexcept = 0;
 };
 
 struct HD : virtual public blockchain::HD, virtual public Deterministic {
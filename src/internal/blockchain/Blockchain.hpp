@@ -7,11 +7,14 @@
 
 #include <boost/endian/buffers.hpp>
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <iosfwd>
+#include <stdexcept>
 #include <string>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 #include "internal/blockchain/client/Client.hpp"
@@ -27,6 +30,14 @@ namespace api
 {
 class Core;
 }  // namespace api
+
+namespace blockchain
+{
+namespace internal
+{
+class SipHash;
+}  // namespace internal
+}  // namespace blockchain
 }  // namespace opentxs
 
 namespace be = boost::endian;
@@ -52,6 +63,10 @@ OPENTXS_EXPORT auto HashedSetConstruct(
     const std::uint32_t M,
     const std::vector<ReadView> items) noexcept(false)
     -> std::vector<std::uint64_t>;
+OPENTXS_EXPORT auto HashedSetConstruct(
+    const blockchain::internal::SipHash& hasher,
+    const std::uint64_t range,
+    const std::vector<ReadView>& items) noexcept -> std::vector<std::uint64_t>;
 }  // namespace opentxs::gcs
 
 namespace opentxs::blockchain::internal
@@ -65,17 +80,24 @@ class BitReader
 public:
     OPENTXS_EXPORT bool eof();
     OPENTXS_EXPORT std::uint64_t read(std::size_t nbits);
+    /// Count and consume 1 bits up to and including the next 0 bit
+    OPENTXS_EXPORT std::uint64_t unary();
 
     OPENTXS_EXPORT BitReader(const Space& data);
     OPENTXS_EXPORT BitReader(std::uint8_t* data, int len);
+    /// Does not copy the input, which must outlive the reader
+    OPENTXS_EXPORT BitReader(const ReadView data);
 
 private:
     OTData raw_data_;
-    std::uint8_t* data_{nullptr};
+    const std::uint8_t* data_{nullptr};
     std::size_t len_{};
+    // Unread bits are stored left-aligned
     std::uint64_t accum_{};
     std::size_t n_{};
 
+    void refill() noexcept;
+
     BitReader() = delete;
     BitReader(const BitReader&) = delete;
     BitReader(BitReader&&) = delete;
@@ -105,16 +127,356 @@ private:
     BitWriter() = delete;
 };
 
+// Unsigned 256 bit integer stored as four 64 bit limbs, least significant limb
+// first. Arithmetic wraps modulo 2^256. Used for targets, hashes and chain
+// work so that comparisons and additions never allocate.
+class UInt256
+{
+public:
+    using Limbs = std::array<std::uint64_t, 4>;
+
+    static constexpr auto bits_ = std::size_t{256};
+
+    /// Interprets bytes as a big endian number, or throws if it is too large
+    OPENTXS_EXPORT static auto BigEndian(const ReadView bytes) noexcept(false)
+        -> UInt256;
+    /// Returns quotient and remainder, or throws if divisor is zero
+    static constexpr auto Divide(
+        const UInt256& dividend,
+        const UInt256& divisor) noexcept(false) -> std::pair<UInt256, UInt256>
+    {
+        if (divisor.IsZero()) { throw std::domain_error("Division by zero"); }
+
+        if (dividend < divisor) { return {UInt256{}, dividend}; }
+
+        if (divisor.Bits() <= 64) { return dividend.DivMod(divisor.limbs_[0]); }
+
+        auto quotient = UInt256{};
+        auto remainder = UInt256{};
+
+        for (auto i = dividend.Bits(); i > 0; --i) {
+            const auto bit = i - 1;
+            const auto carry = remainder.Bit(bits_ - 1);
+            remainder = remainder << 1;
+
+            if (dividend.Bit(bit)) { remainder.limbs_[0] |= 1u; }
+
+            if (carry || (remainder >= divisor)) {
+                remainder = remainder - divisor;
+                quotient.limbs_[bit / 64] |= std::uint64_t{1} << (bit % 64);
+            }
+        }
+
+        return {quotient, remainder};
+    }
+    /// Interprets bytes as a little endian number, or throws if it is too
+    /// large
+    OPENTXS_EXPORT static auto LittleEndian(const ReadView bytes) noexcept(
+        false) -> UInt256;
+
+    constexpr auto operator==(const UInt256& rhs) const noexcept -> bool
+    {
+        return compare(rhs) == 0;
+    }
+    constexpr auto operator!=(const UInt256& rhs) const noexcept -> bool
+    {
+        return compare(rhs) != 0;
+    }
+    constexpr auto operator<(const UInt256& rhs) const noexcept -> bool
+    {
+        return compare(rhs) < 0;
+    }
+    constexpr auto operator<=(const UInt256& rhs) const noexcept -> bool
+    {
+        return compare(rhs) <= 0;
+    }
+    constexpr auto operator>(const UInt256& rhs) const noexcept -> bool
+    {
+        return compare(rhs) > 0;
+    }
+    constexpr auto operator>=(const UInt256& rhs) const noexcept -> bool
+    {
+        return compare(rhs) >= 0;
+    }
+    constexpr auto operator+(const UInt256& rhs) const noexcept -> UInt256
+    {
+        auto output = Limbs{};
+        auto carry = std::uint64_t{0};
+
+        for (auto i = std::size_t{0}; i < limbs_.size(); ++i) {
+            const auto sum = limbs_[i] + rhs.limbs_[i];
+            output[i] = sum + carry;
+            carry = ((sum < limbs_[i]) || (output[i] < sum)) ? 1u : 0u;
+        }
+
+        return UInt256{output};
+    }
+    constexpr auto operator-(const UInt256& rhs) const noexcept -> UInt256
+    {
+        auto output = Limbs{};
+        auto borrow = std::uint64_t{0};
+
+        for (auto i = std::size_t{0}; i < limbs_.size(); ++i) {
+            const auto difference = limbs_[i] - rhs.limbs_[i];
+            output[i] = difference - borrow;
+            borrow = ((limbs_[i] < rhs.limbs_[i]) || (difference < borrow))
+                         ? 1u
+                         : 0u;
+        }
+
+        return UInt256{output};
+    }
+    constexpr auto operator*(const std::uint64_t rhs) const noexcept -> UInt256
+    {
+        auto output = Limbs{};
+        auto carry = std::uint64_t{0};
+
+        for (auto i = std::size_t{0}; i < limbs_.size(); ++i) {
+            auto high = std::uint64_t{0};
+            const auto low = multiply(limbs_[i], rhs, high);
+            output[i] = low + carry;
+            carry = high + ((output[i] < low) ? 1u : 0u);
+        }
+
+        return UInt256{output};
+    }
+    constexpr auto operator<<(const std::size_t shift) const noexcept
+        -> UInt256
+    {
+        if (shift >= bits_) { return UInt256{}; }
+
+        const auto words = shift / 64;
+        const auto bits = shift % 64;
+        auto output = Limbs{};
+
+        for (auto i = limbs_.size(); i > words; --i) {
+            const auto target = i - 1;
+            const auto source = target - words;
+            output[target] = limbs_[source] << bits;
+
+            if ((0 < bits) && (0 < source)) {
+                output[target] |= limbs_[source - 1] >> (64 - bits);
+            }
+        }
+
+        return UInt256{output};
+    }
+    constexpr auto operator>>(const std::size_t shift) const noexcept
+        -> UInt256
+    {
+        if (shift >= bits_) { return UInt256{}; }
+
+        const auto words = shift / 64;
+        const auto bits = shift % 64;
+        auto output = Limbs{};
+
+        for (auto i = std::size_t{0}; (i + words) < limbs_.size(); ++i) {
+            const auto source = i + words;
+            output[i] = limbs_[source] >> bits;
+
+            if ((0 < bits) && ((source + 1) < limbs_.size())) {
+                output[i] |= limbs_[source + 1] << (64 - bits);
+            }
+        }
+
+        return UInt256{output};
+    }
+
+    constexpr auto Bit(const std::size_t position) const noexcept -> bool
+    {
+        if (position >= bits_) { return false; }
+
+        return 0 != ((limbs_[position / 64] >> (position % 64)) & 1u);
+    }
+    /// Number of significant bits
+    constexpr auto Bits() const noexcept -> std::size_t
+    {
+        for (auto i = limbs_.size(); i > 0; --i) {
+            auto limb = limbs_[i - 1];
+
+            if (0 == limb) { continue; }
+
+            auto output = (i - 1) * 64;
+
+            while (0 != limb) {
+                ++output;
+                limb >>= 1;
+            }
+
+            return output;
+        }
+
+        return 0;
+    }
+    OPENTXS_EXPORT auto Decimal() const noexcept -> std::string;
+    /// Returns quotient and remainder, or throws if divisor is zero
+    constexpr auto DivMod(const std::uint64_t divisor) const noexcept(false)
+        -> std::pair<UInt256, UInt256>
+    {
+        if (0 == divisor) { throw std::domain_error("Division by zero"); }
+
+        auto output = Limbs{};
+        auto remainder = std::uint64_t{0};
+
+        for (auto i = limbs_.size(); i > 0; --i) {
+            const auto index = i - 1;
+            output[index] =
+                divide(remainder, limbs_[index], divisor, remainder);
+        }
+
+        return {UInt256{output}, UInt256{remainder}};
+    }
+    /// Minimal big endian encoding, zero padded to at least minimumBytes
+    OPENTXS_EXPORT auto Encode(const std::size_t minimumBytes = 1) const
+        noexcept -> Space;
+    constexpr auto IsZero() const noexcept -> bool
+    {
+        return (0 == limbs_[0]) && (0 == limbs_[1]) && (0 == limbs_[2]) &&
+               (0 == limbs_[3]);
+    }
+    constexpr auto Limb(const std::size_t index) const noexcept
+        -> std::uint64_t
+    {
+        return (index < limbs_.size()) ? limbs_[index] : 0u;
+    }
+
+    constexpr UInt256(const std::uint64_t value = 0) noexcept
+        : limbs_{value, 0, 0, 0}
+    {
+    }
+    constexpr UInt256(const Limbs& limbs) noexcept
+        : limbs_(limbs)
+    {
+    }
+
+private:
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 Wide;
+#endif
+
+    Limbs limbs_;
+
+    /// Divides (high:low) by divisor. high must be less than divisor.
+    static constexpr auto divide(
+        const std::uint64_t high,
+        const std::uint64_t low,
+        const std::uint64_t divisor,
+        std::uint64_t& remainder) noexcept -> std::uint64_t
+    {
+#if defined(__SIZEOF_INT128__)
+        const auto dividend = (Wide{high} << 64) | low;
+        remainder = static_cast<std::uint64_t>(dividend % divisor);
+
+        return static_cast<std::uint64_t>(dividend / divisor);
+#else
+        auto quotient = std::uint64_t{0};
+        auto rem = high;
+
+        for (auto i = 64; i > 0; --i) {
+            const auto carry = 0 != (rem >> 63);
+            rem = (rem << 1) | ((low >> (i - 1)) & 1u);
+
+            if (carry || (rem >= divisor)) {
+                rem -= divisor;
+                quotient |= std::uint64_t{1} << (i - 1);
+            }
+        }
+
+        remainder = rem;
+
+        return quotient;
+#endif
+    }
+    static constexpr auto multiply(
+        const std::uint64_t lhs,
+        const std::uint64_t rhs,
+        std::uint64_t& high) noexcept -> std::uint64_t
+    {
+#if defined(__SIZEOF_INT128__)
+        const auto product = Wide{lhs} * rhs;
+        high = static_cast<std::uint64_t>(product >> 64);
+
+        return static_cast<std::uint64_t>(product);
+#else
+        constexpr auto mask = std::uint64_t{0xffffffff};
+        const auto ll = (lhs & mask) * (rhs & mask);
+        const auto lh = (lhs & mask) * (rhs >> 32);
+        const auto hl = (lhs >> 32) * (rhs & mask);
+        const auto hh = (lhs >> 32) * (rhs >> 32);
+        const auto middle = (ll >> 32) + (lh & mask) + (hl & mask);
+        high = hh + (lh >> 32) + (hl >> 32) + (middle >> 32);
+
+        return (middle << 32) | (ll & mask);
+#endif
+    }
+
+    constexpr auto compare(const UInt256& rhs) const noexcept -> int
+    {
+        for (auto i = limbs_.size(); i > 0; --i) {
+            const auto& lhs = limbs_[i - 1];
+            const auto& other = rhs.limbs_[i - 1];
+
+            if (lhs < other) { return -1; }
+
+            if (lhs > other) { return 1; }
+        }
+
+        return 0;
+    }
+};
+
+// SipHash-2-4 keyed with a single 128 bit key. The batch interface hashes
+// many items with the same key, using multiple SIMD lanes when the cpu
+// supports them.
+class SipHash
+{
+public:
+    enum class Lanes : std::uint8_t {
+        Scalar = 1,
+        SSE2 = 2,
+        AVX2 = 4,
+    };
+
+    using Hashes = std::vector<std::uint64_t>;
+
+    /// Fastest lane configuration for the current cpu
+    OPENTXS_EXPORT static auto Best() noexcept -> Lanes;
+
+    OPENTXS_EXPORT auto operator()(const ReadView item) const noexcept
+        -> std::uint64_t;
+    OPENTXS_EXPORT auto Batch(const std::vector<ReadView>& items) const
+        noexcept -> Hashes;
+    /// Lanes wider than the cpu supports are clamped
+    OPENTXS_EXPORT auto Batch(
+        const std::vector<ReadView>& items,
+        const Lanes lanes) const noexcept -> Hashes;
+
+    OPENTXS_EXPORT SipHash(const ReadView key) noexcept(false);
+    OPENTXS_EXPORT SipHash(const SipHash&) noexcept = default;
+
+private:
+    std::uint64_t k0_;
+    std::uint64_t k1_;
+
+    SipHash() = delete;
+    SipHash(SipHash&&) = delete;
+    SipHash& operator=(const SipHash&) = delete;
+    SipHash& operator=(SipHash&&) = delete;
+};
+
 struct GCS {
     using Targets = std::vector<ReadView>;
     using Matches = std::vector<Targets::const_iterator>;
 
     virtual auto Compressed() const noexcept -> Space = 0;
+    virtual auto CompressedSize() const noexcept -> std::size_t = 0;
     virtual auto ElementCount() const noexcept -> std::uint32_t = 0;
     virtual auto Encode() const noexcept -> OTData = 0;
     virtual auto Hash() const noexcept -> OTData = 0;
     virtual auto Match(const Targets&) const noexcept -> Matches = 0;
     virtual auto Serialize() const noexcept -> proto::GCS = 0;
+    /// Writes a SerializedFilter header followed by the compressed filter
+    virtual auto Serialize(AllocateOutput out) const noexcept -> bool = 0;
     virtual auto Test(const Data& target) const noexcept -> bool = 0;
     virtual auto Test(const ReadView target) const noexcept -> bool = 0;
     virtual auto Test(const std::vector<OTData>& targets) const noexcept
@@ -125,6 +487,35 @@ struct GCS {
     virtual ~GCS() = default;
 };
 
+// Fixed layout of the records in the block filter tables. The compressed
+// filter follows immediately after this header so a filter can be matched in
+// place without parsing or copying.
+struct SerializedFilter {
+    static constexpr auto current_version_ = std::uint8_t{1};
+
+    be::little_uint8_buf_t version_;
+    be::little_uint8_buf_t bits_;
+    be::little_uint32_buf_t fp_rate_;
+    be::little_uint32_buf_t count_;
+    std::array<std::byte, 16> key_;
+
+    /// Returns the compressed filter, or throws if record has the wrong format
+    static auto Filter(const ReadView record) noexcept(false) -> ReadView;
+    /// Returns the header, or throws if record has the wrong format
+    static auto Header(const ReadView record) noexcept(false)
+        -> const SerializedFilter&;
+    static auto Valid(const ReadView record) noexcept -> bool;
+
+    auto Key() const noexcept -> ReadView;
+
+    SerializedFilter(
+        const std::uint8_t bits,
+        const std::uint32_t fpRate,
+        const std::uint32_t count,
+        const ReadView key) noexcept(false);
+    SerializedFilter() noexcept;
+};
+
 struct SerializedBloomFilter {
     be::little_uint32_buf_t function_count_;
     be::little_uint32_buf_t tweak_;
@@ -142,6 +533,11 @@ struct Database : virtual public client::internal::BlockDatabase,
                   virtual public client::internal::HeaderDatabase,
                   virtual public client::internal::PeerDatabase,
                   virtual public client::internal::WalletDatabase {
+    /// Directory to write bootstrap files to in the background after
+    /// startup, or empty
+    virtual auto BootstrapExport() const noexcept -> const std::string& = 0;
+    /// Directory to read bootstrap files from at startup, or empty
+    virtual auto BootstrapImport() const noexcept -> const std::string& = 0;
 
     virtual ~Database() = default;
 };
@@ -176,4 +572,44 @@ auto Ticker(const Type chain) noexcept -> std::string;
 
 namespace opentxs::blockchain::script
 {
+// Byte layout of a standard output script which contains exactly one data
+// push. The script is the prefix opcodes, a patch slot for the pushed key or
+// hash, then the suffix opcodes, so it can be written directly into an
+// existing buffer without constructing a Script object.
+struct Template {
+    /// Size of the largest script produced by any template
+    static constexpr auto max_size_ = std::size_t{67};
+
+    std::array<std::uint8_t, 3> prefix_;
+    std::size_t prefix_size_;
+    std::size_t payload_size_;
+    std::array<std::uint8_t, 2> suffix_;
+    std::size_t suffix_size_;
+
+    constexpr auto Size() const noexcept -> std::size_t
+    {
+        return prefix_size_ + payload_size_ + suffix_size_;
+    }
+    /// Returns false if payload does not fit the patch slot
+    OPENTXS_EXPORT auto Write(
+        const ReadView payload,
+        const AllocateOutput output) const noexcept -> bool;
+    /// Writes Size() bytes to output, which must be large enough
+    OPENTXS_EXPORT auto Write(const ReadView payload, std::uint8_t* output)
+        const noexcept -> bool;
+};
+
+// <33 byte pubkey> CHECKSIG
+constexpr auto P2PK_compressed = Template{{0x21}, 1, 33, {0xac}, 1};
+// <65 byte pubkey> CHECKSIG
+constexpr auto P2PK_uncompressed = Template{{0x41}, 1, 65, {0xac}, 1};
+// DUP HASH160 <20 byte hash> EQUALVERIFY CHECKSIG
+constexpr auto P2PKH = Template{{0x76, 0xa9, 0x14}, 3, 20, {0x88, 0xac}, 2};
+// HASH160 <20 byte hash> EQUAL
+constexpr auto P2SH = Template{{0xa9, 0x14}, 2, 20, {0x87}, 1};
+// 0 <20 byte hash>
+constexpr auto P2WPKH = Template{{0x00, 0x14}, 2, 20, {}, 0};
+
+/// Selects the P2PK layout which matches the size of the public key
+OPENTXS_EXPORT auto P2PK(const ReadView pubkey) noexcept -> const Template&;
 }  // namespace opentxs::blockchain::script
@@ -5,10 +5,20 @@
 
 #pragma once
 
+#include <boost/endian/buffers.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "opentxs/Bytes.hpp"
 #include "opentxs/blockchain/Blockchain.hpp"
+#include "opentxs/blockchain/Work.hpp"
 #include "opentxs/blockchain/block/Block.hpp"
+#include "opentxs/blockchain/block/Header.hpp"
 #include "opentxs/blockchain/block/bitcoin/Header.hpp"
 
+namespace be = boost::endian;
+
 namespace opentxs::blockchain::block
 {
 auto SetIntersection(
@@ -18,6 +28,91 @@ auto SetIntersection(
     const std::vector<Space>& compare) noexcept -> Block::Matches;
 }  // namespace opentxs::blockchain::block
 
+namespace opentxs::blockchain::block::internal
+{
+// Fixed layout of the records in the block header metadata table. The raw
+// header is stored next to the locally calculated metadata so a record can be
+// read in place without parsing. The block hash is the key of the record and
+// is never recalculated when loading.
+struct SerializedHeader {
+    static constexpr auto current_version_ = std::uint8_t{1};
+
+    be::little_uint8_buf_t version_;
+    be::little_uint8_buf_t status_;
+    be::little_uint8_buf_t inherit_status_;
+    be::little_uint8_buf_t reserved_;
+    be::little_uint32_buf_t type_;
+    be::little_int64_buf_t height_;
+    // Work values are big endian fixed point numbers
+    std::array<std::byte, 32> work_;
+    std::array<std::byte, 32> inherit_work_;
+    std::array<std::byte, 80> raw_;
+
+    /// Returns the record, or throws if it has the wrong format
+    OPENTXS_EXPORT static auto Read(const ReadView record) noexcept(false)
+        -> const SerializedHeader&;
+    OPENTXS_EXPORT static auto Valid(const ReadView record) noexcept -> bool;
+
+    auto Chain() const noexcept -> blockchain::Type
+    {
+        return static_cast<blockchain::Type>(type_.value());
+    }
+    OPENTXS_EXPORT auto Difficulty() const noexcept -> OTWork;
+    auto Height() const noexcept -> block::Height { return height_.value(); }
+    auto InheritedState() const noexcept -> block::Header::Status
+    {
+        return static_cast<block::Header::Status>(inherit_status_.value());
+    }
+    auto LocalState() const noexcept -> block::Header::Status
+    {
+        return static_cast<block::Header::Status>(status_.value());
+    }
+    OPENTXS_EXPORT auto ParentHash() const noexcept -> ReadView;
+    OPENTXS_EXPORT auto ParentWork() const noexcept -> OTWork;
+    OPENTXS_EXPORT auto Raw() const noexcept -> ReadView;
+
+    /// Throws if the header type does not have an 80 byte encoding
+    OPENTXS_EXPORT SerializedHeader(const block::Header& header) noexcept(
+        false);
+    OPENTXS_EXPORT SerializedHeader() noexcept;
+
+private:
+    using WorkBytes = std::array<std::byte, 32>;
+
+    static auto decode(const WorkBytes& in) noexcept -> OTWork;
+    static auto encode(const blockchain::Work& in, WorkBytes& out) noexcept
+        -> void;
+};
+
+// Copy of a stored header record and its hash which provides the fields used
+// to walk the chain without constructing a block::Header
+class HeaderView
+{
+public:
+    auto Hash() const noexcept -> ReadView
+    {
+        return {reinterpret_cast<const char*>(hash_.data()), hash_.size()};
+    }
+    auto Height() const noexcept -> block::Height { return record_.Height(); }
+    auto ParentHash() const noexcept -> ReadView
+    {
+        return record_.ParentHash();
+    }
+    auto Record() const noexcept -> const SerializedHeader& { return record_; }
+    /// Cumulative work including this block
+    OPENTXS_EXPORT auto Work() const noexcept -> OTWork;
+
+    /// Throws if hash has the wrong size
+    OPENTXS_EXPORT HeaderView(
+        const ReadView hash,
+        const SerializedHeader& record) noexcept(false);
+
+private:
+    std::array<std::byte, 32> hash_;
+    SerializedHeader record_;
+};
+}  // namespace opentxs::blockchain::block::internal
+
 namespace opentxs::blockchain::block::bitcoin::internal
 {
 auto Opcode(const OP opcode) noexcept(false) -> ScriptElement;
@@ -7,7 +7,10 @@
 
 #include <boost/asio.hpp>
 #include <boost/thread/thread.hpp>
+#include <condition_variable>
+#include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <future>
 #include <iosfwd>
 #include <map>
@@ -22,6 +25,7 @@
 #include <vector>
 
 #include "1_Internal.hpp"
+#include "internal/blockchain/block/Block.hpp"
 #include "internal/core/Core.hpp"
 #if OT_BLOCKCHAIN
 #include "opentxs/Bytes.hpp"
@@ -118,6 +122,7 @@ class Frame;
 namespace socket
 {
 class Publish;
+class Push;
 }  // namespace socket
 }  // namespace zeromq
 }  // namespace network
@@ -157,6 +162,15 @@ enum class BlockStorage : std::uint8_t {
     Cache = 1,
     All = 2,
 };
+
+enum class FilterSource : std::uint8_t {
+    // Download filters and filter headers from peers
+    Peers = 0,
+    // Download from peers, then check each filter against its block
+    Verify = 1,
+    // Build filters and filter headers from blocks
+    Local = 2,
+};
 }  // namespace opentxs::api::client::blockchain
 
 namespace opentxs::blockchain::client
@@ -177,6 +191,8 @@ namespace opentxs::blockchain::client::internal
 {
 #if OT_BLOCKCHAIN
 struct BlockDatabase {
+    /// Memory budget in bytes for blocks cached by the block oracle
+    virtual auto BlockCacheSize() const noexcept -> std::size_t = 0;
     virtual auto BlockExists(const block::Hash& block) const noexcept
         -> bool = 0;
     virtual auto BlockLoadBitcoin(const block::Hash& block) const noexcept
@@ -185,6 +201,8 @@ struct BlockDatabase {
         -> api::client::blockchain::BlockStorage = 0;
     virtual auto BlockStore(const block::Block& block) const noexcept
         -> bool = 0;
+    /// Memory budget in bytes for unconfirmed transactions
+    virtual auto MempoolSize() const noexcept -> std::size_t = 0;
 
     virtual ~BlockDatabase() = default;
 };
@@ -196,7 +214,22 @@ struct BlockOracle : virtual public opentxs::blockchain::client::BlockOracle {
         Shutdown = OT_ZMQ_SHUTDOWN_SIGNAL,
     };
 
+    /// Hint that the blocks will be requested soon, in the order given. The
+    /// oracle downloads as many of them as fit in the cache budget.
+    virtual auto Prefetch(const std::vector<block::pHash>& blocks) const
+        noexcept -> void = 0;
+    /// Record a BIP152 compact block which could not be reconstructed.
+    /// received is the number of payload bytes downloaded for it.
+    virtual auto CompactBlockFailed(const std::size_t received) const noexcept
+        -> void = 0;
     virtual auto SubmitBlock(const zmq::Frame& in) const noexcept -> void = 0;
+    /// Submit a block reconstructed from a BIP152 compact block. received is
+    /// the number of payload bytes downloaded to reconstruct it and roundTrip
+    /// is true if missing transactions were requested with getblocktxn.
+    virtual auto SubmitCompactBlock(
+        const ReadView block,
+        const std::size_t received,
+        const bool roundTrip) const noexcept -> void = 0;
 
     virtual auto Init() noexcept -> void = 0;
     virtual auto Run() noexcept -> void = 0;
@@ -211,11 +244,21 @@ struct FilterDatabase {
     using Header = std::tuple<block::pHash, block::pHash, ReadView>;
     using Filter =
         std::pair<ReadView, std::unique_ptr<const blockchain::internal::GCS>>;
+    /// The filter is only valid for the duration of the callback
+    using FilterCallback =
+        std::function<void(const blockchain::internal::GCS& filter)>;
 
+    /// Memory budget in bytes for filters cached by the filter oracle
+    virtual auto FilterCacheSize() const noexcept -> std::size_t = 0;
     virtual auto FilterHeaderTip(const filter::Type type) const noexcept
         -> block::Position = 0;
+    virtual auto FilterPolicy() const noexcept
+        -> api::client::blockchain::FilterSource = 0;
     virtual auto FilterTip(const filter::Type type) const noexcept
         -> block::Position = 0;
+    /// Highest filter which has been checked against its block
+    virtual auto FilterVerifiedTip(const filter::Type type) const noexcept
+        -> block::Position = 0;
     virtual auto HaveFilter(const filter::Type type, const block::Hash& block)
         const noexcept -> bool = 0;
     virtual auto HaveFilterHeader(
@@ -227,12 +270,20 @@ struct FilterDatabase {
         const noexcept -> Hash = 0;
     virtual auto LoadFilterHeader(const filter::Type type, const ReadView block)
         const noexcept -> Hash = 0;
+    /// Matches the stored filter in place without copying it
+    virtual auto ReadFilter(
+        const filter::Type type,
+        const ReadView block,
+        const FilterCallback& cb) const noexcept -> bool = 0;
     virtual auto SetFilterHeaderTip(
         const filter::Type type,
         const block::Position position) const noexcept -> bool = 0;
     virtual auto SetFilterTip(
         const filter::Type type,
         const block::Position position) const noexcept -> bool = 0;
+    virtual auto SetFilterVerifiedTip(
+        const filter::Type type,
+        const block::Position position) const noexcept -> bool = 0;
     virtual auto StoreFilters(
         const filter::Type type,
         std::vector<Filter> filters) const noexcept -> bool = 0;
@@ -245,12 +296,33 @@ struct FilterDatabase {
 };
 
 struct FilterOracle {
+    /// hits, misses
+    using CacheStatistics = std::pair<std::size_t, std::size_t>;
+
+    virtual auto AddCheckpoints(zmq::Message& work) const noexcept
+        -> void = 0;
     virtual auto AddFilter(zmq::Message& work) const noexcept -> void = 0;
     virtual auto AddHeaders(zmq::Message& work) const noexcept -> void = 0;
+    virtual auto CacheStats() const noexcept -> CacheStatistics = 0;
     virtual auto CheckBlocks() const noexcept -> void = 0;
     virtual auto DefaultType() const noexcept -> filter::Type = 0;
-    virtual auto LoadFilter(const filter::Type type, const block::Hash& block)
-        const noexcept -> std::unique_ptr<const blockchain::internal::GCS> = 0;
+    /// The height of the block determines when a cached filter is discarded
+    /// after a reorg
+    virtual auto LoadFilter(
+        const filter::Type type,
+        const block::Height height,
+        const block::Hash& block) const noexcept
+        -> std::shared_ptr<const blockchain::internal::GCS> = 0;
+    /// Returns false if the filter is not available
+    virtual auto ReadFilter(
+        const filter::Type type,
+        const block::Height height,
+        const block::Hash& block,
+        const FilterDatabase::FilterCallback& cb) const noexcept -> bool = 0;
+    /// Height of the highest filter the wallet may scan. When filters are
+    /// verified against their blocks this does not exceed the verified tip.
+    virtual auto ScanTip(const filter::Type type) const noexcept
+        -> block::Height = 0;
 
     virtual auto Start() noexcept -> void = 0;
     virtual auto Shutdown() noexcept -> std::shared_future<void> = 0;
@@ -259,6 +331,10 @@ struct FilterOracle {
 };
 
 struct HeaderOracle : virtual public opentxs::blockchain::client::HeaderOracle {
+    // Returns an empty optional if the header does not exist
+    virtual auto LoadHeaderView(const ReadView hash) const noexcept
+        -> std::optional<block::internal::HeaderView> = 0;
+
     virtual ~HeaderOracle() = default;
 };
 
@@ -279,6 +355,9 @@ struct HeaderDatabase {
     // Throws std::out_of_range if the header does not exist
     virtual std::unique_ptr<block::Header> LoadHeader(
         const block::Hash& hash) const noexcept(false) = 0;
+    // Returns an empty optional if the header does not exist
+    virtual std::optional<block::internal::HeaderView> LoadHeaderView(
+        const ReadView hash) const noexcept = 0;
     virtual std::vector<block::pHash> RecentHashes() const noexcept = 0;
     virtual Hashes SiblingHashes() const noexcept = 0;
     // Returns null pointer if the header does not exist
@@ -333,16 +412,45 @@ private:
     IO& operator=(IO&&) = delete;
 };
 
+// Unconfirmed transactions received from peers. The pool holds as many
+// transactions as fit in the memory budget and evicts the oldest first.
+// Transactions which have been in the pool for too long are also removed.
+struct Mempool {
+    using Transaction = std::shared_ptr<const block::bitcoin::Transaction>;
+    using Transactions = std::vector<Transaction>;
+
+    /// Returns every transaction added after the sequence number and updates
+    /// it to the newest transaction
+    virtual auto Dump(std::size_t& sequence) const noexcept
+        -> Transactions = 0;
+    /// Removes transactions which were confirmed in the block or which spend
+    /// an outpoint the block also spends. The block must be in the best chain.
+    virtual auto Prune(const block::bitcoin::Block& block) const noexcept
+        -> void = 0;
+    /// Returns false if the transaction is already in the pool or was
+    /// recently requested from another peer
+    virtual auto Request(const block::Txid& txid) const noexcept -> bool = 0;
+    /// Returns false if the transaction is already in the pool
+    virtual auto Submit(Transaction transaction) const noexcept -> bool = 0;
+
+    virtual ~Mempool() = default;
+};
+
 struct Network : virtual public opentxs::blockchain::Network {
     enum class Task : OTZMQWorkType {
         SubmitBlockHeader = 0,
         SubmitFilterHeader = 1,
         SubmitFilter = 2,
         SubmitBlock = 3,
+        SubmitFilterCheckpoints = 4,
+        SubmitTransaction = 5,
         StateMachine = OT_ZMQ_STATE_MACHINE_SIGNAL,
         Shutdown = OT_ZMQ_SHUTDOWN_SIGNAL,
     };
 
+    /// Executed by the thread pool
+    static auto ProcessTask(const zmq::Message& task) noexcept -> void;
+
     virtual auto API() const noexcept -> const api::internal::Core& = 0;
     virtual auto Blockchain() const noexcept
         -> const api::client::internal::Blockchain& = 0;
@@ -350,15 +458,21 @@ struct Network : virtual public opentxs::blockchain::Network {
         -> const internal::BlockOracle& = 0;
     virtual auto Chain() const noexcept -> Type = 0;
     virtual auto DB() const noexcept -> blockchain::internal::Database& = 0;
+    /// Drops a peer which sent invalid data
+    virtual auto DisconnectPeer(const int peer) const noexcept -> void = 0;
     virtual auto FilterOracle() const noexcept
         -> const internal::FilterOracle& = 0;
     virtual auto HeaderOracle() const noexcept
         -> const internal::HeaderOracle& = 0;
     virtual auto IsSynchronized() const noexcept -> bool = 0;
+    virtual auto Mempool() const noexcept -> const internal::Mempool& = 0;
     virtual auto Reorg() const noexcept
         -> const network::zeromq::socket::Publish& = 0;
     virtual auto RequestBlock(const block::Hash& block) const noexcept
         -> bool = 0;
+    virtual auto RequestFilterCheckpoints(
+        const filter::Type type,
+        const block::Hash& stop) const noexcept -> bool = 0;
     virtual auto RequestFilterHeaders(
         const filter::Type type,
         const block::Height start,
@@ -366,7 +480,8 @@ struct Network : virtual public opentxs::blockchain::Network {
     virtual auto RequestFilters(
         const filter::Type type,
         const block::Height start,
-        const block::Hash& stop) const noexcept -> bool = 0;
+        const block::Hash& stop,
+        const int peer) const noexcept -> bool = 0;
     virtual auto Submit(network::zeromq::Message& work) const noexcept
         -> void = 0;
     virtual auto UpdateHeight(const block::Height height) const noexcept
@@ -381,6 +496,76 @@ struct Network : virtual public opentxs::blockchain::Network {
     virtual ~Network() = default;
 };
 
+// Matches a range of block heights in chunks on several threads. The thread
+// which calls Run always takes part, so a scan completes even if none of the
+// dispatched helpers is ever scheduled. Helpers which start after the scan has
+// finished return immediately.
+class ParallelScan
+{
+public:
+    using Height = block::Height;
+    /// Returns false if the block at this height can not be processed, which
+    /// ends the scan. Called concurrently from every participating thread.
+    using Process = std::function<bool(const Height height)>;
+    /// Arranges for job.Help(generation) to be called on another thread
+    using Dispatch =
+        std::function<void(ParallelScan& job, const std::size_t generation)>;
+
+    /// Runs helpers on the blockchain thread pool
+    static auto Dispatcher(
+        const api::Core& api,
+        const zmq::socket::Push& socket,
+        const Type chain) noexcept -> Dispatch;
+    /// Executed by the thread pool
+    static auto ProcessTask(const zmq::Message& task) noexcept -> void;
+
+    /// Entry point for helper threads
+    OPENTXS_EXPORT auto Help(const std::size_t generation) noexcept -> void;
+    /// Returns the highest height for which every block from first up to and
+    /// including that height was processed
+    OPENTXS_EXPORT auto Run(
+        const Height first,
+        const Height last,
+        const Process& process,
+        const Dispatch& dispatch) noexcept -> std::optional<Height>;
+    auto Threads() const noexcept -> std::size_t
+    {
+        return threads_;
+    }
+
+    /// A thread count of zero uses every available core
+    OPENTXS_EXPORT ParallelScan(
+        const std::size_t threads,
+        const Height chunk = 100) noexcept;
+
+    /// Waits for helpers which are running on the thread pool. Helpers which
+    /// are still queued find the job missing and do nothing.
+    OPENTXS_EXPORT ~ParallelScan();
+
+private:
+    const std::size_t id_;
+    const std::size_t threads_;
+    const Height chunk_;
+    mutable std::mutex lock_;
+    std::condition_variable finished_;
+    std::size_t generation_;
+    bool running_;
+    const Process* process_;
+    Height next_;
+    Height last_;
+    Height stop_;
+    std::size_t active_;
+    std::size_t helpers_;
+
+    auto run(Lock& lock) noexcept -> void;
+
+    ParallelScan() = delete;
+    ParallelScan(const ParallelScan&) = delete;
+    ParallelScan(ParallelScan&&) = delete;
+    ParallelScan& operator=(const ParallelScan&) = delete;
+    ParallelScan& operator=(ParallelScan&&) = delete;
+};
+
 struct PeerDatabase {
     using Address = std::unique_ptr<p2p::internal::Address>;
     using Protocol = p2p::Protocol;
@@ -404,6 +589,7 @@ struct PeerManager {
         Getcfilters = 2,
         Heartbeat = 3,
         Getblock = 4,
+        Getcfcheckpt = 5,
         Body = 126,
         Header = 127,
         Connect = OT_ZMQ_CONNECT_SIGNAL,
@@ -422,16 +608,24 @@ struct PeerManager {
     virtual auto Disconnect(const int id) const noexcept -> void = 0;
     virtual auto Endpoint(const Task type) const noexcept -> std::string = 0;
     virtual auto GetPeerCount() const noexcept -> std::size_t = 0;
+    /// Returns true if the peer may ask for high bandwidth compact block
+    /// announcements, which are limited to a few peers at a time
+    virtual auto HighBandwidth(const int peer) const noexcept -> bool = 0;
     virtual auto RequestBlock(const block::Hash& block) const noexcept
         -> bool = 0;
+    virtual auto RequestFilterCheckpoints(
+        const filter::Type type,
+        const block::Hash& stop) const noexcept -> bool = 0;
     virtual auto RequestFilterHeaders(
         const filter::Type type,
         const block::Height start,
         const block::Hash& stop) const noexcept -> bool = 0;
+    /// A negative peer id lets the peer manager choose the peer
     virtual auto RequestFilters(
         const filter::Type type,
         const block::Height start,
-        const block::Hash& stop) const noexcept -> bool = 0;
+        const block::Hash& stop,
+        const int peer) const noexcept -> bool = 0;
     virtual auto RequestHeaders() const noexcept -> bool = 0;
 
     virtual auto init() noexcept -> void = 0;
@@ -446,10 +640,15 @@ struct ThreadPool {
 
     enum class Work : OTZMQWorkType {
         Wallet = 0,
+        ParallelScan = 1,
+        Lookahead = 2,
+        Bootstrap = 3,
     };
 
     virtual auto Endpoint() const noexcept -> std::string = 0;
     virtual auto Reset(const Type chain) const noexcept -> void = 0;
+    /// Queues a task without requiring the caller to own a socket
+    virtual auto Send(zmq::Message& task) const noexcept -> bool = 0;
     virtual auto Stop(const Type chain) const noexcept -> Future = 0;
 
     virtual ~ThreadPool() = default;
@@ -460,6 +659,7 @@ struct Wallet {
         index = 0,
         scan = 1,
         process = 2,
+        scan_chain = 3,
     };
 
     static auto ProcessTask(const zmq::Message& task) noexcept -> void;
@@ -472,6 +672,13 @@ struct Wallet {
 };
 
 struct WalletDatabase {
+    /// Public keys and hashes which identify an element in output scripts
+    enum class KeyType : std::uint8_t {
+        Pubkey = 0,
+        PubkeyHash = 1,
+        ScriptHash = 2,
+    };
+
     using FilterType = filter::Type;
     using NodeID = Identifier;
     using pNodeID = OTIdentifier;
@@ -479,6 +686,8 @@ struct WalletDatabase {
     using SubchainID = std::pair<Subchain, pNodeID>;
     using ElementID = std::pair<Bip32Index, SubchainID>;
     using ElementMap = std::map<Bip32Index, std::vector<Space>>;
+    using ElementKeys =
+        std::map<Bip32Index, std::vector<std::pair<KeyType, Space>>>;
     using Pattern = std::pair<ElementID, Space>;
     using Patterns = std::vector<Pattern>;
     using MatchingIndices = std::vector<Bip32Index>;
@@ -486,14 +695,47 @@ struct WalletDatabase {
         blockchain::block::bitcoin::Outpoint,
         proto::BlockchainTransactionOutput>;
 
+    /// Unspent outputs which were added or spent after an epoch
+    struct UTXOChanges {
+        std::size_t epoch_;
+        /// The caller's epoch is too old or was issued before a restart and
+        /// added_ contains every unspent output
+        bool reset_;
+        std::vector<UTXO> added_;
+        std::vector<blockchain::block::bitcoin::Outpoint> spent_;
+    };
+
     static const VersionNumber DefaultIndexVersion;
 
+    /// Outputs listed in outputIndices belong to the specified subchain
     virtual auto AddConfirmedTransaction(
+        const NodeID& balanceNode,
+        const Subchain subchain,
         const block::Position& block,
         const std::vector<std::uint32_t> outputIndices,
         const block::bitcoin::Transaction& transaction) const noexcept
         -> bool = 0;
+    /// Records the outputs and spends of an unconfirmed transaction. The
+    /// changes are held in memory until the transaction is confirmed or
+    /// dropped.
+    virtual auto AddMempoolTransaction(
+        const NodeID& balanceNode,
+        const Subchain subchain,
+        const std::vector<std::uint32_t> outputIndices,
+        const block::bitcoin::Transaction& transaction) const noexcept
+        -> bool = 0;
+    /// Reverts an unconfirmed transaction which left the mempool without
+    /// being confirmed
+    virtual auto DropMempoolTransaction(const block::Txid& txid) const
+        noexcept -> void = 0;
+    /// Returns the element which owns a key found in an output script
+    virtual auto FindElement(const KeyType type, const ReadView key) const
+        noexcept -> std::optional<ElementID> = 0;
     virtual auto GetBalance() const noexcept -> Balance = 0;
+    virtual auto GetBalance(const NodeID& balanceNode) const noexcept
+        -> Balance = 0;
+    virtual auto GetBalance(const NodeID& balanceNode, const Subchain subchain)
+        const noexcept -> Balance = 0;
     virtual auto GetPatterns(
         const NodeID& balanceNode,
         const Subchain subchain,
@@ -501,6 +743,9 @@ struct WalletDatabase {
         const VersionNumber version = DefaultIndexVersion) const noexcept
         -> Patterns = 0;
     virtual auto GetUnspentOutputs() const noexcept -> std::vector<UTXO> = 0;
+    /// Pass an epoch of zero to request the full set
+    virtual auto GetUnspentOutputs(const std::size_t epoch) const noexcept
+        -> UTXOChanges = 0;
     virtual auto GetUntestedPatterns(
         const NodeID& balanceNode,
         const Subchain subchain,
@@ -508,11 +753,17 @@ struct WalletDatabase {
         const ReadView blockID,
         const VersionNumber version = DefaultIndexVersion) const noexcept
         -> Patterns = 0;
+    virtual auto IsUnspent(
+        const blockchain::block::bitcoin::Outpoint& outpoint) const noexcept
+        -> bool = 0;
+    /// Number of threads which match filters during a wallet scan
+    virtual auto ScanThreads() const noexcept -> std::size_t = 0;
     virtual auto SubchainAddElements(
         const NodeID& balanceNode,
         const Subchain subchain,
         const FilterType type,
         const ElementMap& elements,
+        const ElementKeys& keys,
         const VersionNumber version = DefaultIndexVersion) const noexcept
         -> bool = 0;
     virtual auto SubchainDropIndex(
@@ -559,6 +810,17 @@ struct WalletDatabase {
 
     virtual ~WalletDatabase() = default;
 };
+
+/// Instantiates serialized block headers on several threads and checks that
+/// the hash of each one meets its own target. The output ends before the first
+/// header which fails either step since no header after it could connect.
+OPENTXS_EXPORT auto PrepareHeaders(
+    const std::vector<ReadView>& serialized,
+    const std::function<std::unique_ptr<block::Header>(const ReadView)>&
+        instantiate,
+    ParallelScan& job,
+    const ParallelScan::Dispatch& dispatch) noexcept
+    -> std::vector<std::unique_ptr<block::Header>>;
 #endif  // OT_BLOCKCHAIN
 }  // namespace opentxs::blockchain::client::internal
 
@@ -568,7 +830,6 @@ namespace opentxs::factory
 auto BlockchainDatabase(
     const api::internal::Core& api,
     const api::client::internal::Blockchain& blockchain,
-    const blockchain::client::internal::Network& network,
     const api::client::blockchain::database::implementation::Database& db,
     const blockchain::Type type) noexcept
     -> std::unique_ptr<blockchain::internal::Database>;
@@ -605,6 +866,7 @@ OPENTXS_EXPORT auto BlockchainWallet(
 auto BlockOracle(
     const api::internal::Core& api,
     const blockchain::client::internal::Network& network,
+    const blockchain::client::internal::BlockDatabase& database,
     const blockchain::Type type,
     const std::string& shutdown) noexcept
     -> std::unique_ptr<blockchain::client::internal::BlockOracle>;
@@ -614,5 +876,10 @@ auto HeaderOracle(
     const blockchain::client::internal::HeaderDatabase& database,
     const blockchain::Type type) noexcept
     -> std::unique_ptr<blockchain::client::internal::HeaderOracle>;
+OPENTXS_EXPORT auto Mempool(
+    const api::Core& api,
+    const blockchain::client::internal::WalletDatabase& database,
+    const std::size_t budget) noexcept
+    -> std::unique_ptr<blockchain::client::internal::Mempool>;
 }  // namespace opentxs::factory
 #endif  // OT_BLOCKCHAIN
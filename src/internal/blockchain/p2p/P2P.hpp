@@ -15,6 +15,17 @@
 #include "opentxs/blockchain/p2p/Address.hpp"
 #include "opentxs/blockchain/p2p/Peer.hpp"
 
+namespace opentxs
+{
+namespace network
+{
+namespace zeromq
+{
+class Message;
+}  // namespace zeromq
+}  // namespace network
+}  // namespace opentxs
+
 namespace ba = boost::asio;
 namespace ip = ba::ip;
 using tcp = ip::tcp;
@@ -31,7 +42,11 @@ struct Address : virtual public p2p::Address {
 
 struct Peer : virtual public p2p::Peer {
     virtual OTIdentifier AddressID() const noexcept = 0;
+    /// Services advertised by the peer during the handshake
+    virtual std::set<p2p::Service> Services() const noexcept = 0;
     virtual std::shared_future<void> Shutdown() noexcept = 0;
+    /// Queues a job for this peer instead of the first available peer
+    virtual void Submit(network::zeromq::Message& work) noexcept = 0;
 
     virtual ~Peer() override = default;
 };
@@ -528,6 +528,85 @@ auto LMDB::Load(
         mode);
 }
 
+auto LMDB::LoadPrefix(
+    const Table table,
+    const ReadView index,
+    const ReadView prefix,
+    const Callback cb) const noexcept -> bool
+{
+    struct Cleanup {
+        Cleanup(MDB_txn*& transaction, MDB_cursor*& cursor)
+            : transaction_(transaction)
+            , cursor_(cursor)
+        {
+        }
+
+        ~Cleanup()
+        {
+            if (nullptr != cursor_) {
+                ::mdb_cursor_close(cursor_);
+                cursor_ = nullptr;
+            }
+
+            if (nullptr != transaction_) {
+                ::mdb_txn_abort(transaction_);
+                transaction_ = nullptr;
+            }
+        }
+
+    private:
+        MDB_txn*& transaction_;
+        MDB_cursor*& cursor_;
+    };
+
+    OT_ASSERT(static_cast<std::size_t>(table) < db_.size());
+
+    MDB_txn* transaction{nullptr};
+
+    if (0 != ::mdb_txn_begin(env_, nullptr, MDB_RDONLY, &transaction)) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(": Failed to start transaction")
+            .Flush();
+
+        return false;
+    }
+
+    OT_ASSERT(nullptr != transaction);
+
+    MDB_cursor* cursor{nullptr};
+    Cleanup cleanup(transaction, cursor);
+    const auto database = db_.at(table);
+
+    if (0 != ::mdb_cursor_open(transaction, database, &cursor)) {
+        LogOutput(OT_METHOD)(__FUNCTION__)(": Failed to get cursor").Flush();
+
+        return false;
+    }
+
+    auto key = MDB_val{index.size(), const_cast<char*>(index.data())};
+    auto value = MDB_val{prefix.size(), const_cast<char*>(prefix.data())};
+
+    // Duplicates are sorted, so the matching values follow the first value
+    // which is not less than the prefix
+    if (0 != ::mdb_cursor_get(cursor, &key, &value, MDB_GET_BOTH_RANGE)) {
+
+        return true;
+    }
+
+    do {
+        const auto data =
+            ReadView{static_cast<char*>(value.mv_data), value.mv_size};
+
+        if ((data.size() < prefix.size()) ||
+            (data.substr(0, prefix.size()) != prefix)) {
+            break;
+        }
+
+        cb(data);
+    } while (0 == ::mdb_cursor_get(cursor, &key, &value, MDB_NEXT_DUP));
+
+    return true;
+}
+
 auto LMDB::Queue(
     const Table table,
     const ReadView key,
@@ -85,30 +85,39 @@ public:
         const ReadView value,
         MDB_txn* parent = nullptr) const noexcept;
     bool Exists(const Table table, const ReadView key) const noexcept;
-    bool Load(
+    OPENTXS_EXPORT bool Load(
         const Table table,
         const ReadView key,
         const Callback cb,
         const Mode mode = Mode::One) const noexcept;
-    bool Load(
+    OPENTXS_EXPORT bool Load(
         const Table table,
         const std::size_t key,
         const Callback cb,
         const Mode mode = Mode::One) const noexcept;
+    /// Loads the duplicate values of key which begin with prefix. Only
+    /// meaningful for tables opened with MDB_DUPSORT.
+    bool LoadPrefix(
+        const Table table,
+        const ReadView key,
+        const ReadView prefix,
+        const Callback cb) const noexcept;
     bool Queue(
         const Table table,
         const ReadView key,
         const ReadView value,
         const Mode mode = Mode::One) const noexcept;
-    bool Read(const Table table, const ReadCallback cb, const Dir dir) const
-        noexcept;
-    Result Store(
+    OPENTXS_EXPORT bool Read(
+        const Table table,
+        const ReadCallback cb,
+        const Dir dir) const noexcept;
+    OPENTXS_EXPORT Result Store(
         const Table table,
         const ReadView key,
         const ReadView value,
         MDB_txn* parent = nullptr,
         const Flags flags = 0) const noexcept;
-    Result Store(
+    OPENTXS_EXPORT Result Store(
         const Table table,
         const std::size_t key,
         const ReadView value,
@@ -123,13 +132,13 @@ public:
     Transaction TransactionRO() const noexcept(false);
     Transaction TransactionRW() const noexcept(false);
 
-    LMDB(
+    OPENTXS_EXPORT LMDB(
         const TableNames& names,
         const std::string& folder,
         const TablesToInit init,
         const Flags flags = 0)
     noexcept;
-    ~LMDB();
+    OPENTXS_EXPORT ~LMDB();
 
 private:
     using NewKey = std::tuple<Table, Mode, std::string, std::string>;
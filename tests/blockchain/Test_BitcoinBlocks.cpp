@@ -144,4 +144,90 @@ TEST_F(Test_BitcoinBlock, serialization)
         EXPECT_EQ(raw.get(), serialized);
     }
 }
+
+TEST_F(Test_BitcoinBlock, lazy_transactions)
+{
+    using Style = ot::blockchain::filter::Type;
+    const auto styles = {
+        Style::Basic_BIP158, Style::Basic_BCHVariant, Style::Extended_opentxs};
+
+    for (const auto& vector : bip_158_vectors_) {
+        const auto raw = vector.Block(api_);
+        const auto pBlock = api_.Factory().BitcoinBlock(
+            ot::blockchain::Type::Bitcoin_testnet3, raw->Bytes());
+
+        ASSERT_TRUE(pBlock);
+
+        const auto& block = *pBlock;
+
+        EXPECT_EQ(block.InstantiatedSize(), 0);
+
+        for (const auto style : styles) {
+            auto fromBlock = block.ExtractElements(style);
+            auto fromTransactions = std::vector<ot::Space>{};
+
+            for (const auto& pTx : block) {
+                ASSERT_TRUE(pTx);
+
+                const auto& tx = *pTx;
+
+                EXPECT_EQ(pTx.get(), block.at(tx.ID().Bytes()).get());
+
+                auto elements = tx.ExtractElements(style);
+                std::move(
+                    elements.begin(),
+                    elements.end(),
+                    std::back_inserter(fromTransactions));
+            }
+
+            std::sort(fromBlock.begin(), fromBlock.end());
+            std::sort(fromTransactions.begin(), fromTransactions.end());
+
+            EXPECT_EQ(fromTransactions, fromBlock);
+        }
+
+        // Each transaction is charged once no matter how often it is accessed
+        auto instantiated = std::size_t{0};
+
+        for (const auto& pTx : block) { instantiated += pTx->CalculateSize(); }
+
+        EXPECT_EQ(block.InstantiatedSize(), instantiated);
+    }
+}
+
+TEST_F(Test_BitcoinBlock, nonstandard_scripts)
+{
+    using Style = ot::blockchain::filter::Type;
+    // A coinbase transaction whose outputs contain an unassigned opcode, a
+    // truncated push and a 20 byte push
+    const auto push = std::string(40, '1');
+    const auto tx = std::string{"01000000"} + "01" + std::string(64, '0') +
+                    "ffffffff" + "0151" + "ffffffff" + "03" +
+                    "0000000000000000" + "01ba" + "0000000000000000" +
+                    "034c0501" + "0000000000000000" + "1514" + push +
+                    "00000000";
+    const auto raw = bip_158_vectors_.at(0).Block(api_);
+    auto block = ot::Data::Factory(raw->data(), 80);
+    block += ot::Data::Factory("01" + tx, ot::Data::Mode::Hex);
+    const auto pBlock = api_.Factory().BitcoinBlock(
+        ot::blockchain::Type::Bitcoin_testnet3, block->Bytes());
+
+    ASSERT_TRUE(pBlock);
+    EXPECT_EQ(pBlock->size(), 1u);
+    EXPECT_EQ(pBlock->ExtractElements(Style::Basic_BIP158).size(), 3u);
+
+    const auto elements = pBlock->ExtractElements(Style::Extended_opentxs);
+    const auto expected = ot::Data::Factory(push, ot::Data::Mode::Hex);
+
+    // The coinbase outpoint and the 20 byte push
+    ASSERT_EQ(elements.size(), 2u);
+    EXPECT_EQ(
+        std::count_if(
+            elements.begin(),
+            elements.end(),
+            [&](const auto& element) {
+                return ot::reader(element) == expected->Bytes();
+            }),
+        1);
+}
 }  // namespace
@@ -1845,6 +1845,93 @@ TEST(Test_BitcoinScript, multisig)
     }
 }
 
+TEST(Test_BitcoinScript, templates)
+{
+    namespace bs = ot::blockchain::script;
+
+    const auto check = [](const auto& serialized,
+                          const auto& layout,
+                          const auto payload) {
+        const auto script = ot::Factory::BitcoinScript(
+            ot::reader(serialized), true, false, false);
+
+        ASSERT_TRUE(script);
+        ASSERT_TRUE(payload(*script).has_value());
+
+        auto expected = ot::Space{};
+        auto written = ot::Space{};
+        auto buffer = std::array<std::uint8_t, bs::Template::max_size_>{};
+
+        EXPECT_TRUE(script->Serialize(ot::writer(expected)));
+        const auto data = payload(*script).value();
+
+        EXPECT_TRUE(layout.Write(data, ot::writer(written)));
+        EXPECT_TRUE(layout.Write(data, buffer.data()));
+        ASSERT_EQ(expected.size(), layout.Size());
+        ASSERT_EQ(expected.size(), written.size());
+        EXPECT_EQ(
+            std::memcmp(written.data(), expected.data(), expected.size()), 0);
+        EXPECT_EQ(
+            std::memcmp(buffer.data(), expected.data(), expected.size()), 0);
+    };
+    const auto pubkey = [](const Script& script) { return script.Pubkey(); };
+    const auto pubkeyHash = [](const Script& script) {
+        return script.PubkeyHash();
+    };
+    const auto scriptHash = [](const Script& script) {
+        return script.ScriptHash();
+    };
+
+    check(p2pk_good_.at(0), bs::P2PK_uncompressed, pubkey);
+    check(p2pkh_good_.at(0), bs::P2PKH, pubkeyHash);
+    check(p2sh_good_.at(0), bs::P2SH, scriptHash);
+
+    auto compressed = std::vector<std::byte>{std::byte{33}};
+    compressed.insert(
+        compressed.end(),
+        compressed_pubkey_1_.cbegin(),
+        compressed_pubkey_1_.cend());
+    compressed.emplace_back(std::byte{172});
+    check(compressed, bs::P2PK_compressed, pubkey);
+
+    EXPECT_EQ(
+        &bs::P2PK_compressed, &bs::P2PK(ot::reader(compressed_pubkey_1_)));
+    EXPECT_EQ(
+        &bs::P2PK_uncompressed, &bs::P2PK(ot::reader(uncompressed_pubkey_1_)));
+
+    auto bytes = ot::Space{};
+
+    EXPECT_FALSE(bs::P2PKH.Write(
+        ot::reader(compressed_pubkey_1_), ot::writer(bytes)));
+    EXPECT_FALSE(bs::P2SH.Write(ot::reader(hash_160_), ot::AllocateOutput{}));
+}
+
+TEST(Test_BitcoinScript, template_elements)
+{
+    // Non-minimal pushes must be extracted exactly as they were encoded
+    for (const auto* list : {&p2pk_good_, &p2pkh_good_, &p2sh_good_}) {
+        for (const auto& serialized : *list) {
+            const auto script = ot::Factory::BitcoinScript(
+                ot::reader(serialized), true, false, false);
+
+            ASSERT_TRUE(script);
+
+            const auto elements = script->ExtractElements(
+                ot::blockchain::filter::Type::Basic_BIP158);
+
+            ASSERT_EQ(1, elements.size());
+
+            const auto& element = elements.front();
+
+            ASSERT_EQ(element.size(), serialized.size());
+            EXPECT_EQ(
+                std::memcmp(
+                    element.data(), serialized.data(), serialized.size()),
+                0);
+        }
+    }
+}
+
 TEST(Test_BitcoinScript, input)
 {
     for (const auto& serialized : input_good_) {
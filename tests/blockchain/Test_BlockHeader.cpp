@@ -112,4 +112,50 @@ TEST_F(Test_BlockHeader, Deserialize)
     ASSERT_TRUE(pHeader);
     EXPECT_EQ(expectedHash.get(), pHeader->Hash());
 }
+
+TEST_F(Test_BlockHeader, serialized_record)
+{
+    using Record = bb::internal::SerializedHeader;
+
+    std::unique_ptr<const bb::Header> pHeader{
+        ot::Factory::GenesisBlockHeader(api_, b::Type::Bitcoin)};
+
+    ASSERT_TRUE(pHeader);
+
+    const auto& header = *pHeader;
+    const auto record = Record{header};
+    const auto bytes = ot::ReadView{
+        reinterpret_cast<const char*>(&record), sizeof(record)};
+
+    ASSERT_EQ(sizeof(Record), 160u);
+    ASSERT_TRUE(Record::Valid(bytes));
+    EXPECT_FALSE(Record::Valid({bytes.data(), bytes.size() - 1u}));
+
+    const auto& read = Record::Read(bytes);
+
+    EXPECT_EQ(read.Chain(), b::Type::Bitcoin);
+    EXPECT_EQ(read.Height(), header.Height());
+    EXPECT_EQ(read.LocalState(), header.LocalState());
+    EXPECT_EQ(read.InheritedState(), header.InheritedState());
+    EXPECT_EQ(read.Difficulty()->Decimal(), header.Difficulty()->Decimal());
+    EXPECT_EQ(read.ParentWork()->Decimal(), header.ParentWork()->Decimal());
+    EXPECT_EQ(read.ParentHash(), header.ParentHash().Bytes());
+
+    auto loaded = ot::Factory::BlockHeader(api_, header.Hash(), read);
+
+    ASSERT_TRUE(loaded);
+    EXPECT_EQ(loaded->Hash(), header.Hash());
+    EXPECT_EQ(loaded->Height(), header.Height());
+    EXPECT_EQ(loaded->LocalState(), header.LocalState());
+    EXPECT_EQ(loaded->Work()->Decimal(), header.Work()->Decimal());
+
+    const auto view = bb::internal::HeaderView{header.Hash().Bytes(), read};
+
+    EXPECT_EQ(view.Hash(), header.Hash().Bytes());
+    EXPECT_EQ(view.Height(), header.Height());
+    EXPECT_EQ(view.Work()->Decimal(), header.Work()->Decimal());
+    EXPECT_THROW(
+        bb::internal::HeaderView({bytes.data(), 31u}, read),
+        std::exception);
+}
 }  // namespace
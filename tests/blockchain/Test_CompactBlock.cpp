@@ -0,0 +1,371 @@
+// Copyright (c) 2010-2020 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "OTTestEnvironment.hpp"
+
+#include <algorithm>
+#include <optional>
+#include <set>
+
+#include "Bip158.hpp"
+#include "blockchain/p2p/bitcoin/CompactBlock.hpp"
+#include "blockchain/p2p/bitcoin/message/Getblocktxn.hpp"
+
+namespace
+{
+struct Test_CompactBlock : public ::testing::Test {
+    using Block = ot::blockchain::block::bitcoin::Block;
+    using Compact = ot::blockchain::p2p::bitcoin::CompactBlock;
+    using Positions = std::set<std::size_t>;
+
+    static constexpr auto chain_{ot::blockchain::Type::Bitcoin_testnet3};
+    static constexpr auto header_bytes_ = std::size_t{80};
+    static constexpr auto version_ = std::uint64_t{1};
+
+    const ot::api::client::internal::Manager& api_;
+
+    static auto append(ot::Space& out, const ot::ReadView in) -> void
+    {
+        const auto* it = reinterpret_cast<const std::byte*>(in.data());
+        out.insert(out.end(), it, it + in.size());
+    }
+
+    static auto append_size(ot::Space& out, const std::size_t value) -> void
+    {
+        const auto bytes = ot::blockchain::bitcoin::CompactSize(value).Encode();
+        out.insert(out.end(), bytes.begin(), bytes.end());
+    }
+
+    static auto append_id(ot::Space& out, const std::uint64_t id) -> void
+    {
+        for (auto b = std::size_t{0}; b < Compact::short_id_bytes_; ++b) {
+            out.emplace_back(static_cast<std::byte>(id >> (8 * b)));
+        }
+    }
+
+    static auto nonce() -> const ot::Space&
+    {
+        static const auto output = ot::Space{
+            std::byte{0x01},
+            std::byte{0x23},
+            std::byte{0x45},
+            std::byte{0x67},
+            std::byte{0x89},
+            std::byte{0xab},
+            std::byte{0xcd},
+            std::byte{0xef}};
+
+        return output;
+    }
+
+    static auto serialize(const Block& block, const std::size_t position)
+        -> ot::Space
+    {
+        auto output = ot::Space{};
+        block.at(position)->Serialize(ot::writer(output));
+
+        return output;
+    }
+
+    auto Blocktxn(const Block& block, const Compact::Indices& positions) const
+        -> ot::Space
+    {
+        auto output = ot::Space{};
+        append(output, block.ID().Bytes());
+        append_size(output, positions.size());
+
+        for (const auto position : positions) {
+            append(output, ot::reader(serialize(block, position)));
+        }
+
+        return output;
+    }
+
+    // Builds a cmpctblock payload with the transactions at the listed
+    // positions prefilled and short ids for the rest
+    auto Payload(
+        const Block& block,
+        const ot::ReadView header,
+        const Positions& prefilled,
+        const bool duplicate = false) const -> ot::Space
+    {
+        auto output = ot::Space{};
+        append(output, header);
+        output.insert(output.end(), nonce().begin(), nonce().end());
+        // The short id key only depends on the header and nonce
+        auto keyed = std::unique_ptr<Compact>{};
+
+        if (prefilled.size() < block.size()) {
+            auto all = Positions{};
+
+            for (auto i = std::size_t{0}; i < block.size(); ++i) {
+                all.emplace(i);
+            }
+
+            const auto full = Payload(block, header, all);
+            keyed = std::make_unique<Compact>(
+                api_, chain_, version_, ot::reader(full));
+        }
+
+        append_size(output, block.size() - prefilled.size());
+        auto previous = std::optional<std::uint64_t>{};
+
+        for (auto i = std::size_t{0}; i < block.size(); ++i) {
+            if (0 < prefilled.count(i)) { continue; }
+
+            auto id = keyed->ShortID(block.at(i)->ID().Bytes());
+
+            if (duplicate && previous.has_value()) { id = previous.value(); }
+
+            append_id(output, id);
+            previous = id;
+        }
+
+        append_size(output, prefilled.size());
+        auto next = std::size_t{0};
+
+        for (const auto position : prefilled) {
+            append_size(output, position - next);
+            append(output, ot::reader(serialize(block, position)));
+            next = position + 1u;
+        }
+
+        return output;
+    }
+
+    Test_CompactBlock()
+        : api_(dynamic_cast<const ot::api::client::internal::Manager&>(
+              ot::Context().StartClient(OTTestEnvironment::test_args_, 0)))
+    {
+    }
+};
+
+TEST_F(Test_CompactBlock, reconstruct_from_mempool)
+{
+    for (const auto& vector : bip_158_vectors_) {
+        const auto raw = vector.Block(api_);
+        const auto pBlock = api_.Factory().BitcoinBlock(chain_, raw->Bytes());
+
+        ASSERT_TRUE(pBlock);
+
+        const auto& block = *pBlock;
+        const auto header = ot::ReadView{raw->Bytes().data(), header_bytes_};
+        const auto payload = Payload(block, header, {0});
+        auto compact = Compact{api_, chain_, version_, ot::reader(payload)};
+
+        EXPECT_EQ(compact.Hash(), vector.BlockHash(api_)->Bytes());
+        EXPECT_EQ(compact.size(), block.size());
+        EXPECT_EQ(compact.Missing().size(), block.size() - 1u);
+        EXPECT_EQ(compact.IsComplete(), 1u == block.size());
+
+        auto candidates = Compact::Transactions{};
+
+        for (auto i = std::size_t{1}; i < block.size(); ++i) {
+            candidates.emplace_back(block.at(i));
+        }
+
+        EXPECT_EQ(compact.Match(candidates), block.size() - 1u);
+        EXPECT_TRUE(compact.IsComplete());
+        EXPECT_EQ(compact.Received(), payload.size());
+
+        const auto serialized = compact.Serialize();
+
+        ASSERT_TRUE(serialized.has_value());
+        EXPECT_EQ(raw->Bytes(), ot::reader(serialized.value()));
+    }
+}
+
+// Expected short ids were calculated independently with SipHash-2-4 keyed by
+// SHA256(header || nonce) as specified by BIP152
+TEST_F(Test_CompactBlock, short_id_vectors)
+{
+    const auto legacy = bip_158_vectors_.at(1).Block(api_);
+    const auto witness = bip_158_vectors_.at(8).Block(api_);
+    const auto pLegacy = api_.Factory().BitcoinBlock(chain_, legacy->Bytes());
+    const auto pWitness =
+        api_.Factory().BitcoinBlock(chain_, witness->Bytes());
+
+    ASSERT_TRUE(pLegacy);
+    ASSERT_TRUE(pWitness);
+    ASSERT_EQ(pWitness->size(), 2u);
+
+    const auto legacyPayload = Payload(
+        *pLegacy, ot::ReadView{legacy->Bytes().data(), header_bytes_}, {0});
+    const auto witnessPayload = Payload(
+        *pWitness,
+        ot::ReadView{witness->Bytes().data(), header_bytes_},
+        {0, 1});
+    const auto v1 = Compact{api_, chain_, 1, ot::reader(legacyPayload)};
+    const auto v2 = Compact{api_, chain_, 2, ot::reader(witnessPayload)};
+    const auto& tx = *pWitness->at(1);
+
+    EXPECT_EQ(v1.ShortID(pLegacy->at(0)->ID().Bytes()), 0x22dbcd737e12u);
+    EXPECT_EQ(v2.ShortID(tx.ID().Bytes()), 0xf713e86a001eu);
+    EXPECT_EQ(v2.ShortID(tx.WTXID().Bytes()), 0xfd59115bfd69u);
+}
+
+TEST_F(Test_CompactBlock, version_2_uses_wtxid)
+{
+    const auto raw = bip_158_vectors_.at(8).Block(api_);
+    const auto pBlock = api_.Factory().BitcoinBlock(chain_, raw->Bytes());
+
+    ASSERT_TRUE(pBlock);
+
+    const auto& block = *pBlock;
+
+    ASSERT_EQ(block.size(), 2u);
+    ASSERT_NE(block.at(1)->ID(), block.at(1)->WTXID());
+
+    // The coinbase is prefilled and the short id of the second transaction
+    // is the known answer for its wtxid
+    auto payload = ot::Space{};
+    append(payload, ot::ReadView{raw->Bytes().data(), header_bytes_});
+    payload.insert(payload.end(), nonce().begin(), nonce().end());
+    append_size(payload, 1);
+    append_id(payload, 0xfd59115bfd69u);
+    append_size(payload, 1);
+    append_size(payload, 0);
+    append(payload, ot::reader(serialize(block, 0)));
+    const auto candidates = Compact::Transactions{block.at(1)};
+    auto v1 = Compact{api_, chain_, 1, ot::reader(payload)};
+    auto v2 = Compact{api_, chain_, 2, ot::reader(payload)};
+
+    EXPECT_EQ(v1.Match(candidates), 0u);
+    EXPECT_FALSE(v1.IsComplete());
+    EXPECT_EQ(v2.Match(candidates), 1u);
+    ASSERT_TRUE(v2.IsComplete());
+
+    const auto serialized = v2.Serialize();
+
+    ASSERT_TRUE(serialized.has_value());
+    EXPECT_EQ(raw->Bytes(), ot::reader(serialized.value()));
+}
+
+TEST_F(Test_CompactBlock, request_missing)
+{
+    for (const auto& vector : bip_158_vectors_) {
+        const auto raw = vector.Block(api_);
+        const auto pBlock = api_.Factory().BitcoinBlock(chain_, raw->Bytes());
+
+        ASSERT_TRUE(pBlock);
+
+        const auto& block = *pBlock;
+
+        if (3u > block.size()) { continue; }
+
+        const auto header = ot::ReadView{raw->Bytes().data(), header_bytes_};
+        const auto payload = Payload(block, header, {0});
+        auto compact = Compact{api_, chain_, version_, ot::reader(payload)};
+        auto candidates = Compact::Transactions{};
+        auto expected = Compact::Indices{};
+
+        for (auto i = std::size_t{1}; i < block.size(); ++i) {
+            if (0 == (i % 2)) {
+                expected.emplace_back(i);
+            } else {
+                candidates.emplace_back(block.at(i));
+            }
+        }
+
+        compact.Match(candidates);
+
+        EXPECT_FALSE(compact.IsComplete());
+        EXPECT_FALSE(compact.Serialize().has_value());
+        ASSERT_EQ(compact.Missing(), expected);
+
+        const auto blocktxn = Blocktxn(block, expected);
+
+        EXPECT_FALSE(compact.Receive(ot::reader(Blocktxn(block, {1}))));
+        EXPECT_TRUE(compact.Receive(ot::reader(blocktxn)));
+        EXPECT_TRUE(compact.IsComplete());
+        EXPECT_EQ(compact.Received(), payload.size() + blocktxn.size());
+
+        const auto serialized = compact.Serialize();
+
+        ASSERT_TRUE(serialized.has_value());
+        EXPECT_EQ(raw->Bytes(), ot::reader(serialized.value()));
+    }
+}
+
+TEST_F(Test_CompactBlock, merkle_mismatch)
+{
+    for (const auto& vector : bip_158_vectors_) {
+        const auto raw = vector.Block(api_);
+        const auto pBlock = api_.Factory().BitcoinBlock(chain_, raw->Bytes());
+
+        ASSERT_TRUE(pBlock);
+
+        const auto& block = *pBlock;
+
+        if (3u > block.size()) { continue; }
+
+        const auto header = ot::ReadView{raw->Bytes().data(), header_bytes_};
+        const auto payload = Payload(block, header, {0});
+        auto compact = Compact{api_, chain_, version_, ot::reader(payload)};
+        auto missing = compact.Missing();
+
+        ASSERT_EQ(missing.size(), block.size() - 1u);
+
+        // Supply the right transactions in the wrong order
+        std::reverse(missing.begin(), missing.end());
+
+        EXPECT_TRUE(compact.Receive(ot::reader(Blocktxn(block, missing))));
+        EXPECT_TRUE(compact.IsComplete());
+        EXPECT_FALSE(compact.Serialize().has_value());
+    }
+}
+
+TEST_F(Test_CompactBlock, invalid_payload)
+{
+    const auto& vector = bip_158_vectors_.at(5);
+    const auto raw = vector.Block(api_);
+    const auto pBlock = api_.Factory().BitcoinBlock(chain_, raw->Bytes());
+
+    ASSERT_TRUE(pBlock);
+
+    const auto& block = *pBlock;
+
+    ASSERT_LT(2u, block.size());
+
+    const auto header = ot::ReadView{raw->Bytes().data(), header_bytes_};
+    auto payload = Payload(block, header, {0, 2});
+
+    EXPECT_NO_THROW(Compact(api_, chain_, version_, ot::reader(payload)));
+
+    payload.pop_back();
+
+    EXPECT_THROW(
+        Compact(api_, chain_, version_, ot::reader(payload)), std::exception);
+    EXPECT_THROW(Compact(api_, chain_, version_, header), std::exception);
+
+    const auto duplicate = Payload(block, header, {0}, true);
+
+    EXPECT_THROW(
+        Compact(api_, chain_, version_, ot::reader(duplicate)),
+        std::exception);
+}
+
+TEST_F(Test_CompactBlock, getblocktxn_indices)
+{
+    namespace bitcoin = ot::blockchain::p2p::bitcoin;
+
+    const auto hash = bip_158_vectors_.at(0).BlockHash(api_);
+    const std::unique_ptr<bitcoin::message::Getblocktxn> pMessage{
+        ot::Factory::BitcoinP2PGetblocktxn(api_, chain_, hash, {1, 2, 5})};
+
+    ASSERT_TRUE(pMessage);
+
+    auto expected = ot::Space{};
+    append(expected, hash->Bytes());
+    // Indices are encoded as the difference from the previous index plus one
+    append_size(expected, 3);
+    append_size(expected, 1);
+    append_size(expected, 0);
+    append_size(expected, 2);
+
+    EXPECT_EQ(pMessage->payload()->Bytes(), ot::reader(expected));
+    EXPECT_EQ(pMessage->getIndices(), (std::vector<std::size_t>{1, 2, 5}));
+}
+}  // namespace
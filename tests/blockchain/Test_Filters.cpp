@@ -301,6 +301,29 @@ TEST_F(Test_Filters, bitstreams)
         EXPECT_EQ(intReader.read(1), 0);
         EXPECT_EQ(intReader.read(19u), 498577u);
     }
+
+    {
+        auto result = ot::Space{};
+        auto writer = ot::blockchain::internal::BitWriter{result};
+        const auto runs = std::vector<std::uint64_t>{0, 3, 61, 64, 130, 1};
+
+        for (const auto& run : runs) {
+            for (auto i = std::uint64_t{0}; i < run; ++i) {
+                writer.write(1, 1);
+            }
+
+            writer.write(1, 0);
+            writer.write(19, 498577u);
+        }
+
+        writer.flush();
+        auto reader = ot::blockchain::internal::BitReader{ot::reader(result)};
+
+        for (const auto& run : runs) {
+            EXPECT_EQ(reader.unary(), run);
+            EXPECT_EQ(reader.read(19u), 498577u);
+        }
+    }
 }
 
 TEST_F(Test_Filters, golomb_coding)
@@ -321,6 +344,24 @@ TEST_F(Test_Filters, golomb_coding)
     }
 }
 
+TEST_F(Test_Filters, golomb_coding_large)
+{
+    auto elements = std::vector<std::uint64_t>{};
+    auto value = std::uint64_t{0};
+
+    for (auto i = std::uint64_t{0}; i < 1000; ++i) {
+        value += ((i * 7919u) % 5000000u) + 1u;
+        elements.emplace_back(value);
+    }
+
+    const auto N = static_cast<std::uint32_t>(elements.size());
+    const auto P = std::uint8_t{19};
+    const auto encoded = ot::gcs::GolombEncode(P, elements);
+    const auto decoded = ot::gcs::GolombDecode(N, P, encoded);
+
+    EXPECT_EQ(elements, decoded);
+}
+
 TEST_F(Test_Filters, gcs)
 {
     const auto s1 = std::string{"blah"};
@@ -371,6 +412,41 @@ TEST_F(Test_Filters, gcs)
 
 TEST_F(Test_Filters, bip158_case_0) { EXPECT_TRUE(TestGCSBlock(0)); }
 
+TEST_F(Test_Filters, from_block)
+{
+    for (const auto& [height, vector] : gcs_) {
+        const auto hash =
+            api_.Factory().Data(vector.block_hash_, ot::StringStyle::Hex);
+        const auto raw =
+            api_.Factory().Data(vector.block_, ot::StringStyle::Hex);
+        const auto pBlock = api_.Factory().BitcoinBlock(
+            ot::blockchain::Type::Bitcoin_testnet3, raw->Bytes());
+
+        ASSERT_TRUE(pBlock);
+
+        auto elements =
+            pBlock->ExtractElements(ot::blockchain::filter::Type::Basic_BIP158);
+
+        // Previous output scripts are the only elements which are not
+        // contained in the block
+        for (const auto& script : vector.previous_) {
+            const auto bytes =
+                api_.Factory().Data(script, ot::StringStyle::Hex);
+            elements.emplace_back(ot::space(bytes->Bytes()));
+        }
+
+        const auto pGcs = ot::Factory::GCS(
+            api_,
+            19,
+            784931,
+            ot::blockchain::internal::BlockHashToFilterKey(hash->Bytes()),
+            elements);
+
+        ASSERT_TRUE(pGcs);
+        EXPECT_EQ(vector.filter_, pGcs->Encode()->asHex());
+    }
+}
+
 TEST_F(Test_Filters, bip158_case_49291) { EXPECT_TRUE(TestGCSBlock(49291)); }
 
 // filter for block
@@ -471,6 +547,54 @@ TEST_F(Test_Filters, bip158_headers)
     EXPECT_EQ(calculated_a.get(), expected_3.get());
 }
 
+TEST_F(Test_Filters, serialized)
+{
+    namespace bc = ot::blockchain::internal;
+
+    const auto s1 = std::string{"blah"};
+    const auto s2 = std::string{"foo"};
+    const auto s3 = std::string{"justus"};
+    const auto object1(ot::Data::Factory(s1.data(), s1.length()));
+    const auto object2(ot::Data::Factory(s2.data(), s2.length()));
+    const auto object3(ot::Data::Factory(s3.data(), s3.length()));
+    const auto key = std::string{"0123456789abcdef"};
+    const auto pGcs =
+        ot::Factory::GCS(api_, 19, 784931, key, {object1, object2});
+
+    ASSERT_TRUE(pGcs);
+
+    const auto& gcs = *pGcs;
+    auto record = ot::Space{};
+
+    ASSERT_TRUE(gcs.Serialize(ot::writer(record)));
+    EXPECT_TRUE(bc::SerializedFilter::Valid(ot::reader(record)));
+    EXPECT_EQ(
+        sizeof(bc::SerializedFilter) + gcs.Compressed().size(), record.size());
+
+    const auto proto = gcs.Serialize();
+    const auto legacy = proto.SerializeAsString();
+
+    EXPECT_FALSE(bc::SerializedFilter::Valid(legacy));
+
+    const auto pView = ot::Factory::GCS(api_, ot::reader(record), true);
+
+    ASSERT_TRUE(pView);
+
+    const auto& view = *pView;
+
+    EXPECT_EQ(gcs.ElementCount(), view.ElementCount());
+    EXPECT_EQ(gcs.Encode().get(), view.Encode().get());
+    EXPECT_EQ(gcs.Hash().get(), view.Hash().get());
+    EXPECT_TRUE(view.Test(object1));
+    EXPECT_TRUE(view.Test(object2));
+    EXPECT_FALSE(view.Test(object3));
+
+    const auto targets = std::vector<ot::ReadView>{
+        object1->Bytes(), object2->Bytes(), object3->Bytes()};
+
+    EXPECT_EQ(2u, view.Match(targets).size());
+}
+
 TEST_F(Test_Filters, hash)
 {
     namespace bc = ot::blockchain::internal;
@@ -497,4 +621,58 @@ TEST_F(Test_Filters, hash)
 
     EXPECT_EQ(hash_a.get(), hash_b.get());
 }
+
+TEST_F(Test_Filters, p2wpkh)
+{
+    namespace bb = ot::blockchain::block;
+    namespace bs = ot::blockchain::script;
+
+    const auto style = ot::blockchain::filter::Type::Basic_BIP158;
+    const auto pubkeyHash =
+        api_.Factory().Data(std::string(40, 'a'), ot::StringStyle::Hex);
+    auto script = ot::Space{};
+
+    ASSERT_TRUE(bs::P2WPKH.Write(pubkeyHash->Bytes(), ot::writer(script)));
+    ASSERT_EQ(script.size(), 22);
+
+    // Genesis header followed by a coinbase and a transaction which pays to
+    // the witness key hash
+    const auto raw =
+        std::string{
+            "0100000000000000000000000000000000000000000000000000000000000000"
+            "000000003ba3edfd7a7b12b27ac72c3e67768f617fc81bc3888a51323a9fb8aa"
+            "4b1e5e4a29ab5f49ffff001d1dac2b7c"} +
+        "02" +
+        "01000000010000000000000000000000000000000000000000000000000000000000"
+        "000000ffffffff0151ffffffff0100000000000000000151"
+        "00000000" +
+        "01000000" + "01" + std::string(64, '1') + "00000000" + "00" +
+        "ffffffff" + "01" + std::string(16, '1') + "16" +
+        ot::Data::Factory(script)->asHex() + "00000000";
+    const auto bytes = api_.Factory().Data(raw, ot::StringStyle::Hex);
+    const auto pBlock = api_.Factory().BitcoinBlock(
+        ot::blockchain::Type::Bitcoin, bytes->Bytes());
+
+    ASSERT_TRUE(pBlock);
+
+    const auto& block = *pBlock;
+    const auto pGcs = ot::Factory::GCS(
+        api_,
+        19,
+        784931,
+        ot::blockchain::internal::BlockHashToFilterKey(block.ID().Bytes()),
+        block.ExtractElements(style));
+
+    ASSERT_TRUE(pGcs);
+    EXPECT_EQ(1u, pGcs->Match({ot::reader(script)}).size());
+
+    // The script element found by the filter identifies the transaction
+    const auto id = bb::Block::ElementID{
+        0, {bb::Block::Subchain::External, ot::Identifier::Factory()}};
+    const auto matches =
+        block.FindMatches(style, {}, {{id, ot::space(ot::reader(script))}});
+
+    ASSERT_EQ(matches.size(), 1);
+    EXPECT_EQ(matches.front().first.get(), block.at(1)->ID());
+}
 }  // namespace
@@ -0,0 +1,308 @@
+// Copyright (c) 2010-2020 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "OTTestEnvironment.hpp"
+
+#include <set>
+
+namespace
+{
+using Balance = ot::blockchain::Balance;
+using Chain = ot::blockchain::Type;
+
+const auto chain_{Chain::Bitcoin};
+// Matches the per transaction overhead charged by the pool
+constexpr auto overhead_ = std::size_t{256};
+const auto genesis_header_ = std::string{
+    "0100000000000000000000000000000000000000000000000000000000000000000000003b"
+    "a3edfd7a7b12b27ac72c3e67768f617fc81bc3888a51323a9fb8aa4b1e5e4a29ab5f49ffff"
+    "001d1dac2b7c"};
+const auto coinbase_ = std::string{
+    "01000000010000000000000000000000000000000000000000000000000000000000000000"
+    "ffffffff0151ffffffff0100000000000000000151"
+    "00000000"};
+
+// Wallet database which records the transactions reverted by the pool
+class Database final : public ot::blockchain::client::internal::WalletDatabase
+{
+public:
+    mutable std::set<std::string> dropped_;
+
+    auto AddConfirmedTransaction(
+        const NodeID&,
+        const Subchain,
+        const ot::blockchain::block::Position&,
+        const std::vector<std::uint32_t>,
+        const ot::blockchain::block::bitcoin::Transaction&) const noexcept
+        -> bool final
+    {
+        return true;
+    }
+    auto AddMempoolTransaction(
+        const NodeID&,
+        const Subchain,
+        const std::vector<std::uint32_t>,
+        const ot::blockchain::block::bitcoin::Transaction&) const noexcept
+        -> bool final
+    {
+        return true;
+    }
+    auto DropMempoolTransaction(const ot::blockchain::block::Txid& txid) const
+        noexcept -> void final
+    {
+        dropped_.emplace(txid.asHex());
+    }
+    auto FindElement(const KeyType, const ot::ReadView) const noexcept
+        -> std::optional<ElementID> final
+    {
+        return {};
+    }
+    auto GetBalance() const noexcept -> Balance final { return {}; }
+    auto GetBalance(const NodeID&) const noexcept -> Balance final
+    {
+        return {};
+    }
+    auto GetBalance(const NodeID&, const Subchain) const noexcept
+        -> Balance final
+    {
+        return {};
+    }
+    auto GetPatterns(
+        const NodeID&,
+        const Subchain,
+        const FilterType,
+        const ot::VersionNumber) const noexcept -> Patterns final
+    {
+        return {};
+    }
+    auto GetUnspentOutputs() const noexcept -> std::vector<UTXO> final
+    {
+        return {};
+    }
+    auto GetUnspentOutputs(const std::size_t) const noexcept
+        -> UTXOChanges final
+    {
+        return {};
+    }
+    auto GetUntestedPatterns(
+        const NodeID&,
+        const Subchain,
+        const FilterType,
+        const ot::ReadView,
+        const ot::VersionNumber) const noexcept -> Patterns final
+    {
+        return {};
+    }
+    auto IsUnspent(const ot::blockchain::block::bitcoin::Outpoint&) const
+        noexcept -> bool final
+    {
+        return false;
+    }
+    auto ScanThreads() const noexcept -> std::size_t final { return 1; }
+    auto SubchainAddElements(
+        const NodeID&,
+        const Subchain,
+        const FilterType,
+        const ElementMap&,
+        const ElementKeys&,
+        const ot::VersionNumber) const noexcept -> bool final
+    {
+        return true;
+    }
+    auto SubchainDropIndex(
+        const NodeID&,
+        const Subchain,
+        const FilterType,
+        const ot::VersionNumber) const noexcept -> bool final
+    {
+        return true;
+    }
+    auto SubchainIndexVersion(const NodeID&, const Subchain, const FilterType)
+        const noexcept -> ot::VersionNumber final
+    {
+        return 1;
+    }
+    auto SubchainLastIndexed(
+        const NodeID&,
+        const Subchain,
+        const FilterType,
+        const ot::VersionNumber) const noexcept
+        -> std::optional<ot::Bip32Index> final
+    {
+        return {};
+    }
+    auto SubchainMatchBlock(
+        const NodeID&,
+        const Subchain,
+        const FilterType,
+        const MatchingIndices&,
+        const ot::ReadView,
+        const ot::VersionNumber) const noexcept -> bool final
+    {
+        return true;
+    }
+    auto SubchainLastProcessed(const NodeID&, const Subchain, const FilterType)
+        const noexcept -> ot::blockchain::block::Position final
+    {
+        return {-1, ot::Data::Factory()};
+    }
+    auto SubchainLastScanned(const NodeID&, const Subchain, const FilterType)
+        const noexcept -> ot::blockchain::block::Position final
+    {
+        return {-1, ot::Data::Factory()};
+    }
+    auto SubchainSetLastProcessed(
+        const NodeID&,
+        const Subchain,
+        const FilterType,
+        const ot::blockchain::block::Position&) const noexcept -> bool final
+    {
+        return true;
+    }
+    auto SubchainSetLastScanned(
+        const NodeID&,
+        const Subchain,
+        const FilterType,
+        const ot::blockchain::block::Position&) const noexcept -> bool final
+    {
+        return true;
+    }
+};
+
+struct Test_Mempool : public ::testing::Test {
+    using Transaction = ot::blockchain::client::internal::Mempool::Transaction;
+
+    const ot::api::client::internal::Manager& api_;
+    const Database db_;
+
+    // A transaction with one input and one output. Transactions which spend
+    // the same outpoint with a different value conflict with each other.
+    auto make_transaction(const char prevout, const char value) const
+        -> Transaction
+    {
+        const auto hex = std::string{"01000000"} + "01" +
+                         std::string(64, prevout) + "00000000" + "00" +
+                         "ffffffff" + "01" + std::string(16, value) + "0151" +
+                         "00000000";
+        const auto bytes = ot::Data::Factory(hex, ot::Data::Mode::Hex);
+
+        return ot::Factory::BitcoinTransaction(
+            api_,
+            chain_,
+            false,
+            ot::blockchain::bitcoin::EncodedTransaction::Deserialize(
+                api_, chain_, bytes->Bytes()));
+    }
+
+    auto serialize(const Transaction& tx) const -> std::string
+    {
+        auto output = ot::Space{};
+        tx->Serialize(ot::writer(output));
+
+        return ot::Data::Factory(output)->asHex();
+    }
+
+    Test_Mempool()
+        : api_(dynamic_cast<const ot::api::client::internal::Manager&>(
+              ot::Context().StartClient({}, 0)))
+        , db_()
+    {
+    }
+};
+
+TEST_F(Test_Mempool, budget_eviction)
+{
+    const auto first = make_transaction('1', '1');
+    const auto second = make_transaction('2', '1');
+    const auto third = make_transaction('3', '1');
+
+    ASSERT_TRUE(first);
+    ASSERT_TRUE(second);
+    ASSERT_TRUE(third);
+
+    const auto entry = first->CalculateSize() + overhead_;
+    const auto pool = ot::factory::Mempool(api_, db_, 2 * entry);
+
+    ASSERT_TRUE(pool);
+    EXPECT_TRUE(pool->Submit(first));
+    EXPECT_TRUE(pool->Submit(second));
+    EXPECT_FALSE(pool->Submit(second));
+    EXPECT_TRUE(db_.dropped_.empty());
+    EXPECT_TRUE(pool->Submit(third));
+
+    // The oldest transaction was evicted to make room and its wallet changes
+    // were reverted
+    ASSERT_EQ(db_.dropped_.size(), 1);
+    EXPECT_EQ(db_.dropped_.count(first->ID().asHex()), 1);
+
+    auto sequence = std::size_t{0};
+    const auto contents = pool->Dump(sequence);
+
+    ASSERT_EQ(contents.size(), 2);
+    EXPECT_EQ(contents.at(0)->ID(), second->ID());
+    EXPECT_EQ(contents.at(1)->ID(), third->ID());
+    EXPECT_TRUE(pool->Request(first->ID()));
+    EXPECT_FALSE(pool->Request(second->ID()));
+}
+
+TEST_F(Test_Mempool, oversized)
+{
+    const auto tx = make_transaction('1', '1');
+
+    ASSERT_TRUE(tx);
+
+    const auto pool = ot::factory::Mempool(api_, db_, tx->CalculateSize());
+
+    ASSERT_TRUE(pool);
+    EXPECT_FALSE(pool->Submit(tx));
+
+    auto sequence = std::size_t{0};
+
+    EXPECT_EQ(pool->Dump(sequence).size(), 0);
+}
+
+TEST_F(Test_Mempool, prune)
+{
+    const auto spent = make_transaction('1', '1');
+    const auto conflict = make_transaction('1', '2');
+    const auto confirmed = make_transaction('2', '1');
+    const auto unrelated = make_transaction('3', '1');
+
+    ASSERT_TRUE(spent);
+    ASSERT_TRUE(conflict);
+    ASSERT_TRUE(confirmed);
+    ASSERT_TRUE(unrelated);
+    ASSERT_NE(spent->ID(), conflict->ID());
+
+    const auto pool = ot::factory::Mempool(api_, db_, 1024 * 1024);
+
+    ASSERT_TRUE(pool);
+    EXPECT_TRUE(pool->Submit(spent));
+    EXPECT_TRUE(pool->Submit(confirmed));
+    EXPECT_TRUE(pool->Submit(unrelated));
+
+    const auto raw = genesis_header_ + "03" + coinbase_ + serialize(conflict) +
+                     serialize(confirmed);
+    const auto bytes = ot::Data::Factory(raw, ot::Data::Mode::Hex);
+    const auto pBlock = api_.Factory().BitcoinBlock(chain_, bytes->Bytes());
+
+    ASSERT_TRUE(pBlock);
+    ASSERT_EQ(pBlock->size(), 3);
+
+    pool->Prune(*pBlock);
+
+    // Both the confirmed transaction and the transaction which spends the
+    // same outpoint as a confirmed transaction are removed and reverted
+    ASSERT_EQ(db_.dropped_.size(), 2);
+    EXPECT_EQ(db_.dropped_.count(spent->ID().asHex()), 1);
+    EXPECT_EQ(db_.dropped_.count(confirmed->ID().asHex()), 1);
+
+    auto sequence = std::size_t{0};
+    const auto contents = pool->Dump(sequence);
+
+    ASSERT_EQ(contents.size(), 1);
+    EXPECT_EQ(contents.at(0)->ID(), unrelated->ID());
+}
+}  // namespace
@@ -6,11 +6,25 @@
 #include "OTTestEnvironment.hpp"
 
 #include <boost/endian/buffers.hpp>
+#include <boost/multiprecision/cpp_bin_float.hpp>
+#include <boost/multiprecision/cpp_int.hpp>
+#include <chrono>
+#include <stdexcept>
 
 namespace be = boost::endian;
+namespace mp = boost::multiprecision;
 
 namespace
 {
+using UInt256 = ot::blockchain::internal::UInt256;
+
+constexpr auto regtest_nbits_ = std::int32_t{545259519};  // 0x207fffff
+
+auto to_view(const ot::Space& bytes) -> ot::ReadView
+{
+    return {reinterpret_cast<const char*>(bytes.data()), bytes.size()};
+}
+
 class Test_NumericHash : public ::testing::Test
 {
 public:
@@ -143,4 +157,171 @@ TEST_F(Test_NumericHash, nBits_5)
     EXPECT_EQ(hex, number->asHex());
     EXPECT_STREQ("1", ot::Factory::Work(number)->Decimal().c_str());
 }
+
+TEST_F(Test_NumericHash, nBits_small_exponent)
+{
+    EXPECT_EQ("18", ot::Factory::NumericHashNBits(0x01123456)->Decimal());
+    EXPECT_EQ("4660", ot::Factory::NumericHashNBits(0x02123456)->Decimal());
+    EXPECT_EQ("1193046", ot::Factory::NumericHashNBits(0x03123456)->Decimal());
+}
+
+TEST_F(Test_NumericHash, nBits_overflow)
+{
+    const ot::OTNumericHash number{ot::Factory::NumericHashNBits(0x22123456)};
+
+    EXPECT_EQ("0", number->Decimal());
+}
+
+TEST_F(Test_NumericHash, uint256_arithmetic)
+{
+    constexpr auto max = UInt256{} - UInt256{1};
+    constexpr auto one = UInt256{1};
+
+    static_assert(256 == max.Bits());
+    static_assert((max + one).IsZero());
+    static_assert((one << 64) == UInt256{UInt256::Limbs{0, 1, 0, 0}});
+    static_assert((max >> 255) == one);
+    static_assert(
+        UInt256::Divide(one << 200, one << 100).first == (one << 100));
+
+    const auto a = UInt256{UInt256::Limbs{
+        0xffffffffffffffff, 0xffffffffffffffff, 0x0, 0x0}};
+
+    EXPECT_EQ(UInt256(UInt256::Limbs{0x0, 0x0, 0x1, 0x0}), a + one);
+    EXPECT_EQ(a, (a + one) - one);
+    EXPECT_EQ(
+        UInt256(UInt256::Limbs{
+            0xfffffffffffffff6, 0xffffffffffffffff, 0x9, 0x0}),
+        a * 10u);
+    EXPECT_EQ("340282366920938463463374607431768211455", a.Decimal());
+    EXPECT_EQ(
+        "115792089237316195423570985008687907853269984665640564039457584007913"
+        "129639935",
+        max.Decimal());
+
+    const auto [quotient, remainder] = UInt256::Divide(max, a);
+
+    EXPECT_EQ("340282366920938463463374607431768211457", quotient.Decimal());
+    EXPECT_EQ("0", remainder.Decimal());
+    EXPECT_EQ("7", UInt256::Divide(UInt256{47}, UInt256{8}).second.Decimal());
+    EXPECT_THROW(UInt256::Divide(a, UInt256{}), std::domain_error);
+}
+
+TEST_F(Test_NumericHash, uint256_encoding)
+{
+    const auto raw = ot::Data::Factory(
+        "0x00000000000404cb000000000000000000000000000000000000000000000000",
+        ot::Data::Mode::Hex);
+    const auto big = UInt256::BigEndian(raw->Bytes());
+    const auto little = UInt256::LittleEndian(raw->Bytes());
+
+    EXPECT_EQ(0x0404cbu, big.Limb(3));
+    EXPECT_EQ(0xcb04040000000000u, little.Limb(0));
+    EXPECT_EQ(3u, big.Encode().size());
+    EXPECT_EQ(32u, big.Encode(32).size());
+    EXPECT_EQ(big, UInt256::BigEndian(to_view(big.Encode(32))));
+    EXPECT_EQ(1u, UInt256{}.Encode().size());
+
+    const auto tooLong = ot::Data::Factory(
+        "0x010000000000000000000000000000000000000000000000000000000000000000",
+        ot::Data::Mode::Hex);
+
+    EXPECT_THROW(UInt256::BigEndian(tooLong->Bytes()), std::out_of_range);
+    EXPECT_NO_THROW(UInt256::LittleEndian(tooLong->Bytes()));
+}
+
+TEST_F(Test_NumericHash, work_fraction)
+{
+    const ot::OTNumericHash target{
+        ot::Factory::NumericHashNBits(regtest_nbits_)};
+    const ot::OTWork work{ot::Factory::Work(target)};
+
+    EXPECT_EQ("0.0000000004656542373", work->Decimal());
+    EXPECT_EQ("00", work->asHex());
+
+    auto sum = ot::OTWork{ot::Factory::Work(target)};
+
+    for (auto i = 0; i < 4; ++i) { sum = sum + work; }
+
+    EXPECT_EQ("0.0000000023282711866", sum->Decimal());
+    EXPECT_TRUE(work < sum);
+}
+
+TEST_F(Test_NumericHash, work_serialization)
+{
+    const ot::OTWork work{ot::Factory::Work("03e8")};
+
+    EXPECT_EQ("1000", work->Decimal());
+    EXPECT_EQ("03e8", work->asHex());
+
+    const ot::OTNumericHash target{ot::Factory::NumericHashNBits(453248203)};
+    const ot::OTWork difficulty{ot::Factory::Work(target)};
+    const ot::OTWork restored{ot::Factory::Work(difficulty->asHex())};
+
+    EXPECT_EQ("16307.4209385239832783411", difficulty->Decimal());
+    EXPECT_EQ("3fb3", difficulty->asHex());
+    EXPECT_EQ("16307", restored->Decimal());
+}
+
+TEST_F(Test_NumericHash, benchmark)
+{
+    using Clock = std::chrono::steady_clock;
+    using Float = mp::cpp_bin_float_double;
+    using Int = mp::checked_cpp_int;
+
+    constexpr auto iterations = 20000;
+    constexpr auto nBits = std::uint32_t{453248203};  // 0x1b0404cb
+    const auto seconds = [](const auto start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    };
+    const auto hash = ot::Data::Factory(
+        "0x0000000000000000000000000000000000000000000000cb0404000000000000",
+        ot::Data::Mode::Hex);
+
+    auto legacyHits = 0;
+    auto legacyWork = Float{};
+    const auto legacyStart = Clock::now();
+
+    for (auto i = 0; i < iterations; ++i) {
+        const auto max = Int{0xffff} << (8 * (0x1d - 3));
+        const auto target = Int{nBits & 0x00ffffff}
+                            << (8 * ((nBits >> 24) - 3));
+        auto value = Int{};
+        mp::import_bits(value, hash->begin(), hash->end(), 8, false);
+
+        if (value < target) { ++legacyHits; }
+
+        legacyWork += Float{max} / Float{target};
+    }
+
+    const auto legacy = seconds(legacyStart);
+
+    auto hits = 0;
+    auto work = ot::OTWork{ot::Factory::Work("00")};
+    const auto start = Clock::now();
+
+    for (auto i = 0; i < iterations; ++i) {
+        const ot::OTNumericHash target{
+            ot::Factory::NumericHashNBits(static_cast<std::int32_t>(nBits))};
+        const ot::OTNumericHash value{ot::Factory::NumericHash(hash)};
+
+        if (value < target) { ++hits; }
+
+        work = work + ot::OTWork{ot::Factory::Work(target)};
+    }
+
+    const auto current = seconds(start);
+
+    EXPECT_EQ(iterations, legacyHits);
+    EXPECT_EQ(iterations, hits);
+    EXPECT_EQ(
+        mp::cpp_int(legacyWork).str(),
+        work->Decimal().substr(0, work->Decimal().find('.')));
+
+    RecordProperty(
+        "boost_multiprecision_headers_per_second",
+        static_cast<int>(iterations / legacy));
+    RecordProperty(
+        "uint256_headers_per_second", static_cast<int>(iterations / current));
+}
 }  // namespace
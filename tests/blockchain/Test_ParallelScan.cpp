@@ -0,0 +1,228 @@
+// Copyright (c) 2010-2020 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "OTTestEnvironment.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+namespace
+{
+using Height = ot::blockchain::block::Height;
+using Job = ot::blockchain::client::internal::ParallelScan;
+
+struct Test_ParallelScan : public ::testing::Test {
+    const ot::api::client::Manager& api_;
+    std::mutex lock_;
+    std::vector<std::thread> threads_;
+    const Job::Dispatch dispatch_;
+
+    auto Join() -> void
+    {
+        auto threads = std::vector<std::thread>{};
+
+        {
+            ot::Lock lock(lock_);
+            threads.swap(threads_);
+        }
+
+        for (auto& thread : threads) { thread.join(); }
+    }
+
+    Test_ParallelScan()
+        : api_(ot::Context().StartClient({}, 0))
+        , lock_()
+        , threads_()
+        , dispatch_([this](auto& job, const auto generation) {
+            ot::Lock lock(lock_);
+            threads_.emplace_back([&job, generation] { job.Help(generation); });
+        })
+    {
+    }
+
+    ~Test_ParallelScan() { Join(); }
+};
+
+TEST_F(Test_ParallelScan, every_height_once)
+{
+    constexpr auto first = Height{10};
+    constexpr auto last = Height{1009};
+    auto job = Job{4, 7};
+    auto counts = std::vector<std::atomic<int>>(last + 1);
+    const auto process = [&](const Height height) -> bool {
+        ++counts.at(height);
+
+        return true;
+    };
+    const auto scanned = job.Run(first, last, process, dispatch_);
+    Join();
+
+    ASSERT_TRUE(scanned.has_value());
+    EXPECT_EQ(last, scanned.value());
+
+    for (auto i = Height{0}; i <= last; ++i) {
+        EXPECT_EQ((i < first) ? 0 : 1, counts.at(i).load());
+    }
+}
+
+TEST_F(Test_ParallelScan, stops_at_missing_block)
+{
+    constexpr auto missing = Height{537};
+    auto job = Job{8, 10};
+    const auto process = [&](const Height height) -> bool {
+        return height < missing;
+    };
+    const auto scanned = job.Run(0, 999, process, dispatch_);
+    Join();
+
+    ASSERT_TRUE(scanned.has_value());
+    EXPECT_EQ(missing - 1, scanned.value());
+
+    const auto none = job.Run(
+        missing, 999, [](const auto) { return false; }, dispatch_);
+    Join();
+
+    EXPECT_FALSE(none.has_value());
+}
+
+TEST_F(Test_ParallelScan, helpers_never_scheduled)
+{
+    auto job = Job{16, 3};
+    auto pending = std::vector<std::size_t>{};
+    auto count = std::atomic<Height>{0};
+    const auto process = [&](const Height) -> bool {
+        ++count;
+
+        return true;
+    };
+    const auto scanned = job.Run(
+        1, 100, process, [&](auto&, const auto generation) {
+            pending.emplace_back(generation);
+        });
+
+    ASSERT_TRUE(scanned.has_value());
+    EXPECT_EQ(100, scanned.value());
+    EXPECT_EQ(100, count.load());
+    EXPECT_EQ(15u, pending.size());
+
+    // Late helpers must not run anything
+    for (const auto generation : pending) { job.Help(generation); }
+
+    EXPECT_EQ(100, count.load());
+}
+
+TEST_F(Test_ParallelScan, queued_helpers_outlive_job)
+{
+    namespace zmq = ot::network::zeromq;
+
+    const auto endpoint = std::string{"inproc://opentxs/test/parallel_scan"};
+    auto queued = std::vector<ot::OTZMQMessage>{};
+    auto callback = zmq::ListenCallback::Factory([&](auto& in) {
+        ot::Lock lock(lock_);
+        queued.emplace_back(api_.ZeroMQ().Message(in));
+    });
+    auto pull = api_.ZeroMQ().PullSocket(
+        callback, zmq::socket::Socket::Direction::Bind);
+    auto push =
+        api_.ZeroMQ().PushSocket(zmq::socket::Socket::Direction::Connect);
+
+    ASSERT_TRUE(pull->Start(endpoint));
+    ASSERT_TRUE(push->Start(endpoint));
+
+    auto count = std::atomic<Height>{0};
+    const auto process = [&](const Height) -> bool {
+        ++count;
+
+        return true;
+    };
+
+    {
+        auto job = Job{4, 10};
+        const auto scanned = job.Run(
+            1,
+            100,
+            process,
+            Job::Dispatcher(api_, push, ot::blockchain::Type::Bitcoin));
+
+        ASSERT_TRUE(scanned.has_value());
+        EXPECT_EQ(100, scanned.value());
+    }
+
+    const auto end =
+        std::chrono::steady_clock::now() + std::chrono::seconds(15);
+
+    while (std::chrono::steady_clock::now() < end) {
+        {
+            ot::Lock lock(lock_);
+
+            if (3u <= queued.size()) { break; }
+        }
+
+        ot::Sleep(std::chrono::milliseconds(10));
+    }
+
+    ot::Lock lock(lock_);
+
+    ASSERT_EQ(3u, queued.size());
+
+    // The job no longer exists so the helpers must not do anything
+    for (const auto& message : queued) { Job::ProcessTask(message); }
+
+    EXPECT_EQ(100, count.load());
+}
+
+TEST_F(Test_ParallelScan, throughput)
+{
+    constexpr auto blocks = Height{2000};
+    constexpr auto elements = std::size_t{1000};
+    constexpr auto targets = std::size_t{400};
+    auto key = std::string{"0123456789abcdef"};
+    auto items = std::vector<ot::OTData>{};
+    auto patterns = std::vector<ot::OTData>{};
+
+    for (auto i = std::size_t{0}; i < elements; ++i) {
+        auto& item = items.emplace_back(api_.Factory().Data());
+        item->Randomize(25);
+    }
+
+    for (auto i = std::size_t{0}; i < targets; ++i) {
+        auto& item = patterns.emplace_back(api_.Factory().Data());
+        item->Randomize(25);
+    }
+
+    const auto pGcs = ot::Factory::GCS(api_, 19, 784931, key, items);
+
+    ASSERT_TRUE(pGcs);
+
+    const auto& gcs = *pGcs;
+    auto views = ot::blockchain::internal::GCS::Targets{};
+
+    for (const auto& item : patterns) { views.emplace_back(item->Bytes()); }
+
+    const auto process = [&](const Height) -> bool {
+        return gcs.Match(views).size() <= views.size();
+    };
+    const auto max = std::max(std::thread::hardware_concurrency(), 1u);
+
+    for (auto threads = 1u; threads <= max; threads *= 2u) {
+        auto job = Job{threads};
+        const auto start = std::chrono::steady_clock::now();
+        const auto scanned = job.Run(1, blocks, process, dispatch_);
+        const auto seconds = std::chrono::duration<double>(
+                                 std::chrono::steady_clock::now() - start)
+                                 .count();
+        Join();
+
+        ASSERT_TRUE(scanned.has_value());
+        EXPECT_EQ(blocks, scanned.value());
+
+        RecordProperty(
+            std::to_string(threads) + "_threads_filters_per_second",
+            static_cast<int>(blocks / seconds));
+    }
+}
+}  // namespace
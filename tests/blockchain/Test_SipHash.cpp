@@ -0,0 +1,154 @@
+// Copyright (c) 2010-2020 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "OTTestEnvironment.hpp"
+
+#include "Bip158.hpp"
+
+namespace
+{
+using Lanes = ot::blockchain::internal::SipHash::Lanes;
+
+struct Test_SipHash : public ::testing::Test {
+    const ot::api::client::Manager& api_;
+
+    auto Reference(const ot::ReadView key, const ot::ReadView item) const
+        -> std::uint64_t
+    {
+        auto output = std::uint64_t{};
+        const auto writer = [&output](const auto size) -> ot::WritableView {
+            EXPECT_EQ(sizeof(output), size);
+
+            return {&output, sizeof(output)};
+        };
+
+        EXPECT_TRUE(api_.Crypto().Hash().HMAC(
+            ot::proto::HASHTYPE_SIPHASH24, key, item, writer));
+
+        return output;
+    }
+
+    auto Elements(const Bip158Vector& vector, std::vector<ot::OTData>& out)
+        const -> std::vector<ot::ReadView>
+    {
+        const auto raw = vector.Block(api_);
+        const auto pBlock = api_.Factory().BitcoinBlock(
+            ot::blockchain::Type::Bitcoin_testnet3, raw->Bytes());
+
+        EXPECT_TRUE(pBlock);
+
+        if (false == bool(pBlock)) { return {}; }
+
+        for (const auto& bytes : pBlock->ExtractElements(
+                 ot::blockchain::filter::Type::Basic_BIP158)) {
+            out.emplace_back(api_.Factory().Data(ot::reader(bytes)));
+        }
+
+        for (auto& bytes : vector.PreviousOutputs(api_)) {
+            if ((nullptr != bytes->data()) && (0 != bytes->size())) {
+                out.emplace_back(std::move(bytes));
+            }
+        }
+
+        std::sort(out.begin(), out.end());
+        out.erase(std::unique(out.begin(), out.end()), out.end());
+        auto output = std::vector<ot::ReadView>{};
+
+        for (const auto& item : out) { output.emplace_back(item->Bytes()); }
+
+        return output;
+    }
+
+    Test_SipHash()
+        : api_(ot::Context().StartClient({}, 0))
+    {
+    }
+};
+
+TEST_F(Test_SipHash, reference_vectors)
+{
+    // https://github.com/veorq/SipHash/blob/master/vectors.h
+    const auto expected = std::vector<std::uint64_t>{
+        0x726fdb47dd0e0e31,
+        0x74f839c593dc67fd,
+        0x0d6c8009d9a94f5a,
+        0x85676696d7fb7e2d,
+        0xcf2794e0277187b7,
+        0x18765564cd99a68d,
+        0xcbc9466e58fee3ce,
+        0xab0200f58b01d137,
+        0x93f5f5799a932462,
+        0x9e0082df0ba9e4b0,
+        0x7a5dbbc594ddb9f3,
+        0xf4b32f46226bada7,
+        0x751e8fbc860ee5fb,
+        0x14ea5627c0843d90,
+        0xf723ca908e7af2ee,
+        0xa129ca6149be45e5,
+    };
+    auto key = std::string{};
+
+    for (auto i = char{0}; i < 16; ++i) { key.push_back(i); }
+
+    const auto hasher = ot::blockchain::internal::SipHash{key};
+    auto messages = std::vector<std::string>{};
+    auto message = std::string{};
+
+    for (auto i = std::size_t{0}; i < expected.size(); ++i) {
+        messages.emplace_back(message);
+        message.push_back(static_cast<char>(i));
+    }
+
+    const auto items =
+        std::vector<ot::ReadView>(messages.begin(), messages.end());
+
+    for (auto i = std::size_t{0}; i < items.size(); ++i) {
+        EXPECT_EQ(hasher(items.at(i)), expected.at(i));
+    }
+
+    for (const auto lanes : {Lanes::Scalar, Lanes::SSE2, Lanes::AVX2}) {
+        EXPECT_EQ(hasher.Batch(items, lanes), expected);
+    }
+}
+
+TEST_F(Test_SipHash, bip158)
+{
+    for (const auto& vector : bip_158_vectors_) {
+        auto buffer = std::vector<ot::OTData>{};
+        const auto elements = Elements(vector, buffer);
+        const auto blockHash = vector.BlockHash(api_);
+        const auto key =
+            ot::blockchain::internal::BlockHashToFilterKey(blockHash->Bytes());
+        const auto hasher = ot::blockchain::internal::SipHash{key};
+        auto expected = std::vector<std::uint64_t>{};
+
+        for (const auto& element : elements) {
+            const auto hash = hasher(element);
+
+            EXPECT_EQ(hash, Reference(key, element));
+
+            expected.emplace_back(hash);
+        }
+
+        for (const auto lanes : {Lanes::Scalar, Lanes::SSE2, Lanes::AVX2}) {
+            EXPECT_EQ(hasher.Batch(elements, lanes), expected);
+        }
+
+        const auto N = static_cast<std::uint32_t>(elements.size());
+        const auto set = ot::gcs::HashedSetConstruct(
+            hasher, std::uint64_t{N} * 784931u, elements);
+
+        EXPECT_EQ(
+            set, ot::gcs::HashedSetConstruct(api_, key, N, 784931, elements));
+
+        const auto encoded = ot::gcs::GolombEncode(19, set);
+        const auto compact = ot::blockchain::bitcoin::CompactSize(N).Encode();
+        auto filter = ot::Data::Factory(compact.data(), compact.size());
+        filter->Concatenate(encoded.data(), encoded.size());
+
+        EXPECT_EQ(filter.get(), vector.Filter(api_).get());
+    }
+}
+}  // namespace
@@ -0,0 +1,326 @@
+// Copyright (c) 2010-2020 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "OTTestEnvironment.hpp"
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+
+namespace
+{
+namespace b = ot::blockchain;
+namespace bc = b::client;
+
+using Balance = b::Balance;
+using Database = bc::internal::WalletDatabase;
+using Outpoint = b::block::bitcoin::Outpoint;
+using Subchain = Database::Subchain;
+
+const auto chain_{b::Type::Bitcoin};
+const auto filter_{b::filter::Type::Basic_BIP158};
+
+class Test_WalletDatabase : public ::testing::Test
+{
+public:
+    const ot::api::client::internal::Manager& api_;
+    // Every test uses its own balance node since the database is shared
+    const ot::OTIdentifier node_;
+    std::unique_ptr<bc::internal::Network> network_;
+
+    auto db() const -> const Database& { return network_->DB(); }
+    // A transaction with one input and one output. The value is encoded as
+    // eight little endian bytes.
+    auto make_transaction(const std::string& prevout, const std::string& value)
+        const -> std::shared_ptr<const b::block::bitcoin::Transaction>
+    {
+        const auto hex = std::string{"01000000"} + "01" + prevout +
+                         "00000000" + "00" + "ffffffff" + "01" + value +
+                         "0151" + "00000000";
+        const auto bytes = ot::Data::Factory(hex, ot::Data::Mode::Hex);
+
+        return ot::Factory::BitcoinTransaction(
+            api_,
+            chain_,
+            false,
+            ot::blockchain::bitcoin::EncodedTransaction::Deserialize(
+                api_, chain_, bytes->Bytes()));
+    }
+    auto position(const b::block::Height height, const char fill) const
+        -> b::block::Position
+    {
+        return {
+            height,
+            ot::Data::Factory(std::string(64, fill), ot::Data::Mode::Hex)};
+    }
+    // Closes the chain database and opens it again
+    auto restart() -> void
+    {
+        network_.reset();
+        network_ = start();
+
+        ASSERT_TRUE(network_);
+    }
+    auto start() const -> std::unique_ptr<bc::internal::Network>
+    {
+        return ot::factory::BlockchainNetworkBitcoin(
+            api_,
+            dynamic_cast<const ot::api::client::internal::Blockchain&>(
+                api_.Blockchain()),
+            chain_,
+            "do not init peers",
+            "inproc://empty");
+    }
+
+    Test_WalletDatabase()
+        : api_(dynamic_cast<const ot::api::client::internal::Manager&>(
+              ot::Context().StartClient({}, 0)))
+        , node_(ot::Identifier::Random())
+        , network_(start())
+    {
+    }
+};
+
+TEST_F(Test_WalletDatabase, resume_after_restart)
+{
+    const auto subchain = Subchain::External;
+    auto elements = Database::ElementMap{};
+
+    for (auto i = ot::Bip32Index{0}; i < 3; ++i) {
+        elements[i].emplace_back(
+            ot::space(std::string{"pattern "} + std::to_string(i)));
+    }
+
+    ASSERT_TRUE(network_);
+    ASSERT_TRUE(
+        db().SubchainAddElements(node_, subchain, filter_, elements, {}));
+
+    const auto first = position(1, '1');
+    const auto second = position(2, '2');
+    const auto unmatched = position(3, '3');
+
+    ASSERT_TRUE(db().SubchainMatchBlock(
+        node_, subchain, filter_, {0}, first.second->Bytes()));
+    ASSERT_TRUE(db().SubchainMatchBlock(
+        node_, subchain, filter_, {1, 2}, second.second->Bytes()));
+    ASSERT_TRUE(db().SubchainSetLastScanned(node_, subchain, filter_, second));
+    ASSERT_TRUE(db().SubchainSetLastProcessed(node_, subchain, filter_, first));
+
+    restart();
+
+    EXPECT_EQ(
+        db().SubchainIndexVersion(node_, subchain, filter_),
+        Database::DefaultIndexVersion);
+
+    const auto indexed = db().SubchainLastIndexed(node_, subchain, filter_);
+
+    ASSERT_TRUE(indexed.has_value());
+    EXPECT_EQ(indexed.value(), 2);
+
+    const auto scanned = db().SubchainLastScanned(node_, subchain, filter_);
+    const auto processed = db().SubchainLastProcessed(node_, subchain, filter_);
+
+    EXPECT_EQ(scanned.first, second.first);
+    EXPECT_EQ(scanned.second->asHex(), second.second->asHex());
+    EXPECT_EQ(processed.first, first.first);
+    EXPECT_EQ(processed.second->asHex(), first.second->asHex());
+    EXPECT_EQ(db().GetPatterns(node_, subchain, filter_).size(), 3);
+
+    // Elements which already matched a block are not tested against it again
+    const auto untested = [&](const auto& block) {
+        auto output = std::set<ot::Bip32Index>{};
+
+        for (const auto& [id, pattern] : db().GetUntestedPatterns(
+                 node_, subchain, filter_, block.second->Bytes())) {
+            output.emplace(id.first);
+        }
+
+        return output;
+    };
+
+    EXPECT_EQ(untested(first), (std::set<ot::Bip32Index>{1, 2}));
+    EXPECT_EQ(untested(second), (std::set<ot::Bip32Index>{0}));
+    EXPECT_EQ(untested(unmatched), (std::set<ot::Bip32Index>{0, 1, 2}));
+}
+
+TEST_F(Test_WalletDatabase, change_feed)
+{
+    const auto subchain = Subchain::External;
+    const auto initial = db().GetUnspentOutputs(0);
+
+    EXPECT_TRUE(initial.reset_);
+
+    // The balance node is random so every run creates new transactions
+    const auto funding = make_transaction(node_->asHex(), "e803000000000000");
+
+    ASSERT_TRUE(funding);
+
+    const auto funded = Outpoint{funding->ID().Bytes(), 0};
+
+    ASSERT_TRUE(db().AddConfirmedTransaction(
+        node_, subchain, position(1, '1'), {0}, *funding));
+
+    // Only the latest change to each of this test's outputs is checked since
+    // other tests share the database
+    const auto changes = [&](const std::size_t epoch) {
+        auto output = std::map<Outpoint, bool>{};
+        const auto feed = db().GetUnspentOutputs(epoch);
+
+        EXPECT_FALSE(feed.reset_);
+
+        for (const auto& [outpoint, serialized] : feed.added_) {
+            output.emplace(outpoint, true);
+        }
+
+        for (const auto& outpoint : feed.spent_) {
+            output.emplace(outpoint, false);
+        }
+
+        return std::make_pair(feed.epoch_, output);
+    };
+    const auto [afterFunding, added] = changes(initial.epoch_);
+
+    EXPECT_LT(initial.epoch_, afterFunding);
+    EXPECT_EQ(added.count(funded), 1);
+    EXPECT_TRUE(added.at(funded));
+
+    const auto spend =
+        make_transaction(funding->ID().asHex(), "e803000000000000");
+
+    ASSERT_TRUE(spend);
+
+    const auto change = Outpoint{spend->ID().Bytes(), 0};
+
+    ASSERT_TRUE(db().AddConfirmedTransaction(
+        node_, subchain, position(2, '2'), {0}, *spend));
+
+    // Resuming from the first epoch reports the net effect of both blocks
+    const auto [afterSpend, both] = changes(initial.epoch_);
+
+    EXPECT_LT(afterFunding, afterSpend);
+    EXPECT_EQ(both.count(funded), 1);
+    EXPECT_FALSE(both.at(funded));
+    EXPECT_EQ(both.count(change), 1);
+    EXPECT_TRUE(both.at(change));
+
+    // Resuming from the previous epoch reports only the second block
+    const auto [resumed, second] = changes(afterFunding);
+
+    EXPECT_EQ(resumed, afterSpend);
+    EXPECT_EQ(second.size(), 2);
+    EXPECT_FALSE(second.at(funded));
+    EXPECT_TRUE(second.at(change));
+
+    // Resuming from the latest epoch reports nothing
+    const auto [latest, none] = changes(afterSpend);
+
+    EXPECT_EQ(latest, afterSpend);
+    EXPECT_TRUE(none.empty());
+
+    restart();
+
+    // Epochs issued before a restart are not valid afterwards
+    const auto reset = db().GetUnspentOutputs(afterSpend);
+    auto unspent = std::set<Outpoint>{};
+
+    for (const auto& [outpoint, serialized] : reset.added_) {
+        unspent.emplace(outpoint);
+    }
+
+    EXPECT_TRUE(reset.reset_);
+    EXPECT_TRUE(reset.spent_.empty());
+    EXPECT_EQ(unspent.count(funded), 0);
+    EXPECT_EQ(unspent.count(change), 1);
+}
+
+TEST_F(Test_WalletDatabase, balance)
+{
+    const auto subchain = Subchain::Internal;
+    const auto funding = make_transaction(node_->asHex(), "e803000000000000");
+    const auto spend =
+        make_transaction(funding->ID().asHex(), "5802000000000000");
+
+    ASSERT_TRUE(funding);
+    ASSERT_TRUE(spend);
+    ASSERT_TRUE(db().AddConfirmedTransaction(
+        node_, subchain, position(1, '1'), {0}, *funding));
+    EXPECT_EQ(db().GetBalance(node_), Balance(1000, 1000));
+    EXPECT_EQ(db().GetBalance(node_, subchain), Balance(1000, 1000));
+    EXPECT_EQ(db().GetBalance(node_, Subchain::External), Balance(0, 0));
+
+    // A reorg confirms the same transaction in a different block
+    ASSERT_TRUE(db().AddConfirmedTransaction(
+        node_, subchain, position(2, 'a'), {0}, *funding));
+    EXPECT_EQ(db().GetBalance(node_), Balance(1000, 1000));
+
+    ASSERT_TRUE(db().AddMempoolTransaction(node_, subchain, {0}, *spend));
+    EXPECT_EQ(db().GetBalance(node_), Balance(1000, 600));
+
+    db().DropMempoolTransaction(spend->ID());
+
+    EXPECT_EQ(db().GetBalance(node_), Balance(1000, 1000));
+    ASSERT_TRUE(db().AddConfirmedTransaction(
+        node_, subchain, position(3, '3'), {0}, *spend));
+    EXPECT_EQ(db().GetBalance(node_), Balance(600, 600));
+    EXPECT_EQ(db().GetBalance(node_, subchain), Balance(600, 600));
+
+    restart();
+
+    EXPECT_EQ(db().GetBalance(node_), Balance(600, 600));
+    EXPECT_EQ(db().GetBalance(node_, subchain), Balance(600, 600));
+}
+
+TEST_F(Test_WalletDatabase, element_keys_after_restart)
+{
+    using KeyType = Database::KeyType;
+
+    const auto subchain = Subchain::External;
+    // The balance node is random so every run indexes new keys
+    const auto key = [&](const std::string& name) {
+        return ot::space(node_->asHex() + name);
+    };
+    auto elements = Database::ElementMap{};
+    auto keys = Database::ElementKeys{};
+    elements[0].emplace_back(key("pattern 0"));
+    elements[1].emplace_back(key("pattern 1"));
+    keys[0].emplace_back(KeyType::Pubkey, key("pubkey 0"));
+    keys[0].emplace_back(KeyType::PubkeyHash, key("hash 0"));
+    keys[1].emplace_back(KeyType::PubkeyHash, key("hash 1"));
+
+    ASSERT_TRUE(
+        db().SubchainAddElements(node_, subchain, filter_, elements, keys));
+
+    const auto check = [&](const KeyType type,
+                           const std::string& name,
+                           const ot::Bip32Index expected) {
+        const auto found = db().FindElement(type, ot::reader(key(name)));
+
+        ASSERT_TRUE(found.has_value());
+
+        const auto& [index, id] = found.value();
+
+        EXPECT_EQ(index, expected);
+        EXPECT_EQ(id.first, subchain);
+        EXPECT_EQ(id.second.get(), node_.get());
+    };
+
+    check(KeyType::Pubkey, "pubkey 0", 0);
+
+    restart();
+
+    check(KeyType::Pubkey, "pubkey 0", 0);
+    check(KeyType::PubkeyHash, "hash 0", 0);
+    check(KeyType::PubkeyHash, "hash 1", 1);
+
+    // Keys are indexed by type as well as value
+    EXPECT_FALSE(
+        db().FindElement(KeyType::ScriptHash, ot::reader(key("hash 0")))
+            .has_value());
+    EXPECT_FALSE(
+        db().FindElement(KeyType::Pubkey, ot::reader(key("pubkey 2")))
+            .has_value());
+}
+}  // namespace
@@ -5,6 +5,9 @@
 
 #include "OTTestEnvironment.hpp"
 
+#include <mutex>
+#include <thread>
+
 namespace b = ot::blockchain;
 namespace bb = b::block;
 namespace bc = b::client;
@@ -38,6 +41,10 @@ public:
         std::tuple<std::string, std::string, bb::Height, Status, Status>;
     using PostStateVector = std::vector<HeaderData>;
     using ExpectedSiblings = std::set<std::string>;
+    using Job = bc::internal::ParallelScan;
+
+    // Index of the header modified by break_work
+    static constexpr auto invalid_ = std::size_t{1234};
 
     static const std::vector<Block> create_1_;
     static const std::vector<Test> sequence_1_;
@@ -90,6 +97,10 @@ public:
     static const std::vector<Block> create_10_;
     static const std::vector<Test> sequence_10_;
     static const std::vector<std::string> bitcoin_;
+    // Runs each helper on a new thread which is joined by join()
+    static const Job::Dispatch dispatch_;
+    static std::mutex lock_;
+    static std::vector<std::thread> threads_;
 
     const ot::api::client::internal::Manager& api_;
     const b::Type type_;
@@ -125,6 +136,14 @@ public:
         return header_oracle_.AddHeaders(headers);
     }
 
+    // Changing the nonce produces a hash which does not meet the target
+    [[maybe_unused]] static void break_work(
+        ot::Space& headers,
+        const std::size_t index)
+    {
+        headers.at((index * 80) + 76) ^= std::byte{0x01};
+    }
+
     [[maybe_unused]] bool create_blocks(const std::vector<Block>& vector)
     {
         for (const auto& [parent, child] : vector) {
@@ -162,6 +181,18 @@ public:
         }
     }
 
+    [[maybe_unused]] static void join()
+    {
+        auto threads = std::vector<std::thread>{};
+
+        {
+            ot::Lock lock(lock_);
+            threads.swap(threads_);
+        }
+
+        for (auto& thread : threads) { thread.join(); }
+    }
+
     [[maybe_unused]] bool make_test_block(
         const std::string& hash,
         const bb::Hash& parent)
@@ -2790,4 +2821,12 @@ const std::vector<std::string> Test_HeaderOracle::bitcoin_{
     {"0100000026a22e3c2d19d49a1c1cb8a68e6ab77440c30e5974404a2a806d49a100000000eabf215e0cc526ff9802fe16717dfe87d734bc90bbeaddbcd61a0831e672f010bbcc7e49ffff001d0035ceb2"},
 };
 // clang-format on
+
+const Test_HeaderOracle::Job::Dispatch Test_HeaderOracle::dispatch_{
+    [](auto& job, const auto generation) {
+        ot::Lock lock(lock_);
+        threads_.emplace_back([&job, generation] { job.Help(generation); });
+    }};
+std::mutex Test_HeaderOracle::lock_{};
+std::vector<std::thread> Test_HeaderOracle::threads_{};
 }  // namespace
@@ -0,0 +1,203 @@
+// Copyright (c) 2010-2020 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "Helpers.hpp"
+
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <iterator>
+
+#include "Factory.hpp"
+#include "blockchain/bitcoin/CompactSize.hpp"
+#include "blockchain/client/Bootstrap.hpp"
+#include "internal/blockchain/block/Block.hpp"
+
+namespace
+{
+namespace fs = boost::filesystem;
+
+constexpr auto filtered_ = std::size_t{100};
+
+auto append(ot::Space& out, const ot::ReadView in) -> void
+{
+    const auto* it = reinterpret_cast<const std::byte*>(in.data());
+    out.insert(out.end(), it, it + in.size());
+}
+
+auto read(const fs::path& file) -> ot::Space
+{
+    auto in = std::ifstream{file.string(), std::ios::binary};
+    const auto bytes = std::vector<char>{
+        std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+    const auto* it = reinterpret_cast<const std::byte*>(bytes.data());
+
+    return ot::Space{it, it + bytes.size()};
+}
+
+auto write(const fs::path& file, const ot::Space& bytes) -> void
+{
+    auto out = std::ofstream{file.string(), std::ios::binary};
+    out.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+}
+
+auto directory() -> fs::path
+{
+    auto output = fs::temp_directory_path() / fs::unique_path();
+    fs::create_directories(output);
+
+    return output;
+}
+}  // namespace
+
+TEST_F(Test_HeaderOracle, bootstrap)
+{
+    constexpr auto filterType = b::filter::Type::Basic_BIP158;
+    auto& oracle = dynamic_cast<bc::internal::HeaderOracle&>(header_oracle_);
+    auto& database = network_->DB();
+    const auto instantiate =
+        [&](const ot::ReadView bytes) -> std::unique_ptr<bb::Header> {
+        return api_.Factory().BlockHeader(
+            type_, ot::Data::Factory(bytes.data(), bytes.size()));
+    };
+    auto job = Job{4, 50};
+    auto bootstrap = bc::Bootstrap{api_, type_, oracle, database};
+
+    if (false == bc::Bootstrap::Enabled()) {
+        const auto missing = directory();
+
+        EXPECT_FALSE(
+            bootstrap.Import(missing.string(), instantiate, job, dispatch_));
+
+        return;
+    }
+
+    const auto& genesis = bc::HeaderOracle::GenesisBlockHash(type_);
+    const auto genesisView = oracle.LoadHeaderView(genesis.Bytes());
+
+    ASSERT_TRUE(genesisView.has_value());
+
+    auto headers = ot::Space{};
+    append(headers, genesisView->Record().Raw());
+
+    for (const auto& hex : bitcoin_) {
+        append(headers, ot::Data::Factory(hex, ot::Data::Mode::Hex)->Bytes());
+    }
+
+    constexpr auto size = bc::Bootstrap::header_bytes_;
+    const auto input = directory();
+    const auto file = input / "BTC.headers";
+
+    auto modified = headers;
+    break_work(modified, invalid_);
+    write(file, modified);
+
+    EXPECT_TRUE(bootstrap.Import(input.string(), instantiate, job, dispatch_));
+    join();
+    EXPECT_EQ(header_oracle_.BestChain().first, invalid_ - 1);
+
+    write(file, headers);
+
+    EXPECT_TRUE(bootstrap.Import(input.string(), instantiate, job, dispatch_));
+    join();
+    EXPECT_EQ(header_oracle_.BestChain().first, bitcoin_.size());
+
+    // Synthetic filters which commit to each block hash
+    auto cfheaders = ot::Space{};
+    auto cfilters = ot::Space{};
+    auto previous = database.LoadFilterHeader(filterType, genesis.Bytes());
+
+    for (auto height = std::size_t{0}; height <= filtered_; ++height) {
+        const auto block = header_oracle_.BestHash(height);
+        const auto pFilter = ot::Factory::GCS(
+            api_,
+            19,
+            784931,
+            b::internal::BlockHashToFilterKey(block->Bytes()),
+            std::vector<ot::Space>{ot::space(block->Bytes())});
+
+        ASSERT_TRUE(pFilter);
+
+        const auto hash = (0 == height)
+                              ? database.LoadFilterHash(
+                                    filterType, genesis.Bytes())
+                              : pFilter->Hash();
+        const auto header =
+            (0 == height)
+                ? previous
+                : b::internal::FilterHashToHeader(
+                      api_, hash->Bytes(), previous->Bytes());
+        append(cfheaders, hash->Bytes());
+        append(cfheaders, header->Bytes());
+        previous = header;
+        auto record = ot::Space{};
+
+        if (0 == height) {
+            database.ReadFilter(
+                filterType, genesis.Bytes(), [&](const auto& filter) {
+                    filter.Serialize(ot::writer(record));
+                });
+        } else {
+            ASSERT_TRUE(pFilter->Serialize(ot::writer(record)));
+        }
+
+        const auto cs = b::bitcoin::CompactSize(record.size()).Encode();
+        cfilters.insert(cfilters.end(), cs.begin(), cs.end());
+        cfilters.insert(cfilters.end(), record.begin(), record.end());
+    }
+
+    // A filter header which does not commit to the previous header
+    auto broken = cfheaders;
+    broken.at((invalid_ % filtered_) * bc::Bootstrap::filter_header_bytes_) ^=
+        std::byte{0x01};
+    write(input / "BTC.cfheaders", broken);
+
+    EXPECT_TRUE(bootstrap.Import(input.string(), instantiate, job, dispatch_));
+    join();
+    EXPECT_EQ(
+        database.FilterHeaderTip(filterType).first,
+        (invalid_ % filtered_) - 1);
+
+    write(input / "BTC.cfheaders", cfheaders);
+
+    // Filter headers are only imported for blocks which match the local chain
+    auto unrelated = headers;
+    break_work(unrelated, filtered_ / 2);
+    write(file, unrelated);
+
+    EXPECT_TRUE(bootstrap.Import(input.string(), instantiate, job, dispatch_));
+    join();
+    EXPECT_EQ(database.FilterHeaderTip(filterType).first, (filtered_ / 2) - 1);
+
+    write(file, headers);
+    write(input / "BTC.cfilters", cfilters);
+
+    EXPECT_TRUE(bootstrap.Import(input.string(), instantiate, job, dispatch_));
+    join();
+    EXPECT_EQ(database.FilterHeaderTip(filterType).first, filtered_);
+    EXPECT_EQ(database.FilterTip(filterType).first, filtered_);
+
+    const auto output = directory();
+
+    EXPECT_TRUE(bootstrap.Export(output.string()));
+    EXPECT_EQ(read(output / "BTC.headers"), headers);
+    EXPECT_EQ(read(output / "BTC.cfheaders"), cfheaders);
+    EXPECT_EQ(read(output / "BTC.cfilters"), cfilters);
+
+    // Files are not written again while the tips are unchanged
+    write(output / "BTC.cfilters", ot::Space{});
+
+    EXPECT_TRUE(bootstrap.Export(output.string()));
+    EXPECT_TRUE(read(output / "BTC.cfilters").empty());
+
+    // The first record must be the genesis block of the chain
+    write(file, ot::Space{headers.begin() + size, headers.end()});
+
+    EXPECT_FALSE(bootstrap.Import(input.string(), instantiate, job, dispatch_));
+    EXPECT_FALSE(
+        bootstrap.Import(directory().string(), instantiate, job, dispatch_));
+
+    fs::remove_all(input);
+    fs::remove_all(output);
+}
@@ -0,0 +1,131 @@
+// Copyright (c) 2010-2020 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "Helpers.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+
+namespace
+{
+using Headers = std::vector<std::unique_ptr<bb::Header>>;
+
+auto serialize(const std::vector<std::string>& hex) -> std::vector<ot::OTData>
+{
+    auto output = std::vector<ot::OTData>{};
+
+    for (const auto& header : hex) {
+        output.emplace_back(ot::Data::Factory(header, ot::Data::Mode::Hex));
+    }
+
+    return output;
+}
+
+auto views(const std::vector<ot::OTData>& raw) -> std::vector<ot::ReadView>
+{
+    auto output = std::vector<ot::ReadView>{};
+
+    for (const auto& header : raw) { output.emplace_back(header->Bytes()); }
+
+    return output;
+}
+}  // namespace
+
+TEST_F(Test_HeaderOracle, prepare_headers)
+{
+    const auto raw = serialize(bitcoin_);
+    const auto instantiate =
+        [&](const ot::ReadView bytes) -> std::unique_ptr<bb::Header> {
+        return api_.Factory().BlockHeader(
+            type_, ot::Data::Factory(bytes.data(), bytes.size()));
+    };
+    auto job = Job{4, 50};
+    auto headers = bc::internal::PrepareHeaders(
+        views(raw), instantiate, job, dispatch_);
+    join();
+
+    ASSERT_EQ(bitcoin_.size(), headers.size());
+
+    for (auto i = std::size_t{0}; i < raw.size(); ++i) {
+        const auto expected = instantiate(raw.at(i)->Bytes());
+
+        ASSERT_TRUE(expected);
+        ASSERT_TRUE(headers.at(i));
+        EXPECT_EQ(expected->Hash(), headers.at(i)->Hash());
+        EXPECT_EQ(
+            expected->Work()->Decimal(), headers.at(i)->Work()->Decimal());
+    }
+
+    EXPECT_TRUE(header_oracle_.AddHeaders(headers));
+
+    const auto [height, hash] = header_oracle_.BestChain();
+
+    EXPECT_EQ(height, bitcoin_.size());
+}
+
+TEST_F(Test_HeaderOracle, prepare_headers_stops_at_invalid_work)
+{
+    const auto raw = serialize(bitcoin_);
+    auto input = views(raw);
+    auto modified = ot::space(input.at(invalid_));
+    break_work(modified, 0);
+    input.at(invalid_) = ot::reader(modified);
+    const auto instantiate =
+        [&](const ot::ReadView bytes) -> std::unique_ptr<bb::Header> {
+        return api_.Factory().BlockHeader(
+            type_, ot::Data::Factory(bytes.data(), bytes.size()));
+    };
+    auto job = Job{4, 50};
+    const auto headers =
+        bc::internal::PrepareHeaders(input, instantiate, job, dispatch_);
+    join();
+
+    EXPECT_EQ(invalid_, headers.size());
+
+    for (const auto& header : headers) { EXPECT_TRUE(header); }
+
+    input.at(0) = ot::ReadView{input.at(0).data(), 79};
+    const auto none =
+        bc::internal::PrepareHeaders(input, instantiate, job, dispatch_);
+    join();
+
+    EXPECT_TRUE(none.empty());
+}
+
+TEST_F(Test_HeaderOracle, prepare_headers_throughput)
+{
+    constexpr auto rounds = std::size_t{5};
+    const auto raw = serialize(bitcoin_);
+    const auto input = views(raw);
+    const auto instantiate =
+        [&](const ot::ReadView bytes) -> std::unique_ptr<bb::Header> {
+        return api_.Factory().BlockHeader(
+            type_, ot::Data::Factory(bytes.data(), bytes.size()));
+    };
+    const auto max = std::max(std::thread::hardware_concurrency(), 1u);
+
+    for (auto threads = 1u; threads <= max; threads *= 2u) {
+        auto job = Job{threads, 50};
+        const auto start = std::chrono::steady_clock::now();
+
+        for (auto i = std::size_t{0}; i < rounds; ++i) {
+            const auto headers = bc::internal::PrepareHeaders(
+                input, instantiate, job, dispatch_);
+
+            EXPECT_EQ(input.size(), headers.size());
+        }
+
+        const auto seconds = std::chrono::duration<double>(
+                                 std::chrono::steady_clock::now() - start)
+                                 .count();
+        join();
+
+        RecordProperty(
+            std::to_string(threads) + "_threads_headers_per_second",
+            static_cast<int>((rounds * input.size()) / seconds));
+    }
+}
@@ -0,0 +1,132 @@
+// Copyright (c) 2010-2020 The Open-Transactions developers
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "Helpers.hpp"
+
+#include <cstring>
+#include <string>
+
+#include "api/client/blockchain/database/Database.hpp"
+#include "internal/api/client/Client.hpp"
+#include "internal/blockchain/block/Block.hpp"
+#include "util/LMDB.hpp"
+
+namespace
+{
+namespace lmdb = ot::storage::lmdb;
+
+// Tables and keys of the chain database which hold the header records
+enum Table { Config = 0, BlockHeaderMetadata = 1 };
+constexpr auto header_storage_version_key_ = std::size_t{4};
+
+const lmdb::TableNames tables_{
+    {Config, "config"},
+    {BlockHeaderMetadata, "block_header_metadata"},
+};
+const lmdb::TablesToInit init_{{Config, MDB_INTEGERKEY},
+                               {BlockHeaderMetadata, 0}};
+
+template <typename Input>
+auto tsv(const Input& in) -> ot::ReadView
+{
+    return {reinterpret_cast<const char*>(&in), sizeof(in)};
+}
+}  // namespace
+
+TEST_F(Test_HeaderOracle, upgrade)
+{
+    using Record = bb::internal::SerializedHeader;
+
+    const auto& blockchain =
+        dynamic_cast<const ot::api::client::internal::Blockchain&>(
+            api_.Blockchain());
+    auto headers = std::vector<std::unique_ptr<bb::Header>>{};
+
+    for (const auto& hex : bitcoin_) {
+        headers.emplace_back(api_.Factory().BlockHeader(
+            type_, ot::Data::Factory(hex, ot::Data::Mode::Hex)));
+
+        ASSERT_TRUE(headers.back());
+    }
+
+    ASSERT_TRUE(header_oracle_.AddHeaders(headers));
+
+    auto expected = std::vector<std::unique_ptr<bb::Header>>{};
+
+    for (auto height = std::size_t{0}; height <= bitcoin_.size(); ++height) {
+        expected.emplace_back(header_oracle_.LoadHeader(
+            header_oracle_.BestHash(static_cast<bb::Height>(height))));
+
+        ASSERT_TRUE(expected.back());
+    }
+
+    network_.reset();
+    const auto& common = blockchain.BlockchainDB();
+    const auto folder = common.AllocateStorageFolder(
+        std::to_string(static_cast<std::uint32_t>(type_)));
+
+    // Rewrite every record in the format used before header storage version 2
+    {
+        const auto db = lmdb::LMDB{tables_, folder, init_};
+
+        for (const auto& header : expected) {
+            const auto local = header->Serialize().local().SerializeAsString();
+
+            ASSERT_TRUE(common.StoreBlockHeader(*header));
+            ASSERT_TRUE(
+                db.Store(BlockHeaderMetadata, header->Hash().Bytes(), local)
+                    .first);
+        }
+
+        ASSERT_TRUE(
+            db.Store(Config, header_storage_version_key_, tsv(std::size_t{1}))
+                .first);
+    }
+
+    network_ = ot::factory::BlockchainNetworkBitcoin(
+        api_, blockchain, type_, "do not init peers", "inproc://empty");
+
+    ASSERT_TRUE(network_);
+
+    const auto& oracle = network_->HeaderOracle();
+
+    EXPECT_EQ(oracle.BestChain().first, bitcoin_.size());
+
+    for (const auto& header : expected) {
+        const auto loaded = oracle.LoadHeader(header->Hash());
+
+        ASSERT_TRUE(loaded);
+        EXPECT_EQ(loaded->Hash(), header->Hash());
+        EXPECT_EQ(loaded->ParentHash(), header->ParentHash());
+        EXPECT_EQ(loaded->Height(), header->Height());
+        EXPECT_EQ(loaded->LocalState(), header->LocalState());
+        EXPECT_EQ(loaded->InheritedState(), header->InheritedState());
+        EXPECT_EQ(loaded->Work()->Decimal(), header->Work()->Decimal());
+    }
+
+    network_.reset();
+
+    const auto db = lmdb::LMDB{tables_, folder, init_};
+    auto converted = std::size_t{0};
+    auto legacy = std::size_t{0};
+    db.Read(
+        BlockHeaderMetadata,
+        [&](const auto, const auto value) {
+            ++(Record::Valid(value) ? converted : legacy);
+
+            return true;
+        },
+        lmdb::LMDB::Dir::Forward);
+    auto version = std::size_t{0};
+    db.Load(Config, header_storage_version_key_, [&](const auto value) {
+        if (sizeof(version) == value.size()) {
+            std::memcpy(&version, value.data(), value.size());
+        }
+    });
+
+    EXPECT_EQ(converted, expected.size());
+    EXPECT_EQ(legacy, 0);
+    EXPECT_EQ(version, 2);
+}
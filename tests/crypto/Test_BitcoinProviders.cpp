@@ -574,6 +574,74 @@ public:
 
         return true;
     }
+
+    bool test_bip32_batch(const ot::crypto::Bip32& library)
+    {
+        constexpr auto first = ot::Bip32Index{3};
+        constexpr auto count = ot::Bip32Index{8};
+
+        for (const auto& testVector : bip_32_) {
+            const auto& [hex, cases] = testVector;
+            const auto pSeed = get_seed(hex);
+            const auto& seed = *pSeed;
+            const auto parent = Path{
+                0 | static_cast<ot::Bip32Index>(ot::Bip32Child::HARDENED), 1};
+            const auto keys = library.DeriveKeys(
+                ot::EcdsaCurve::secp256k1, seed, parent, first, count);
+            const auto& [xPrivate, xCode, xPublic, xPath, xParent] =
+                library.DeriveKey(ot::EcdsaCurve::secp256k1, seed, parent);
+            const auto pubkeys = library.DerivePublicKeys(
+                ot::EcdsaCurve::secp256k1,
+                xPublic->Bytes(),
+                xCode.Bytes(),
+                parent,
+                first,
+                count);
+
+            EXPECT_EQ(count, keys.size());
+            EXPECT_EQ(count, pubkeys.size());
+
+            if ((count != keys.size()) || (count != pubkeys.size())) {
+                return false;
+            }
+
+            for (auto i = ot::Bip32Index{0}; i < count; ++i) {
+                auto path{parent};
+                path.emplace_back(first + i);
+                const auto expected =
+                    library.DeriveKey(ot::EcdsaCurve::secp256k1, seed, path);
+                const auto& [ePrivate, eCode, ePublic, ePath, eParent] =
+                    expected;
+                const auto& [bPrivate, bCode, bPublic, bPath, bParent] =
+                    keys.at(i);
+                const auto& [pPrivate, pCode, pPublic, pPath, pParent] =
+                    pubkeys.at(i);
+
+                EXPECT_EQ(ePrivate.Bytes(), bPrivate.Bytes());
+                EXPECT_EQ(eCode.Bytes(), bCode.Bytes());
+                EXPECT_EQ(ePublic.get(), bPublic.get());
+                EXPECT_EQ(ePath, bPath);
+                EXPECT_EQ(eParent, bParent);
+                EXPECT_EQ(0, pPrivate.getMemorySize());
+                EXPECT_EQ(eCode.Bytes(), pCode.Bytes());
+                EXPECT_EQ(ePublic.get(), pPublic.get());
+                EXPECT_EQ(ePath, pPath);
+                EXPECT_EQ(eParent, pParent);
+            }
+
+            const auto hardened = library.DerivePublicKeys(
+                ot::EcdsaCurve::secp256k1,
+                xPublic->Bytes(),
+                xCode.Bytes(),
+                parent,
+                static_cast<ot::Bip32Index>(ot::Bip32Child::HARDENED),
+                1);
+
+            EXPECT_EQ(0, hardened.size());
+        }
+
+        return true;
+    }
 #endif
 
     bool test_bip39(const ot::crypto::Bip32& library)
@@ -623,6 +691,7 @@ TEST_F(Test_Bitcoin_Providers, Common)
 #if OT_CRYPTO_WITH_BIP32
     EXPECT_TRUE(test_bip32_seed(crypto_.BIP32()));
     EXPECT_TRUE(test_bip32_child_key(crypto_.BIP32()));
+    EXPECT_TRUE(test_bip32_batch(crypto_.BIP32()));
 #endif  // OT_CRYPTO_WITH_BIP32
 }
 }  // namespace